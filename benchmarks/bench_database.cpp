@@ -0,0 +1,150 @@
+#include "synthetic_load.h"
+#include "database/database_manager.h"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <memory>
+#include <cstdlib>
+
+namespace {
+
+using namespace TradingSystem;
+
+enum Backend : int64_t { kSqlite = 0, kJournal = 1 };
+
+// A fresh database (and journal directory) under /tmp, removed afterwards
+class ScratchDatabase {
+public:
+    explicit ScratchDatabase(Backend backend) {
+        char pattern[] = "/tmp/trading_bench_XXXXXX";
+        if (mkdtemp(pattern)) {
+            directory = pattern;
+            db = std::make_unique<DatabaseManager>(directory + "/bench.db");
+            ready = db->initialize() &&
+                    (backend != kJournal || db->enableBarJournal(directory + "/journal"));
+        }
+    }
+
+    ~ScratchDatabase() {
+        db.reset();
+        if (!directory.empty()) {
+            std::error_code ignored;
+            std::filesystem::remove_all(directory, ignored);
+        }
+    }
+
+    bool ready = false;
+    std::unique_ptr<DatabaseManager> db;
+
+private:
+    std::string directory;
+};
+
+const char* backendName(int64_t backend) {
+    return backend == kJournal ? "journal" : "sqlite";
+}
+
+// One batch per iteration holding a bar for each of range(0) symbols, as
+// the fetch loop stores them
+void BM_DatabaseInsertBatch(benchmark::State& state) {
+    ScratchDatabase scratch(static_cast<Backend>(state.range(1)));
+    if (!scratch.ready) {
+        state.SkipWithError("could not create the database");
+        return;
+    }
+    SyntheticMarket market(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        const std::vector<MarketData>& bars = market.nextBars();
+        state.ResumeTiming();
+        if (!scratch.db->insertMarketDataBatch(bars)) {
+            state.SkipWithError("insert failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(backendName(state.range(1)));
+}
+BENCHMARK(BM_DatabaseInsertBatch)
+    ->ArgNames({"symbols", "backend"})
+    ->ArgsProduct({{1, 10, 100}, {kSqlite, kJournal}})
+    ->Unit(benchmark::kMicrosecond);
+
+constexpr size_t kReadSymbols = 10;
+constexpr size_t kStoredBars = 20000;
+
+void fill(DatabaseManager& db, SyntheticMarket& market) {
+    std::vector<MarketData> batch;
+    for (size_t s = 0; s < market.symbolCount(); ++s) {
+        batch.clear();
+        for (size_t i = 0; i < kStoredBars; ++i) {
+            batch.push_back(market.nextBar(s));
+        }
+        db.insertMarketDataBatch(batch);
+    }
+}
+
+// The indicator warm-up read: the newest range(0) bars of one symbol
+void BM_DatabaseReadLatest(benchmark::State& state) {
+    ScratchDatabase scratch(static_cast<Backend>(state.range(1)));
+    if (!scratch.ready) {
+        state.SkipWithError("could not create the database");
+        return;
+    }
+    SyntheticMarket market(kReadSymbols);
+    fill(*scratch.db, market);
+
+    const int limit = static_cast<int>(state.range(0));
+    size_t next = 0;
+    for (auto _ : state) {
+        auto bars = scratch.db->getMarketData(market.symbol(next), limit);
+        benchmark::DoNotOptimize(bars.data());
+        next = (next + 1) % kReadSymbols;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(backendName(state.range(1)));
+}
+BENCHMARK(BM_DatabaseReadLatest)
+    ->ArgNames({"bars", "backend"})
+    ->ArgsProduct({{100, 500}, {kSqlite, kJournal}})
+    ->Unit(benchmark::kMicrosecond);
+
+// A streamed range scan covering range(0) bars from the middle of the history
+void BM_DatabaseScanRange(benchmark::State& state) {
+    ScratchDatabase scratch(static_cast<Backend>(state.range(1)));
+    if (!scratch.ready) {
+        state.SkipWithError("could not create the database");
+        return;
+    }
+    SyntheticMarket market(kReadSymbols);
+    fill(*scratch.db, market);
+
+    const int64_t span = state.range(0);
+    auto start = fromEpochNanos(SyntheticMarket::kDefaultStartNs +
+                                static_cast<int64_t>(kStoredBars / 4) * SyntheticMarket::kBarIntervalNs);
+    auto end = start + std::chrono::nanoseconds((span - 1) * SyntheticMarket::kBarIntervalNs);
+
+    size_t next = 0;
+    for (auto _ : state) {
+        double sum = 0.0;
+        size_t rows = scratch.db->getMarketDataRange(market.symbol(next), start, end,
+            [&sum](const DatabaseManager::BarRow& row) {
+                sum += row.close;
+                return true;
+            });
+        if (rows != static_cast<size_t>(span)) {
+            state.SkipWithError("range returned the wrong number of bars");
+            break;
+        }
+        benchmark::DoNotOptimize(sum);
+        next = (next + 1) % kReadSymbols;
+    }
+    state.SetItemsProcessed(state.iterations() * span);
+    state.SetLabel(backendName(state.range(1)));
+}
+BENCHMARK(BM_DatabaseScanRange)
+    ->ArgNames({"bars", "backend"})
+    ->ArgsProduct({{1440, 10000}, {kSqlite, kJournal}})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
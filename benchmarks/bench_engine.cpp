@@ -0,0 +1,97 @@
+#include "synthetic_load.h"
+#include "trading/trading_engine.h"
+#include "market_data/market_data_cache.h"
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+
+namespace {
+
+using namespace TradingSystem;
+
+// A paper engine over range(0) symbols with every price cached. Limits are
+// wide enough that no order is refused, and there is no database, so the
+// numbers are the engine's own cost.
+struct EngineFixture {
+    explicit EngineFixture(size_t symbol_count)
+        : market(symbol_count),
+          cache(std::make_shared<MarketDataCache>()),
+          engine(TradingMode::PAPER, 1e12) {
+        engine.setVerbose(false);
+        engine.setMarketDataCache(cache);
+        engine.setMaxPositionSize(1e9);
+        engine.setMaxDrawdown(1.0);
+        for (const auto& bar : market.nextBars()) {
+            cache->update(bar);
+        }
+    }
+
+    SyntheticMarket market;
+    std::shared_ptr<MarketDataCache> cache;
+    TradingEngine engine;
+};
+
+// A market buy and the sell that closes it, cycling through the symbols
+void BM_EnginePlaceOrder(benchmark::State& state) {
+    EngineFixture fixture(static_cast<size_t>(state.range(0)));
+    const auto& ids = fixture.market.symbolIds();
+    size_t next = 0;
+    for (auto _ : state) {
+        SymbolId id = ids[next];
+        fixture.engine.placeOrder(id, OrderSide::BUY, 1.0);
+        fixture.engine.placeOrder(id, OrderSide::SELL, 1.0);
+        next = (next + 1) % ids.size();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_EnginePlaceOrder)->ArgName("symbols")->Arg(10)->Arg(100)->Arg(1000);
+
+// A BUY signal and the SELL that exits it, sized from the cached quote
+void BM_EngineProcessSignal(benchmark::State& state) {
+    EngineFixture fixture(static_cast<size_t>(state.range(0)));
+    const size_t symbol_count = fixture.market.symbolCount();
+    std::vector<TradingSignal> buys;
+    std::vector<TradingSignal> sells;
+    for (size_t i = 0; i < symbol_count; ++i) {
+        buys.push_back(fixture.market.signal(i, SignalAction::BUY, 1000.0));
+        sells.push_back(fixture.market.signal(i, SignalAction::SELL, 1000.0));
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+        fixture.engine.processTradingSignal(buys[next]);
+        fixture.engine.processTradingSignal(sells[next]);
+        next = (next + 1) % symbol_count;
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_EngineProcessSignal)->ArgName("symbols")->Arg(10)->Arg(100)->Arg(1000);
+
+// A position in every symbol, all marked by one updatePositionPrices call.
+// Prices move between two nearby levels, inside the stop-loss and
+// take-profit bands, so nothing exits.
+void BM_EngineUpdatePositionPrices(benchmark::State& state) {
+    EngineFixture fixture(static_cast<size_t>(state.range(0)));
+    const auto& ids = fixture.market.symbolIds();
+    for (SymbolId id : ids) {
+        fixture.engine.placeOrder(id, OrderSide::BUY, 1.0);
+    }
+
+    std::map<std::string, double> up = fixture.market.prices();
+    std::map<std::string, double> down = up;
+    for (auto& [symbol, price] : up) price *= 1.001;
+    for (auto& [symbol, price] : down) price *= 0.999;
+
+    bool flip = false;
+    for (auto _ : state) {
+        fixture.engine.updatePositionPrices(flip ? up : down);
+        flip = !flip;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    if (fixture.engine.getAllPositions().size() != ids.size()) {
+        state.SkipWithError("positions exited during the benchmark");
+    }
+}
+BENCHMARK(BM_EngineUpdatePositionPrices)->ArgName("symbols")->Arg(10)->Arg(100)->Arg(1000);
+
+} // namespace
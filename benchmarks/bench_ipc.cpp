@@ -0,0 +1,87 @@
+#include "ipc/ipc_manager.h"
+#include "ipc/shm_ring_buffer.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using namespace TradingSystem;
+
+// Stands in for the Python analyzer: attaches to the manager's two rings
+// and sends every frame straight back
+class EchoPeer {
+public:
+    explicit EchoPeer(const std::string& base) {
+        attached = inbound.attach("/" + base + "_to_python") && outbound.attach("/" + base + "_to_cpp");
+        if (attached) {
+            thread = std::thread([this] { run(); });
+        }
+    }
+
+    ~EchoPeer() {
+        running = false;
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    bool attached = false;
+
+private:
+    ShmRingBuffer inbound;
+    ShmRingBuffer outbound;
+    std::atomic<bool> running{true};
+    std::thread thread;
+
+    void run() {
+        while (running) {
+            if (!inbound.waitForData(50)) {
+                continue;
+            }
+            std::string_view frame;
+            while (inbound.peek(frame)) {
+                outbound.write(frame.data(), frame.size(), 1000);
+                inbound.consume();
+            }
+        }
+    }
+};
+
+// Send to the analyzer and wait for the reply through IPCManager's reader
+// thread and receive backlog; range(0) is the message size in bytes
+void BM_IpcRoundTrip(benchmark::State& state) {
+    std::string base = "trading_bench_ipc_" + std::to_string(getpid());
+    IPCManager ipc("/tmp/" + base, IPCTransport::SHARED_MEMORY);
+    if (!ipc.initialize()) {
+        state.SkipWithError("could not create the shared-memory rings");
+        return;
+    }
+    EchoPeer peer(base);
+    if (!peer.attached) {
+        state.SkipWithError("could not attach to the shared-memory rings");
+        return;
+    }
+    ipc.start();
+
+    std::string message(static_cast<size_t>(state.range(0)), 'x');
+    for (auto _ : state) {
+        if (!ipc.sendMessage(message)) {
+            state.SkipWithError("send failed");
+            break;
+        }
+        std::string reply = ipc.receiveMessage(1000);
+        if (reply.size() != message.size()) {
+            state.SkipWithError("no reply within 1s");
+            break;
+        }
+    }
+    ipc.stop();
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_IpcRoundTrip)->Arg(64)->Arg(1024)->Arg(16384)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+} // namespace
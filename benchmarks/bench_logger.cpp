@@ -0,0 +1,85 @@
+#include "logging/logger.h"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+
+using namespace TradingSystem;
+
+// Records go to /dev/null so the numbers are the logger's cost (encoding,
+// ring handoff, formatting, batching) rather than the disk's
+void useNullSink() {
+    static bool initialized = false;
+    if (!initialized) {
+        Logger& logger = Logger::getInstance();
+        logger.setConsoleOutput(false);
+        logger.initialize("/dev/null", LogLevel::INFO);
+        initialized = true;
+    }
+}
+
+// LOG_FAST on the async path, one ring per benchmark thread. BLOCK makes
+// the callers wait for the writer, so this is sustained throughput, not
+// the rate at which a ring fills.
+void BM_LoggerFastAsync(benchmark::State& state) {
+    Logger& logger = Logger::getInstance();
+    if (state.thread_index() == 0) {
+        useNullSink();
+        AsyncLogOptions options;
+        options.overflow = LogOverflowPolicy::BLOCK;
+        logger.startAsync(options);
+    }
+
+    double price = 43125.5;
+    for (auto _ : state) {
+        LOG_FAST(LogLevel::INFO, "Fetched {} price: ${}", "BTC", price);
+        price += 0.25;
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        logger.flush();
+        state.counters["dropped"] = static_cast<double>(logger.droppedCount());
+        logger.stopAsync();
+    }
+}
+BENCHMARK(BM_LoggerFastAsync)->ThreadRange(1, 4)->UseRealTime();
+
+// The same call site with the logger synchronous: formatted and written
+// on the calling thread
+void BM_LoggerFastSync(benchmark::State& state) {
+    useNullSink();
+    double price = 43125.5;
+    for (auto _ : state) {
+        LOG_FAST(LogLevel::INFO, "Fetched {} price: ${}", "BTC", price);
+        price += 0.25;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerFastSync);
+
+// The string API most of main_new still uses
+void BM_LoggerInfo(benchmark::State& state) {
+    useNullSink();
+    double price = 43125.5;
+    for (auto _ : state) {
+        LOG_INFO("Fetched BTC price: $" + std::to_string(price));
+        price += 0.25;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerInfo);
+
+// A disabled level costs one relaxed load
+void BM_LoggerDisabled(benchmark::State& state) {
+    useNullSink();
+    double price = 43125.5;
+    for (auto _ : state) {
+        LOG_FAST(LogLevel::DEBUG, "Fetched {} price: ${}", "BTC", price);
+        price += 0.25;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerDisabled);
+
+} // namespace
@@ -0,0 +1,19 @@
+#include <benchmark/benchmark.h>
+
+#ifndef TRADING_BENCH_REVISION
+#define TRADING_BENCH_REVISION "unknown"
+#endif
+
+// Google Benchmark's own main, plus the source revision in the report's
+// context block so JSON results can be matched to a release:
+//   trading_benchmarks --benchmark_out=results.json --benchmark_out_format=json
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::AddCustomContext("revision", TRADING_BENCH_REVISION);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
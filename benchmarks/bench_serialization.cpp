@@ -0,0 +1,77 @@
+#include "synthetic_load.h"
+#include "polygon_parser.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+using namespace TradingSystem;
+
+// curl hands the write callback at most CURL_MAX_WRITE_SIZE bytes at a time
+constexpr size_t kCurlChunkBytes = 16 * 1024;
+
+void BM_MarketDataToJson(benchmark::State& state) {
+    SyntheticMarket market(1);
+    MarketData data = market.nextBar(0);
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::string json = data.toJson();
+        bytes += json.size();
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_MarketDataToJson);
+
+void BM_MarketDataFromJson(benchmark::State& state) {
+    SyntheticMarket market(1);
+    std::string json = market.nextBar(0).toJson();
+    for (auto _ : state) {
+        MarketData data = MarketData::fromJson(json);
+        benchmark::DoNotOptimize(data);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * json.size()));
+}
+BENCHMARK(BM_MarketDataFromJson);
+
+void BM_TradingSignalFromJson(benchmark::State& state) {
+    SyntheticMarket market(1);
+    std::string json = market.signal(0, SignalAction::BUY, 1000.0).toJson();
+    for (auto _ : state) {
+        TradingSignal signal = TradingSignal::fromJson(json);
+        benchmark::DoNotOptimize(signal);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TradingSignalFromJson);
+
+// The body StockApi streams through PolygonAggParser, fed in curl-sized
+// chunks; range(0) is the number of bars in the response
+void BM_PolygonParse(benchmark::State& state) {
+    const size_t bar_count = static_cast<size_t>(state.range(0));
+    SyntheticMarket market(1);
+    std::string body = market.polygonResponse(0, bar_count);
+    std::vector<PolygonBar> bars(bar_count);
+    PolygonAggParser parser;
+
+    for (auto _ : state) {
+        parser.reset(bars.data(), bars.size());
+        for (size_t offset = 0; offset < body.size(); offset += kCurlChunkBytes) {
+            size_t length = std::min(kCurlChunkBytes, body.size() - offset);
+            parser.feed(std::string_view(body.data() + offset, length));
+        }
+        if (!parser.finish() || parser.barCount() != bar_count) {
+            state.SkipWithError("Polygon response did not parse");
+            break;
+        }
+        benchmark::DoNotOptimize(bars.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * bar_count));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+}
+BENCHMARK(BM_PolygonParse)->Arg(1)->Arg(1000)->Arg(50000);
+
+} // namespace
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <string>
+#include <cstdint>
+
+#include "synthetic_load.h"
+#include "backtest/bar_dataset.h"
+
+using namespace TradingSystem;
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " --out FILE [options]\n"
+              << "  --out FILE           .bars file to write (replay with backtest_main --bars)\n"
+              << "  --symbols N          synthetic symbols (default 8)\n"
+              << "  --bars N             one-minute bars per symbol (default 100000)\n"
+              << "  --seed N             random walk seed (default 1)\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string out_path;
+    size_t symbol_count = 8;
+    size_t bar_count = 100000;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--out" && has_value) {
+            out_path = argv[++i];
+        } else if (arg == "--symbols" && has_value) {
+            symbol_count = std::stoul(argv[++i]);
+        } else if (arg == "--bars" && has_value) {
+            bar_count = std::stoul(argv[++i]);
+        } else if (arg == "--seed" && has_value) {
+            seed = std::stoull(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (out_path.empty() || symbol_count == 0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    SyntheticMarket market(symbol_count, seed);
+    BarDataset dataset;
+    for (size_t i = 0; i < symbol_count; ++i) {
+        dataset.add(market.series(i, bar_count));
+    }
+    if (!dataset.saveFile(out_path)) {
+        std::cerr << "Failed to write " << out_path << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << dataset.totalBars() << " bars for " << symbol_count
+              << " symbols to " << out_path << std::endl;
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "synthetic_load.h"
+#include "common/symbol_table.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace TradingSystem {
+
+SyntheticMarket::SyntheticMarket(size_t symbol_count, uint64_t seed, int64_t start_ns)
+    : rng(seed) {
+    names.reserve(symbol_count);
+    ids.reserve(symbol_count);
+    walks.reserve(symbol_count);
+    for (size_t i = 0; i < symbol_count; ++i) {
+        char name[32];  // "SYN" and any size_t
+        std::snprintf(name, sizeof(name), "SYN%04zu", i);
+        names.emplace_back(name);
+        ids.push_back(SymbolTable::getInstance().intern(names.back()));
+
+        // Prices from about 1 to 50000, per-bar volatility 0.05% to 0.3%
+        Walk walk;
+        walk.close = std::exp(rng.nextDouble() * std::log(50000.0));
+        walk.volatility = 0.0005 + rng.nextDouble() * 0.0025;
+        walk.timestamp_ns = start_ns;
+        walks.push_back(walk);
+    }
+}
+
+double SyntheticMarket::gaussian() {
+    // Box-Muller; the second draw is thrown away to keep the stream simple
+    double u1 = std::max(rng.nextDouble(), 1e-300);
+    double u2 = rng.nextDouble();
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+}
+
+void SyntheticMarket::step(Walk& walk, double& open, double& high, double& low, double& close, double& volume) {
+    open = walk.close;
+    close = open * std::exp(walk.volatility * gaussian());
+    double wick = walk.volatility * 0.5;
+    high = std::max(open, close) * (1.0 + wick * rng.nextDouble());
+    low = std::min(open, close) * (1.0 - wick * rng.nextDouble());
+    volume = 1.0 + 999.0 * rng.nextDouble();
+    walk.close = close;
+    walk.timestamp_ns += kBarIntervalNs;
+}
+
+MarketData SyntheticMarket::nextBar(size_t symbol_index) {
+    Walk& walk = walks[symbol_index];
+    MarketData data;
+    data.symbol = names[symbol_index];
+    data.timestamp = fromEpochNanos(walk.timestamp_ns);
+    step(walk, data.open, data.high, data.low, data.close, data.volume);
+    return data;
+}
+
+const std::vector<MarketData>& SyntheticMarket::nextBars() {
+    bars.resize(names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+        bars[i] = nextBar(i);
+    }
+    return bars;
+}
+
+std::map<std::string, double> SyntheticMarket::prices() const {
+    std::map<std::string, double> result;
+    for (size_t i = 0; i < names.size(); ++i) {
+        result[names[i]] = walks[i].close;
+    }
+    return result;
+}
+
+TradingSignal SyntheticMarket::signal(size_t symbol_index, SignalAction action, double position_size) {
+    TradingSignal signal;
+    signal.symbol = names[symbol_index];
+    signal.symbol_id = ids[symbol_index];
+    signal.action = action;
+    signal.confidence = 0.5 + 0.5 * rng.nextDouble();
+    signal.suggested_position_size = position_size;
+    signal.timestamp = fromEpochNanos(walks[symbol_index].timestamp_ns);
+    return signal;
+}
+
+BarSeries SyntheticMarket::series(size_t symbol_index, size_t n) {
+    BarSeries result(names[symbol_index]);
+    result.reserve(n);
+    Walk& walk = walks[symbol_index];
+    for (size_t i = 0; i < n; ++i) {
+        int64_t timestamp_ns = walk.timestamp_ns;
+        double open, high, low, close, volume;
+        step(walk, open, high, low, close, volume);
+        result.append(open, high, low, close, volume, timestamp_ns);
+    }
+    return result;
+}
+
+std::string SyntheticMarket::polygonResponse(size_t symbol_index, size_t n) {
+    std::string body;
+    body.reserve(160 + n * 128);
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "{\"ticker\":\"X:%sUSD\",\"queryCount\":%zu,\"resultsCount\":%zu,\"adjusted\":true,\"results\":[",
+                  names[symbol_index].c_str(), n, n);
+    body += buffer;
+
+    Walk& walk = walks[symbol_index];
+    for (size_t i = 0; i < n; ++i) {
+        int64_t timestamp_ms = walk.timestamp_ns / 1000000;
+        double open, high, low, close, volume;
+        step(walk, open, high, low, close, volume);
+        double vwap = (high + low + close) / 3.0;
+        long long trades = 1 + static_cast<long long>(volume / 4.0);
+        std::snprintf(buffer, sizeof(buffer),
+                      "%s{\"v\":%.8f,\"vw\":%.4f,\"o\":%.4f,\"c\":%.4f,\"h\":%.4f,\"l\":%.4f,\"t\":%lld,\"n\":%lld}",
+                      i == 0 ? "" : ",", volume, vwap, open, close, high, low,
+                      static_cast<long long>(timestamp_ms), trades);
+        body += buffer;
+    }
+
+    body += "],\"status\":\"OK\",\"request_id\":\"6a7e466379af0a71039d60cc78e72282\",\"count\":";
+    body += std::to_string(n);
+    body += "}";
+    return body;
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,69 @@
+#ifndef SYNTHETIC_LOAD_H
+#define SYNTHETIC_LOAD_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstddef>
+#include <cstdint>
+#include "common/data_types.h"
+#include "common/fast_random.h"
+#include "analysis/bar_series.h"
+
+namespace TradingSystem {
+
+// Deterministic synthetic market for benchmarks and replays. Each symbol
+// follows its own geometric random walk on one-minute bars, all driven by
+// one seeded xoshiro256** stream, so the same seed gives the same bars,
+// signals and payloads on every machine and every release.
+class SyntheticMarket {
+public:
+    static constexpr int64_t kBarIntervalNs = 60LL * 1000000000LL;
+    // 2024-01-01T00:00:00Z
+    static constexpr int64_t kDefaultStartNs = 1704067200LL * 1000000000LL;
+
+    explicit SyntheticMarket(size_t symbol_count, uint64_t seed = 1,
+                             int64_t start_ns = kDefaultStartNs);
+
+    size_t symbolCount() const { return names.size(); }
+    const std::vector<std::string>& symbols() const { return names; }
+    const std::string& symbol(size_t i) const { return names[i]; }
+    // Interned ids, same order as symbols()
+    const std::vector<SymbolId>& symbolIds() const { return ids; }
+
+    // Advance every symbol by one bar and return the bars, in symbol order
+    const std::vector<MarketData>& nextBars();
+    // Advance one symbol by one bar
+    MarketData nextBar(size_t symbol_index);
+    // The latest close of every symbol, keyed by name
+    std::map<std::string, double> prices() const;
+
+    // A BUY or SELL with random confidence for symbol_index
+    TradingSignal signal(size_t symbol_index, SignalAction action, double position_size);
+
+    // n bars of one symbol as a columnar series (replay and .bars files)
+    BarSeries series(size_t symbol_index, size_t n);
+
+    // Body of a Polygon /v2/aggs response carrying n bars of symbol_index
+    std::string polygonResponse(size_t symbol_index, size_t n);
+
+private:
+    struct Walk {
+        double close;
+        double volatility;  // per-bar stddev of log returns
+        int64_t timestamp_ns;
+    };
+
+    Xoshiro256 rng;
+    std::vector<std::string> names;
+    std::vector<SymbolId> ids;
+    std::vector<Walk> walks;
+    std::vector<MarketData> bars;
+
+    double gaussian();
+    void step(Walk& walk, double& open, double& high, double& low, double& close, double& volume);
+};
+
+} // namespace TradingSystem
+
+#endif // SYNTHETIC_LOAD_H
@@ -0,0 +1,101 @@
+#include "bar_series.h"
+
+namespace TradingSystem {
+
+BarSeries::BarSeries(const std::string& symbol)
+    : symbol_name(symbol), symbol_id(SymbolTable::getInstance().intern(symbol)) {
+}
+
+BarSeries BarSeries::fromMarketData(const std::string& symbol, const std::vector<MarketData>& rows) {
+    BarSeries series(symbol);
+    series.reserve(rows.size());
+    for (const auto& row : rows) {
+        series.append(row);
+    }
+    return series;
+}
+
+BarSeries BarSeries::view(const std::string& symbol, const double* open, const double* high, const double* low,
+                          const double* close, const double* volume, const int64_t* timestamps_ns, size_t n) {
+    BarSeries series(symbol);
+    series.viewing = true;
+    series.viewed = Columns{open, high, low, close, volume, timestamps_ns, n};
+    return series;
+}
+
+void BarSeries::materialize() {
+    Columns columns = viewed;
+    viewing = false;
+    viewed = Columns();
+    reserve(columns.count);
+    appendColumns(columns.open, columns.high, columns.low, columns.close, columns.volume,
+                  columns.timestamps, columns.count);
+}
+
+void BarSeries::reserve(size_t n) {
+    if (viewing) {
+        materialize();
+    }
+    open_col.reserve(n);
+    high_col.reserve(n);
+    low_col.reserve(n);
+    close_col.reserve(n);
+    volume_col.reserve(n);
+    timestamp_col.reserve(n);
+}
+
+void BarSeries::clear() {
+    viewing = false;
+    viewed = Columns();
+    open_col.clear();
+    high_col.clear();
+    low_col.clear();
+    close_col.clear();
+    volume_col.clear();
+    timestamp_col.clear();
+}
+
+void BarSeries::append(double open, double high, double low, double close, double volume,
+                       int64_t timestamp_ns) {
+    if (viewing) {
+        materialize();
+    }
+    open_col.push_back(open);
+    high_col.push_back(high);
+    low_col.push_back(low);
+    close_col.push_back(close);
+    volume_col.push_back(volume);
+    timestamp_col.push_back(timestamp_ns);
+}
+
+void BarSeries::append(const MarketData& data) {
+    append(data.open, data.high, data.low, data.close, data.volume, toEpochNanos(data.timestamp));
+}
+
+void BarSeries::appendColumns(const double* open, const double* high, const double* low,
+                              const double* close, const double* volume, const int64_t* timestamps_ns,
+                              size_t n) {
+    if (viewing) {
+        materialize();
+    }
+    open_col.append(open, n);
+    high_col.append(high, n);
+    low_col.append(low, n);
+    close_col.append(close, n);
+    volume_col.append(volume, n);
+    timestamp_col.append(timestamps_ns, n);
+}
+
+MarketData BarSeries::row(size_t i) const {
+    MarketData data;
+    data.symbol = symbol_name;
+    data.open = open()[i];
+    data.high = high()[i];
+    data.low = low()[i];
+    data.close = close()[i];
+    data.volume = volume()[i];
+    data.timestamp = fromEpochNanos(timestamps()[i]);
+    return data;
+}
+
+} // namespace TradingSystem
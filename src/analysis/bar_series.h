@@ -0,0 +1,170 @@
+#ifndef BAR_SERIES_H
+#define BAR_SERIES_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include "../common/data_types.h"
+#include "../common/symbol_table.h"
+
+namespace TradingSystem {
+
+// Growable array of trivially copyable T whose storage starts on a 64-byte
+// boundary and whose capacity is a multiple of 8 elements, so SIMD kernels
+// can use aligned loads and run whole vectors past size() without faulting.
+template <typename T>
+class AlignedBuffer {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    AlignedBuffer() = default;
+    explicit AlignedBuffer(size_t n) { resize(n); }
+    ~AlignedBuffer() { std::free(ptr); }
+
+    AlignedBuffer(const AlignedBuffer& other) { *this = other; }
+    AlignedBuffer& operator=(const AlignedBuffer& other) {
+        if (this != &other) {
+            resize(other.count);
+            if (count > 0) std::memcpy(ptr, other.ptr, count * sizeof(T));
+        }
+        return *this;
+    }
+
+    AlignedBuffer(AlignedBuffer&& other) noexcept { swap(other); }
+    AlignedBuffer& operator=(AlignedBuffer&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    void reserve(size_t n) {
+        if (n <= cap) return;
+        size_t new_cap = (n + 7) & ~size_t(7);
+        void* mem = std::aligned_alloc(kAlignment, new_cap * sizeof(T));
+        if (!mem) throw std::bad_alloc();
+        if (count > 0) std::memcpy(mem, ptr, count * sizeof(T));
+        std::free(ptr);
+        ptr = static_cast<T*>(mem);
+        cap = new_cap;
+    }
+
+    void resize(size_t n) {
+        reserve(n);
+        count = n;
+    }
+
+    void push_back(T value) {
+        if (count == cap) reserve(cap < 8 ? 8 : cap * 2);
+        ptr[count++] = value;
+    }
+
+    void append(const T* values, size_t n) {
+        if (n == 0) return;
+        if (count + n > cap) reserve(std::max(count + n, cap * 2));
+        std::memcpy(ptr + count, values, n * sizeof(T));
+        count += n;
+    }
+
+    void clear() { count = 0; }
+
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+    bool empty() const { return count == 0; }
+
+    T& operator[](size_t i) { return ptr[i]; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+
+    void swap(AlignedBuffer& other) noexcept {
+        std::swap(ptr, other.ptr);
+        std::swap(count, other.count);
+        std::swap(cap, other.cap);
+    }
+
+private:
+    T* ptr = nullptr;
+    size_t count = 0;
+    size_t cap = 0;
+};
+
+// Columnar (struct-of-arrays) bar history for one symbol. Each field is a
+// contiguous aligned array, so batch indicator kernels stream straight
+// through memory instead of striding over MarketData rows and their
+// per-row symbol strings.
+//
+// A series can also be a read-only view over columns owned elsewhere (a
+// mapped .bars file); those are only 8-byte aligned, which the kernels'
+// unaligned loads accept. Reserving or appending copies a view into
+// buffers of its own first.
+class BarSeries {
+public:
+    BarSeries() = default;
+    explicit BarSeries(const std::string& symbol);
+
+    // Build from rows in time order (oldest first)
+    static BarSeries fromMarketData(const std::string& symbol, const std::vector<MarketData>& rows);
+    // View n bars given as columns; they must outlive every copy of the view
+    static BarSeries view(const std::string& symbol, const double* open, const double* high, const double* low,
+                          const double* close, const double* volume, const int64_t* timestamps_ns, size_t n);
+
+    void reserve(size_t n);
+    void clear();
+
+    void append(double open, double high, double low, double close, double volume, int64_t timestamp_ns);
+    void append(const MarketData& data);
+    // Bulk append of n bars given as columns (file loads, replays)
+    void appendColumns(const double* open, const double* high, const double* low, const double* close,
+                       const double* volume, const int64_t* timestamps_ns, size_t n);
+
+    // Row view, for handing single bars back to row-oriented code
+    MarketData row(size_t i) const;
+
+    const std::string& symbol() const { return symbol_name; }
+    SymbolId symbolId() const { return symbol_id; }
+    size_t size() const { return viewing ? viewed.count : close_col.size(); }
+    bool empty() const { return size() == 0; }
+    bool isView() const { return viewing; }
+
+    const double* open() const { return viewing ? viewed.open : open_col.data(); }
+    const double* high() const { return viewing ? viewed.high : high_col.data(); }
+    const double* low() const { return viewing ? viewed.low : low_col.data(); }
+    const double* close() const { return viewing ? viewed.close : close_col.data(); }
+    const double* volume() const { return viewing ? viewed.volume : volume_col.data(); }
+    const int64_t* timestamps() const { return viewing ? viewed.timestamps : timestamp_col.data(); }
+
+private:
+    struct Columns {
+        const double* open = nullptr;
+        const double* high = nullptr;
+        const double* low = nullptr;
+        const double* close = nullptr;
+        const double* volume = nullptr;
+        const int64_t* timestamps = nullptr;
+        size_t count = 0;
+    };
+
+    // Copy a view into the owned buffers so it can grow
+    void materialize();
+
+    std::string symbol_name;
+    SymbolId symbol_id = kInvalidSymbolId;
+    bool viewing = false;
+    Columns viewed;  // Read instead of the buffers while viewing
+
+    AlignedBuffer<double> open_col;
+    AlignedBuffer<double> high_col;
+    AlignedBuffer<double> low_col;
+    AlignedBuffer<double> close_col;
+    AlignedBuffer<double> volume_col;
+    AlignedBuffer<int64_t> timestamp_col;
+};
+
+} // namespace TradingSystem
+
+#endif // BAR_SERIES_H
@@ -0,0 +1,224 @@
+#include "indicator_engine.h"
+#include <cstring>
+#include <type_traits>
+
+namespace TradingSystem {
+
+namespace {
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// ewm(span=N, adjust=False) smoothing factor
+constexpr double emaAlpha(int span) {
+    return 2.0 / (span + 1.0);
+}
+}
+
+IndicatorEngine::SymbolState& IndicatorEngine::stateFor(SymbolId id) {
+    if (id >= states.size()) {
+        states.resize(id + 1);
+    }
+    return states[id];
+}
+
+void IndicatorEngine::update(const MarketData& data) {
+    SymbolId id = SymbolTable::getInstance().intern(data.symbol);
+    update(id, data.high, data.low, data.close, data.volume);
+}
+
+void IndicatorEngine::update(SymbolId id, double high, double low, double close, double volume) {
+    std::lock_guard<std::mutex> lock(mutex);
+    updateLocked(stateFor(id), high, low, close, volume);
+}
+
+void IndicatorEngine::warmUp(const std::vector<MarketData>& history) {
+    for (const auto& bar : history) {
+        update(bar);
+    }
+}
+
+void IndicatorEngine::warmUp(const BarSeries& series) {
+    if (series.empty()) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    SymbolState& state = stateFor(series.symbolId());
+    const double* high = series.high();
+    const double* low = series.low();
+    const double* close = series.close();
+    const double* volume = series.volume();
+    for (size_t i = 0; i < series.size(); ++i) {
+        updateLocked(state, high[i], low[i], close[i], volume[i]);
+    }
+}
+
+void IndicatorEngine::updateLocked(SymbolState& state, double high, double low,
+                                   double close, double volume) {
+    // Price changes and gains/losses against the previous close. The first
+    // bar has no delta; pandas' where(delta > 0, 0) turns it into 0.
+    double gain = 0.0;
+    double loss = 0.0;
+    if (state.bars > 0) {
+        double delta = close - state.close;
+        gain = delta > 0 ? delta : 0.0;
+        loss = delta < 0 ? -delta : 0.0;
+
+        double change = close / state.close - 1.0;
+        state.last_change = change;
+        if (std::isfinite(change)) {
+            state.changes.push(change);
+        }
+    }
+    state.gains_14.push(gain);
+    state.losses_14.push(loss);
+
+    // EMA recursions seeded with the first value (adjust=False)
+    if (state.bars == 0) {
+        state.ema_12 = close;
+        state.ema_26 = close;
+        state.macd_signal = 0.0;
+    } else {
+        state.ema_12 += emaAlpha(12) * (close - state.ema_12);
+        state.ema_26 += emaAlpha(26) * (close - state.ema_26);
+        state.macd_signal += emaAlpha(9) * ((state.ema_12 - state.ema_26) - state.macd_signal);
+    }
+
+    state.close_5.push(close);
+    state.close_20.push(close);
+    state.volume_20.push(volume);
+
+    state.recent_closes[state.bars % state.recent_closes.size()] = close;
+
+    state.high = high;
+    state.low = low;
+    state.close = close;
+    state.volume = volume;
+    ++state.bars;
+}
+
+void IndicatorEngine::fillSnapshot(const SymbolState& state, IndicatorSnapshot& out) const {
+    out.bars = state.bars;
+    out.close = state.close;
+    out.high = state.high;
+    out.low = state.low;
+    out.volume = state.volume;
+
+    out.sma_5 = state.close_5.full() ? state.close_5.mean() : kNaN;
+    out.sma_20 = state.close_20.full() ? state.close_20.mean() : kNaN;
+    out.ema_12 = state.ema_12;
+    out.ema_26 = state.ema_26;
+    out.macd = state.ema_12 - state.ema_26;
+    out.macd_signal = state.macd_signal;
+
+    // RSI = 100 - 100 / (1 + gain/loss), with pandas' division semantics
+    out.rsi = kNaN;
+    if (state.gains_14.full()) {
+        double avg_gain = state.gains_14.mean();
+        double avg_loss = state.losses_14.mean();
+        if (avg_loss > 0) {
+            out.rsi = 100.0 - 100.0 / (1.0 + avg_gain / avg_loss);
+        } else if (avg_gain > 0) {
+            out.rsi = 100.0;
+        }
+    }
+
+    out.bb_middle = out.sma_20;
+    if (state.close_20.full()) {
+        double std20 = state.close_20.stddev();
+        out.bb_upper = out.bb_middle + 2.0 * std20;
+        out.bb_lower = out.bb_middle - 2.0 * std20;
+    } else {
+        out.bb_upper = kNaN;
+        out.bb_lower = kNaN;
+    }
+
+    out.volume_sma = state.volume_20.full() ? state.volume_20.mean() : kNaN;
+    out.volume_ratio = state.volume / out.volume_sma;
+
+    out.price_change = state.bars > 1 ? state.last_change : kNaN;
+    if (state.bars > 5) {
+        const auto& closes = state.recent_closes;
+        double past = closes[(state.bars - 6) % closes.size()];
+        out.price_change_5d = state.close / past - 1.0;
+    } else {
+        out.price_change_5d = kNaN;
+    }
+
+    out.volatility = state.changes.stddev();
+}
+
+bool IndicatorEngine::snapshot(SymbolId id, IndicatorSnapshot& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (id >= states.size() || states[id].bars == 0) {
+        return false;
+    }
+    fillSnapshot(states[id], out);
+    return true;
+}
+
+bool IndicatorEngine::snapshot(const std::string& symbol, IndicatorSnapshot& out) const {
+    SymbolId id = SymbolTable::getInstance().find(symbol);
+    return id != kInvalidSymbolId && snapshot(id, out);
+}
+
+IndicatorEngine::FeatureVector IndicatorEngine::toFeatures(const IndicatorSnapshot& s) {
+    // NaN comparisons are false, which reproduces the pandas fallbacks
+    FeatureVector f;
+    f[0] = s.sma_20 > 0 ? s.close / s.sma_20 : 1.0;
+    f[1] = s.sma_5 > 0 ? s.close / s.sma_5 : 1.0;
+    f[2] = s.high > s.low ? (s.close - s.low) / (s.high - s.low) : 0.5;
+    f[3] = std::isnan(s.rsi) ? 0.5 : s.rsi / 100.0;
+    f[4] = s.close > 0 ? s.macd / s.close : 0.0;
+    f[5] = s.bb_upper > s.bb_lower ? (s.close - s.bb_lower) / (s.bb_upper - s.bb_lower) : 0.5;
+    f[6] = std::isnan(s.volume_ratio) ? 1.0 : s.volume_ratio;
+    f[7] = std::isnan(s.price_change) ? 0.0 : s.price_change;
+    f[8] = std::isnan(s.price_change_5d) ? 0.0 : s.price_change_5d;
+    f[9] = std::isnan(s.volatility) ? 0.0 : s.volatility;
+    return f;
+}
+
+double IndicatorEngine::suggestedPositionSize(double confidence, double volatility) {
+    double size = 1000.0 * confidence;
+    if (volatility > 0) {
+        size *= std::min(0.02 / volatility, 2.0);
+    }
+    return std::round(size * 100.0) / 100.0;
+}
+
+bool IndicatorEngine::features(SymbolId id, FeatureVector& out) const {
+    IndicatorSnapshot snap;
+    if (!snapshot(id, snap) || snap.bars < kMinBars) {
+        return false;
+    }
+    out = toFeatures(snap);
+    return true;
+}
+
+bool IndicatorEngine::features(const std::string& symbol, FeatureVector& out) const {
+    SymbolId id = SymbolTable::getInstance().find(symbol);
+    return id != kInvalidSymbolId && features(id, out);
+}
+
+size_t IndicatorEngine::barCount(SymbolId id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return id < states.size() ? states[id].bars : 0;
+}
+
+size_t IndicatorEngine::stateSize() {
+    static_assert(std::is_trivially_copyable<SymbolState>::value, "SymbolState is saved as raw bytes");
+    return sizeof(SymbolState);
+}
+
+bool IndicatorEngine::saveState(SymbolId id, void* out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (id >= states.size() || states[id].bars == 0) {
+        return false;
+    }
+    std::memcpy(out, &states[id], sizeof(SymbolState));
+    return true;
+}
+
+void IndicatorEngine::restoreState(SymbolId id, const void* data) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::memcpy(&stateFor(id), data, sizeof(SymbolState));
+}
+
+} // namespace TradingSystem
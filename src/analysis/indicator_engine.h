@@ -0,0 +1,195 @@
+#ifndef INDICATOR_ENGINE_H
+#define INDICATOR_ENGINE_H
+
+#include <array>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "../common/data_types.h"
+#include "../common/symbol_table.h"
+#include "bar_series.h"
+
+namespace TradingSystem {
+
+// Fixed-length rolling window with O(1) mean and sample variance.
+// Variance uses Welford's update extended to a sliding window (add the new
+// value, retire the oldest); the sums are rebuilt from the ring every time
+// it wraps so floating-point drift cannot accumulate. A window of
+// identical values reports that value and a std of 0, as pandas does,
+// rather than the drift left since the last rebuild.
+template <size_t N>
+class RollingWindow {
+public:
+    void push(double value) {
+        double last = values[(head + N - 1) % N];
+        same_run = count > 0 && value == last ? std::min(same_run + 1, N) : 1;
+
+        if (count < N) {
+            values[head] = value;
+            ++count;
+            double delta = value - mean_value;
+            mean_value += delta / static_cast<double>(count);
+            m2 += delta * (value - mean_value);
+        } else {
+            double old = values[head];
+            values[head] = value;
+            double old_mean = mean_value;
+            mean_value += (value - old) / static_cast<double>(N);
+            m2 += (value - old) * (value - mean_value + old - old_mean);
+        }
+
+        head = (head + 1) % N;
+        if (head == 0 && count == N) {
+            resync();
+        }
+    }
+
+    bool full() const { return count == N; }
+    size_t size() const { return count; }
+    double mean() const { return constant() ? values[(head + N - 1) % N] : mean_value; }
+
+    // Sample (ddof=1) standard deviation, matching pandas rolling().std()
+    double stddev() const {
+        if (count < 2) return std::numeric_limits<double>::quiet_NaN();
+        if (constant()) return 0.0;
+        return std::sqrt(std::max(m2, 0.0) / static_cast<double>(count - 1));
+    }
+
+private:
+    std::array<double, N> values{};
+    size_t head = 0;
+    size_t count = 0;
+    double mean_value = 0.0;
+    double m2 = 0.0;
+    size_t same_run = 0;  // trailing values equal to the newest
+
+    bool constant() const { return count > 0 && same_run >= count; }
+
+    void resync() {
+        double sum = 0.0;
+        for (double v : values) sum += v;
+        mean_value = sum / static_cast<double>(N);
+        m2 = 0.0;
+        for (double v : values) m2 += (v - mean_value) * (v - mean_value);
+    }
+};
+
+// Live indicator values for one symbol. Fields that need more history than
+// has been seen are NaN, as they would be in the pandas frame.
+struct IndicatorSnapshot {
+    size_t bars = 0;
+    double close = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double volume = 0.0;
+
+    double sma_5;
+    double sma_20;
+    double ema_12;
+    double ema_26;
+    double macd;
+    double macd_signal;
+    double rsi;
+    double bb_middle;
+    double bb_upper;
+    double bb_lower;
+    double volume_sma;
+    double volume_ratio;
+    double price_change;
+    double price_change_5d;
+    double volatility;  // std of the last kVolatilityWindow price changes
+};
+
+// Incremental replacement for MarketDataAnalyzer.calculate_technical_indicators
+// plus prepare_features. Each bar updates O(1) streaming state per symbol
+// (rolling windows, EMA recursions), so producing the feature vector never
+// touches history.
+class IndicatorEngine {
+public:
+    static constexpr size_t kFeatureCount = 10;
+    static constexpr size_t kMinBars = 30;  // prepare_features' warm-up
+    // prepare_features takes the std of price changes over the analyzer's
+    // 30-day frame: 30 daily bars, so 29 one-bar changes
+    static constexpr size_t kVolatilityWindow = 29;
+    using FeatureVector = std::array<double, kFeatureCount>;
+
+    IndicatorEngine() = default;
+
+    IndicatorEngine(const IndicatorEngine&) = delete;
+    IndicatorEngine& operator=(const IndicatorEngine&) = delete;
+
+    // Feed the next bar for a symbol; bars must arrive in time order
+    void update(const MarketData& data);
+    void update(SymbolId id, double high, double low, double close, double volume);
+
+    // Feed historical bars (oldest first) to warm up a symbol
+    void warmUp(const std::vector<MarketData>& history);
+    void warmUp(const BarSeries& series);
+
+    // Current indicator values; false if the symbol has no bars
+    bool snapshot(SymbolId id, IndicatorSnapshot& out) const;
+    bool snapshot(const std::string& symbol, IndicatorSnapshot& out) const;
+
+    // The 10 features prepare_features builds, in the same order. Returns
+    // false until kMinBars bars have been seen.
+    bool features(SymbolId id, FeatureVector& out) const;
+    bool features(const std::string& symbol, FeatureVector& out) const;
+
+    size_t barCount(SymbolId id) const;
+
+    // Raw per-symbol state for warm restarts (see WarmSnapshot). A blob is
+    // only meaningful to an engine of the same layout; stateSize() changes
+    // with it and is all that is checked.
+    static size_t stateSize();
+    // Copies stateSize() bytes to out; false if the symbol has no bars
+    bool saveState(SymbolId id, void* out) const;
+    void restoreState(SymbolId id, const void* data);
+
+    // Same fallbacks prepare_features applies to missing values
+    static FeatureVector toFeatures(const IndicatorSnapshot& snap);
+
+    // The analyzer's calculate_position_size: 1000 scaled by confidence and
+    // by inverse volatility (capped at 2x), rounded to cents
+    static double suggestedPositionSize(double confidence, double volatility);
+
+private:
+    struct SymbolState {
+        size_t bars = 0;
+        double high = 0.0;
+        double low = 0.0;
+        double close = 0.0;
+        double volume = 0.0;
+
+        RollingWindow<5> close_5;
+        RollingWindow<20> close_20;
+        RollingWindow<20> volume_20;
+        RollingWindow<14> gains_14;
+        RollingWindow<14> losses_14;
+
+        // Last six closes for pct_change(periods=5)
+        std::array<double, 6> recent_closes{};
+
+        double ema_12 = 0.0;
+        double ema_26 = 0.0;
+        double macd_signal = 0.0;
+
+        RollingWindow<kVolatilityWindow> changes;
+        double last_change = 0.0;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<SymbolState> states;  // indexed by SymbolId
+
+    SymbolState& stateFor(SymbolId id);
+    void updateLocked(SymbolState& state, double high, double low, double close, double volume);
+    void fillSnapshot(const SymbolState& state, IndicatorSnapshot& out) const;
+};
+
+} // namespace TradingSystem
+
+#endif // INDICATOR_ENGINE_H
@@ -0,0 +1,231 @@
+#include "mlp_model.h"
+#include "simd_kernels.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TS_MLP_X86 1
+#endif
+
+namespace TradingSystem {
+
+namespace {
+
+constexpr size_t kLanes = 8;  // floats per AVX2 register; outputs are padded to this
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t input_size;
+    uint32_t layer_count;
+};
+
+struct LayerHeader {
+    uint32_t in;
+    uint32_t out;
+    uint32_t activation;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 16, "FileHeader layout");
+static_assert(sizeof(LayerHeader) == 16, "LayerHeader layout");
+
+// One dense layer over rows of a block: out[r] = act(bias + x[r] * W).
+// x has row stride x_stride, out and W have stride out_padded.
+using DenseFn = void (*)(const float* x, size_t x_stride, size_t rows, size_t in,
+                         const float* weights, const float* bias, size_t out_padded,
+                         bool relu, float* out);
+
+void denseScalar(const float* x, size_t x_stride, size_t rows, size_t in,
+                 const float* weights, const float* bias, size_t out_padded,
+                 bool relu, float* out) {
+    for (size_t r = 0; r < rows; ++r) {
+        const float* xr = x + r * x_stride;
+        float* yr = out + r * out_padded;
+        std::memcpy(yr, bias, out_padded * sizeof(float));
+        for (size_t i = 0; i < in; ++i) {
+            float xi = xr[i];
+            const float* wi = weights + i * out_padded;
+            for (size_t o = 0; o < out_padded; ++o) {
+                yr[o] += xi * wi[o];
+            }
+        }
+        if (relu) {
+            for (size_t o = 0; o < out_padded; ++o) {
+                yr[o] = yr[o] > 0.0f ? yr[o] : 0.0f;
+            }
+        }
+    }
+}
+
+#if defined(TS_MLP_X86)
+#define TS_AVX2 __attribute__((target("avx2")))
+
+// kRows rows by 8 outputs accumulated in registers; each weight vector is
+// loaded once per input and reused across the rows
+template <size_t kRows>
+TS_AVX2 inline void denseTileAvx2(const float* x, size_t x_stride, size_t in,
+                                  const float* weights, const float* bias, size_t out_padded,
+                                  bool relu, float* out, size_t o) {
+    __m256 acc[kRows];
+    __m256 b = _mm256_load_ps(bias + o);
+    for (size_t r = 0; r < kRows; ++r) acc[r] = b;
+
+    for (size_t i = 0; i < in; ++i) {
+        __m256 w = _mm256_load_ps(weights + i * out_padded + o);
+        for (size_t r = 0; r < kRows; ++r) {
+            acc[r] = _mm256_add_ps(acc[r], _mm256_mul_ps(_mm256_set1_ps(x[r * x_stride + i]), w));
+        }
+    }
+
+    __m256 zero = _mm256_setzero_ps();
+    for (size_t r = 0; r < kRows; ++r) {
+        __m256 y = relu ? _mm256_max_ps(acc[r], zero) : acc[r];
+        _mm256_store_ps(out + r * out_padded + o, y);
+    }
+}
+
+TS_AVX2 void denseAvx2(const float* x, size_t x_stride, size_t rows, size_t in,
+                       const float* weights, const float* bias, size_t out_padded,
+                       bool relu, float* out) {
+    size_t r = 0;
+    for (; r + 4 <= rows; r += 4) {
+        for (size_t o = 0; o < out_padded; o += kLanes) {
+            denseTileAvx2<4>(x + r * x_stride, x_stride, in, weights, bias, out_padded,
+                             relu, out + r * out_padded, o);
+        }
+    }
+    for (; r < rows; ++r) {
+        for (size_t o = 0; o < out_padded; o += kLanes) {
+            denseTileAvx2<1>(x + r * x_stride, x_stride, in, weights, bias, out_padded,
+                             relu, out + r * out_padded, o);
+        }
+    }
+}
+#endif
+
+DenseFn denseKernel() {
+#if defined(TS_MLP_X86)
+    if (activeKernelSet() == KernelSet::AVX2) return denseAvx2;
+#endif
+    return denseScalar;
+}
+
+// Ping-pong activation blocks, per thread so concurrent scorers do not
+// share them and repeated calls do not reach the allocator
+AlignedBuffer<float>& activations(size_t slot, size_t n) {
+    thread_local AlignedBuffer<float> buffers[2];
+    if (buffers[slot].size() < n) buffers[slot].resize(n);
+    return buffers[slot];
+}
+
+} // namespace
+
+bool MlpModel::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open model " << path << std::endl;
+        return false;
+    }
+
+    FileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != kFileMagic || header.version != kFileVersion) {
+        std::cerr << path << ": not a version " << kFileVersion << " model file" << std::endl;
+        return false;
+    }
+
+    std::vector<Layer> loaded;
+    size_t expected_in = header.input_size;
+    size_t widest = 0;
+    std::vector<float> row_major;
+
+    for (uint32_t l = 0; l < header.layer_count; ++l) {
+        LayerHeader layer_header;
+        if (!file.read(reinterpret_cast<char*>(&layer_header), sizeof(layer_header))) {
+            std::cerr << path << ": truncated at layer " << l << std::endl;
+            return false;
+        }
+        if (layer_header.in != expected_in || layer_header.out == 0) {
+            std::cerr << path << ": layer " << l << " is " << layer_header.in << "x" << layer_header.out
+                      << ", expected " << expected_in << " inputs" << std::endl;
+            return false;
+        }
+
+        Layer layer;
+        layer.in = layer_header.in;
+        layer.out = layer_header.out;
+        layer.out_padded = (layer.out + kLanes - 1) / kLanes * kLanes;
+        layer.relu = layer_header.activation == 1;
+
+        row_major.resize(layer.out * layer.in);
+        layer.bias.resize(layer.out_padded);
+        std::fill(layer.bias.data(), layer.bias.data() + layer.out_padded, 0.0f);
+        if (!file.read(reinterpret_cast<char*>(row_major.data()),
+                       static_cast<std::streamsize>(row_major.size() * sizeof(float))) ||
+            !file.read(reinterpret_cast<char*>(layer.bias.data()),
+                       static_cast<std::streamsize>(layer.out * sizeof(float)))) {
+            std::cerr << path << ": truncated at layer " << l << std::endl;
+            return false;
+        }
+
+        // Transpose to input-major; padded outputs have zero weights and
+        // bias, so they stay zero through ReLU and never reach a real output
+        layer.weights.resize(layer.in * layer.out_padded);
+        std::fill(layer.weights.data(), layer.weights.data() + layer.weights.size(), 0.0f);
+        for (size_t o = 0; o < layer.out; ++o) {
+            for (size_t i = 0; i < layer.in; ++i) {
+                layer.weights[i * layer.out_padded + o] = row_major[o * layer.in + i];
+            }
+        }
+
+        expected_in = layer.out;
+        widest = std::max(widest, layer.out_padded);
+        loaded.push_back(std::move(layer));
+    }
+
+    if (loaded.empty() || loaded.back().out != 1) {
+        std::cerr << path << ": model must end in a single score output" << std::endl;
+        return false;
+    }
+
+    input_size = header.input_size;
+    max_width = widest;
+    layers = std::move(loaded);
+    return true;
+}
+
+void MlpModel::score(const float* features, size_t rows, float* scores) const {
+    if (layers.empty()) {
+        std::fill(scores, scores + rows, 0.0f);
+        return;
+    }
+
+    DenseFn dense = denseKernel();
+    float* ping = activations(0, kRowBlock * max_width).data();
+    float* pong = activations(1, kRowBlock * max_width).data();
+
+    for (size_t begin = 0; begin < rows; begin += kRowBlock) {
+        size_t block = std::min(kRowBlock, rows - begin);
+
+        const float* x = features + begin * input_size;
+        size_t x_stride = input_size;
+        float* y = ping;
+        for (const Layer& layer : layers) {
+            dense(x, x_stride, block, layer.in, layer.weights.data(), layer.bias.data(),
+                  layer.out_padded, layer.relu, y);
+            x = y;
+            x_stride = layer.out_padded;
+            y = (y == ping) ? pong : ping;
+        }
+
+        for (size_t r = 0; r < block; ++r) {
+            scores[begin + r] = x[r * x_stride];
+        }
+    }
+}
+
+} // namespace TradingSystem
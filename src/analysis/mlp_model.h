@@ -0,0 +1,65 @@
+#ifndef MLP_MODEL_H
+#define MLP_MODEL_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "bar_series.h"
+
+namespace TradingSystem {
+
+// Forward pass of a StockRankingNN exported by StockRanker.export_weights.
+// The exporter folds the input StandardScaler into the first layer and
+// each eval-mode BatchNorm into the layer after it (dropout is a no-op at
+// inference), so the file is a plain chain of dense layers with ReLU
+// between them.
+//
+// Weights are kept transposed (input-major, outputs padded to 8 floats)
+// so one input value times one contiguous weight row updates a run of
+// outputs. score() walks the batch in blocks of kRowBlock rows, running
+// every layer on a block before the next so the activations stay in L1.
+// Within a block the AVX2 kernel holds a 4-row by 8-output tile in
+// registers; it is used when activeKernelSet() is AVX2, otherwise a scalar
+// loop the compiler can vectorize.
+//
+// File layout (little-endian):
+//   header   : magic u32, version u32, input_size u32, layer_count u32
+//   per layer: in u32, out u32, activation u32 (0 none, 1 relu), reserved u32
+//              weights f32[out * in] (row-major, PyTorch layout), bias f32[out]
+class MlpModel {
+public:
+    static constexpr uint32_t kFileMagic = 0x504C4D54;  // "TMLP"
+    static constexpr uint32_t kFileVersion = 1;
+    static constexpr size_t kRowBlock = 64;
+
+    MlpModel() = default;
+
+    bool load(const std::string& path);
+
+    bool empty() const { return layers.empty(); }
+    size_t inputSize() const { return input_size; }
+    size_t layerCount() const { return layers.size(); }
+
+    // features: rows x inputSize(), row-major. Writes one score per row;
+    // higher ranks better.
+    void score(const float* features, size_t rows, float* scores) const;
+
+private:
+    struct Layer {
+        size_t in = 0;
+        size_t out = 0;
+        size_t out_padded = 0;
+        bool relu = false;
+        AlignedBuffer<float> weights;  // in x out_padded
+        AlignedBuffer<float> bias;     // out_padded
+    };
+
+    size_t input_size = 0;
+    size_t max_width = 0;  // widest padded layer output
+    std::vector<Layer> layers;
+};
+
+} // namespace TradingSystem
+
+#endif // MLP_MODEL_H
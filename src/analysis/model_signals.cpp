@@ -0,0 +1,75 @@
+#include "model_signals.h"
+#include <algorithm>
+#include <cmath>
+
+namespace TradingSystem {
+
+ModelSignalGenerator::ModelSignalGenerator(std::shared_ptr<const MlpModel> model, double signal_fraction)
+    : model(std::move(model)), signal_fraction(signal_fraction) {
+}
+
+std::vector<TradingSignal> ModelSignalGenerator::generate(const IndicatorEngine& indicators,
+                                                          const std::vector<std::string>& symbols,
+                                                          std::vector<std::string>& cold_symbols) {
+    std::vector<TradingSignal> signals;
+    if (!model || model->inputSize() != IndicatorEngine::kFeatureCount) {
+        cold_symbols.insert(cold_symbols.end(), symbols.begin(), symbols.end());
+        return signals;
+    }
+
+    feature_rows.clear();
+    ready_symbols.clear();
+    volatilities.clear();
+
+    IndicatorEngine::FeatureVector features;
+    for (const auto& symbol : symbols) {
+        if (!indicators.features(symbol, features)) {
+            cold_symbols.push_back(symbol);
+            continue;
+        }
+        feature_rows.insert(feature_rows.end(), features.begin(), features.end());
+        ready_symbols.push_back(&symbol);
+        volatilities.push_back(features[9]);
+    }
+
+    size_t n = ready_symbols.size();
+    if (n < 2) {
+        return signals;  // Nothing to rank against
+    }
+
+    scores.resize(n);
+    model->score(feature_rows.data(), n, scores.data());
+
+    ranked.resize(n);
+    for (size_t i = 0; i < n; ++i) ranked[i] = i;
+    std::sort(ranked.begin(), ranked.end(), [this](size_t a, size_t b) { return scores[a] > scores[b]; });
+
+    size_t per_side = static_cast<size_t>(static_cast<double>(n) * signal_fraction);
+    per_side = std::min(std::max<size_t>(per_side, 1), n / 2);
+
+    auto now = std::chrono::system_clock::now();
+    double half = static_cast<double>(n - 1) / 2.0;
+    for (size_t rank = 0; rank < n; ++rank) {
+        SignalAction action;
+        if (rank < per_side) {
+            action = SignalAction::BUY;
+        } else if (rank >= n - per_side) {
+            action = SignalAction::SELL;
+        } else {
+            continue;
+        }
+
+        size_t i = ranked[rank];
+        TradingSignal signal;
+        signal.symbol = *ready_symbols[i];
+        signal.symbol_id = SymbolTable::getInstance().find(signal.symbol);
+        signal.action = action;
+        signal.confidence = 0.5 + 0.45 * std::fabs(static_cast<double>(rank) - half) / half;
+        signal.suggested_position_size = IndicatorEngine::suggestedPositionSize(signal.confidence, volatilities[i]);
+        signal.timestamp = now;
+        signals.push_back(std::move(signal));
+    }
+    return signals;
+}
+
+} // namespace TradingSystem
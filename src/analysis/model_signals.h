@@ -0,0 +1,44 @@
+#ifndef MODEL_SIGNALS_H
+#define MODEL_SIGNALS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "mlp_model.h"
+#include "indicator_engine.h"
+#include "../common/data_types.h"
+
+namespace TradingSystem {
+
+// In-process counterpart of the batch_analyze round trip for warmed-up
+// symbols: their IndicatorEngine features are scored as one batch by an
+// exported StockRankingNN and turned into signals by rank. The top
+// signal_fraction of the ranked symbols get BUY and the bottom fraction
+// SELL (at least one each once two symbols are ranked). Confidence grows
+// from 0.5 at the median rank to 0.95 at either end, and sizes follow
+// the analyzer's calculate_position_size.
+class ModelSignalGenerator {
+public:
+    explicit ModelSignalGenerator(std::shared_ptr<const MlpModel> model, double signal_fraction = 0.2);
+
+    // Symbols with fewer than IndicatorEngine::kMinBars bars are appended
+    // to cold_symbols for the Python analyzer to handle
+    std::vector<TradingSignal> generate(const IndicatorEngine& indicators,
+                                        const std::vector<std::string>& symbols,
+                                        std::vector<std::string>& cold_symbols);
+
+private:
+    std::shared_ptr<const MlpModel> model;
+    double signal_fraction;
+
+    // Reused between cycles
+    std::vector<float> feature_rows;
+    std::vector<float> scores;
+    std::vector<size_t> ranked;
+    std::vector<const std::string*> ready_symbols;
+    std::vector<double> volatilities;
+};
+
+} // namespace TradingSystem
+
+#endif // MODEL_SIGNALS_H
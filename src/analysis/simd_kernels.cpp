@@ -0,0 +1,535 @@
+#include "simd_kernels.h"
+#include <cmath>
+#include <limits>
+#include <atomic>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TS_KERNELS_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define TS_KERNELS_NEON 1
+#endif
+
+namespace TradingSystem {
+
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// The kernels are built from a handful of primitives. Rolling statistics
+// come from running sums over windows ending at each index. The sums are
+// restarted every kBlock windows, centred on the first value of the
+// block, so neither drift nor the offset of the price level can eat into
+// the precision of the variance.
+constexpr size_t kBlock = 512;
+
+using RollingMomentsFn = void (*)(const double* x, size_t n, size_t w, double* mean, double* stdev);
+using PctChangeFn = void (*)(const double* x, size_t n, size_t periods, double* out);
+using GainsLossesFn = void (*)(const double* x, size_t n, double* gains, double* losses);
+using RsiFromMeansFn = void (*)(const double* g, const double* l, size_t begin, size_t n, double* out);
+
+struct KernelOps {
+    KernelSet set;
+    RollingMomentsFn rolling_moments;
+    PctChangeFn pct_change;
+    GainsLossesFn gains_losses;
+    RsiFromMeansFn rsi_from_means;
+};
+
+// ---------------------------------------------------------------------------
+// Scalar reference implementations
+
+inline double stdFromSums(double s1, double s2, double wd) {
+    double var = (s2 - s1 * s1 / wd) / (wd - 1.0);
+    return std::sqrt(var > 0 ? var : 0.0);
+}
+
+// Windows o in [first, last), window o covers x[o .. o+w-1] and its
+// result is stored at index o+w-1
+template <bool kWithStd>
+void rollingMomentsRange(const double* x, size_t w, size_t first, size_t last,
+                         double* mean, double* stdev) {
+    double wd = static_cast<double>(w);
+    double inv_w = 1.0 / wd;
+    for (size_t block = first; block < last; block += kBlock) {
+        size_t block_end = std::min(block + kBlock, last);
+        double ref = x[block];
+        double s1 = 0.0;
+        double s2 = 0.0;
+        for (size_t i = block; i < block + w; ++i) {
+            double v = x[i] - ref;
+            s1 += v;
+            s2 += v * v;
+        }
+        for (size_t o = block; o < block_end; ++o) {
+            if (o > block) {
+                double add = x[o + w - 1] - ref;
+                double rem = x[o - 1] - ref;
+                s1 += add - rem;
+                if (kWithStd) s2 += add * add - rem * rem;
+            }
+            mean[o + w - 1] = ref + s1 * inv_w;
+            if (kWithStd) stdev[o + w - 1] = stdFromSums(s1, s2, wd);
+        }
+    }
+}
+
+void rollingMomentsScalar(const double* x, size_t n, size_t w, double* mean, double* stdev) {
+    if (stdev) {
+        rollingMomentsRange<true>(x, w, 0, n - w + 1, mean, stdev);
+    } else {
+        rollingMomentsRange<false>(x, w, 0, n - w + 1, mean, nullptr);
+    }
+}
+
+void pctChangeScalar(const double* x, size_t n, size_t periods, double* out) {
+    for (size_t i = periods; i < n; ++i) {
+        out[i] = x[i] / x[i - periods] - 1.0;
+    }
+}
+
+void gainsLossesScalar(const double* x, size_t n, double* gains, double* losses) {
+    for (size_t i = 1; i < n; ++i) {
+        double d = x[i] - x[i - 1];
+        gains[i] = d > 0 ? d : 0.0;
+        losses[i] = -d > 0 ? -d : 0.0;
+    }
+}
+
+void rsiFromMeansScalar(const double* g, const double* l, size_t begin, size_t n, double* out) {
+    for (size_t i = begin; i < n; ++i) {
+        if (l[i] > 0) {
+            out[i] = 100.0 * g[i] / (g[i] + l[i]);
+        } else {
+            out[i] = g[i] > 0 ? 100.0 : kNaN;
+        }
+    }
+}
+
+const KernelOps kScalarOps = {
+    KernelSet::SCALAR, rollingMomentsScalar, pctChangeScalar, gainsLossesScalar, rsiFromMeansScalar
+};
+
+// ---------------------------------------------------------------------------
+// AVX2 (compiled with a target attribute, selected only if the CPU has it)
+
+#if defined(TS_KERNELS_X86)
+#define TS_AVX2 __attribute__((target("avx2")))
+
+TS_AVX2 inline void transpose4(__m256d& r0, __m256d& r1, __m256d& r2, __m256d& r3) {
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+    __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+    __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+    r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+    r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+    r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+    r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+// One step of four running window sums, plus the finished mean (and std)
+template <bool kWithStd>
+TS_AVX2 inline void slideStep(__m256d& sum, __m256d& sumsq, __m256d add, __m256d rem,
+                              __m256d ref, __m256d inv_w, __m256d wd, __m256d wm1,
+                              __m256d& mean, __m256d& stdev) {
+    __m256d a = _mm256_sub_pd(add, ref);
+    __m256d r = _mm256_sub_pd(rem, ref);
+    sum = _mm256_add_pd(sum, _mm256_sub_pd(a, r));
+    mean = _mm256_add_pd(ref, _mm256_mul_pd(sum, inv_w));
+    if (kWithStd) {
+        sumsq = _mm256_add_pd(sumsq, _mm256_sub_pd(_mm256_mul_pd(a, a), _mm256_mul_pd(r, r)));
+        __m256d var = _mm256_div_pd(_mm256_sub_pd(sumsq, _mm256_div_pd(_mm256_mul_pd(sum, sum), wd)), wm1);
+        stdev = _mm256_sqrt_pd(_mm256_max_pd(var, _mm256_setzero_pd()));
+    } else {
+        stdev = mean;
+    }
+}
+
+// A running sum is one long dependency chain, so four consecutive blocks
+// run side by side, one per vector lane, each with its own reference.
+// 4x4 transposes turn four per-block loads into one column per step and
+// back again for the stores; the mean and std are finished in registers.
+template <bool kWithStd>
+TS_AVX2 void rollingMomentsAvx2Impl(const double* x, size_t n, size_t w, double* mean, double* stdev) {
+    size_t windows = n - w + 1;
+    size_t chunks = windows / (4 * kBlock);
+
+    __m256d wd = _mm256_set1_pd(static_cast<double>(w));
+    __m256d inv_w = _mm256_set1_pd(1.0 / static_cast<double>(w));
+    __m256d wm1 = _mm256_set1_pd(static_cast<double>(w) - 1.0);
+
+    for (size_t c = 0; c < chunks; ++c) {
+        size_t base = c * 4 * kBlock;
+        alignas(32) double refs[4];
+        alignas(32) double acc1[4];
+        alignas(32) double acc2[4];
+        for (size_t k = 0; k < 4; ++k) {
+            const double* start = x + base + k * kBlock;
+            refs[k] = start[0];
+            double s1 = 0.0;
+            double s2 = 0.0;
+            for (size_t i = 0; i < w; ++i) {
+                double v = start[i] - refs[k];
+                s1 += v;
+                s2 += v * v;
+            }
+            acc1[k] = s1;
+            acc2[k] = s2;
+        }
+
+        __m256d vref = _mm256_load_pd(refs);
+        __m256d sum = _mm256_load_pd(acc1);
+        __m256d sumsq = _mm256_load_pd(acc2);
+
+        // Step j moves every lane from window (start + j - 1) to (start + j)
+        for (size_t j = 0; j < kBlock; j += 4) {
+            const double* lane0 = x + base + j;
+            __m256d a0 = _mm256_loadu_pd(lane0 + w - 1);
+            __m256d a1 = _mm256_loadu_pd(lane0 + kBlock + w - 1);
+            __m256d a2 = _mm256_loadu_pd(lane0 + 2 * kBlock + w - 1);
+            __m256d a3 = _mm256_loadu_pd(lane0 + 3 * kBlock + w - 1);
+            __m256d r0, r1, r2, r3;
+            if (j == 0) {
+                // x[start - 1] may not exist; step 0 retires nothing anyway
+                r0 = _mm256_set_pd(lane0[2], lane0[1], lane0[0], 0.0);
+                r1 = _mm256_set_pd(lane0[kBlock + 2], lane0[kBlock + 1], lane0[kBlock], 0.0);
+                r2 = _mm256_set_pd(lane0[2 * kBlock + 2], lane0[2 * kBlock + 1], lane0[2 * kBlock], 0.0);
+                r3 = _mm256_set_pd(lane0[3 * kBlock + 2], lane0[3 * kBlock + 1], lane0[3 * kBlock], 0.0);
+            } else {
+                r0 = _mm256_loadu_pd(lane0 - 1);
+                r1 = _mm256_loadu_pd(lane0 + kBlock - 1);
+                r2 = _mm256_loadu_pd(lane0 + 2 * kBlock - 1);
+                r3 = _mm256_loadu_pd(lane0 + 3 * kBlock - 1);
+            }
+            transpose4(a0, a1, a2, a3);
+            transpose4(r0, r1, r2, r3);
+            if (j == 0) {
+                // Emit the initial sums unchanged
+                a0 = vref;
+                r0 = vref;
+            }
+
+            __m256d m0, m1, m2, m3, d0, d1, d2, d3;
+            slideStep<kWithStd>(sum, sumsq, a0, r0, vref, inv_w, wd, wm1, m0, d0);
+            slideStep<kWithStd>(sum, sumsq, a1, r1, vref, inv_w, wd, wm1, m1, d1);
+            slideStep<kWithStd>(sum, sumsq, a2, r2, vref, inv_w, wd, wm1, m2, d2);
+            slideStep<kWithStd>(sum, sumsq, a3, r3, vref, inv_w, wd, wm1, m3, d3);
+
+            double* mean_out = mean + base + j + w - 1;
+            transpose4(m0, m1, m2, m3);
+            _mm256_storeu_pd(mean_out, m0);
+            _mm256_storeu_pd(mean_out + kBlock, m1);
+            _mm256_storeu_pd(mean_out + 2 * kBlock, m2);
+            _mm256_storeu_pd(mean_out + 3 * kBlock, m3);
+            if (kWithStd) {
+                double* std_out = stdev + base + j + w - 1;
+                transpose4(d0, d1, d2, d3);
+                _mm256_storeu_pd(std_out, d0);
+                _mm256_storeu_pd(std_out + kBlock, d1);
+                _mm256_storeu_pd(std_out + 2 * kBlock, d2);
+                _mm256_storeu_pd(std_out + 3 * kBlock, d3);
+            }
+        }
+    }
+
+    rollingMomentsRange<kWithStd>(x, w, chunks * 4 * kBlock, windows, mean, stdev);
+}
+
+TS_AVX2 void rollingMomentsAvx2(const double* x, size_t n, size_t w, double* mean, double* stdev) {
+    if (stdev) {
+        rollingMomentsAvx2Impl<true>(x, n, w, mean, stdev);
+    } else {
+        rollingMomentsAvx2Impl<false>(x, n, w, mean, nullptr);
+    }
+}
+
+TS_AVX2 void pctChangeAvx2(const double* x, size_t n, size_t periods, double* out) {
+    __m256d one = _mm256_set1_pd(1.0);
+    size_t i = periods;
+    for (; i + 4 <= n; i += 4) {
+        __m256d cur = _mm256_loadu_pd(x + i);
+        __m256d past = _mm256_loadu_pd(x + i - periods);
+        _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_div_pd(cur, past), one));
+    }
+    for (; i < n; ++i) {
+        out[i] = x[i] / x[i - periods] - 1.0;
+    }
+}
+
+TS_AVX2 void gainsLossesAvx2(const double* x, size_t n, double* gains, double* losses) {
+    // maxpd returns its second operand for NaN, so NaN deltas become 0
+    // exactly like the scalar comparisons
+    __m256d zero = _mm256_setzero_pd();
+    size_t i = 1;
+    for (; i + 4 <= n; i += 4) {
+        __m256d d = _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(x + i - 1));
+        _mm256_storeu_pd(gains + i, _mm256_max_pd(d, zero));
+        _mm256_storeu_pd(losses + i, _mm256_max_pd(_mm256_sub_pd(zero, d), zero));
+    }
+    gainsLossesScalar(x + i - 1, n - i + 1, gains + i - 1, losses + i - 1);
+}
+
+TS_AVX2 void rsiFromMeansAvx2(const double* g, const double* l, size_t begin, size_t n, double* out) {
+    __m256d zero = _mm256_setzero_pd();
+    __m256d hundred = _mm256_set1_pd(100.0);
+    __m256d nan = _mm256_set1_pd(kNaN);
+    size_t i = begin;
+    for (; i + 4 <= n; i += 4) {
+        __m256d vg = _mm256_loadu_pd(g + i);
+        __m256d vl = _mm256_loadu_pd(l + i);
+        __m256d rsi = _mm256_div_pd(_mm256_mul_pd(hundred, vg), _mm256_add_pd(vg, vl));
+        __m256d flat = _mm256_blendv_pd(nan, hundred, _mm256_cmp_pd(vg, zero, _CMP_GT_OQ));
+        _mm256_storeu_pd(out + i, _mm256_blendv_pd(flat, rsi, _mm256_cmp_pd(vl, zero, _CMP_GT_OQ)));
+    }
+    rsiFromMeansScalar(g, l, i, n, out);
+}
+
+const KernelOps kAvx2Ops = {
+    KernelSet::AVX2, rollingMomentsAvx2, pctChangeAvx2, gainsLossesAvx2, rsiFromMeansAvx2
+};
+#endif
+
+// ---------------------------------------------------------------------------
+// NEON (baseline on AArch64). Two-lane doubles do not pay for running the
+// blocked sums side by side, so rolling moments stay scalar.
+
+#if defined(TS_KERNELS_NEON)
+void pctChangeNeon(const double* x, size_t n, size_t periods, double* out) {
+    float64x2_t one = vdupq_n_f64(1.0);
+    size_t i = periods;
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t ratio = vdivq_f64(vld1q_f64(x + i), vld1q_f64(x + i - periods));
+        vst1q_f64(out + i, vsubq_f64(ratio, one));
+    }
+    for (; i < n; ++i) {
+        out[i] = x[i] / x[i - periods] - 1.0;
+    }
+}
+
+void gainsLossesNeon(const double* x, size_t n, double* gains, double* losses) {
+    // vmaxnm returns the number when one side is NaN, matching the scalar path
+    float64x2_t zero = vdupq_n_f64(0.0);
+    size_t i = 1;
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t d = vsubq_f64(vld1q_f64(x + i), vld1q_f64(x + i - 1));
+        vst1q_f64(gains + i, vmaxnmq_f64(d, zero));
+        vst1q_f64(losses + i, vmaxnmq_f64(vnegq_f64(d), zero));
+    }
+    gainsLossesScalar(x + i - 1, n - i + 1, gains + i - 1, losses + i - 1);
+}
+
+void rsiFromMeansNeon(const double* g, const double* l, size_t begin, size_t n, double* out) {
+    float64x2_t zero = vdupq_n_f64(0.0);
+    float64x2_t hundred = vdupq_n_f64(100.0);
+    float64x2_t nan = vdupq_n_f64(kNaN);
+    size_t i = begin;
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t vg = vld1q_f64(g + i);
+        float64x2_t vl = vld1q_f64(l + i);
+        float64x2_t rsi = vdivq_f64(vmulq_f64(hundred, vg), vaddq_f64(vg, vl));
+        float64x2_t flat = vbslq_f64(vcgtq_f64(vg, zero), hundred, nan);
+        vst1q_f64(out + i, vbslq_f64(vcgtq_f64(vl, zero), rsi, flat));
+    }
+    rsiFromMeansScalar(g, l, i, n, out);
+}
+
+const KernelOps kNeonOps = {
+    KernelSet::NEON, rollingMomentsScalar, pctChangeNeon, gainsLossesNeon, rsiFromMeansNeon
+};
+#endif
+
+// ---------------------------------------------------------------------------
+// Dispatch
+
+bool cpuSupports(KernelSet set) {
+    switch (set) {
+        case KernelSet::SCALAR:
+            return true;
+        case KernelSet::AVX2:
+#if defined(TS_KERNELS_X86)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+        case KernelSet::NEON:
+#if defined(TS_KERNELS_NEON)
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+const KernelOps* opsFor(KernelSet set) {
+    switch (set) {
+#if defined(TS_KERNELS_X86)
+        case KernelSet::AVX2: return &kAvx2Ops;
+#endif
+#if defined(TS_KERNELS_NEON)
+        case KernelSet::NEON: return &kNeonOps;
+#endif
+        default: return &kScalarOps;
+    }
+}
+
+const KernelOps* detectOps() {
+    if (cpuSupports(KernelSet::AVX2)) return opsFor(KernelSet::AVX2);
+    if (cpuSupports(KernelSet::NEON)) return opsFor(KernelSet::NEON);
+    return &kScalarOps;
+}
+
+std::atomic<const KernelOps*>& activeOps() {
+    static std::atomic<const KernelOps*> ops(detectOps());
+    return ops;
+}
+
+const KernelOps& ops() {
+    return *activeOps().load(std::memory_order_relaxed);
+}
+
+// Per-thread scratch columns so repeated kernel calls do not hit the
+// allocator (and fresh pages) every time
+AlignedBuffer<double>& scratch(size_t slot, size_t n) {
+    thread_local AlignedBuffer<double> buffers[4];
+    buffers[slot].resize(n);
+    return buffers[slot];
+}
+
+void fillNaN(double* out, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        out[i] = kNaN;
+    }
+}
+
+// Like pandas, a window of identical values has exactly that mean and a
+// std of 0. The running sums leave rounding noise there instead, which
+// turns a flat RSI window from NaN into 100 and a flat Bollinger band
+// into a width of about sqrt(eps) times the price.
+void pinConstantWindows(const double* x, size_t n, size_t w, double* mean, double* stdev) {
+    size_t run = 1;
+    for (size_t i = 1; i < n; ++i) {
+        run = x[i] == x[i - 1] ? run + 1 : 1;
+        if (run >= w) {
+            mean[i] = x[i];
+            if (stdev) stdev[i] = 0.0;
+        }
+    }
+}
+
+} // namespace
+
+KernelSet activeKernelSet() {
+    return ops().set;
+}
+
+const char* kernelSetName(KernelSet set) {
+    switch (set) {
+        case KernelSet::SCALAR: return "scalar";
+        case KernelSet::AVX2: return "avx2";
+        case KernelSet::NEON: return "neon";
+    }
+    return "unknown";
+}
+
+bool forceKernelSet(KernelSet set) {
+    if (!cpuSupports(set)) {
+        return false;
+    }
+    activeOps().store(opsFor(set), std::memory_order_relaxed);
+    return true;
+}
+
+void rollingMean(const double* x, size_t n, size_t window, double* out) {
+    if (window == 0 || n < window) {
+        fillNaN(out, 0, n);
+        return;
+    }
+    fillNaN(out, 0, window - 1);
+    ops().rolling_moments(x, n, window, out, nullptr);
+    pinConstantWindows(x, n, window, out, nullptr);
+}
+
+void rollingStd(const double* x, size_t n, size_t window, double* out) {
+    if (window < 2 || n < window) {
+        fillNaN(out, 0, n);
+        return;
+    }
+    AlignedBuffer<double>& mean = scratch(0, n);
+    fillNaN(out, 0, window - 1);
+    ops().rolling_moments(x, n, window, mean.data(), out);
+    pinConstantWindows(x, n, window, mean.data(), out);
+}
+
+void ema(const double* x, size_t n, int span, double* out) {
+    if (n == 0) return;
+    double alpha = 2.0 / (span + 1.0);
+    double value = x[0];
+    out[0] = value;
+    for (size_t i = 1; i < n; ++i) {
+        value += alpha * (x[i] - value);
+        out[i] = value;
+    }
+}
+
+void pctChange(const double* x, size_t n, size_t periods, double* out) {
+    size_t head = periods < n ? periods : n;
+    fillNaN(out, 0, head);
+    if (periods == 0 || periods >= n) return;
+    ops().pct_change(x, n, periods, out);
+}
+
+void rsi(const double* close, size_t n, size_t period, double* out) {
+    if (period == 0 || n < period) {
+        fillNaN(out, 0, n);
+        return;
+    }
+
+    // First delta is NaN in pandas and where(delta > 0, 0) maps it to 0
+    AlignedBuffer<double>& gains = scratch(0, n);
+    AlignedBuffer<double>& losses = scratch(1, n);
+    gains[0] = 0.0;
+    losses[0] = 0.0;
+    ops().gains_losses(close, n, gains.data(), losses.data());
+
+    AlignedBuffer<double>& avg_gain = scratch(2, n);
+    AlignedBuffer<double>& avg_loss = scratch(3, n);
+    ops().rolling_moments(gains.data(), n, period, avg_gain.data(), nullptr);
+    ops().rolling_moments(losses.data(), n, period, avg_loss.data(), nullptr);
+    pinConstantWindows(gains.data(), n, period, avg_gain.data(), nullptr);
+    pinConstantWindows(losses.data(), n, period, avg_loss.data(), nullptr);
+
+    fillNaN(out, 0, period - 1);
+    ops().rsi_from_means(avg_gain.data(), avg_loss.data(), period - 1, n, out);
+}
+
+void computeIndicators(const BarSeries& series, IndicatorColumns& out) {
+    size_t n = series.size();
+    const double* close = series.close();
+
+    for (auto* col : {&out.sma_5, &out.sma_20, &out.std_20, &out.ema_12, &out.ema_26, &out.macd,
+                      &out.macd_signal, &out.rsi_14, &out.volume_sma_20, &out.price_change,
+                      &out.price_change_5d}) {
+        col->resize(n);
+    }
+    if (n == 0) return;
+
+    rollingMean(close, n, 5, out.sma_5.data());
+    rollingMean(close, n, 20, out.sma_20.data());
+    rollingStd(close, n, 20, out.std_20.data());
+    ema(close, n, 12, out.ema_12.data());
+    ema(close, n, 26, out.ema_26.data());
+    for (size_t i = 0; i < n; ++i) {
+        out.macd[i] = out.ema_12[i] - out.ema_26[i];
+    }
+    ema(out.macd.data(), n, 9, out.macd_signal.data());
+    rsi(close, n, 14, out.rsi_14.data());
+    rollingMean(series.volume(), n, 20, out.volume_sma_20.data());
+    pctChange(close, n, 1, out.price_change.data());
+    pctChange(close, n, 5, out.price_change_5d.data());
+}
+
+} // namespace TradingSystem
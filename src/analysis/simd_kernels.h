@@ -0,0 +1,60 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstddef>
+#include "bar_series.h"
+
+namespace TradingSystem {
+
+// Vectorized batch indicator kernels over contiguous double columns.
+// Each kernel writes n outputs; positions without enough history are NaN,
+// matching pandas. The implementation is picked once at startup: AVX2 on
+// x86-64 CPUs that support it, NEON on AArch64, scalar otherwise.
+enum class KernelSet {
+    SCALAR,
+    AVX2,
+    NEON
+};
+
+KernelSet activeKernelSet();
+const char* kernelSetName(KernelSet set);
+
+// Override the runtime choice (benchmarks, A/B checks). Returns false and
+// leaves the selection unchanged if the CPU cannot run the requested set.
+bool forceKernelSet(KernelSet set);
+
+// rolling(window).mean() / rolling(window).std() (ddof=1)
+void rollingMean(const double* x, size_t n, size_t window, double* out);
+void rollingStd(const double* x, size_t n, size_t window, double* out);
+
+// ewm(span, adjust=False).mean(). The recursion is inherently serial, so
+// every kernel set shares the scalar loop.
+void ema(const double* x, size_t n, int span, double* out);
+
+// pct_change(periods)
+void pctChange(const double* x, size_t n, size_t periods, double* out);
+
+// The analyzer's RSI: simple rolling means of gains and losses over period
+void rsi(const double* close, size_t n, size_t period, double* out);
+
+// Full indicator columns for a series, the batch counterpart of
+// IndicatorEngine for backtests and re-warming
+struct IndicatorColumns {
+    AlignedBuffer<double> sma_5;
+    AlignedBuffer<double> sma_20;
+    AlignedBuffer<double> std_20;
+    AlignedBuffer<double> ema_12;
+    AlignedBuffer<double> ema_26;
+    AlignedBuffer<double> macd;
+    AlignedBuffer<double> macd_signal;
+    AlignedBuffer<double> rsi_14;
+    AlignedBuffer<double> volume_sma_20;
+    AlignedBuffer<double> price_change;
+    AlignedBuffer<double> price_change_5d;
+};
+
+void computeIndicators(const BarSeries& series, IndicatorColumns& out);
+
+} // namespace TradingSystem
+
+#endif // SIMD_KERNELS_H
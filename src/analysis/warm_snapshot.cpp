@@ -0,0 +1,161 @@
+#include "warm_snapshot.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace TradingSystem {
+
+namespace {
+
+struct FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t state_size;
+    uint32_t symbol_count;
+    int64_t written_ns;
+};
+
+struct SymbolHeader {
+    uint32_t name_length;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 24, "FileHeader layout");
+static_assert(sizeof(SymbolHeader) == 8, "SymbolHeader layout");
+static_assert(sizeof(CachedBar) % 8 == 0, "CachedBar keeps the blocks aligned");
+
+size_t padTo8(size_t n) {
+    return (n + 7) & ~size_t(7);
+}
+
+} // namespace
+
+bool WarmSnapshot::save(const std::string& path, const std::vector<std::string>& symbols,
+                        const IndicatorEngine& engine, const MarketDataCache& cache) {
+    const size_t state_size = IndicatorEngine::stateSize();
+    const size_t state_bytes = padTo8(state_size);
+    std::string state(state_bytes, '\0');
+
+    // Collect first so the header carries the symbol count
+    std::string body;
+    uint32_t symbol_count = 0;
+    static const char padding[8] = {};
+    for (const auto& symbol : symbols) {
+        SymbolId id = SymbolTable::getInstance().find(symbol);
+        CachedBar bar;
+        if (id == kInvalidSymbolId || !cache.latest(id, bar) || !engine.saveState(id, &state[0])) {
+            continue;
+        }
+        SymbolHeader symbol_header = {static_cast<uint32_t>(symbol.size()), 0};
+        body.append(reinterpret_cast<const char*>(&symbol_header), sizeof(symbol_header));
+        body.append(symbol);
+        body.append(padding, padTo8(symbol.size()) - symbol.size());
+        body.append(reinterpret_cast<const char*>(&bar), sizeof(bar));
+        body.append(state);
+        ++symbol_count;
+    }
+
+    // Write to a temporary and rename so a crash never leaves half a file
+    std::string tmp_path = path + ".tmp";
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to create " << tmp_path << std::endl;
+        return false;
+    }
+    int64_t now_ns = toEpochNanos(std::chrono::system_clock::now());
+    FileHeader header = {kFileMagic, kFileVersion, 0, static_cast<uint32_t>(state_size), symbol_count, now_ns};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(body.data(), static_cast<std::streamsize>(body.size()));
+
+    out.close();
+    if (!out) {
+        std::cerr << "Failed to write " << tmp_path << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to rename " << tmp_path << ": " << strerror(errno) << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool WarmSnapshot::load(const std::string& path, IndicatorEngine& engine, MarketDataCache& cache,
+                        std::vector<Restored>& restored) {
+    restored.clear();
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;  // No snapshot yet is the normal first start
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const size_t size = data.size();
+
+    FileHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << path << ": truncated header" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    const size_t state_size = IndicatorEngine::stateSize();
+    if (header.magic != kFileMagic || header.version != kFileVersion) {
+        std::cerr << path << ": not a version " << kFileVersion << " warm snapshot" << std::endl;
+        return false;
+    }
+    if (header.state_size != state_size) {
+        std::cerr << path << ": indicator state is " << header.state_size << " bytes, this build uses "
+                  << state_size << std::endl;
+        return false;
+    }
+
+    // Validate everything before touching the engine or the cache
+    struct Entry {
+        std::string symbol;
+        CachedBar bar;
+        size_t state_offset;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(header.symbol_count);
+    const size_t state_bytes = padTo8(state_size);
+    size_t offset = sizeof(header);
+    for (uint32_t s = 0; s < header.symbol_count; ++s) {
+        SymbolHeader symbol_header;
+        if (size - offset < sizeof(symbol_header)) {
+            std::cerr << path << ": truncated at symbol " << s << std::endl;
+            return false;
+        }
+        std::memcpy(&symbol_header, data.data() + offset, sizeof(symbol_header));
+        offset += sizeof(symbol_header);
+
+        size_t name_bytes = padTo8(symbol_header.name_length);
+        if (size - offset < name_bytes + sizeof(CachedBar) + state_bytes) {
+            std::cerr << path << ": truncated at symbol " << s << std::endl;
+            return false;
+        }
+        Entry entry;
+        entry.symbol.assign(data.data() + offset, symbol_header.name_length);
+        offset += name_bytes;
+        std::memcpy(&entry.bar, data.data() + offset, sizeof(CachedBar));
+        offset += sizeof(CachedBar);
+        entry.state_offset = offset;
+        offset += state_bytes;
+        entries.push_back(std::move(entry));
+    }
+
+    for (const auto& entry : entries) {
+        SymbolId id = SymbolTable::getInstance().intern(entry.symbol);
+        if (!cache.update(id, entry.bar)) {
+            continue;  // Outside the cache's capacity; leave it to the warm-up
+        }
+        engine.restoreState(id, data.data() + entry.state_offset);
+        restored.push_back(Restored{entry.symbol, entry.bar.timestamp_ns});
+    }
+    return true;
+}
+
+} // namespace TradingSystem
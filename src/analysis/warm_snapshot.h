@@ -0,0 +1,49 @@
+#ifndef WARM_SNAPSHOT_H
+#define WARM_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "indicator_engine.h"
+#include "../market_data/market_data_cache.h"
+
+namespace TradingSystem {
+
+// Streaming indicator state and the latest cached bar per symbol, written
+// at shutdown so the next start restores them instead of re-reading
+// indicator_warmup_bars of history per symbol. The caller replays whatever
+// bars were stored after each symbol's snapshot bar.
+//
+// Layout (little-endian, every block 8-byte aligned):
+//   header  : magic u32, version u16, reserved u16, state_size u32,
+//             symbol_count u32, written_ns i64
+//   per symbol:
+//     name_length u32, reserved u32, name padded to 8 bytes
+//     CachedBar, then state_size bytes of IndicatorEngine state
+//
+// A file whose state_size differs from this build's is refused, so a
+// deploy that changes the indicator layout falls back to the full warm-up.
+class WarmSnapshot {
+public:
+    static constexpr uint32_t kFileMagic = 0x53575354;  // "TSWS"
+    static constexpr uint16_t kFileVersion = 1;
+
+    struct Restored {
+        std::string symbol;
+        int64_t timestamp_ns;  // of the restored bar; replay from after it
+    };
+
+    // Symbols with both indicator state and a cached bar are written
+    static bool save(const std::string& path, const std::vector<std::string>& symbols,
+                     const IndicatorEngine& engine, const MarketDataCache& cache);
+
+    // Restore every symbol in the file; false (and nothing restored) if
+    // the file is missing, truncated or from another layout
+    static bool load(const std::string& path, IndicatorEngine& engine, MarketDataCache& cache,
+                     std::vector<Restored>& restored);
+};
+
+} // namespace TradingSystem
+
+#endif // WARM_SNAPSHOT_H
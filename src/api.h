@@ -3,10 +3,15 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <memory>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
 #include <curl/curl.h>
+#include "polygon_parser.h"
+#include "common/data_types.h"
 
 // Forward declaration
 std::map<std::string, std::string> loadEnv(const std::string& filename = ".env");
@@ -22,15 +27,13 @@ struct CryptoPrice {
 	std::string date;      // Date/time of data
 };
 
-// Structure to hold HTTP response data from curl
-struct WriteResponse {
-	std::string data;
-};
-
-// Callback function for curl to write HTTP response data
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, WriteResponse* response) {
+// Callback that streams the HTTP body straight into a Polygon parser.
+// Returning less than the chunk size makes curl abort a malformed transfer.
+static size_t ParserWriteCallback(void* contents, size_t size, size_t nmemb, PolygonAggParser* parser) {
 	size_t totalSize = size * nmemb;
-	response->data.append((char*)contents, totalSize);
+	if (!parser->feed(std::string_view(static_cast<const char*>(contents), totalSize))) {
+		return 0;
+	}
 	return totalSize;
 }
 
@@ -48,13 +51,31 @@ class StockApi {
 				m_isInitialized = false;
 			}
 			curl_global_init(CURL_GLOBAL_DEFAULT);
+			
+			// One multi handle for the object's lifetime: its connection cache
+			// keeps TLS sessions alive across batches and multiplexes HTTP/2
+			m_Multi = curl_multi_init();
+			if (m_Multi) {
+				curl_multi_setopt(m_Multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+				curl_multi_setopt(m_Multi, CURLMOPT_MAX_HOST_CONNECTIONS, 8L);
+			}
 		}
 		
 		// Destructor: Cleanup curl resources
 		~StockApi() {
+			for (auto& slot : m_Slots) {
+				curl_easy_cleanup(slot->handle);
+			}
+			m_Slots.clear();
+			if (m_Multi) {
+				curl_multi_cleanup(m_Multi);
+			}
 			curl_global_cleanup();
 		}
 		
+		StockApi(const StockApi&) = delete;
+		StockApi& operator=(const StockApi&) = delete;
+		
 		// Get the loaded API key
 		std::string getApiKey() const {
 			return m_ApiKey;
@@ -68,121 +89,215 @@ class StockApi {
 		// Fetch BTC price data from Polygon API
 		// Uses the aggregates endpoint to get previous day's OHLCV data
 		CryptoPrice getBTCPrice() {
+			PolygonBar bar;
+			if (getPreviousClose("X:BTCUSD", &bar, 1) == 0 || bar.close == 0.0) {
+				throw std::runtime_error("Failed to parse price data from API response");
+			}
+			
+			CryptoPrice result;
+			result.symbol = "BTC";
+			result.price = bar.close;
+			result.open = bar.open;
+			result.high = bar.high;
+			result.low = bar.low;
+			result.volume = bar.volume;
+			result.date = "Latest";
+			return result;
+		}
+		
+		// Fetch the previous day's bar for a ticker (e.g. "X:BTCUSD", "AAPL")
+		// Returns the number of bars written to out
+		size_t getPreviousClose(const std::string& ticker, PolygonBar* out, size_t capacity) {
+			std::string url = "https://api.polygon.io/v2/aggs/ticker/" + ticker + "/prev?apikey=" + m_ApiKey;
+			return fetchAggregates(url, out, capacity);
+		}
+		
+		// Fetch an aggregates range, e.g. getAggregates("X:BTCUSD", 1, "minute",
+		// "2024-01-01", "2024-01-02", bars, n). Bars are written in ascending time
+		// order; any beyond capacity are dropped. Returns the number written.
+		size_t getAggregates(const std::string& ticker, int multiplier, const std::string& timespan,
+		                     const std::string& from, const std::string& to,
+		                     PolygonBar* out, size_t capacity) {
+			std::string url = "https://api.polygon.io/v2/aggs/ticker/" + ticker + "/range/" +
+				std::to_string(multiplier) + "/" + timespan + "/" + from + "/" + to +
+				"?adjusted=true&sort=asc&limit=50000&apikey=" + m_ApiKey;
+			return fetchAggregates(url, out, capacity);
+		}
+		
+		// Map a configured symbol to a Polygon ticker. Symbols that already
+		// carry a market prefix ("X:BTCUSD", "C:EURUSD") pass through; bare
+		// symbols are treated as crypto quoted in USD, matching the default
+		// BTC/ETH/DOGE universe.
+		static std::string toPolygonTicker(const std::string& symbol) {
+			if (symbol.find(':') != std::string::npos) {
+				return symbol;
+			}
+			return "X:" + symbol + "USD";
+		}
+		
+		// Fetch the latest bar for every symbol concurrently over the shared
+		// multi handle. Each transfer is bounded by timeout_ms; symbols that
+		// fail or time out are reported to stderr and left out of the result.
+		// Bars are written into out, reusing its elements and capacity, so a
+		// caller that keeps the vector across cycles allocates nothing once
+		// warm. Returns the number of bars fetched.
+		size_t fetchLatestBars(const std::vector<std::string>& symbols, long timeout_ms,
+		                       std::vector<TradingSystem::MarketData>& out) {
 			if (!m_isInitialized) {
 				throw std::runtime_error("API not initialized");
 			}
+			if (!m_Multi) {
+				throw std::runtime_error("Failed to initialize CURL multi handle");
+			}
 			
-			CURL* curl = curl_easy_init();
-			CryptoPrice result;
+			// Grow the handle pool on demand; handles are reused across batches
+			while (m_Slots.size() < symbols.size()) {
+				auto slot = std::make_unique<BatchSlot>();
+				slot->handle = curl_easy_init();
+				if (!slot->handle) {
+					throw std::runtime_error("Failed to initialize CURL");
+				}
+				m_Slots.push_back(std::move(slot));
+			}
 			
-			if (curl) {
-				// Build Polygon API URL for BTC/USD previous day data
-				std::string url = "https://api.polygon.io/v2/aggs/ticker/X:BTCUSD/prev?apikey=" + m_ApiKey;
-				WriteResponse response;
-				
-				// Configure curl options
-				curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-				curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-				curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-				curl_easy_setopt(curl, CURLOPT_USERAGENT, "TradingSystem/1.0");
+			for (size_t i = 0; i < symbols.size(); ++i) {
+				BatchSlot& slot = *m_Slots[i];
+				slot.parser.reset(&slot.bar, 1);
+				slot.bar = PolygonBar();
+				if (slot.symbol != symbols[i]) {
+					slot.symbol = symbols[i];
+					slot.url = "https://api.polygon.io/v2/aggs/ticker/" + toPolygonTicker(symbols[i]) + "/prev?apikey=" + m_ApiKey;
+				}
 				
-				// Execute HTTP request
-				CURLcode res = curl_easy_perform(curl);
-				curl_easy_cleanup(curl);
+				curl_easy_setopt(slot.handle, CURLOPT_URL, slot.url.c_str());
+				curl_easy_setopt(slot.handle, CURLOPT_WRITEFUNCTION, ParserWriteCallback);
+				curl_easy_setopt(slot.handle, CURLOPT_WRITEDATA, &slot.parser);
+				curl_easy_setopt(slot.handle, CURLOPT_USERAGENT, "TradingSystem/1.0");
+				curl_easy_setopt(slot.handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+				curl_easy_setopt(slot.handle, CURLOPT_PIPEWAIT, 1L);
+				curl_easy_setopt(slot.handle, CURLOPT_TCP_KEEPALIVE, 1L);
+				curl_easy_setopt(slot.handle, CURLOPT_TIMEOUT_MS, timeout_ms);
+				curl_easy_setopt(slot.handle, CURLOPT_CONNECTTIMEOUT_MS, timeout_ms);
+				curl_easy_setopt(slot.handle, CURLOPT_PRIVATE, reinterpret_cast<char*>(i));
+				curl_multi_add_handle(m_Multi, slot.handle);
+			}
+			
+			// Drive all transfers until done; individual timeouts bound the total
+			std::vector<CURLcode> status(symbols.size(), CURLE_OK);
+			int still_running = 0;
+			do {
+				CURLMcode mc = curl_multi_perform(m_Multi, &still_running);
+				if (mc == CURLM_OK && still_running) {
+					mc = curl_multi_poll(m_Multi, nullptr, 0, 100, nullptr);
+				}
+				if (mc != CURLM_OK) {
+					std::cerr << "curl_multi failed: " << curl_multi_strerror(mc) << std::endl;
+					break;
+				}
 				
-				if (res == CURLE_OK) {
-					// Simple JSON parsing without external library
-					std::string jsonStr = response.data;
-					
-					// Check if response contains success status
-					if (jsonStr.find("\"status\":\"OK\"") == std::string::npos) {
-						throw std::runtime_error("API returned error status");
-					}
-					
-					// Extract values using string parsing (basic implementation)
-					double close_price = 0.0, open_price = 0.0, high_price = 0.0, low_price = 0.0, volume = 0.0;
-					
-					// Find the results array and extract first result
-					size_t results_pos = jsonStr.find("\"results\":[{");
-					if (results_pos != std::string::npos) {
-						std::string results_section = jsonStr.substr(results_pos);
-						
-						// Extract close price
-						size_t c_pos = results_section.find("\"c\":");
-						if (c_pos != std::string::npos) {
-							size_t start = c_pos + 4;
-							size_t end = results_section.find_first_of(",}", start);
-							if (end != std::string::npos) {
-								close_price = std::stod(results_section.substr(start, end - start));
-							}
-						}
-						
-						// Extract open price
-						size_t o_pos = results_section.find("\"o\":");
-						if (o_pos != std::string::npos) {
-							size_t start = o_pos + 4;
-							size_t end = results_section.find_first_of(",}", start);
-							if (end != std::string::npos) {
-								open_price = std::stod(results_section.substr(start, end - start));
-							}
-						}
-						
-						// Extract high price
-						size_t h_pos = results_section.find("\"h\":");
-						if (h_pos != std::string::npos) {
-							size_t start = h_pos + 4;
-							size_t end = results_section.find_first_of(",}", start);
-							if (end != std::string::npos) {
-								high_price = std::stod(results_section.substr(start, end - start));
-							}
-						}
-						
-						// Extract low price
-						size_t l_pos = results_section.find("\"l\":");
-						if (l_pos != std::string::npos) {
-							size_t start = l_pos + 4;
-							size_t end = results_section.find_first_of(",}", start);
-							if (end != std::string::npos) {
-								low_price = std::stod(results_section.substr(start, end - start));
-							}
-						}
-						
-						// Extract volume
-						size_t v_pos = results_section.find("\"v\":");
-						if (v_pos != std::string::npos) {
-							size_t start = v_pos + 4;
-							size_t end = results_section.find_first_of(",}", start);
-							if (end != std::string::npos) {
-								volume = std::stod(results_section.substr(start, end - start));
-							}
-						}
+				int queued = 0;
+				while (CURLMsg* msg = curl_multi_info_read(m_Multi, &queued)) {
+					if (msg->msg == CURLMSG_DONE) {
+						char* index = nullptr;
+						curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &index);
+						status[reinterpret_cast<size_t>(index)] = msg->data.result;
 					}
-					
-					// Set extracted values
-					result.symbol = "BTC";
-					result.price = close_price;
-					result.open = open_price;
-					result.high = high_price;
-					result.low = low_price;
-					result.volume = volume;
-					result.date = "Latest";
-					
-					if (close_price == 0.0) {
-						throw std::runtime_error("Failed to parse price data from API response");
-					}
-				} else {
-					throw std::runtime_error("HTTP request failed: " + std::string(curl_easy_strerror(res)));
 				}
-			} else {
-				throw std::runtime_error("Failed to initialize CURL");
+			} while (still_running);
+			
+			size_t count = 0;
+			auto now = std::chrono::system_clock::now();
+			
+			for (size_t i = 0; i < symbols.size(); ++i) {
+				BatchSlot& slot = *m_Slots[i];
+				curl_multi_remove_handle(m_Multi, slot.handle);
+				
+				bool parsed = slot.parser.finish();
+				if (status[i] != CURLE_OK && !slot.parser.failed()) {
+					std::cerr << "HTTP request for " << symbols[i] << " failed: " << curl_easy_strerror(status[i]) << std::endl;
+					continue;
+				}
+				if (!parsed || !slot.parser.statusOk() || slot.parser.barCount() == 0 || slot.bar.close == 0.0) {
+					std::cerr << "No usable price data for " << symbols[i] << std::endl;
+					continue;
+				}
+				
+				if (count == out.size()) {
+					out.emplace_back();
+				}
+				TradingSystem::MarketData& data = out[count++];
+				data.symbol.assign(symbols[i]);
+				data.open = slot.bar.open;
+				data.high = slot.bar.high;
+				data.low = slot.bar.low;
+				data.close = slot.bar.close;
+				data.volume = slot.bar.volume;
+				// Stamp the bar's own start ("t", ms) so staleness checks and
+				// ts_us ordering see its age; a bar without one gets the fetch time
+				data.timestamp = slot.bar.timestamp_ms > 0
+					? std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+						std::chrono::milliseconds(slot.bar.timestamp_ms)))
+					: now;
 			}
 			
-			return result;
+			out.resize(count);
+			return count;
 		}
 	
 	private:
+		// One pooled easy handle plus the state its transfer writes into
+		struct BatchSlot {
+			CURL* handle = nullptr;
+			PolygonAggParser parser;
+			PolygonBar bar;
+			std::string symbol;          // Symbol the cached url was built for
+			std::string url;
+		};
+		
+		CURLM* m_Multi = nullptr;                      // Shared connection cache for batches
+		std::vector<std::unique_ptr<BatchSlot>> m_Slots; // Reusable handle pool
 		std::string m_ApiKey;        // Polygon API key from .env file
 		bool m_isInitialized = false; // Flag indicating successful initialization
+		PolygonAggParser m_Parser;   // Reused across requests, holds no heap state
+		
+		// Run one aggregates request, parsing the body as it streams in
+		size_t fetchAggregates(const std::string& url, PolygonBar* out, size_t capacity) {
+			if (!m_isInitialized) {
+				throw std::runtime_error("API not initialized");
+			}
+			
+			CURL* curl = curl_easy_init();
+			if (!curl) {
+				throw std::runtime_error("Failed to initialize CURL");
+			}
+			
+			m_Parser.reset(out, capacity);
+			
+			// Configure curl options
+			curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+			curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, ParserWriteCallback);
+			curl_easy_setopt(curl, CURLOPT_WRITEDATA, &m_Parser);
+			curl_easy_setopt(curl, CURLOPT_USERAGENT, "TradingSystem/1.0");
+			
+			// Execute HTTP request
+			CURLcode res = curl_easy_perform(curl);
+			curl_easy_cleanup(curl);
+			
+			if (res != CURLE_OK && !m_Parser.failed()) {
+				throw std::runtime_error("HTTP request failed: " + std::string(curl_easy_strerror(res)));
+			}
+			
+			if (!m_Parser.finish()) {
+				throw std::runtime_error("Malformed JSON in API response");
+			}
+			
+			// Check if response contains success status
+			if (!m_Parser.statusOk()) {
+				throw std::runtime_error("API returned error status");
+			}
+			
+			return m_Parser.barCount();
+		}
 };
 
 // Function to load environment variables from .env file
@@ -0,0 +1,218 @@
+#include "backtester.h"
+#include "../trading/trading_engine.h"
+#include "../market_data/market_data_cache.h"
+#include "../common/work_stealing_pool.h"
+#include "../analysis/indicator_engine.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace TradingSystem {
+
+namespace {
+
+// The live fetch-and-analyse loop, one bar at a time, against one engine
+SymbolBacktestResult replay(const BarSeries& series, const IndicatorColumns& indicators,
+                            const BacktestConfig& config, const SignalRule& rule,
+                            const std::shared_ptr<MarketDataCache>& cache) {
+    SymbolBacktestResult result;
+    result.symbol = series.symbol();
+    result.bars = series.size();
+    result.final_equity = config.initial_balance;
+    if (series.empty()) {
+        return result;
+    }
+
+    TradingEngine engine(TradingMode::PAPER, config.initial_balance);
+    engine.setMarketDataCache(cache);
+    engine.setMaxPositionSize(config.max_position_size);
+    engine.setMaxDrawdown(config.max_drawdown);
+    engine.setStopLoss(config.stop_loss_percentage);
+    engine.setTakeProfit(config.take_profit_percentage);
+    engine.setSlippageRate(config.slippage_rate);
+    engine.setSpreadRate(config.spread_rate);
+    // Keyed by ticker rather than SymbolId, which depends on load order
+    engine.setSimulatorSeed(config.seed ^ std::hash<std::string>{}(series.symbol()));
+    engine.setVerbose(false);
+
+    // One signal reused for every bar so the ticker is copied once
+    TradingSignal signal;
+    signal.symbol = series.symbol();
+    signal.symbol_id = series.symbolId();
+
+    const SymbolId id = series.symbolId();
+    const double* open = series.open();
+    const double* high = series.high();
+    const double* low = series.low();
+    const double* close = series.close();
+    const double* volume = series.volume();
+    const int64_t* timestamps = series.timestamps();
+
+    RollingWindow<IndicatorEngine::kVolatilityWindow> changes;
+
+    for (size_t i = 0; i < series.size(); ++i) {
+        auto now = fromEpochNanos(timestamps[i]);
+        engine.setSimulatedTime(now);
+
+        CachedBar bar;
+        bar.open = open[i];
+        bar.high = high[i];
+        bar.low = low[i];
+        bar.close = close[i];
+        bar.volume = volume[i];
+        bar.timestamp_ns = timestamps[i];
+        cache->update(id, bar);
+
+        engine.updatePositionPrice(id, close[i]);
+
+        // Rolling std of one-bar changes, as IndicatorEngine keeps it
+        double change = indicators.price_change[i];
+        if (std::isfinite(change)) {
+            changes.push(change);
+        }
+
+        if (i + 1 >= config.warmup_bars) {
+            double volatility = changes.size() > 1 ? changes.stddev() : 0.0;
+            SignalContext context{series, indicators, i, volatility};
+            signal.timestamp = now;
+            if (rule(context, signal)) {
+                ++result.signals;
+                engine.processTradingSignal(signal);
+            }
+        }
+    }
+
+    result.fills = engine.getFillCount();
+    result.final_equity = engine.getTotalEquity();
+    result.pnl = result.final_equity - config.initial_balance;
+    result.winning_trades = engine.getWinningTradeCount();
+    result.losing_trades = engine.getLosingTradeCount();
+    result.win_rate = engine.getWinRate();
+    result.sharpe_ratio = engine.getSharpeRatio();
+    result.max_drawdown = engine.getMaxDrawdown();
+    return result;
+}
+
+} // namespace
+
+Backtester::Backtester(BacktestConfig config)
+    : settings(config), rule(&Backtester::analyzerRule) {
+}
+
+SymbolBacktestResult Backtester::runSymbol(const BarSeries& series) const {
+    IndicatorColumns indicators;
+    computeIndicators(series, indicators);
+    return runSymbol(series, indicators);
+}
+
+SymbolBacktestResult Backtester::runSymbol(const BarSeries& series, const IndicatorColumns& indicators) const {
+    auto cache = std::make_shared<MarketDataCache>(0, static_cast<size_t>(series.symbolId()) + 1);
+    return replay(series, indicators, settings, rule, cache);
+}
+
+BacktestResult Backtester::run(const BarDataset& dataset) const {
+    BacktestResult result;
+    const auto& all_series = dataset.series();
+    result.symbols.resize(all_series.size());
+    result.total_bars = dataset.totalBars();
+
+    // Symbols are independent accounts, so one latest-price cache serves
+    // every worker: each slot has a single writer
+    auto cache = std::make_shared<MarketDataCache>(0, std::max<size_t>(1, SymbolTable::getInstance().size()));
+
+    auto started = std::chrono::steady_clock::now();
+
+    // One task per symbol; idle workers steal, so long series do not leave
+    // other threads waiting behind a static split
+    WorkStealingPool pool(settings.threads);
+    for (size_t i = 0; i < all_series.size(); ++i) {
+        pool.submit([&, i] {
+            IndicatorColumns indicators;
+            computeIndicators(all_series[i], indicators);
+            result.symbols[i] = replay(all_series[i], indicators, settings, rule, cache);
+        });
+    }
+    pool.wait();
+
+    result.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    for (const auto& symbol : result.symbols) {
+        result.total_pnl += symbol.pnl;
+    }
+    return result;
+}
+
+bool Backtester::analyzerRule(const SignalContext& context, TradingSignal& signal) {
+    const IndicatorColumns& ind = context.indicators;
+    const size_t i = context.index;
+
+    double close = context.series.close()[i];
+    double rsi = ind.rsi_14[i];
+    double macd = ind.macd[i];
+    double macd_signal = ind.macd_signal[i];
+    double sma_5 = ind.sma_5[i];
+    double sma_20 = ind.sma_20[i];
+    double bb_upper = sma_20 + 2.0 * ind.std_20[i];
+    double bb_lower = sma_20 - 2.0 * ind.std_20[i];
+
+    // Same rule order and weights as generate_signal; NaN comparisons are
+    // false here as they are in pandas
+    SignalAction action = SignalAction::HOLD;
+    double confidence = 0.5;
+
+    if (rsi < 30) {
+        action = SignalAction::BUY;
+        confidence += 0.2;
+    } else if (rsi > 70) {
+        action = SignalAction::SELL;
+        confidence += 0.2;
+    }
+
+    if (macd > macd_signal && macd > 0) {
+        if (action != SignalAction::SELL) {
+            action = SignalAction::BUY;
+            confidence += 0.15;
+        }
+    } else if (macd < macd_signal && macd < 0) {
+        if (action != SignalAction::BUY) {
+            action = SignalAction::SELL;
+            confidence += 0.15;
+        }
+    }
+
+    if (close > sma_20 && sma_5 > sma_20) {
+        if (action != SignalAction::SELL) {
+            action = SignalAction::BUY;
+            confidence += 0.1;
+        }
+    } else if (close < sma_20 && sma_5 < sma_20) {
+        if (action != SignalAction::BUY) {
+            action = SignalAction::SELL;
+            confidence += 0.1;
+        }
+    }
+
+    if (close < bb_lower) {
+        if (action != SignalAction::SELL) {
+            action = SignalAction::BUY;
+            confidence += 0.1;
+        }
+    } else if (close > bb_upper) {
+        if (action != SignalAction::BUY) {
+            action = SignalAction::SELL;
+            confidence += 0.1;
+        }
+    }
+
+    if (action == SignalAction::HOLD) {
+        return false;
+    }
+
+    confidence = std::min(confidence, 0.95);
+
+    signal.action = action;
+    signal.confidence = confidence;
+    signal.suggested_position_size = IndicatorEngine::suggestedPositionSize(confidence, context.volatility);
+    return true;
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,96 @@
+#ifndef BACKTESTER_H
+#define BACKTESTER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include "bar_dataset.h"
+#include "../analysis/simd_kernels.h"
+#include "../common/data_types.h"
+
+namespace TradingSystem {
+
+struct BacktestConfig {
+    double initial_balance = 10000.0;   // per symbol
+    double max_position_size = 5000.0;
+    double max_drawdown = 0.20;
+    double stop_loss_percentage = 0.02;
+    double take_profit_percentage = 0.05;
+    double slippage_rate = 0.001;       // PaperTradingSimulator defaults
+    double spread_rate = 0.0005;
+    uint64_t seed = 1;                  // fill model RNG, mixed with each symbol
+    size_t warmup_bars = 30;            // bars before the first signal
+    size_t threads = 0;                 // 0 = hardware concurrency
+};
+
+// What a signal rule sees at bar index: the whole series and its
+// precomputed indicator columns (only [0, index] may be used), plus the
+// rolling volatility of the one-bar price changes ending at index
+struct SignalContext {
+    const BarSeries& series;
+    const IndicatorColumns& indicators;
+    size_t index;
+    double volatility;
+};
+
+// Fill signal and return true to send it to the engine
+using SignalRule = std::function<bool(const SignalContext& context, TradingSignal& signal)>;
+
+struct SymbolBacktestResult {
+    std::string symbol;
+    size_t bars = 0;
+    uint64_t signals = 0;
+    uint64_t fills = 0;
+    uint64_t winning_trades = 0;
+    uint64_t losing_trades = 0;
+    double final_equity = 0.0;
+    double pnl = 0.0;
+    double max_drawdown = 0.0;  // fraction of peak equity
+    double win_rate = 0.0;
+    double sharpe_ratio = 0.0;  // annualised, from daily equity returns
+};
+
+struct BacktestResult {
+    std::vector<SymbolBacktestResult> symbols;  // dataset order
+    size_t total_bars = 0;
+    double total_pnl = 0.0;
+    double elapsed_seconds = 0.0;
+
+    double barsPerSecond() const {
+        return elapsed_seconds > 0 ? static_cast<double>(total_bars) / elapsed_seconds : 0.0;
+    }
+};
+
+// Replays historical bars through the real TradingEngine and
+// PaperTradingSimulator on a simulated clock. Each symbol runs as its own
+// account (initial_balance each) on its own engine with persistence
+// disabled, so symbols are independent and spread across worker threads;
+// per bar the engine sees exactly what the live loop does: a cache
+// update, a position mark (stop-loss / take-profit) and then any signal.
+class Backtester {
+public:
+    explicit Backtester(BacktestConfig config = BacktestConfig());
+
+    // Defaults to analyzerRule
+    void setSignalRule(SignalRule rule) { this->rule = std::move(rule); }
+
+    BacktestResult run(const BarDataset& dataset) const;
+    SymbolBacktestResult runSymbol(const BarSeries& series) const;
+    // With indicators already computed for series, e.g. shared by a sweep
+    SymbolBacktestResult runSymbol(const BarSeries& series, const IndicatorColumns& indicators) const;
+
+    // Port of MarketDataAnalyzer.generate_signal / calculate_position_size
+    static bool analyzerRule(const SignalContext& context, TradingSignal& signal);
+
+    const BacktestConfig& config() const { return settings; }
+
+private:
+    BacktestConfig settings;
+    SignalRule rule;
+};
+
+} // namespace TradingSystem
+
+#endif // BACKTESTER_H
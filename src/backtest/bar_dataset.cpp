@@ -0,0 +1,203 @@
+#include "bar_dataset.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TradingSystem {
+
+namespace {
+
+struct FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t symbol_count;
+    uint32_t reserved2;
+};
+
+struct SeriesHeader {
+    uint32_t name_length;
+    uint32_t reserved;
+    uint64_t bar_count;
+};
+
+static_assert(sizeof(FileHeader) == 16, "FileHeader layout");
+static_assert(sizeof(SeriesHeader) == 16, "SeriesHeader layout");
+
+size_t padTo8(size_t n) {
+    return (n + 7) & ~size_t(7);
+}
+
+// Read-only mapping released when the last dataset sharing it goes
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            std::cerr << "Failed to open " << path << ": " << strerror(errno) << std::endl;
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* mem = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mem != MAP_FAILED) {
+                base = static_cast<const char*>(mem);
+                length = static_cast<size_t>(st.st_size);
+                // Each sweep configuration reads every page again
+                madvise(mem, length, MADV_WILLNEED);
+            } else {
+                std::cerr << "Failed to map " << path << ": " << strerror(errno) << std::endl;
+            }
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if (base) munmap(const_cast<char*>(base), length);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    const char* base = nullptr;
+    size_t length = 0;
+};
+
+} // namespace
+
+bool BarDataset::loadFromDatabase(DatabaseManager& db, const std::vector<std::string>& symbols, int max_bars) {
+    clear();
+    for (const auto& symbol : symbols) {
+        auto rows = db.getMarketData(symbol, max_bars);
+        if (rows.empty()) {
+            std::cerr << "No stored bars for " << symbol << ", skipping" << std::endl;
+            continue;
+        }
+        std::reverse(rows.begin(), rows.end());  // Stored newest first
+        series_list.push_back(BarSeries::fromMarketData(symbol, rows));
+    }
+    return !series_list.empty();
+}
+
+bool BarDataset::loadFile(const std::string& path) {
+    auto file = std::make_shared<const MappedFile>(path);
+    if (!file->data()) {
+        return false;
+    }
+
+    const char* data = file->data();
+    size_t size = file->size();
+
+    FileHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << path << ": truncated header" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != kFileMagic || header.version != kFileVersion) {
+        std::cerr << path << ": not a version " << kFileVersion << " bar file" << std::endl;
+        return false;
+    }
+
+    std::vector<BarSeries> loaded;
+    loaded.reserve(header.symbol_count);
+    size_t offset = sizeof(header);
+
+    for (uint32_t s = 0; s < header.symbol_count; ++s) {
+        SeriesHeader series_header;
+        if (size - offset < sizeof(series_header)) {
+            std::cerr << path << ": truncated at symbol " << s << std::endl;
+            return false;
+        }
+        std::memcpy(&series_header, data + offset, sizeof(series_header));
+        offset += sizeof(series_header);
+
+        size_t name_bytes = padTo8(series_header.name_length);
+        uint64_t n = series_header.bar_count;
+        if (n > (size - offset) / (6 * sizeof(double)) ||
+            size - offset < name_bytes + n * 6 * sizeof(double)) {
+            std::cerr << path << ": truncated at symbol " << s << std::endl;
+            return false;
+        }
+
+        std::string name(data + offset, series_header.name_length);
+        offset += name_bytes;
+
+        // Offsets are 8-byte aligned, so the mapping can be read in place
+        const double* columns = reinterpret_cast<const double*>(data + offset);
+        const int64_t* timestamps = reinterpret_cast<const int64_t*>(data + offset + 5 * n * sizeof(double));
+        loaded.push_back(BarSeries::view(name, columns, columns + n, columns + 2 * n, columns + 3 * n,
+                                         columns + 4 * n, timestamps, n));
+        offset += 6 * n * sizeof(double);
+    }
+
+    series_list = std::move(loaded);
+    mapping = std::move(file);
+    return true;
+}
+
+bool BarDataset::saveFile(const std::string& path) const {
+    // Write to a temporary and rename so readers never map a partial file
+    std::string tmp_path = path + ".tmp";
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to create " << tmp_path << std::endl;
+        return false;
+    }
+
+    FileHeader header = {kFileMagic, kFileVersion, 0, static_cast<uint32_t>(series_list.size()), 0};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    static const char padding[8] = {};
+    for (const auto& series : series_list) {
+        const std::string& name = series.symbol();
+        SeriesHeader series_header = {static_cast<uint32_t>(name.size()), 0, series.size()};
+        out.write(reinterpret_cast<const char*>(&series_header), sizeof(series_header));
+        out.write(name.data(), static_cast<std::streamsize>(name.size()));
+        out.write(padding, static_cast<std::streamsize>(padTo8(name.size()) - name.size()));
+
+        std::streamsize column_bytes = static_cast<std::streamsize>(series.size() * sizeof(double));
+        for (const double* column : {series.open(), series.high(), series.low(), series.close(), series.volume()}) {
+            out.write(reinterpret_cast<const char*>(column), column_bytes);
+        }
+        out.write(reinterpret_cast<const char*>(series.timestamps()), column_bytes);
+    }
+
+    out.close();
+    if (!out) {
+        std::cerr << "Failed to write " << tmp_path << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to rename " << tmp_path << ": " << strerror(errno) << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void BarDataset::add(BarSeries series) {
+    series_list.push_back(std::move(series));
+}
+
+size_t BarDataset::totalBars() const {
+    size_t total = 0;
+    for (const auto& series : series_list) {
+        total += series.size();
+    }
+    return total;
+}
+
+} // namespace TradingSystem
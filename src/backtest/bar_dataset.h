@@ -0,0 +1,59 @@
+#ifndef BAR_DATASET_H
+#define BAR_DATASET_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include "../analysis/bar_series.h"
+#include "../database/database_manager.h"
+
+namespace TradingSystem {
+
+// Historical bars for a backtest: one columnar BarSeries per symbol, each
+// oldest first. Loaded from SQLite or from a .bars file, a flat columnar
+// dump that is memory-mapped and served in place: the series loaded from
+// it are views into the mapping, so loading a large universe parses no
+// timestamps and copies nothing, and every sweep worker replays the same
+// pages. The mapping lives as long as the dataset or any copy of it; a
+// series copied out must not outlive them.
+//
+// .bars layout (little-endian, every block 8-byte aligned):
+//   header  : magic u32, version u16, reserved u16, symbol_count u32, reserved u32
+//   per symbol:
+//     name_length u32, reserved u32, bar_count u64, name padded to 8 bytes
+//     open, high, low, close, volume : double[bar_count] each
+//     timestamp_ns                   : int64[bar_count]
+class BarDataset {
+public:
+    static constexpr uint32_t kFileMagic = 0x52425354;  // "TSBR"
+    static constexpr uint16_t kFileVersion = 1;
+
+    BarDataset() = default;
+
+    // Up to max_bars most recent bars per symbol; symbols without any
+    // stored bars are skipped
+    bool loadFromDatabase(DatabaseManager& db, const std::vector<std::string>& symbols, int max_bars);
+
+    bool loadFile(const std::string& path);
+    bool saveFile(const std::string& path) const;
+
+    void add(BarSeries series);
+    void clear() {
+        series_list.clear();
+        mapping.reset();
+    }
+
+    const std::vector<BarSeries>& series() const { return series_list; }
+    size_t symbolCount() const { return series_list.size(); }
+    size_t totalBars() const;
+
+private:
+    std::vector<BarSeries> series_list;
+    std::shared_ptr<const void> mapping;  // The .bars file the views read from
+};
+
+} // namespace TradingSystem
+
+#endif // BAR_DATASET_H
@@ -0,0 +1,137 @@
+#include "parameter_sweep.h"
+#include "../common/work_stealing_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace TradingSystem {
+
+namespace {
+
+using ConfigField = double BacktestConfig::*;
+using GridField = std::vector<double> ParameterGrid::*;
+
+struct SweptParameter {
+    const char* name;
+    GridField values;
+    ConfigField field;
+};
+
+const SweptParameter kParameters[] = {
+    {"max_position_size", &ParameterGrid::max_position_size, &BacktestConfig::max_position_size},
+    {"max_drawdown", &ParameterGrid::max_drawdown, &BacktestConfig::max_drawdown},
+    {"stop_loss_percentage", &ParameterGrid::stop_loss_percentage, &BacktestConfig::stop_loss_percentage},
+    {"take_profit_percentage", &ParameterGrid::take_profit_percentage, &BacktestConfig::take_profit_percentage},
+    {"slippage_rate", &ParameterGrid::slippage_rate, &BacktestConfig::slippage_rate},
+    {"spread_rate", &ParameterGrid::spread_rate, &BacktestConfig::spread_rate},
+};
+
+} // namespace
+
+bool ParameterGrid::set(const std::string& name, std::vector<double> values) {
+    for (const auto& parameter : kParameters) {
+        std::string full = parameter.name;
+        if (name == full || name + "_percentage" == full) {
+            this->*parameter.values = std::move(values);
+            return true;
+        }
+    }
+    return false;
+}
+
+ParameterSweep::ParameterSweep(BacktestConfig base)
+    : base(base), rule(&Backtester::analyzerRule) {
+}
+
+std::vector<BacktestConfig> ParameterSweep::gridConfigurations(const ParameterGrid& grid) const {
+    std::vector<BacktestConfig> configs{base};
+    for (const auto& parameter : kParameters) {
+        const std::vector<double>& values = grid.*parameter.values;
+        if (values.empty()) continue;
+
+        std::vector<BacktestConfig> expanded;
+        expanded.reserve(configs.size() * values.size());
+        for (const auto& config : configs) {
+            for (double value : values) {
+                BacktestConfig next = config;
+                next.*parameter.field = value;
+                expanded.push_back(next);
+            }
+        }
+        configs = std::move(expanded);
+    }
+    return configs;
+}
+
+std::vector<BacktestConfig> ParameterSweep::randomConfigurations(const ParameterGrid& grid, size_t count,
+                                                                 uint64_t seed) const {
+    std::mt19937_64 gen(seed);
+    std::vector<BacktestConfig> configs(count, base);
+    for (auto& config : configs) {
+        for (const auto& parameter : kParameters) {
+            const std::vector<double>& values = grid.*parameter.values;
+            if (values.empty()) continue;
+            auto [low, high] = std::minmax_element(values.begin(), values.end());
+            std::uniform_real_distribution<double> dis(*low, *high);
+            config.*parameter.field = *low == *high ? *low : dis(gen);
+        }
+    }
+    return configs;
+}
+
+std::vector<SweepResult> ParameterSweep::run(const BarDataset& dataset, const std::vector<BacktestConfig>& configs) {
+    const auto& all_series = dataset.series();
+    std::vector<std::vector<SymbolBacktestResult>> per_symbol(configs.size());
+    for (auto& results : per_symbol) {
+        results.resize(all_series.size());
+    }
+
+    auto started = std::chrono::steady_clock::now();
+
+    {
+        WorkStealingPool pool(base.threads);
+
+        // Indicators depend only on the bars, so every configuration
+        // shares one set per symbol
+        std::vector<IndicatorColumns> indicators(all_series.size());
+        for (size_t s = 0; s < all_series.size(); ++s) {
+            pool.submit([&, s] { computeIndicators(all_series[s], indicators[s]); });
+        }
+        pool.wait();
+
+        for (size_t c = 0; c < configs.size(); ++c) {
+            for (size_t s = 0; s < all_series.size(); ++s) {
+                pool.submit([&, c, s] {
+                    Backtester backtester(configs[c]);
+                    backtester.setSignalRule(rule);
+                    per_symbol[c][s] = backtester.runSymbol(all_series[s], indicators[s]);
+                });
+            }
+        }
+        pool.wait();
+    }
+
+    elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    std::vector<SweepResult> results(configs.size());
+    for (size_t c = 0; c < configs.size(); ++c) {
+        SweepResult& result = results[c];
+        result.config = configs[c];
+
+        uint64_t wins = 0;
+        double sharpe_sum = 0.0;
+        for (const auto& symbol : per_symbol[c]) {
+            result.total_pnl += symbol.pnl;
+            result.max_drawdown = std::max(result.max_drawdown, symbol.max_drawdown);
+            result.fills += symbol.fills;
+            result.trades += symbol.winning_trades + symbol.losing_trades;
+            wins += symbol.winning_trades;
+            sharpe_sum += symbol.sharpe_ratio;
+        }
+        result.win_rate = result.trades > 0 ? static_cast<double>(wins) / result.trades : 0.0;
+        result.sharpe_ratio = per_symbol[c].empty() ? 0.0 : sharpe_sum / per_symbol[c].size();
+    }
+    return results;
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,67 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "backtester.h"
+
+namespace TradingSystem {
+
+// Candidate values per risk / fill parameter. An empty list keeps the base
+// configuration's value. For a random search only the smallest and largest
+// value of each list matter: samples are drawn uniformly between them.
+struct ParameterGrid {
+    std::vector<double> max_position_size;
+    std::vector<double> max_drawdown;
+    std::vector<double> stop_loss_percentage;
+    std::vector<double> take_profit_percentage;
+    std::vector<double> slippage_rate;
+    std::vector<double> spread_rate;
+
+    // name is the BacktestConfig field ("stop_loss_percentage") or its
+    // short form without "_percentage"; false for an unknown name
+    bool set(const std::string& name, std::vector<double> values);
+};
+
+struct SweepResult {
+    BacktestConfig config;
+    double total_pnl = 0.0;
+    double win_rate = 0.0;       // over the closed trades of every symbol
+    double sharpe_ratio = 0.0;   // mean of the per-symbol ratios
+    double max_drawdown = 0.0;   // worst symbol
+    uint64_t fills = 0;
+    uint64_t trades = 0;
+};
+
+// Runs many Backtester configurations over one dataset. Every
+// (configuration, symbol) pair is a task on a work-stealing pool, all
+// replaying the same read-only BarDataset on an engine of their own, so
+// the bars are loaded once instead of once per process.
+class ParameterSweep {
+public:
+    explicit ParameterSweep(BacktestConfig base = BacktestConfig());
+
+    void setSignalRule(SignalRule rule) { this->rule = std::move(rule); }
+
+    // Every combination of the grid's values
+    std::vector<BacktestConfig> gridConfigurations(const ParameterGrid& grid) const;
+    // count configurations drawn uniformly within each list's range
+    std::vector<BacktestConfig> randomConfigurations(const ParameterGrid& grid, size_t count,
+                                                     uint64_t seed) const;
+
+    // Results in configuration order; base.threads sizes the pool
+    std::vector<SweepResult> run(const BarDataset& dataset, const std::vector<BacktestConfig>& configs);
+
+    double lastElapsedSeconds() const { return elapsed_seconds; }
+
+private:
+    BacktestConfig base;
+    SignalRule rule;
+    double elapsed_seconds = 0.0;
+};
+
+} // namespace TradingSystem
+
+#endif // PARAMETER_SWEEP_H
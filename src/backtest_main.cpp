@@ -0,0 +1,196 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+
+#include "config/config_manager.h"
+#include "database/database_manager.h"
+#include "backtest/bar_dataset.h"
+#include "backtest/backtester.h"
+#include "backtest/parameter_sweep.h"
+
+using namespace TradingSystem;
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --config FILE        config.ini to read defaults from\n"
+              << "  --db FILE            SQLite database to replay (default: [database] path)\n"
+              << "  --bars FILE          replay a .bars file instead of the database\n"
+              << "  --export FILE        write the loaded bars to a .bars file\n"
+              << "  --symbols A,B,...    symbols to load from the database\n"
+              << "  --max-bars N         most recent bars per symbol from the database\n"
+              << "  --stop-loss X        stop-loss fraction (e.g. 0.02)\n"
+              << "  --take-profit X      take-profit fraction (e.g. 0.05)\n"
+              << "  --threads N          worker threads, 0 = all cores\n"
+              << "  --sim-seed N         paper fill model seed (default 1)\n"
+              << "  --sweep NAME=V1,V2   sweep a parameter (repeatable): max_position_size,\n"
+              << "                       max_drawdown, stop_loss, take_profit, slippage_rate, spread_rate\n"
+              << "  --random N           sample N configurations within the swept ranges\n"
+              << "  --seed N             random search seed (default 1)\n"
+              << "  --top N              rows of the sweep table, best P&L first (default all)\n";
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+std::vector<double> parseValues(const std::string& list) {
+    std::vector<double> values;
+    for (const auto& item : splitList(list)) {
+        values.push_back(std::stod(item));
+    }
+    return values;
+}
+
+void printSweep(std::vector<SweepResult> results, size_t top, double elapsed_seconds, size_t total_bars) {
+    std::sort(results.begin(), results.end(),
+              [](const SweepResult& a, const SweepResult& b) { return a.total_pnl > b.total_pnl; });
+    size_t rows = top > 0 ? std::min(top, results.size()) : results.size();
+
+    std::cout << std::fixed
+              << "  max_pos  max_dd  stop  take  slip    spread  |        P&L   win%  sharpe  max_dd%  trades\n";
+    for (size_t i = 0; i < rows; ++i) {
+        const SweepResult& r = results[i];
+        const BacktestConfig& c = r.config;
+        std::cout << std::setprecision(0) << std::setw(9) << c.max_position_size
+                  << std::setprecision(2) << std::setw(8) << c.max_drawdown
+                  << std::setprecision(3) << std::setw(6) << c.stop_loss_percentage
+                  << std::setw(6) << c.take_profit_percentage
+                  << std::setprecision(4) << std::setw(8) << c.slippage_rate
+                  << std::setw(8) << c.spread_rate << "  |"
+                  << std::setprecision(2) << std::setw(11) << r.total_pnl
+                  << std::setprecision(1) << std::setw(7) << r.win_rate * 100.0
+                  << std::setprecision(2) << std::setw(8) << r.sharpe_ratio
+                  << std::setprecision(1) << std::setw(9) << r.max_drawdown * 100.0
+                  << std::setw(8) << r.trades << "\n";
+    }
+
+    double replayed = static_cast<double>(total_bars) * results.size();
+    std::cout << results.size() << " configurations, " << std::setprecision(0) << replayed << " bars in "
+              << std::setprecision(3) << elapsed_seconds << "s ("
+              << std::setprecision(0) << (elapsed_seconds > 0 ? replayed / elapsed_seconds : 0.0)
+              << " bars/s)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string config_file = "config.ini";
+    std::string db_path;
+    std::string bars_file;
+    std::string export_file;
+    std::string symbol_list;
+    int max_bars = 1000000;
+    double stop_loss = -1.0;
+    double take_profit = -1.0;
+    int threads = 0;
+    uint64_t sim_seed = 1;
+    ParameterGrid grid;
+    bool sweep = false;
+    size_t random_count = 0;
+    uint64_t seed = 1;
+    size_t top = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--config" && has_value) config_file = argv[++i];
+        else if (arg == "--db" && has_value) db_path = argv[++i];
+        else if (arg == "--bars" && has_value) bars_file = argv[++i];
+        else if (arg == "--export" && has_value) export_file = argv[++i];
+        else if (arg == "--symbols" && has_value) symbol_list = argv[++i];
+        else if (arg == "--max-bars" && has_value) max_bars = std::stoi(argv[++i]);
+        else if (arg == "--stop-loss" && has_value) stop_loss = std::stod(argv[++i]);
+        else if (arg == "--take-profit" && has_value) take_profit = std::stod(argv[++i]);
+        else if (arg == "--threads" && has_value) threads = std::stoi(argv[++i]);
+        else if (arg == "--sim-seed" && has_value) sim_seed = std::stoull(argv[++i]);
+        else if (arg == "--random" && has_value) random_count = std::stoul(argv[++i]);
+        else if (arg == "--seed" && has_value) seed = std::stoull(argv[++i]);
+        else if (arg == "--top" && has_value) top = std::stoul(argv[++i]);
+        else if (arg == "--sweep" && has_value) {
+            std::string spec = argv[++i];
+            size_t eq = spec.find('=');
+            if (eq == std::string::npos || !grid.set(spec.substr(0, eq), parseValues(spec.substr(eq + 1)))) {
+                std::cerr << "Unknown sweep parameter: " << spec << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            sweep = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    ConfigManager::getInstance().loadConfig(config_file);
+    TradingConfig trading = *ConfigManager::getInstance().snapshot();
+
+    BacktestConfig config;
+    config.initial_balance = trading.initial_balance;
+    config.max_position_size = trading.max_position_size;
+    config.max_drawdown = trading.max_drawdown;
+    config.stop_loss_percentage = stop_loss >= 0 ? stop_loss : trading.stop_loss_percentage;
+    config.take_profit_percentage = take_profit >= 0 ? take_profit : trading.take_profit_percentage;
+    config.threads = static_cast<size_t>(std::max(0, threads));
+    config.seed = sim_seed;
+
+    BarDataset dataset;
+    if (!bars_file.empty()) {
+        if (!dataset.loadFile(bars_file)) {
+            return 1;
+        }
+    } else {
+        DatabaseManager db(db_path.empty() ? trading.db_path : db_path);
+        if (!db.initialize()) {
+            std::cerr << "Failed to open database" << std::endl;
+            return 1;
+        }
+        std::vector<std::string> symbols = symbol_list.empty() ? trading.symbols : splitList(symbol_list);
+        if (!dataset.loadFromDatabase(db, symbols, max_bars)) {
+            std::cerr << "No bars to replay" << std::endl;
+            return 1;
+        }
+    }
+
+    if (!export_file.empty() && !dataset.saveFile(export_file)) {
+        return 1;
+    }
+
+    if (sweep) {
+        ParameterSweep sweeper(config);
+        std::vector<BacktestConfig> configs = random_count > 0
+                                                  ? sweeper.randomConfigurations(grid, random_count, seed)
+                                                  : sweeper.gridConfigurations(grid);
+        auto results = sweeper.run(dataset, configs);
+        printSweep(std::move(results), top, sweeper.lastElapsedSeconds(), dataset.totalBars());
+        return 0;
+    }
+
+    Backtester backtester(config);
+    BacktestResult result = backtester.run(dataset);
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& symbol : result.symbols) {
+        std::cout << std::left << std::setw(10) << symbol.symbol << std::right
+                  << " bars " << std::setw(9) << symbol.bars
+                  << "  signals " << std::setw(8) << symbol.signals
+                  << "  fills " << std::setw(7) << symbol.fills
+                  << "  P&L $" << std::setw(10) << symbol.pnl
+                  << "  max DD " << std::setw(6) << symbol.max_drawdown * 100.0 << "%" << std::endl;
+    }
+    std::cout << "Replayed " << result.total_bars << " bars for " << result.symbols.size() << " symbols in "
+              << std::setprecision(3) << result.elapsed_seconds << "s ("
+              << std::setprecision(0) << result.barsPerSecond() << " bars/s), total P&L $"
+              << std::setprecision(2) << result.total_pnl << std::endl;
+    return 0;
+}
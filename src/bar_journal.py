@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+
+"""Zero-copy reader for the per-symbol bar journals written by BarJournal.
+
+The file layout mirrors src/database/bar_journal.h:
+
+    offset  0  u32 magic, u16 version, u16 record_size, u64 record_count,
+               char[48] symbol
+    offset 64  records of i64 timestamp_ns and f64 open/high/low/close/volume
+
+The trading system may still be appending while a journal is mapped. It
+preallocates the file and publishes record_count after each record is
+written, so only the first record_count records are read, never the
+file length. A bar refetched while it is still forming is appended again
+rather than rewritten, so readers keep the last record of each timestamp.
+"""
+
+import os
+import struct
+
+import numpy as np
+import pandas as pd
+
+MAGIC = 0x4A425354
+VERSION = 1
+HEADER_SIZE = 64
+
+RECORD_DTYPE = np.dtype([
+    ('timestamp_ns', '<i8'),
+    ('open', '<f8'),
+    ('high', '<f8'),
+    ('low', '<f8'),
+    ('close', '<f8'),
+    ('volume', '<f8'),
+])
+
+_HEADER = struct.Struct('<IHHQ')
+
+
+def file_name(symbol: str) -> str:
+    """Same sanitising as BarJournal::fileName"""
+    safe = ''.join(c if c.isascii() and (c.isalnum() or c in '-_.') else '_' for c in symbol)
+    return safe + '.journal'
+
+
+def journal_path(directory: str, symbol: str) -> str:
+    return os.path.join(directory, file_name(symbol))
+
+
+def open_records(directory: str, symbol: str) -> np.ndarray:
+    """All committed records as a read-only memmap (empty if there is no journal)"""
+    path = journal_path(directory, symbol)
+    try:
+        with open(path, 'rb') as f:
+            header = f.read(_HEADER.size)
+    except FileNotFoundError:
+        return np.empty(0, dtype=RECORD_DTYPE)
+
+    if len(header) < _HEADER.size:
+        raise ValueError(f"{path}: truncated journal header")
+    magic, version, record_size, record_count = _HEADER.unpack(header)
+    if magic != MAGIC or version != VERSION or record_size != RECORD_DTYPE.itemsize:
+        raise ValueError(f"{path}: not a version {VERSION} bar journal")
+
+    available = (os.path.getsize(path) - HEADER_SIZE) // RECORD_DTYPE.itemsize
+    count = min(record_count, available)
+    if count == 0:
+        return np.empty(0, dtype=RECORD_DTYPE)
+    return np.memmap(path, dtype=RECORD_DTYPE, mode='r', offset=HEADER_SIZE, shape=(count,))
+
+
+def read_range(directory: str, symbol: str, start_ns: int, end_ns: int) -> np.ndarray:
+    """Records with start_ns <= timestamp_ns <= end_ns, one per timestamp.
+
+    A view, not a copy, unless superseded records had to be dropped.
+    """
+    records = open_records(directory, symbol)
+    timestamps = records['timestamp_ns']
+    lo = np.searchsorted(timestamps, start_ns, side='left')
+    hi = np.searchsorted(timestamps, end_ns, side='right')
+    selected = records[lo:hi]
+    stamps = selected['timestamp_ns']
+    superseded = stamps[1:] == stamps[:-1]
+    if superseded.any():
+        selected = selected[np.append(~superseded, True)]
+    return selected
+
+
+def to_frame(symbol: str, records: np.ndarray) -> pd.DataFrame:
+    """DataFrame shaped like the market_data query in MarketDataAnalyzer"""
+    df = pd.DataFrame({
+        'symbol': symbol,
+        'open': records['open'],
+        'high': records['high'],
+        'low': records['low'],
+        'close': records['close'],
+        'volume': records['volume'],
+    }, index=pd.to_datetime(records['timestamp_ns'], unit='ns'))
+    df.index.name = 'timestamp'
+    return df
@@ -5,6 +5,85 @@
 
 namespace TradingSystem {
 
+namespace {
+
+// Parse the "%Y-%m-%d %H:%M:%S" UTC timestamp written by toJson; fall back
+// to now() only when the field is missing or malformed
+std::chrono::system_clock::time_point parseJsonTimestamp(const std::string& json) {
+    size_t pos = json.find("\"timestamp\":\"");
+    if (pos != std::string::npos) {
+        pos += 13;
+        std::tm tm = {};
+        std::istringstream ss(json.substr(pos, 19));
+        ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+        if (!ss.fail()) {
+            return std::chrono::system_clock::from_time_t(timegm(&tm));
+        }
+    }
+    return std::chrono::system_clock::now();
+}
+
+} // namespace
+
+const char* toString(OrderSide side) {
+    return side == OrderSide::SELL ? "SELL" : "BUY";
+}
+
+const char* toString(OrderType type) {
+    switch (type) {
+        case OrderType::LIMIT: return "LIMIT";
+        case OrderType::STOP: return "STOP";
+        default: return "MARKET";
+    }
+}
+
+const char* toString(OrderStatus status) {
+    switch (status) {
+        case OrderStatus::FILLED: return "FILLED";
+        case OrderStatus::CANCELLED: return "CANCELLED";
+        case OrderStatus::REJECTED: return "REJECTED";
+        case OrderStatus::PARTIALLY_FILLED: return "PARTIALLY_FILLED";
+        default: return "PENDING";
+    }
+}
+
+const char* toString(SignalAction action) {
+    switch (action) {
+        case SignalAction::BUY: return "BUY";
+        case SignalAction::SELL: return "SELL";
+        default: return "HOLD";
+    }
+}
+
+bool fromString(std::string_view text, OrderSide& out) {
+    if (text == "BUY") { out = OrderSide::BUY; return true; }
+    if (text == "SELL") { out = OrderSide::SELL; return true; }
+    return false;
+}
+
+bool fromString(std::string_view text, OrderType& out) {
+    if (text == "MARKET") { out = OrderType::MARKET; return true; }
+    if (text == "LIMIT") { out = OrderType::LIMIT; return true; }
+    if (text == "STOP") { out = OrderType::STOP; return true; }
+    return false;
+}
+
+bool fromString(std::string_view text, OrderStatus& out) {
+    if (text == "PENDING") { out = OrderStatus::PENDING; return true; }
+    if (text == "FILLED") { out = OrderStatus::FILLED; return true; }
+    if (text == "CANCELLED") { out = OrderStatus::CANCELLED; return true; }
+    if (text == "REJECTED") { out = OrderStatus::REJECTED; return true; }
+    if (text == "PARTIALLY_FILLED") { out = OrderStatus::PARTIALLY_FILLED; return true; }
+    return false;
+}
+
+bool fromString(std::string_view text, SignalAction& out) {
+    if (text == "BUY") { out = SignalAction::BUY; return true; }
+    if (text == "SELL") { out = SignalAction::SELL; return true; }
+    if (text == "HOLD") { out = SignalAction::HOLD; return true; }
+    return false;
+}
+
 std::string MarketData::toJson() const {
     std::stringstream ss;
     auto time_t = std::chrono::system_clock::to_time_t(timestamp);
@@ -63,7 +142,7 @@ MarketData MarketData::fromJson(const std::string& json) {
         data.volume = std::stod(json.substr(pos));
     }
     
-    data.timestamp = std::chrono::system_clock::now();
+    data.timestamp = parseJsonTimestamp(json);
     
     return data;
 }
@@ -75,7 +154,7 @@ std::string TradingSignal::toJson() const {
     ss << "{"
        << "\"symbol\":\"" << symbol << "\","
        << "\"confidence\":" << std::fixed << std::setprecision(4) << confidence << ","
-       << "\"action\":\"" << action << "\","
+       << "\"action\":\"" << toString(action) << "\","
        << "\"suggested_position_size\":" << suggested_position_size << ","
        << "\"timestamp\":\"" << std::put_time(std::gmtime(&time_t), "%Y-%m-%d %H:%M:%S") << "\""
        << "}";
@@ -91,6 +170,7 @@ TradingSignal TradingSignal::fromJson(const std::string& json) {
         pos += 10;
         size_t end = json.find("\"", pos);
         signal.symbol = json.substr(pos, end - pos);
+        signal.symbol_id = SymbolTable::getInstance().intern(signal.symbol);
     }
     
     pos = json.find("\"confidence\":");
@@ -103,7 +183,8 @@ TradingSignal TradingSignal::fromJson(const std::string& json) {
     if (pos != std::string::npos) {
         pos += 10;
         size_t end = json.find("\"", pos);
-        signal.action = json.substr(pos, end - pos);
+        // Unknown actions stay HOLD so a malformed signal never trades
+        fromString(std::string_view(json).substr(pos, end - pos), signal.action);
     }
     
     pos = json.find("\"suggested_position_size\":");
@@ -112,7 +193,7 @@ TradingSignal TradingSignal::fromJson(const std::string& json) {
         signal.suggested_position_size = std::stod(json.substr(pos));
     }
     
-    signal.timestamp = std::chrono::system_clock::now();
+    signal.timestamp = parseJsonTimestamp(json);
     
     return signal;
 }
@@ -2,11 +2,65 @@
 #define DATA_TYPES_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <chrono>
+#include <cstdint>
+#include "symbol_table.h"
 
 namespace TradingSystem {
 
+// Epoch-nanosecond conversions shared by the wire format and persistence
+inline int64_t toEpochNanos(const std::chrono::system_clock::time_point& tp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+inline std::chrono::system_clock::time_point fromEpochNanos(int64_t ns) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+enum class OrderSide : uint8_t {
+    BUY,
+    SELL
+};
+
+enum class OrderType : uint8_t {
+    MARKET,
+    LIMIT,
+    STOP        // market order once the price reaches the stop price
+};
+
+enum class OrderStatus : uint8_t {
+    PENDING,
+    FILLED,
+    CANCELLED,
+    REJECTED,
+    PARTIALLY_FILLED    // some quantity filled, the rest still working
+};
+
+enum class SignalAction : uint8_t {
+    HOLD,
+    BUY,
+    SELL
+};
+
+// Canonical spellings used in JSON and the database
+const char* toString(OrderSide side);
+const char* toString(OrderType type);
+const char* toString(OrderStatus status);
+const char* toString(SignalAction action);
+
+// Parse a canonical spelling; false (out untouched) for anything else
+bool fromString(std::string_view text, OrderSide& out);
+bool fromString(std::string_view text, OrderType& out);
+bool fromString(std::string_view text, OrderStatus& out);
+bool fromString(std::string_view text, SignalAction& out);
+
+// Numeric order identifier; 0 is never issued and marks a rejected order
+using OrderId = uint64_t;
+constexpr OrderId kInvalidOrderId = 0;
+
 struct MarketData {
     std::string symbol;
     double open;
@@ -22,8 +76,9 @@ struct MarketData {
 
 struct TradingSignal {
     std::string symbol;
+    SymbolId symbol_id = kInvalidSymbolId;  // Set by fromJson and the wire decoder
     double confidence;  // 0.0 to 1.0
-    std::string action; // "BUY", "SELL", "HOLD"
+    SignalAction action = SignalAction::HOLD;
     double suggested_position_size;
     std::chrono::system_clock::time_point timestamp;
     
@@ -32,27 +87,36 @@ struct TradingSignal {
 };
 
 struct Position {
-    std::string symbol;
-    double quantity;
-    double entry_price;
-    double current_price;
-    double unrealized_pnl;
+    SymbolId symbol_id = kInvalidSymbolId;
+    double quantity = 0.0;
+    double entry_price = 0.0;
+    double current_price = 0.0;
+    double unrealized_pnl = 0.0;
     std::chrono::system_clock::time_point entry_time;
     
+    const std::string& symbolName() const { return SymbolTable::getInstance().name(symbol_id); }
+    
     double getPnlPercentage() const {
         return ((current_price - entry_price) / entry_price) * 100.0;
     }
 };
 
 struct Order {
-    std::string order_id;
-    std::string symbol;
-    std::string side; // "BUY" or "SELL"
-    double quantity;
-    double price;
-    std::string order_type; // "MARKET", "LIMIT"
-    std::string status; // "PENDING", "FILLED", "CANCELLED"
+    OrderId order_id = kInvalidOrderId;
+    SymbolId symbol_id = kInvalidSymbolId;
+    OrderSide side = OrderSide::BUY;
+    OrderType order_type = OrderType::MARKET;
+    OrderStatus status = OrderStatus::PENDING;
+    double quantity = 0.0;
+    double price = 0.0;
+    double filled_quantity = 0.0;
+    // Paper fill model: volume estimated to be resting ahead of this
+    // order at its limit price, consumed by trades before it can fill
+    double queue_ahead = 0.0;
     std::chrono::system_clock::time_point timestamp;
+    
+    double remainingQuantity() const { return quantity - filled_quantity; }
+    const std::string& symbolName() const { return SymbolTable::getInstance().name(symbol_id); }
 };
 
 } // namespace TradingSystem
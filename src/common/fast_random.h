@@ -0,0 +1,56 @@
+#ifndef FAST_RANDOM_H
+#define FAST_RANDOM_H
+
+#include <cstdint>
+#include <limits>
+
+namespace TradingSystem {
+
+// xoshiro256** (Blackman & Vigna): 32 bytes of state, a few shifts and
+// multiplies per draw, and a full-quality 64-bit output. Seeding runs the
+// seed through splitmix64 as the authors recommend, so any seed, 0
+// included, gives a well-mixed state and the same sequence on every run.
+// Satisfies UniformRandomBitGenerator for use with <random> distributions.
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed = 0) { this->seed(seed); }
+
+    void seed(uint64_t seed) {
+        for (auto& word : state) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t operator()() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1) from the top 53 bits
+    double nextDouble() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return std::numeric_limits<uint64_t>::max(); }
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+} // namespace TradingSystem
+
+#endif // FAST_RANDOM_H
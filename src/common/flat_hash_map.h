@@ -0,0 +1,190 @@
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TradingSystem {
+
+// Open-addressing hash map for integer keys (SymbolId, OrderId). Entries
+// live inline in one power-of-two array with linear probing, so a lookup
+// is a multiply, a shift and usually a single cache line; there are no
+// per-entry nodes to allocate. Erase shifts the following run back instead
+// of leaving tombstones. Any insert may rehash and any erase may move
+// entries, so pointers and iterators are invalidated by both.
+template <typename Key, typename Value>
+class FlatHashMap {
+    static_assert(std::is_integral<Key>::value, "FlatHashMap keys must be integers");
+
+public:
+    using value_type = std::pair<Key, Value>;
+
+    explicit FlatHashMap(size_t initial_capacity = 16) {
+        rehash(initial_capacity);
+    }
+
+    template <typename Slot, typename Map>
+    class Iterator {
+    public:
+        Iterator(Map* map, size_t index) : map(map), index(index) { skipEmpty(); }
+
+        Slot& operator*() const { return map->slots[index]; }
+        Slot* operator->() const { return &map->slots[index]; }
+        Iterator& operator++() {
+            ++index;
+            skipEmpty();
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return index == other.index; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+
+    private:
+        void skipEmpty() {
+            while (index < map->slots.size() && !map->used[index]) ++index;
+        }
+
+        Map* map;
+        size_t index;
+    };
+
+    using iterator = Iterator<value_type, FlatHashMap>;
+    using const_iterator = Iterator<const value_type, const FlatHashMap>;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, slots.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, slots.size()); }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return slots.size(); }
+
+    Value* find(Key key) {
+        size_t index;
+        return locate(key, index) ? &slots[index].second : nullptr;
+    }
+
+    const Value* find(Key key) const {
+        size_t index;
+        return locate(key, index) ? &slots[index].second : nullptr;
+    }
+
+    bool contains(Key key) const {
+        size_t index;
+        return locate(key, index);
+    }
+
+    // Existing value, or a default-constructed one inserted for key
+    Value& operator[](Key key) {
+        size_t index;
+        if (locate(key, index)) {
+            return slots[index].second;
+        }
+        if ((count + 1) * 4 > slots.size() * 3) {
+            rehash(slots.size() * 2);
+            locate(key, index);
+        }
+        used[index] = 1;
+        slots[index].first = key;
+        slots[index].second = Value();
+        ++count;
+        return slots[index].second;
+    }
+
+    bool erase(Key key) {
+        size_t hole;
+        if (!locate(key, hole)) {
+            return false;
+        }
+
+        // Backward-shift: pull later entries of the probe run into the hole
+        // whenever their home slot does not lie between the hole and them
+        size_t next = (hole + 1) & mask;
+        while (used[next]) {
+            size_t home = homeOf(slots[next].first);
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                slots[hole] = std::move(slots[next]);
+                hole = next;
+            }
+            next = (next + 1) & mask;
+        }
+        used[hole] = 0;
+        slots[hole].second = Value();
+        --count;
+        return true;
+    }
+
+    void clear() {
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (used[i]) {
+                used[i] = 0;
+                slots[i].second = Value();
+            }
+        }
+        count = 0;
+    }
+
+    // Size the table so n entries fit without rehashing
+    void reserve(size_t n) {
+        if (n * 4 > slots.size() * 3) {
+            rehash(n * 4 / 3 + 1);
+        }
+    }
+
+private:
+    size_t homeOf(Key key) const {
+        // Fibonacci hashing spreads dense or strided ids across the table
+        return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    // True with index at key's slot, or false with index at the free slot
+    // where key would go
+    bool locate(Key key, size_t& index) const {
+        index = homeOf(key);
+        while (used[index]) {
+            if (slots[index].first == key) {
+                return true;
+            }
+            index = (index + 1) & mask;
+        }
+        return false;
+    }
+
+    void rehash(size_t requested) {
+        size_t capacity = 8;
+        unsigned bits = 3;
+        while (capacity < requested) {
+            capacity <<= 1;
+            ++bits;
+        }
+
+        std::vector<value_type> old_slots(capacity);
+        std::vector<uint8_t> old_used(capacity, 0);
+        old_slots.swap(slots);
+        old_used.swap(used);
+        mask = capacity - 1;
+        shift = 64 - bits;
+
+        for (size_t i = 0; i < old_slots.size(); ++i) {
+            if (old_used[i]) {
+                size_t index;
+                locate(old_slots[i].first, index);
+                used[index] = 1;
+                slots[index] = std::move(old_slots[i]);
+            }
+        }
+    }
+
+    std::vector<value_type> slots;
+    std::vector<uint8_t> used;
+    size_t count = 0;
+    size_t mask = 0;
+    unsigned shift = 64;
+};
+
+} // namespace TradingSystem
+
+#endif // FLAT_HASH_MAP_H
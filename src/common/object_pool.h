@@ -0,0 +1,61 @@
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "bounded_queue.h"
+
+namespace TradingSystem {
+
+// Recycling pool for objects whose heap buffer is the expensive part
+// (message strings, scratch vectors). Released objects are cleared but
+// keep their capacity, so once the pool is warm acquire() and release()
+// never reach the allocator. The free list is a lock-free BoundedQueue:
+// an object may be acquired on one thread and released on another.
+// Releasing into a full pool destroys the object, which bounds the pool's
+// footprint by its capacity. T must be movable and provide clear().
+template <typename T>
+class ObjectPool {
+public:
+    using Factory = std::function<T()>;
+
+    explicit ObjectPool(size_t capacity, Factory factory = [] { return T(); }, size_t prefill = 0)
+        : free_list(capacity), factory(std::move(factory)), misses(0) {
+        for (size_t i = 0; i < prefill && free_list.tryPush(this->factory()); ++i) {
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // A recycled object if one is free, otherwise a new one from the factory
+    T acquire() {
+        T object;
+        if (free_list.tryPop(object)) {
+            return object;
+        }
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return factory();
+    }
+
+    void release(T&& object) {
+        object.clear();
+        free_list.tryPush(std::move(object));
+    }
+
+    size_t available() const { return free_list.sizeApprox(); }
+    // Acquires that found the pool empty and had to allocate
+    uint64_t missCount() const { return misses.load(std::memory_order_relaxed); }
+
+private:
+    BoundedQueue<T> free_list;
+    Factory factory;
+    std::atomic<uint64_t> misses;
+};
+
+} // namespace TradingSystem
+
+#endif // OBJECT_POOL_H
@@ -0,0 +1,55 @@
+#include "symbol_table.h"
+#include <stdexcept>
+#include <mutex>
+
+namespace TradingSystem {
+
+namespace {
+const std::string kEmptyName;
+}
+
+SymbolTable::SymbolTable()
+    : names(new std::string[kMaxSymbols]), count(0) {
+}
+
+SymbolId SymbolTable::intern(std::string_view symbol) {
+    SymbolId existing = find(symbol);
+    if (existing != kInvalidSymbolId) {
+        return existing;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    // Another thread may have interned it while we waited for the lock
+    auto it = ids.find(symbol);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    uint32_t id = count.load(std::memory_order_relaxed);
+    if (id >= kMaxSymbols) {
+        throw std::runtime_error("Symbol table full, cannot intern " + std::string(symbol));
+    }
+
+    // Publish the name before the count so lock-free readers see it
+    names[id] = std::string(symbol);
+    ids.emplace(std::string_view(names[id]), id);
+    count.store(id + 1, std::memory_order_release);
+
+    return id;
+}
+
+SymbolId SymbolTable::find(std::string_view symbol) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(symbol);
+    return (it != ids.end()) ? it->second : kInvalidSymbolId;
+}
+
+const std::string& SymbolTable::name(SymbolId id) const {
+    if (id < count.load(std::memory_order_acquire)) {
+        return names[id];
+    }
+    return kEmptyName;
+}
+
+} // namespace TradingSystem
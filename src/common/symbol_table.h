@@ -0,0 +1,56 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <shared_mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace TradingSystem {
+
+using SymbolId = uint32_t;
+constexpr SymbolId kInvalidSymbolId = 0xFFFFFFFFu;
+
+// Process-wide table mapping ticker strings to dense integer IDs.
+// IDs are assigned in interning order and never reused, so they can index
+// flat arrays. Resolving an ID back to its name is lock-free.
+class SymbolTable {
+public:
+    static constexpr SymbolId kMaxSymbols = 4096;
+
+    static SymbolTable& getInstance() {
+        static SymbolTable instance;
+        return instance;
+    }
+
+    SymbolTable();
+
+    // Return the ID for symbol, assigning a new one if needed
+    SymbolId intern(std::string_view symbol);
+
+    // Return the ID for symbol, or kInvalidSymbolId if it was never interned
+    SymbolId find(std::string_view symbol) const;
+
+    // Name for a previously interned ID (empty string for unknown IDs)
+    const std::string& name(SymbolId id) const;
+
+    size_t size() const { return count.load(std::memory_order_acquire); }
+
+private:
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    mutable std::shared_mutex mutex;
+    // Keys view the strings in names, which never move once assigned, so
+    // lookups by string_view need no temporary std::string
+    std::unordered_map<std::string_view, SymbolId> ids;
+    std::unique_ptr<std::string[]> names;
+    std::atomic<uint32_t> count;
+};
+
+} // namespace TradingSystem
+
+#endif // SYMBOL_TABLE_H
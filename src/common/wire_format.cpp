@@ -0,0 +1,258 @@
+#include "wire_format.h"
+#include <cstring>
+
+namespace TradingSystem {
+
+// WireEncoder implementation
+WireEncoder::WireEncoder(SymbolTable& symbols) : symbols(symbols), announced(0) {
+}
+
+void WireEncoder::appendHeader(std::string& out, WireMessageType type, uint32_t count, uint32_t payload_size) {
+    WireHeader header;
+    header.magic = kWireMagic;
+    header.version = kWireVersion;
+    header.type = static_cast<uint16_t>(type);
+    header.count = count;
+    header.payload_size = payload_size;
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void WireEncoder::appendSymbolTable(std::string& out) {
+    size_t total = symbols.size();
+    if (announced >= total) {
+        return;
+    }
+
+    uint32_t payload_size = 0;
+    for (size_t id = announced; id < total; ++id) {
+        payload_size += static_cast<uint32_t>(kSymbolEntryHeaderSize + symbols.name(static_cast<SymbolId>(id)).size());
+    }
+
+    out.reserve(out.size() + kWireHeaderSize + payload_size);
+    appendHeader(out, WireMessageType::SYMBOL_TABLE, static_cast<uint32_t>(total - announced), payload_size);
+
+    for (size_t id = announced; id < total; ++id) {
+        const std::string& name = symbols.name(static_cast<SymbolId>(id));
+        SymbolEntryHeader entry;
+        entry.symbol_id = static_cast<uint32_t>(id);
+        entry.length = static_cast<uint16_t>(name.size());
+        out.append(reinterpret_cast<const char*>(&entry.symbol_id), sizeof(entry.symbol_id));
+        out.append(reinterpret_cast<const char*>(&entry.length), sizeof(entry.length));
+        out.append(name);
+    }
+
+    announced = total;
+}
+
+void WireEncoder::appendMarketData(std::string& out, const MarketData* data, size_t count) {
+    // Intern up front so the symbol frame precedes the records using it
+    std::vector<SymbolId> ids(count);
+    for (size_t i = 0; i < count; ++i) {
+        ids[i] = symbols.intern(data[i].symbol);
+    }
+    appendSymbolTable(out);
+
+    uint32_t payload_size = static_cast<uint32_t>(count * sizeof(MarketDataRecord));
+    size_t offset = out.size() + kWireHeaderSize;
+    appendHeader(out, WireMessageType::MARKET_DATA, static_cast<uint32_t>(count), payload_size);
+    out.resize(offset + payload_size);
+
+    // Fill records in place; the string buffer has no alignment guarantee
+    for (size_t i = 0; i < count; ++i) {
+        MarketDataRecord record;
+        record.symbol_id = ids[i];
+        record.reserved = 0;
+        record.timestamp_ns = toEpochNanos(data[i].timestamp);
+        record.open = data[i].open;
+        record.high = data[i].high;
+        record.low = data[i].low;
+        record.close = data[i].close;
+        record.volume = data[i].volume;
+        std::memcpy(&out[offset + i * sizeof(record)], &record, sizeof(record));
+    }
+}
+
+void WireEncoder::appendTradingSignals(std::string& out, const TradingSignal* signals, size_t count) {
+    std::vector<SymbolId> ids(count);
+    for (size_t i = 0; i < count; ++i) {
+        ids[i] = symbols.intern(signals[i].symbol);
+    }
+    appendSymbolTable(out);
+
+    uint32_t payload_size = static_cast<uint32_t>(count * sizeof(TradingSignalRecord));
+    size_t offset = out.size() + kWireHeaderSize;
+    appendHeader(out, WireMessageType::TRADING_SIGNAL, static_cast<uint32_t>(count), payload_size);
+    out.resize(offset + payload_size);
+
+    for (size_t i = 0; i < count; ++i) {
+        TradingSignalRecord record = {};
+        record.symbol_id = ids[i];
+        record.action = static_cast<uint8_t>(actionToWire(signals[i].action));
+        record.timestamp_ns = toEpochNanos(signals[i].timestamp);
+        record.confidence = signals[i].confidence;
+        record.suggested_position_size = signals[i].suggested_position_size;
+        std::memcpy(&out[offset + i * sizeof(record)], &record, sizeof(record));
+    }
+}
+
+WireAction WireEncoder::actionToWire(SignalAction action) {
+    switch (action) {
+        case SignalAction::BUY: return WireAction::BUY;
+        case SignalAction::SELL: return WireAction::SELL;
+        default: return WireAction::HOLD;
+    }
+}
+
+// WireDecoder implementation
+WireDecoder::WireDecoder(SymbolTable& symbols) : symbols(symbols) {
+}
+
+bool WireDecoder::peekHeader(std::string_view buffer, WireHeader& header) {
+    if (buffer.size() < kWireHeaderSize) {
+        return false;
+    }
+
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (header.magic != kWireMagic || header.version != kWireVersion) {
+        return false;
+    }
+
+    return buffer.size() >= kWireHeaderSize + header.payload_size;
+}
+
+bool WireDecoder::resolve(uint32_t remote_id, SymbolId& local_id) const {
+    if (remote_id >= remote_to_local.size() || remote_to_local[remote_id] == kInvalidSymbolId) {
+        return false;
+    }
+    local_id = remote_to_local[remote_id];
+    return true;
+}
+
+size_t WireDecoder::decodeFrame(std::string_view buffer,
+                                std::vector<MarketData>* market_data,
+                                std::vector<TradingSignal>* signals) {
+    WireHeader header;
+    if (!peekHeader(buffer, header)) {
+        return 0;
+    }
+
+    const char* payload = buffer.data() + kWireHeaderSize;
+    const size_t frame_size = kWireHeaderSize + header.payload_size;
+
+    switch (static_cast<WireMessageType>(header.type)) {
+        case WireMessageType::SYMBOL_TABLE: {
+            size_t pos = 0;
+            for (uint32_t i = 0; i < header.count; ++i) {
+                if (pos + kSymbolEntryHeaderSize > header.payload_size) {
+                    return 0;
+                }
+                uint32_t remote_id;
+                uint16_t length;
+                std::memcpy(&remote_id, payload + pos, sizeof(remote_id));
+                std::memcpy(&length, payload + pos + sizeof(remote_id), sizeof(length));
+                pos += kSymbolEntryHeaderSize;
+                if (pos + length > header.payload_size || remote_id >= SymbolTable::kMaxSymbols) {
+                    return 0;
+                }
+
+                if (remote_id >= remote_to_local.size()) {
+                    remote_to_local.resize(remote_id + 1, kInvalidSymbolId);
+                }
+                remote_to_local[remote_id] = symbols.intern(std::string_view(payload + pos, length));
+                pos += length;
+            }
+            break;
+        }
+
+        case WireMessageType::MARKET_DATA: {
+            if (header.payload_size != header.count * sizeof(MarketDataRecord)) {
+                return 0;
+            }
+            if (!market_data) {
+                break;
+            }
+
+            market_data->reserve(market_data->size() + header.count);
+            for (uint32_t i = 0; i < header.count; ++i) {
+                MarketDataRecord record;
+                std::memcpy(&record, payload + i * sizeof(record), sizeof(record));
+
+                SymbolId local_id;
+                if (!resolve(record.symbol_id, local_id)) {
+                    continue;
+                }
+
+                MarketData data;
+                data.symbol = symbols.name(local_id);
+                data.open = record.open;
+                data.high = record.high;
+                data.low = record.low;
+                data.close = record.close;
+                data.volume = record.volume;
+                data.timestamp = fromEpochNanos(record.timestamp_ns);
+                market_data->push_back(std::move(data));
+            }
+            break;
+        }
+
+        case WireMessageType::TRADING_SIGNAL: {
+            if (header.payload_size != header.count * sizeof(TradingSignalRecord)) {
+                return 0;
+            }
+            if (!signals) {
+                break;
+            }
+
+            signals->reserve(signals->size() + header.count);
+            for (uint32_t i = 0; i < header.count; ++i) {
+                TradingSignalRecord record;
+                std::memcpy(&record, payload + i * sizeof(record), sizeof(record));
+
+                SymbolId local_id;
+                if (!resolve(record.symbol_id, local_id)) {
+                    continue;
+                }
+
+                TradingSignal signal;
+                signal.symbol = symbols.name(local_id);
+                signal.symbol_id = local_id;
+                signal.action = actionFromWire(record.action);
+                signal.confidence = record.confidence;
+                signal.suggested_position_size = record.suggested_position_size;
+                signal.timestamp = fromEpochNanos(record.timestamp_ns);
+                signals->push_back(std::move(signal));
+            }
+            break;
+        }
+
+        default:
+            // Unknown frame types are skipped so newer senders stay readable
+            break;
+    }
+
+    return frame_size;
+}
+
+size_t WireDecoder::decodeAll(std::string_view buffer,
+                              std::vector<MarketData>* market_data,
+                              std::vector<TradingSignal>* signals) {
+    size_t consumed = 0;
+    while (consumed < buffer.size()) {
+        size_t used = decodeFrame(buffer.substr(consumed), market_data, signals);
+        if (used == 0) {
+            break;
+        }
+        consumed += used;
+    }
+    return consumed;
+}
+
+SignalAction WireDecoder::actionFromWire(uint8_t action) {
+    switch (static_cast<WireAction>(action)) {
+        case WireAction::BUY: return SignalAction::BUY;
+        case WireAction::SELL: return SignalAction::SELL;
+        default: return SignalAction::HOLD;
+    }
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,138 @@
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "data_types.h"
+#include "symbol_table.h"
+
+namespace TradingSystem {
+
+// Compact little-endian binary encoding for market data and signals.
+//
+// A stream is a sequence of frames, each one a fixed 16-byte WireHeader
+// followed by payload_size bytes. Records refer to symbols by ID; a
+// SYMBOL_TABLE frame carries the (id, name) pairs and must precede any
+// records that use those IDs. The same layout is decoded on the Python
+// side by wire_format.py, so changes here must be mirrored there.
+
+enum class WireMessageType : uint16_t {
+    SYMBOL_TABLE = 1,
+    MARKET_DATA = 2,
+    TRADING_SIGNAL = 3
+};
+
+struct WireHeader {
+    uint32_t magic;          // kWireMagic
+    uint16_t version;        // kWireVersion
+    uint16_t type;           // WireMessageType
+    uint32_t count;          // Number of records in the payload
+    uint32_t payload_size;   // Bytes following this header
+};
+
+struct MarketDataRecord {
+    uint32_t symbol_id;
+    uint32_t reserved;
+    int64_t timestamp_ns;    // Nanoseconds since the Unix epoch, UTC
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+};
+
+struct TradingSignalRecord {
+    uint32_t symbol_id;
+    uint8_t action;          // WireAction
+    uint8_t reserved[3];
+    int64_t timestamp_ns;
+    double confidence;
+    double suggested_position_size;
+};
+
+// Symbol table entries are packed as [uint32 id][uint16 length][bytes]
+struct SymbolEntryHeader {
+    uint32_t symbol_id;
+    uint16_t length;
+};
+
+enum class WireAction : uint8_t {
+    HOLD = 0,
+    BUY = 1,
+    SELL = 2
+};
+
+constexpr uint32_t kWireMagic = 0x46574D54;  // "TMWF"
+constexpr uint16_t kWireVersion = 1;
+constexpr size_t kWireHeaderSize = 16;
+constexpr size_t kSymbolEntryHeaderSize = 6;
+
+static_assert(sizeof(WireHeader) == kWireHeaderSize, "wire header layout changed");
+static_assert(sizeof(MarketDataRecord) == 56, "market data record layout changed");
+static_assert(sizeof(TradingSignalRecord) == 32, "trading signal record layout changed");
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "wire format assumes a little-endian host");
+
+class WireEncoder {
+public:
+    explicit WireEncoder(SymbolTable& symbols = SymbolTable::getInstance());
+
+    // Append a SYMBOL_TABLE frame for every symbol not yet announced
+    // through this encoder (no-op if there are none)
+    void appendSymbolTable(std::string& out);
+
+    // Append record frames, interning symbols and announcing new ones first
+    void appendMarketData(std::string& out, const MarketData* data, size_t count);
+    void appendMarketData(std::string& out, const std::vector<MarketData>& data) {
+        appendMarketData(out, data.data(), data.size());
+    }
+    void appendTradingSignals(std::string& out, const TradingSignal* signals, size_t count);
+    void appendTradingSignals(std::string& out, const std::vector<TradingSignal>& signals) {
+        appendTradingSignals(out, signals.data(), signals.size());
+    }
+
+    // Forget which symbols were announced, e.g. when a new peer connects
+    void reset() { announced = 0; }
+
+    static WireAction actionToWire(SignalAction action);
+
+private:
+    SymbolTable& symbols;
+    size_t announced;
+
+    static void appendHeader(std::string& out, WireMessageType type, uint32_t count, uint32_t payload_size);
+};
+
+class WireDecoder {
+public:
+    explicit WireDecoder(SymbolTable& symbols = SymbolTable::getInstance());
+
+    // Inspect the next frame; returns false if the buffer holds less than a
+    // full frame or the header is invalid
+    static bool peekHeader(std::string_view buffer, WireHeader& header);
+
+    // Decode one frame from the front of buffer and return the bytes it
+    // consumed (0 on error or incomplete frame). Only the output vector
+    // matching the frame type is appended to.
+    size_t decodeFrame(std::string_view buffer,
+                       std::vector<MarketData>* market_data,
+                       std::vector<TradingSignal>* signals);
+
+    // Decode every complete frame in buffer; returns bytes consumed
+    size_t decodeAll(std::string_view buffer,
+                     std::vector<MarketData>* market_data,
+                     std::vector<TradingSignal>* signals);
+
+    static SignalAction actionFromWire(uint8_t action);
+
+private:
+    SymbolTable& symbols;
+    std::vector<SymbolId> remote_to_local;  // Sender ID -> local ID
+
+    bool resolve(uint32_t remote_id, SymbolId& local_id) const;
+};
+
+} // namespace TradingSystem
+
+#endif // WIRE_FORMAT_H
@@ -0,0 +1,136 @@
+#include "work_stealing_pool.h"
+#include <algorithm>
+
+namespace TradingSystem {
+
+namespace {
+
+// Which pool and deque the current thread works for, so tasks that
+// submit more tasks keep them local
+thread_local const WorkStealingPool* current_pool = nullptr;
+thread_local size_t current_index = 0;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping = true;
+    }
+    wake_cv.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    size_t index = current_pool == this ? current_index
+                                        : next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+    pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1);
+
+    // Taking the lock orders the count above against a worker that is
+    // about to sleep, so the notification cannot be lost
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+    }
+    wake_cv.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    {
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        done_cv.wait(lock, [this] { return pending.load() == 0; });
+    }
+
+    std::lock_guard<std::mutex> lock(error_mutex);
+    if (first_error) {
+        std::exception_ptr error = first_error;
+        first_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    current_pool = this;
+    current_index = index;
+
+    Task task;
+    while (true) {
+        if (takeTask(index, task)) {
+            runTask(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake_cv.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping && queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+bool WorkStealingPool::takeTask(size_t index, Task& task) {
+    if (queued.load() == 0) {
+        return false;
+    }
+
+    // Own deque from the back: the most recent task, likely still warm
+    {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Steal the oldest task of the next non-empty victim
+    for (size_t offset = 1; offset < workers.size(); ++offset) {
+        Worker& victim = *workers[(index + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::runTask(Task& task) {
+    try {
+        task();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!first_error) {
+            first_error = std::current_exception();
+        }
+    }
+    task = nullptr;
+
+    if (pending.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        done_cv.notify_all();
+    }
+}
+
+} // namespace TradingSystem
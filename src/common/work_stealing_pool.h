@@ -0,0 +1,70 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TradingSystem {
+
+// Fixed pool of workers with one task deque each. A worker runs its own
+// deque newest first and, when it runs dry, steals the oldest task from
+// another worker, so uneven tasks (a long series next to short ones)
+// rebalance without a shared queue every task has to pass through.
+// Tasks submitted from inside a task land on the submitting worker's
+// deque; tasks from outside are dealt round-robin.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // 0 = hardware concurrency
+    explicit WorkStealingPool(size_t thread_count = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task);
+
+    // Blocks until every submitted task has finished. Rethrows the first
+    // exception a task threw. Must not be called from inside a task.
+    void wait();
+
+    size_t threadCount() const { return threads.size(); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::atomic<size_t> queued{0};    // sitting in a deque
+    std::atomic<size_t> pending{0};   // submitted and not yet finished
+    std::atomic<size_t> next_worker{0};
+
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;  // workers: a task was queued
+    std::condition_variable done_cv;  // wait(): pending reached zero
+    bool stopping = false;
+
+    std::mutex error_mutex;
+    std::exception_ptr first_error;
+
+    void workerLoop(size_t index);
+    bool takeTask(size_t index, Task& task);
+    void runTask(Task& task);
+};
+
+} // namespace TradingSystem
+
+#endif // WORK_STEALING_POOL_H
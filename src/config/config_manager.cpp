@@ -2,18 +2,169 @@
 #include <iostream>
 #include <algorithm>
 #include <cstdlib>
+#include <cmath>
 
 namespace TradingSystem {
 
+namespace {
+
+using Sections = std::map<std::string, std::map<std::string, std::string>>;
+
+// The whole value must be the number: "1,000" or "5000abc" is an error,
+// not 1 or 5000
+bool parseInt(const std::string& value, int& out) {
+    try {
+        size_t pos = 0;
+        int parsed = std::stoi(value, &pos);
+        if (pos != value.size()) return false;
+        out = parsed;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool parseDouble(const std::string& value, double& out) {
+    try {
+        size_t pos = 0;
+        double parsed = std::stod(value, &pos);
+        if (pos != value.size() || !std::isfinite(parsed)) return false;
+        out = parsed;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+// Lookups over a Sections map that is not (yet) the live one
+class SectionReader {
+public:
+    SectionReader(const Sections& data, std::vector<std::string>& errors) : data(data), errors(errors) {}
+    
+    std::string getString(const std::string& section, const std::string& key, const std::string& default_value) const {
+        auto section_it = data.find(section);
+        if (section_it != data.end()) {
+            auto key_it = section_it->second.find(key);
+            if (key_it != section_it->second.end()) {
+                return key_it->second;
+            }
+        }
+        return default_value;
+    }
+    
+    int getInt(const std::string& section, const std::string& key, int default_value) const {
+        std::string value = getString(section, key, "");
+        int parsed = default_value;
+        if (!value.empty() && !parseInt(value, parsed)) {
+            errors.push_back(section + "." + key + ": '" + value + "' is not an integer");
+            return default_value;
+        }
+        return parsed;
+    }
+    
+    double getDouble(const std::string& section, const std::string& key, double default_value) const {
+        std::string value = getString(section, key, "");
+        double parsed = default_value;
+        if (!value.empty() && !parseDouble(value, parsed)) {
+            errors.push_back(section + "." + key + ": '" + value + "' is not a number");
+            return default_value;
+        }
+        return parsed;
+    }
+    
+    bool getBool(const std::string& section, const std::string& key, bool default_value) const {
+        std::string value = getString(section, key, "");
+        if (value.empty()) return default_value;
+        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+        return (value == "true" || value == "1" || value == "yes" || value == "on");
+    }
+    
+    // min < value <= max, or min <= value <= max with inclusive_min
+    void checkRange(const char* name, double value, double min, double max, bool inclusive_min = false) const {
+        bool ok = (inclusive_min ? value >= min : value > min) && value <= max;
+        if (!ok) {
+            errors.push_back(std::string(name) + " = " + std::to_string(value) + " is outside " +
+                             (inclusive_min ? "[" : "(") + std::to_string(min) + ", " + std::to_string(max) + "]");
+        }
+    }
+    
+private:
+    const Sections& data;
+    std::vector<std::string>& errors;
+};
+
+} // namespace
+
 bool ConfigManager::loadConfig(const std::string& config_file) {
-    // First load environment variables
-    loadEnvironment();
+    bool loaded;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        // First load environment variables
+        readEnvironment(config_data);
+        
+        // Then load from config file
+        loaded = parseIniFile(config_file, config_data);
+        config_path = config_file;
+    }
+    publish();
+    return loaded;
+}
+
+bool ConfigManager::reload() {
+    std::string path;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        path = config_path;
+    }
+    if (path.empty()) {
+        return false;
+    }
     
-    // Then load from config file
-    return parseIniFile(config_file);
+    // Parse outside the lock; readers keep the old values meanwhile
+    Sections fresh;
+    readEnvironment(fresh);
+    if (!parseIniFile(path, fresh)) {
+        return false;
+    }
+    std::vector<std::string> errors;
+    std::shared_ptr<const TradingConfig> next = std::make_shared<const TradingConfig>(parse(fresh, errors));
+    if (!errors.empty()) {
+        for (const auto& error : errors) {
+            std::cerr << "Config reload rejected: " << error << std::endl;
+        }
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> publish_lock(publish_mutex);
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        config_data.swap(fresh);
+    }
+    std::atomic_store(&current, next);
+    return true;
 }
 
-bool ConfigManager::parseIniFile(const std::string& filename) {
+std::shared_ptr<const TradingConfig> ConfigManager::snapshot() const {
+    return std::atomic_load(&current);
+}
+
+void ConfigManager::publish() {
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    std::vector<std::string> errors;
+    std::shared_ptr<const TradingConfig> next;
+    {
+        std::shared_lock<std::shared_mutex> data_lock(mutex);
+        next = std::make_shared<const TradingConfig>(parse(config_data, errors));
+    }
+    // A first load or an explicit set has nothing older to fall back on;
+    // report what was wrong and run with it
+    for (const auto& error : errors) {
+        std::cerr << "Warning: config " << error << std::endl;
+    }
+    std::atomic_store(&current, next);
+}
+
+bool ConfigManager::parseIniFile(const std::string& filename, Sections& into) const {
     std::ifstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Warning: Config file " << filename << " not found" << std::endl;
@@ -43,7 +194,7 @@ bool ConfigManager::parseIniFile(const std::string& filename) {
             std::string key = trim(line.substr(0, eq_pos));
             std::string value = trim(line.substr(eq_pos + 1));
             
-            config_data[current_section][key] = value;
+            into[current_section][key] = value;
         }
     }
     
@@ -52,24 +203,33 @@ bool ConfigManager::parseIniFile(const std::string& filename) {
 }
 
 void ConfigManager::loadEnvironment() {
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        readEnvironment(config_data);
+    }
+    publish();
+}
+
+void ConfigManager::readEnvironment(Sections& into) {
     // Load common environment variables
     const char* api_key = std::getenv("API_KEY");
     if (api_key) {
-        config_data["api"]["key"] = api_key;
+        into["api"]["key"] = api_key;
     }
     
     const char* trading_mode = std::getenv("TRADING_MODE");
     if (trading_mode) {
-        config_data["trading"]["mode"] = trading_mode;
+        into["trading"]["mode"] = trading_mode;
     }
     
     const char* log_level = std::getenv("LOG_LEVEL");
     if (log_level) {
-        config_data["logging"]["level"] = log_level;
+        into["logging"]["level"] = log_level;
     }
 }
 
 std::string ConfigManager::getString(const std::string& section, const std::string& key, const std::string& default_value) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
     auto section_it = config_data.find(section);
     if (section_it != config_data.end()) {
         auto key_it = section_it->second.find(key);
@@ -82,26 +242,22 @@ std::string ConfigManager::getString(const std::string& section, const std::stri
 
 int ConfigManager::getInt(const std::string& section, const std::string& key, int default_value) const {
     std::string value = getString(section, key, "");
-    if (!value.empty()) {
-        try {
-            return std::stoi(value);
-        } catch (...) {
-            std::cerr << "Invalid integer value for " << section << "." << key << std::endl;
-        }
+    int parsed = default_value;
+    if (!value.empty() && !parseInt(value, parsed)) {
+        std::cerr << "Invalid integer value for " << section << "." << key << std::endl;
+        return default_value;
     }
-    return default_value;
+    return parsed;
 }
 
 double ConfigManager::getDouble(const std::string& section, const std::string& key, double default_value) const {
     std::string value = getString(section, key, "");
-    if (!value.empty()) {
-        try {
-            return std::stod(value);
-        } catch (...) {
-            std::cerr << "Invalid double value for " << section << "." << key << std::endl;
-        }
+    double parsed = default_value;
+    if (!value.empty() && !parseDouble(value, parsed)) {
+        std::cerr << "Invalid double value for " << section << "." << key << std::endl;
+        return default_value;
     }
-    return default_value;
+    return parsed;
 }
 
 bool ConfigManager::getBool(const std::string& section, const std::string& key, bool default_value) const {
@@ -114,19 +270,23 @@ bool ConfigManager::getBool(const std::string& section, const std::string& key,
 }
 
 void ConfigManager::setString(const std::string& section, const std::string& key, const std::string& value) {
-    config_data[section][key] = value;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        config_data[section][key] = value;
+    }
+    publish();
 }
 
 void ConfigManager::setInt(const std::string& section, const std::string& key, int value) {
-    config_data[section][key] = std::to_string(value);
+    setString(section, key, std::to_string(value));
 }
 
 void ConfigManager::setDouble(const std::string& section, const std::string& key, double value) {
-    config_data[section][key] = std::to_string(value);
+    setString(section, key, std::to_string(value));
 }
 
 void ConfigManager::setBool(const std::string& section, const std::string& key, bool value) {
-    config_data[section][key] = value ? "true" : "false";
+    setString(section, key, value ? "true" : "false");
 }
 
 bool ConfigManager::saveConfig(const std::string& config_file) {
@@ -136,6 +296,7 @@ bool ConfigManager::saveConfig(const std::string& config_file) {
         return false;
     }
     
+    std::shared_lock<std::shared_mutex> lock(mutex);
     for (const auto& [section, keys] : config_data) {
         file << "[" << section << "]" << std::endl;
         for (const auto& [key, value] : keys) {
@@ -156,10 +317,9 @@ std::string ConfigManager::trim(const std::string& str) const {
     return str.substr(first, (last - first + 1));
 }
 
-// TradingConfig implementation
-TradingConfig TradingConfig::loadFromConfig() {
+TradingConfig ConfigManager::parse(const Sections& data, std::vector<std::string>& errors) {
     TradingConfig config;
-    ConfigManager& cm = ConfigManager::getInstance();
+    SectionReader cm(data, errors);
     
     // API settings
     config.api_key = cm.getString("api", "key", "");
@@ -171,18 +331,38 @@ TradingConfig TradingConfig::loadFromConfig() {
     config.initial_balance = cm.getDouble("trading", "initial_balance", 10000.0);
     config.max_position_size = cm.getDouble("trading", "max_position_size", 5000.0);
     config.max_drawdown = cm.getDouble("trading", "max_drawdown", 0.20);
+    config.engine_shards = cm.getInt("trading", "engine_shards", 2);
     config.stop_loss_percentage = cm.getDouble("trading", "stop_loss_percentage", 0.02);
     config.take_profit_percentage = cm.getDouble("trading", "take_profit_percentage", 0.05);
     
     // Database settings
     config.db_path = cm.getString("database", "path", "trading_system.db");
+    config.db_async_writes = cm.getBool("database", "async_writes", true);
+    config.db_writer_max_lag_ms = cm.getInt("database", "max_lag_ms", 100);
+    config.db_writer_queue_size = cm.getInt("database", "writer_queue_size", 65536);
+    config.db_journal_dir = cm.getString("database", "journal_dir", "");
     
     // IPC settings
     config.ipc_pipe_name = cm.getString("ipc", "pipe_name", "/tmp/trading_system_pipe");
+    config.ipc_transport = cm.getString("ipc", "transport", "pipe");
+    config.ipc_shm_capacity_kb = cm.getInt("ipc", "shm_capacity_kb", 1024);
+    config.ipc_wire_format = cm.getString("ipc", "wire_format", "json");
+    config.ipc_dispatch_workers = cm.getInt("ipc", "dispatch_workers", 2);
+    config.ipc_dispatch_queue_size = cm.getInt("ipc", "dispatch_queue_size", 4096);
     
     // Logging settings
     config.log_level = cm.getString("logging", "level", "INFO");
     config.log_file = cm.getString("logging", "file", "trading_system.log");
+    config.log_async = cm.getBool("logging", "async", true);
+    config.log_overflow = cm.getString("logging", "overflow", "count");
+    config.log_ring_kb = cm.getInt("logging", "ring_kb", 256);
+    
+    // Metrics export
+    config.metrics_enabled = cm.getBool("metrics", "enabled", true);
+    config.metrics_port = cm.getInt("metrics", "port", 0);
+    config.metrics_bind_address = cm.getString("metrics", "bind_address", "127.0.0.1");
+    config.metrics_snapshot_file = cm.getString("metrics", "snapshot_file", "trading_metrics.prom");
+    config.metrics_snapshot_interval_seconds = cm.getInt("metrics", "snapshot_interval", 15);
     
     // Market data settings
     std::string symbols_str = cm.getString("market_data", "symbols", "BTC,ETH,DOGE");
@@ -194,8 +374,40 @@ TradingConfig TradingConfig::loadFromConfig() {
     
     config.data_fetch_interval_seconds = cm.getInt("market_data", "fetch_interval", 60);
     config.analysis_interval_seconds = cm.getInt("market_data", "analysis_interval", 300);
+    config.market_data_history_depth = cm.getInt("market_data", "history_depth", 64);
+    config.indicator_warmup_bars = cm.getInt("market_data", "indicator_warmup_bars", 500);
+    // Bars carry their own start time and the feed serves the previous
+    // session's daily bar, so allow a weekend plus a holiday by default
+    config.max_price_age_seconds = cm.getInt("market_data", "max_price_age", 4 * 86400);
+    config.quote_spread = cm.getDouble("market_data", "quote_spread", 0.0);
+    config.warm_snapshot = cm.getString("market_data", "warm_snapshot", "trading_state.snapshot");
+    
+    // In-process model signals
+    config.model_path = cm.getString("analysis", "model_path", "");
+    config.model_signal_fraction = cm.getDouble("analysis", "signal_fraction", 0.2);
+    
+    // Values a typo could turn into an unbounded or inverted risk check
+    cm.checkRange("trading.initial_balance", config.initial_balance, 0.0, 1e12);
+    cm.checkRange("trading.max_position_size", config.max_position_size, 0.0, 1e12);
+    cm.checkRange("trading.max_drawdown", config.max_drawdown, 0.0, 1.0);
+    cm.checkRange("trading.stop_loss_percentage", config.stop_loss_percentage, 0.0, 1.0);
+    cm.checkRange("trading.take_profit_percentage", config.take_profit_percentage, 0.0, 10.0);
+    cm.checkRange("trading.engine_shards", config.engine_shards, 1.0, 256.0, true);
+    cm.checkRange("market_data.quote_spread", config.quote_spread, 0.0, 0.5, true);
+    cm.checkRange("analysis.signal_fraction", config.model_signal_fraction, 0.0, 0.5);
+    cm.checkRange("metrics.port", config.metrics_port, 0.0, 65535.0, true);
     
     return config;
 }
 
+// TradingConfig implementation
+TradingConfig TradingConfig::loadFromConfig() {
+    std::shared_ptr<const TradingConfig> current = ConfigManager::getInstance().snapshot();
+    if (current) {
+        return *current;
+    }
+    std::vector<std::string> errors;
+    return ConfigManager::parse({}, errors);
+}
+
 } // namespace TradingSystem
\ No newline at end of file
@@ -4,11 +4,21 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <fstream>
 #include <sstream>
 
 namespace TradingSystem {
 
+struct TradingConfig;
+
+// Raw section/key strings behind a reader-writer lock, plus a typed
+// TradingConfig parsed from them and published as an immutable snapshot.
+// Hot paths hold a snapshot (or values copied from one) instead of looking
+// keys up; every load, reload or set publishes a new one, and readers
+// holding the old one keep it until they let go.
 class ConfigManager {
 public:
     static ConfigManager& getInstance() {
@@ -18,6 +28,16 @@ public:
     
     // Load configuration from file
     bool loadConfig(const std::string& config_file = "config.ini");
+    // Re-read the environment and the file last loaded, replacing every
+    // value. The new snapshot is built and checked first: if the file is
+    // unreadable, a number does not parse, or a limit is out of range, the
+    // whole reload is rejected (each problem printed) and the current
+    // values and snapshot stay.
+    bool reload();
+    
+    // Typed values as of the last load, reload or set; null before any.
+    // Never blocks on a reload.
+    std::shared_ptr<const TradingConfig> snapshot() const;
     
     // Get configuration values
     std::string getString(const std::string& section, const std::string& key, const std::string& default_value = "") const;
@@ -38,15 +58,28 @@ public:
     void loadEnvironment();
     
 private:
+    friend struct TradingConfig;
+    using Sections = std::map<std::string, std::map<std::string, std::string>>;
+    
     ConfigManager() = default;
     ~ConfigManager() = default;
     ConfigManager(const ConfigManager&) = delete;
     ConfigManager& operator=(const ConfigManager&) = delete;
     
-    std::map<std::string, std::map<std::string, std::string>> config_data;
+    mutable std::shared_mutex mutex;  // guards config_data and config_path
+    Sections config_data;
+    std::string config_path;
+    std::shared_ptr<const TradingConfig> current;  // atomic_load / atomic_store only
+    std::mutex publish_mutex;  // so a slower publish never replaces a newer one
     
     std::string trim(const std::string& str) const;
-    bool parseIniFile(const std::string& filename);
+    bool parseIniFile(const std::string& filename, Sections& into) const;
+    static void readEnvironment(Sections& into);
+    // Parse config_data into a new TradingConfig and swap it in
+    void publish();
+    // Typed values from data; keys that do not parse keep their default
+    // and add a message to errors, as do values outside a sane range
+    static TradingConfig parse(const Sections& data, std::vector<std::string>& errors);
 };
 
 // Configuration structure for easy access
@@ -61,23 +94,52 @@ struct TradingConfig {
     double initial_balance;
     double max_position_size;
     double max_drawdown;
+    int engine_shards;              // engine worker threads, symbols hashed across them
     double stop_loss_percentage;
     double take_profit_percentage;
     
     // Database settings
     std::string db_path;
+    bool db_async_writes;
+    int db_writer_max_lag_ms;
+    int db_writer_queue_size;
+    std::string db_journal_dir;     // bar journal directory; empty keeps bars in SQLite
     
     // IPC settings
     std::string ipc_pipe_name;
+    std::string ipc_transport;  // "pipe" or "shm"
+    int ipc_shm_capacity_kb;
+    std::string ipc_wire_format;    // analyzer replies: "json" or "binary" (shm transport only)
+    int ipc_dispatch_workers;       // threads handling Python messages, sharded by symbol
+    int ipc_dispatch_queue_size;    // per-worker bound before the reader blocks
     
     // Logging settings
     std::string log_level;
     std::string log_file;
+    bool log_async;                 // format and write on a background thread
+    std::string log_overflow;       // "drop", "block" or "count" when a ring is full
+    int log_ring_kb;                // per-thread record ring
+    
+    // Metrics export
+    bool metrics_enabled;
+    int metrics_port;                   // Prometheus text endpoint, 0 = off
+    std::string metrics_bind_address;
+    std::string metrics_snapshot_file;  // periodic snapshot, empty = off
+    int metrics_snapshot_interval_seconds;
     
     // Market data settings
     std::vector<std::string> symbols;
     int data_fetch_interval_seconds;
     int analysis_interval_seconds;
+    int market_data_history_depth;  // recent bars kept in memory per symbol
+    int indicator_warmup_bars;      // stored bars replayed into the indicator engine
+    int max_price_age_seconds;      // bars that started longer ago are not traded on, 0 = no limit
+    double quote_spread;            // bid-ask spread assumed around the last close
+    std::string warm_snapshot;      // indicator state saved at shutdown, empty = always warm from the db
+    
+    // In-process model signals
+    std::string model_path;         // exported StockRankingNN weights, empty = Python analyzer only
+    double model_signal_fraction;   // share of ranked symbols signalled on each side
     
     // Load from ConfigManager
     static TradingConfig loadFromConfig();
@@ -0,0 +1,110 @@
+#include "config_watcher.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace TradingSystem {
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+bool ConfigWatcher::start(EventLoop& event_loop, const std::string& config_file, Callback callback) {
+    stop();
+    loop = &event_loop;
+    on_change = std::move(callback);
+
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd != -1 && !loop->watchFd(fd, EPOLLIN, [this](uint32_t) { drainTrigger(); })) {
+        close(fd);
+        fd = -1;
+    }
+    trigger_fd.store(fd);
+
+    size_t slash = config_file.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : config_file.substr(0, slash == 0 ? 1 : slash);
+    file_name = slash == std::string::npos ? config_file : config_file.substr(slash + 1);
+
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd == -1 ||
+        inotify_add_watch(inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1 ||
+        !loop->watchFd(inotify_fd, EPOLLIN, [this](uint32_t) { drainInotify(); })) {
+        std::cerr << "Not watching " << config_file << " for changes: " << strerror(errno) << std::endl;
+        if (inotify_fd != -1) {
+            close(inotify_fd);
+            inotify_fd = -1;
+        }
+    }
+
+    return trigger_fd.load() != -1 || inotify_fd != -1;
+}
+
+void ConfigWatcher::stop() {
+    if (inotify_fd != -1) {
+        if (loop) loop->unwatchFd(inotify_fd);
+        close(inotify_fd);
+        inotify_fd = -1;
+    }
+    int fd = trigger_fd.exchange(-1);
+    if (fd != -1) {
+        if (loop) loop->unwatchFd(fd);
+        close(fd);
+    }
+}
+
+void ConfigWatcher::trigger() {
+    int fd = trigger_fd.load();
+    if (fd != -1) {
+        uint64_t one = 1;
+        ssize_t ignored = write(fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void ConfigWatcher::drainInotify() {
+    alignas(inotify_event) char buffer[4096];
+    bool changed = false;
+    for (;;) {
+        ssize_t n = read(inotify_fd, buffer, sizeof(buffer));
+        if (n <= 0) {
+            break;
+        }
+        for (ssize_t offset = 0; offset < n;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0 && file_name == event->name) {
+                changed = true;
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+    if (changed) {
+        schedule();
+    }
+}
+
+void ConfigWatcher::drainTrigger() {
+    uint64_t count;
+    if (read(trigger_fd.load(), &count, sizeof(count)) > 0) {
+        schedule();
+    }
+}
+
+void ConfigWatcher::schedule() {
+    if (pending) {
+        return;
+    }
+    pending = true;
+    loop->addTimer(kSettleMs, 0, [this] {
+        pending = false;
+        if (on_change) {
+            on_change();
+        }
+    });
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,51 @@
+#ifndef CONFIG_WATCHER_H
+#define CONFIG_WATCHER_H
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include "../core/event_loop.h"
+
+namespace TradingSystem {
+
+// Calls back on the event loop thread when the config file changes or a
+// reload is requested (SIGHUP). The file's directory is watched with
+// inotify, since editors and deploy tools usually replace the file rather
+// than write it in place; a burst of events within kSettleMs is one reload.
+class ConfigWatcher {
+public:
+    using Callback = std::function<void()>;
+    static constexpr int kSettleMs = 100;
+
+    ConfigWatcher() = default;
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    // Call before loop.run() or from the loop thread. Without inotify the
+    // file is not watched but trigger() still works; false only if
+    // neither is available.
+    bool start(EventLoop& loop, const std::string& config_file, Callback on_change);
+    void stop();
+
+    // Request a reload as if the file had changed. Async-signal-safe (one
+    // write(2)), so a SIGHUP handler may call it.
+    void trigger();
+
+private:
+    void drainInotify();
+    void drainTrigger();
+    void schedule();
+
+    EventLoop* loop = nullptr;
+    Callback on_change;
+    std::string file_name;
+    int inotify_fd = -1;
+    std::atomic<int> trigger_fd{-1};  // read by trigger() in signal handlers
+    bool pending = false;  // loop thread only
+};
+
+} // namespace TradingSystem
+
+#endif // CONFIG_WATCHER_H
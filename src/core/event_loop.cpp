@@ -0,0 +1,190 @@
+#include "event_loop.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace TradingSystem {
+
+namespace {
+
+constexpr int kMaxEvents = 64;
+
+itimerspec toTimerSpec(int delay_ms, int interval_ms) {
+    itimerspec spec{};
+    // A zero it_value disarms the timer, so "now" becomes one nanosecond
+    long delay_ns = delay_ms > 0 ? static_cast<long>(delay_ms % 1000) * 1000000L : 1;
+    spec.it_value.tv_sec = delay_ms > 0 ? delay_ms / 1000 : 0;
+    spec.it_value.tv_nsec = delay_ns;
+    spec.it_interval.tv_sec = interval_ms / 1000;
+    spec.it_interval.tv_nsec = static_cast<long>(interval_ms % 1000) * 1000000L;
+    return spec;
+}
+
+} // namespace
+
+EventLoop::EventLoop()
+    : epoll_fd(epoll_create1(EPOLL_CLOEXEC)),
+      wake_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      stopping(false),
+      wake_pending(false) {
+    if (epoll_fd < 0 || wake_fd < 0) {
+        std::cerr << "Failed to create event loop: " << strerror(errno) << std::endl;
+        return;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev) < 0) {
+        std::cerr << "Failed to watch event loop wakeup fd: " << strerror(errno) << std::endl;
+    }
+}
+
+EventLoop::~EventLoop() {
+    for (const auto& timer : timers) {
+        ::close(timer.first);
+    }
+    if (wake_fd >= 0) ::close(wake_fd);
+    if (epoll_fd >= 0) ::close(epoll_fd);
+}
+
+void EventLoop::run() {
+    if (!isValid()) return;
+
+    epoll_event events[kMaxEvents];
+    while (!stopping.load(std::memory_order_acquire)) {
+        int n = epoll_wait(epoll_fd, events, kMaxEvents, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "epoll_wait failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < n && !stopping.load(std::memory_order_acquire); ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd) {
+                uint64_t value;
+                while (::read(wake_fd, &value, sizeof(value)) > 0) {}
+                drainPosted();
+            } else if (timers.count(fd)) {
+                dispatchTimer(fd);
+            } else {
+                auto it = watched.find(fd);
+                if (it != watched.end()) {
+                    // Copy so the callback may unwatch itself
+                    auto callback = it->second;
+                    callback(events[i].events);
+                }
+            }
+        }
+    }
+}
+
+void EventLoop::stop() {
+    stopping.store(true, std::memory_order_release);
+    uint64_t one = 1;
+    ssize_t ignored = ::write(wake_fd, &one, sizeof(one));
+    (void)ignored;
+}
+
+void EventLoop::post(Callback callback) {
+    {
+        std::lock_guard<std::mutex> lock(posted_mutex);
+        posted.push_back(std::move(callback));
+    }
+    // One eventfd write per batch the loop has not picked up yet
+    if (!wake_pending.exchange(true, std::memory_order_acq_rel)) {
+        uint64_t one = 1;
+        ssize_t ignored = ::write(wake_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void EventLoop::drainPosted() {
+    std::vector<Callback> batch;
+    {
+        std::lock_guard<std::mutex> lock(posted_mutex);
+        wake_pending.store(false, std::memory_order_release);
+        batch.swap(posted);
+    }
+    for (auto& callback : batch) {
+        if (stopping.load(std::memory_order_acquire)) break;
+        callback();
+    }
+}
+
+EventLoop::TimerId EventLoop::addTimer(int delay_ms, int interval_ms, Callback callback) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Failed to create timer: " << strerror(errno) << std::endl;
+        return -1;
+    }
+
+    itimerspec spec = toTimerSpec(delay_ms, interval_ms);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (timerfd_settime(fd, 0, &spec, nullptr) < 0 ||
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        std::cerr << "Failed to arm timer: " << strerror(errno) << std::endl;
+        ::close(fd);
+        return -1;
+    }
+
+    timers[fd] = TimerEntry{std::move(callback), interval_ms > 0};
+    return fd;
+}
+
+bool EventLoop::cancelTimer(TimerId timer) {
+    auto it = timers.find(timer);
+    if (it == timers.end()) return false;
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, timer, nullptr);
+    ::close(timer);
+    timers.erase(it);
+    return true;
+}
+
+void EventLoop::dispatchTimer(int fd) {
+    // Expirations are coalesced: a slow callback does not queue up repeats
+    uint64_t expirations;
+    if (::read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return;
+    }
+
+    auto it = timers.find(fd);
+    if (it == timers.end()) return;
+    bool repeating = it->second.repeating;
+    Callback callback = it->second.callback;
+    if (!repeating) {
+        cancelTimer(fd);
+    }
+    callback();
+}
+
+bool EventLoop::watchFd(int fd, uint32_t events, std::function<void(uint32_t)> callback) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    int op = watched.count(fd) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(epoll_fd, op, fd, &ev) < 0) {
+        std::cerr << "Failed to watch fd " << fd << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    watched[fd] = std::move(callback);
+    return true;
+}
+
+bool EventLoop::unwatchFd(int fd) {
+    auto it = watched.find(fd);
+    if (it == watched.end()) return false;
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    watched.erase(it);
+    return true;
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,72 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace TradingSystem {
+
+// Single-threaded reactor over epoll. Timers are timerfds, cross-thread
+// work arrives through post() and one eventfd, and file descriptors can be
+// watched directly. Every callback runs on the thread inside run(), so the
+// state they touch needs no further locking against each other.
+class EventLoop {
+public:
+    using Callback = std::function<void()>;
+    using TimerId = int;  // the timerfd; -1 on failure
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    bool isValid() const { return epoll_fd >= 0 && wake_fd >= 0; }
+
+    // Dispatch events until stop(); returns immediately if invalid
+    void run();
+
+    // Ask run() to return after the current callback. Safe from any thread
+    // and from signal handlers (one atomic store and one write(2)).
+    void stop();
+    bool isStopping() const { return stopping.load(std::memory_order_acquire); }
+
+    // Run callback on the loop thread. Safe from any thread.
+    void post(Callback callback);
+
+    // Timers and watches are set up before run() or from loop callbacks.
+    // Fire after delay_ms, then every interval_ms (0 = once)
+    TimerId addTimer(int delay_ms, int interval_ms, Callback callback);
+    bool cancelTimer(TimerId timer);
+
+    // Watch a file descriptor for EPOLLIN/EPOLLOUT; the loop does not own it
+    bool watchFd(int fd, uint32_t events, std::function<void(uint32_t)> callback);
+    bool unwatchFd(int fd);
+
+private:
+    void drainPosted();
+    void dispatchTimer(int fd);
+
+    int epoll_fd;
+    int wake_fd;
+    std::atomic<bool> stopping;
+    std::atomic<bool> wake_pending;
+
+    std::mutex posted_mutex;
+    std::vector<Callback> posted;
+
+    struct TimerEntry {
+        Callback callback;
+        bool repeating;
+    };
+    std::unordered_map<int, TimerEntry> timers;
+    std::unordered_map<int, std::function<void(uint32_t)>> watched;
+};
+
+} // namespace TradingSystem
+
+#endif // EVENT_LOOP_H
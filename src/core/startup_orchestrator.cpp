@@ -0,0 +1,84 @@
+#include "startup_orchestrator.h"
+#include <chrono>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace TradingSystem {
+
+StartupOrchestrator::StepId StartupOrchestrator::add(const std::string& name, Step step,
+                                                     std::vector<StepId> depends_on) {
+    StepId id = steps.size();
+    for (StepId dependency : depends_on) {
+        if (dependency >= id) {
+            throw std::invalid_argument("Startup step " + name + " depends on a step not yet added");
+        }
+    }
+    steps.push_back(Entry{std::move(step), std::move(depends_on)});
+    Timing timing;
+    timing.name = name;
+    results.push_back(timing);
+    return id;
+}
+
+bool StartupOrchestrator::run() {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point started = Clock::now();
+    auto elapsedMs = [started](Clock::time_point at) {
+        return std::chrono::duration<double, std::milli>(at - started).count();
+    };
+
+    std::vector<std::promise<bool>> done(steps.size());
+    std::vector<std::shared_future<bool>> outcomes;
+    outcomes.reserve(steps.size());
+    for (auto& promise : done) {
+        outcomes.push_back(promise.get_future().share());
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(steps.size());
+    for (StepId id = 0; id < steps.size(); ++id) {
+        threads.emplace_back([&, id] {
+            Timing& timing = results[id];
+            timing.ran = false;
+            timing.ok = false;
+            for (StepId dependency : steps[id].depends_on) {
+                if (!outcomes[dependency].get()) {
+                    done[id].set_value(false);
+                    return;
+                }
+            }
+
+            Clock::time_point begin = Clock::now();
+            bool ok = false;
+            try {
+                ok = steps[id].step();
+            } catch (const std::exception& e) {
+                std::cerr << "Startup step " << timing.name << " threw: " << e.what() << std::endl;
+            } catch (...) {
+                std::cerr << "Startup step " << timing.name << " threw" << std::endl;
+            }
+            Clock::time_point end = Clock::now();
+            timing.ran = true;
+            timing.ok = ok;
+            timing.start_ms = elapsedMs(begin);
+            timing.duration_ms = std::chrono::duration<double, std::milli>(end - begin).count();
+            done[id].set_value(ok);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    total_ms = elapsedMs(Clock::now());
+
+    for (const auto& timing : results) {
+        if (!timing.ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace TradingSystem
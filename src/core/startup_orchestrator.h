@@ -0,0 +1,51 @@
+#ifndef STARTUP_ORCHESTRATOR_H
+#define STARTUP_ORCHESTRATOR_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace TradingSystem {
+
+// Runs initialization steps concurrently, each on its own thread as soon
+// as the steps it depends on have succeeded. A step that fails (returns
+// false or throws) skips everything that depends on it; the others still
+// run. Steps that share state with each other must say so as a dependency.
+class StartupOrchestrator {
+public:
+    using StepId = size_t;
+    using Step = std::function<bool()>;
+
+    struct Timing {
+        std::string name;
+        bool ran = false;        // false = skipped after a dependency failed
+        bool ok = false;
+        double start_ms = 0.0;   // from the start of run()
+        double duration_ms = 0.0;
+    };
+
+    // Dependencies must already have been added
+    StepId add(const std::string& name, Step step, std::vector<StepId> depends_on = {});
+
+    // Run every step and wait for all of them; true if all succeeded
+    bool run();
+
+    // Per-step results of the last run(), in the order added
+    const std::vector<Timing>& timings() const { return results; }
+    double totalMs() const { return total_ms; }
+
+private:
+    struct Entry {
+        Step step;
+        std::vector<StepId> depends_on;
+    };
+
+    std::vector<Entry> steps;
+    std::vector<Timing> results;
+    double total_ms = 0.0;
+};
+
+} // namespace TradingSystem
+
+#endif // STARTUP_ORCHESTRATOR_H
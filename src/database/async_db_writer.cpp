@@ -0,0 +1,218 @@
+#include "async_db_writer.h"
+#include "../metrics/metrics_registry.h"
+#include "../common/flat_hash_map.h"
+#include <iostream>
+#include <chrono>
+
+namespace TradingSystem {
+
+AsyncDbWriter::AsyncDbWriter(std::shared_ptr<DatabaseManager> db_manager,
+                             size_t queue_capacity,
+                             int max_lag_ms,
+                             size_t max_batch_size)
+    : db_manager(db_manager), queue(queue_capacity),
+      max_lag_ms(max_lag_ms), max_batch_size(max_batch_size),
+      running(false), accepting(false), enqueued(0), committed(0), coalesced(0),
+      flush_requested(false) {
+}
+
+AsyncDbWriter::~AsyncDbWriter() {
+    stop();
+}
+
+void AsyncDbWriter::start() {
+    if (running) return;
+
+    running = true;
+    accepting = true;
+    writer_thread = std::thread(&AsyncDbWriter::writerLoop, this);
+}
+
+void AsyncDbWriter::stop() {
+    if (!running) return;
+
+    // Stop accepting, then let the writer drain what is already queued
+    accepting = false;
+    flush();
+
+    running = false;
+    wake_cv.notify_one();
+    if (writer_thread.joinable()) {
+        writer_thread.join();
+    }
+}
+
+bool AsyncDbWriter::enqueue(DbMutation mutation) {
+    if (!accepting.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // Backpressure instead of dropping: persistence must not lose orders
+    while (!queue.tryPush(std::move(mutation))) {
+        wake_cv.notify_one();
+        std::this_thread::yield();
+    }
+    enqueued.fetch_add(1, std::memory_order_release);
+
+    // Wake the writer early once a full batch is waiting; otherwise its
+    // lag timer picks the mutation up
+    if (queue.sizeApprox() >= max_batch_size) {
+        wake_cv.notify_one();
+    }
+    return true;
+}
+
+bool AsyncDbWriter::insertMarketData(const MarketData& data) {
+    DbMutation mutation;
+    mutation.type = DbMutation::Type::INSERT_MARKET_DATA;
+    mutation.payload = data;
+    return enqueue(std::move(mutation));
+}
+
+bool AsyncDbWriter::insertTradingSignal(const TradingSignal& signal) {
+    DbMutation mutation;
+    mutation.type = DbMutation::Type::INSERT_TRADING_SIGNAL;
+    mutation.payload = signal;
+    return enqueue(std::move(mutation));
+}
+
+bool AsyncDbWriter::insertPosition(const Position& position) {
+    DbMutation mutation;
+    mutation.type = DbMutation::Type::INSERT_POSITION;
+    mutation.payload = position;
+    return enqueue(std::move(mutation));
+}
+
+bool AsyncDbWriter::updatePosition(const Position& position) {
+    DbMutation mutation;
+    mutation.type = DbMutation::Type::UPDATE_POSITION;
+    mutation.payload = position;
+    return enqueue(std::move(mutation));
+}
+
+bool AsyncDbWriter::insertOrder(const Order& order) {
+    DbMutation mutation;
+    mutation.type = DbMutation::Type::INSERT_ORDER;
+    mutation.payload = order;
+    return enqueue(std::move(mutation));
+}
+
+bool AsyncDbWriter::updateOrderStatus(OrderId order_id, OrderStatus status) {
+    DbMutation mutation;
+    mutation.type = DbMutation::Type::UPDATE_ORDER_STATUS;
+    mutation.payload = OrderStatusUpdate{order_id, status};
+    return enqueue(std::move(mutation));
+}
+
+bool AsyncDbWriter::flush(int timeout_ms) {
+    if (!running) return true;
+
+    uint64_t target = enqueued.load(std::memory_order_acquire);
+    flush_requested = true;
+    wake_cv.notify_one();
+
+    std::unique_lock<std::mutex> lock(flush_mutex);
+    return flush_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this, target] {
+        return committed.load(std::memory_order_acquire) >= target;
+    });
+}
+
+void AsyncDbWriter::writerLoop() {
+    std::vector<DbMutation> batch;
+    batch.reserve(max_batch_size);
+
+    while (running || queue.sizeApprox() > 0) {
+        if (drainBatch(batch) == 0) {
+            // Nothing queued: sleep until the lag deadline or an early wakeup
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake_cv.wait_for(lock, std::chrono::milliseconds(max_lag_ms), [this] {
+                return !running || flush_requested.load() || queue.sizeApprox() >= max_batch_size;
+            });
+            flush_requested = false;
+
+            // Wake flushers even if the queue was already empty
+            std::lock_guard<std::mutex> flush_lock(flush_mutex);
+            flush_cv.notify_all();
+            continue;
+        }
+
+        commitBatch(batch);
+        batch.clear();
+    }
+
+    std::lock_guard<std::mutex> flush_lock(flush_mutex);
+    flush_cv.notify_all();
+}
+
+size_t AsyncDbWriter::drainBatch(std::vector<DbMutation>& batch) {
+    DbMutation mutation;
+    while (batch.size() < max_batch_size && queue.tryPop(mutation)) {
+        batch.push_back(std::move(mutation));
+    }
+    return batch.size();
+}
+
+void AsyncDbWriter::commitBatch(std::vector<DbMutation>& batch) {
+    METRIC_SCOPE("DbCommitBatch");
+    
+    // Each UPDATE_POSITION carries the full position state, so only the
+    // last one per symbol in the batch needs to reach SQLite
+    FlatHashMap<SymbolId, size_t> last_update(batch.size() * 2);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (batch[i].type == DbMutation::Type::UPDATE_POSITION) {
+            last_update[std::get<Position>(batch[i].payload).symbol_id] = i;
+        }
+    }
+
+    uint64_t skipped = 0;
+    {
+        DatabaseManager::Transaction tx(*db_manager);
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const DbMutation& mutation = batch[i];
+            if (mutation.type == DbMutation::Type::UPDATE_POSITION &&
+                *last_update.find(std::get<Position>(mutation.payload).symbol_id) != i) {
+                ++skipped;
+                continue;
+            }
+            apply(mutation);
+        }
+
+        if (!tx.commit()) {
+            std::cerr << "Failed to commit persistence batch of " << batch.size() << " mutations" << std::endl;
+        }
+    }
+
+    coalesced.fetch_add(skipped, std::memory_order_relaxed);
+    committed.fetch_add(batch.size(), std::memory_order_release);
+
+    std::lock_guard<std::mutex> flush_lock(flush_mutex);
+    flush_cv.notify_all();
+}
+
+void AsyncDbWriter::apply(const DbMutation& mutation) {
+    switch (mutation.type) {
+        case DbMutation::Type::INSERT_MARKET_DATA:
+            db_manager->insertMarketData(std::get<MarketData>(mutation.payload));
+            break;
+        case DbMutation::Type::INSERT_TRADING_SIGNAL:
+            db_manager->insertTradingSignal(std::get<TradingSignal>(mutation.payload));
+            break;
+        case DbMutation::Type::INSERT_POSITION:
+            db_manager->insertPosition(std::get<Position>(mutation.payload));
+            break;
+        case DbMutation::Type::UPDATE_POSITION:
+            db_manager->updatePosition(std::get<Position>(mutation.payload));
+            break;
+        case DbMutation::Type::INSERT_ORDER:
+            db_manager->insertOrder(std::get<Order>(mutation.payload));
+            break;
+        case DbMutation::Type::UPDATE_ORDER_STATUS: {
+            const auto& update = std::get<OrderStatusUpdate>(mutation.payload);
+            db_manager->updateOrderStatus(update.order_id, update.status);
+            break;
+        }
+    }
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,105 @@
+#ifndef ASYNC_DB_WRITER_H
+#define ASYNC_DB_WRITER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <variant>
+#include "database_manager.h"
+#include "../common/bounded_queue.h"
+#include "../common/data_types.h"
+
+namespace TradingSystem {
+
+struct OrderStatusUpdate {
+    OrderId order_id;
+    OrderStatus status;
+};
+
+// One deferred write against DatabaseManager
+struct DbMutation {
+    enum class Type {
+        INSERT_MARKET_DATA,
+        INSERT_TRADING_SIGNAL,
+        INSERT_POSITION,
+        UPDATE_POSITION,
+        INSERT_ORDER,
+        UPDATE_ORDER_STATUS
+    };
+
+    Type type = Type::INSERT_MARKET_DATA;
+    std::variant<MarketData, TradingSignal, Position, Order, OrderStatusUpdate> payload;
+};
+
+// Write-behind persistence stage. Producers (the engine, the fetch loop)
+// push typed mutations into a lock-free queue and return immediately; a
+// dedicated writer thread drains it, drops position updates superseded
+// later in the same batch, and commits each batch in one transaction.
+// A mutation is committed at most max_lag_ms after it was enqueued (plus
+// the commit itself), and flush() waits for everything enqueued so far.
+class AsyncDbWriter {
+public:
+    AsyncDbWriter(std::shared_ptr<DatabaseManager> db_manager,
+                  size_t queue_capacity = 65536,
+                  int max_lag_ms = 100,
+                  size_t max_batch_size = 1024);
+    ~AsyncDbWriter();
+
+    AsyncDbWriter(const AsyncDbWriter&) = delete;
+    AsyncDbWriter& operator=(const AsyncDbWriter&) = delete;
+
+    void start();
+    // Flush outstanding mutations and stop the writer thread
+    void stop();
+
+    // Enqueue a mutation. Never drops: if the queue is full the caller
+    // yields until the writer catches up. Returns false once stopped.
+    bool enqueue(DbMutation mutation);
+
+    // Typed convenience wrappers
+    bool insertMarketData(const MarketData& data);
+    bool insertTradingSignal(const TradingSignal& signal);
+    bool insertPosition(const Position& position);
+    bool updatePosition(const Position& position);
+    bool insertOrder(const Order& order);
+    bool updateOrderStatus(OrderId order_id, OrderStatus status);
+
+    // Block until every mutation enqueued before this call is committed
+    bool flush(int timeout_ms = 5000);
+
+    size_t queueDepth() const { return queue.sizeApprox(); }
+    uint64_t committedCount() const { return committed.load(std::memory_order_acquire); }
+    uint64_t coalescedCount() const { return coalesced.load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<DatabaseManager> db_manager;
+    BoundedQueue<DbMutation> queue;
+    int max_lag_ms;
+    size_t max_batch_size;
+
+    std::thread writer_thread;
+    std::atomic<bool> running;
+    std::atomic<bool> accepting;
+    std::atomic<uint64_t> enqueued;
+    std::atomic<uint64_t> committed;
+    std::atomic<uint64_t> coalesced;
+    std::atomic<bool> flush_requested;
+
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    std::mutex flush_mutex;
+    std::condition_variable flush_cv;
+
+    void writerLoop();
+    size_t drainBatch(std::vector<DbMutation>& batch);
+    void commitBatch(std::vector<DbMutation>& batch);
+    void apply(const DbMutation& mutation);
+};
+
+} // namespace TradingSystem
+
+#endif // ASYNC_DB_WRITER_H
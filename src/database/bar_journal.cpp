@@ -0,0 +1,349 @@
+#include "bar_journal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace TradingSystem {
+
+struct BarJournal::Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint64_t record_count;
+    char symbol[48];
+};
+
+static_assert(sizeof(BarJournal::Record) == 48, "Record layout");
+
+struct BarJournal::Stream {
+    std::string path;
+    int fd = -1;
+    char* base = nullptr;
+    size_t capacity = 0;  // records the mapping can hold
+    size_t count = 0;     // records committed
+    std::vector<int64_t> sparse;  // timestamp of every kIndexStride-th record
+
+    Header* header() const { return reinterpret_cast<Header*>(base); }
+    Record* records() const { return reinterpret_cast<Record*>(base + kHeaderSize); }
+    size_t mappedBytes() const { return kHeaderSize + capacity * sizeof(Record); }
+};
+
+namespace {
+
+int64_t toNanos(const std::chrono::system_clock::time_point& tp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+} // namespace
+
+BarJournal::BarJournal(std::string directory)
+    : root(std::move(directory)), opened(false) {
+    static_assert(sizeof(Header) == kHeaderSize, "Header layout");
+}
+
+BarJournal::~BarJournal() {
+    close();
+}
+
+bool BarJournal::open() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (opened) {
+        return true;
+    }
+    if (::mkdir(root.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "Failed to create bar journal directory " << root << ": "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+    opened = true;
+    return true;
+}
+
+void BarJournal::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : streams) {
+        closeStream(*entry.second);
+    }
+    streams.clear();
+    opened = false;
+}
+
+std::string BarJournal::fileName(const std::string& symbol) {
+    std::string name = symbol;
+    for (char& c : name) {
+        bool safe = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+                    (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.';
+        if (!safe) c = '_';
+    }
+    return name + ".journal";
+}
+
+BarJournal::Stream* BarJournal::stream(const std::string& symbol, bool create) {
+    auto it = streams.find(symbol);
+    if (it != streams.end()) {
+        return it->second.get();
+    }
+    if (!opened) {
+        return nullptr;
+    }
+
+    auto opened_stream = std::make_unique<Stream>();
+    if (!openStream(*opened_stream, symbol, create)) {
+        return nullptr;
+    }
+    Stream* result = opened_stream.get();
+    streams.emplace(symbol, std::move(opened_stream));
+    return result;
+}
+
+bool BarJournal::openStream(Stream& s, const std::string& symbol, bool create) {
+    s.path = root + "/" + fileName(symbol);
+    s.fd = ::open(s.path.c_str(), O_RDWR | (create ? O_CREAT : 0), 0644);
+    if (s.fd == -1) {
+        if (create || errno != ENOENT) {
+            std::cerr << "Failed to open " << s.path << ": " << strerror(errno) << std::endl;
+        }
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(s.fd, &st) != 0) {
+        std::cerr << "Failed to stat " << s.path << ": " << strerror(errno) << std::endl;
+        closeStream(s);
+        return false;
+    }
+
+    size_t file_size = static_cast<size_t>(st.st_size);
+    if (file_size == 0) {
+        if (!grow(s, kGrowRecords)) {
+            closeStream(s);
+            return false;
+        }
+        Header* header = s.header();
+        header->magic = kFileMagic;
+        header->version = kFileVersion;
+        header->record_size = sizeof(Record);
+        header->record_count = 0;
+        std::strncpy(header->symbol, symbol.c_str(), sizeof(header->symbol) - 1);
+        return true;
+    }
+
+    if (file_size < kHeaderSize) {
+        std::cerr << s.path << ": truncated journal header" << std::endl;
+        closeStream(s);
+        return false;
+    }
+    // Check the header before touching the file so a foreign one is left alone
+    Header header;
+    if (pread(s.fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        header.magic != kFileMagic || header.version != kFileVersion ||
+        header.record_size != sizeof(Record)) {
+        std::cerr << s.path << ": not a version " << kFileVersion << " bar journal" << std::endl;
+        closeStream(s);
+        return false;
+    }
+    std::string stored(header.symbol, strnlen(header.symbol, sizeof(header.symbol)));
+    if (stored != symbol) {
+        std::cerr << s.path << ": holds " << stored << ", not " << symbol << std::endl;
+        closeStream(s);
+        return false;
+    }
+
+    size_t on_disk = (file_size - kHeaderSize) / sizeof(Record);
+    if (!grow(s, on_disk)) {
+        closeStream(s);
+        return false;
+    }
+
+    s.count = std::min<size_t>(header.record_count, on_disk);
+    const Record* records = s.records();
+    for (size_t i = 0; i < s.count; i += kIndexStride) {
+        s.sparse.push_back(records[i].timestamp_ns);
+    }
+    return true;
+}
+
+bool BarJournal::grow(Stream& s, size_t min_records) {
+    size_t capacity = std::max(min_records, s.capacity + kGrowRecords);
+    size_t bytes = kHeaderSize + capacity * sizeof(Record);
+
+    struct stat st;
+    if (fstat(s.fd, &st) != 0) {
+        std::cerr << "Failed to stat " << s.path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (static_cast<size_t>(st.st_size) < bytes) {
+        // Allocate the blocks now: with a sparse tail a full disk would
+        // surface as SIGBUS on a store into the mapping
+        int rc = posix_fallocate(s.fd, st.st_size, static_cast<off_t>(bytes) - st.st_size);
+        if (rc != 0) {
+            std::cerr << "Failed to extend " << s.path << ": " << strerror(rc) << std::endl;
+            return false;
+        }
+    }
+
+    void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, s.fd, 0);
+    if (mem == MAP_FAILED) {
+        std::cerr << "Failed to map " << s.path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (s.base) {
+        munmap(s.base, s.mappedBytes());
+    }
+    s.base = static_cast<char*>(mem);
+    s.capacity = capacity;
+    return true;
+}
+
+void BarJournal::closeStream(Stream& s) {
+    if (s.base) {
+        munmap(s.base, s.mappedBytes());
+        s.base = nullptr;
+        // Drop the preallocated tail so the file is exactly header + records
+        if (ftruncate(s.fd, static_cast<off_t>(kHeaderSize + s.count * sizeof(Record))) != 0) {
+            std::cerr << "Failed to trim " << s.path << ": " << strerror(errno) << std::endl;
+        }
+    }
+    if (s.fd != -1) {
+        ::close(s.fd);
+        s.fd = -1;
+    }
+    s.capacity = 0;
+}
+
+bool BarJournal::append(const MarketData& data) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stream* s = stream(data.symbol, true);
+    if (!s) {
+        return false;
+    }
+
+    int64_t timestamp_ns = toNanos(data.timestamp);
+    Record record{timestamp_ns, data.open, data.high, data.low, data.close, data.volume};
+    Record* records = s->records();
+
+    // A refetch of the newest bar is appended like any other; only the
+    // published count ever changes under a reader
+    if (s->count > 0 && timestamp_ns < records[s->count - 1].timestamp_ns) {
+        return true;  // Already have a later bar
+    }
+
+    if (s->count == s->capacity) {
+        if (!grow(*s, s->count + 1)) {
+            return false;
+        }
+        records = s->records();
+    }
+
+    records[s->count] = record;
+    if (s->count % kIndexStride == 0) {
+        s->sparse.push_back(timestamp_ns);
+    }
+    ++s->count;
+    // Publish after the record so a concurrent reader never sees a torn one
+    __atomic_store_n(&s->header()->record_count, static_cast<uint64_t>(s->count), __ATOMIC_RELEASE);
+    return true;
+}
+
+size_t BarJournal::lowerBound(const Stream& s, int64_t timestamp_ns) {
+    // Last indexed stride starting at or before timestamp_ns, then a search
+    // within it; earlier strides are entirely older
+    auto next = std::upper_bound(s.sparse.begin(), s.sparse.end(), timestamp_ns);
+    if (next == s.sparse.begin()) {
+        return 0;
+    }
+    size_t block = static_cast<size_t>(next - s.sparse.begin()) - 1;
+    const Record* first = s.records() + block * kIndexStride;
+    const Record* last = s.records() + std::min(s.count, (block + 1) * kIndexStride);
+    const Record* found = std::lower_bound(first, last, timestamp_ns,
+        [](const Record& record, int64_t ts) { return record.timestamp_ns < ts; });
+    return static_cast<size_t>(found - s.records());
+}
+
+MarketData BarJournal::toMarketData(const std::string& symbol, const Record& record) {
+    MarketData data;
+    data.symbol = symbol;
+    data.open = record.open;
+    data.high = record.high;
+    data.low = record.low;
+    data.close = record.close;
+    data.volume = record.volume;
+    data.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(record.timestamp_ns)));
+    return data;
+}
+
+std::vector<MarketData> BarJournal::latest(const std::string& symbol, size_t limit) {
+    std::vector<MarketData> results;
+    std::lock_guard<std::mutex> lock(mutex);
+    Stream* s = stream(symbol, false);
+    if (!s) {
+        return results;
+    }
+
+    results.reserve(std::min(limit, s->count));
+    const Record* records = s->records();
+    for (size_t i = s->count; i > 0 && results.size() < limit; --i) {
+        // Walking backwards, a timestamp's last record comes first
+        if (i < s->count && records[i - 1].timestamp_ns == records[i].timestamp_ns) {
+            continue;
+        }
+        results.push_back(toMarketData(symbol, records[i - 1]));
+    }
+    return results;
+}
+
+std::vector<MarketData> BarJournal::range(const std::string& symbol,
+                                          const std::chrono::system_clock::time_point& start,
+                                          const std::chrono::system_clock::time_point& end) {
+    std::vector<MarketData> results;
+    scanRange(symbol, start, end, [&](const Record& record) {
+        results.push_back(toMarketData(symbol, record));
+        return true;
+    });
+    return results;
+}
+
+size_t BarJournal::scanRange(const std::string& symbol,
+                             const std::chrono::system_clock::time_point& start,
+                             const std::chrono::system_clock::time_point& end,
+                             const Visitor& visitor) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stream* s = stream(symbol, false);
+    if (!s) {
+        return 0;
+    }
+
+    int64_t end_ns = toNanos(end);
+    size_t begin = lowerBound(*s, toNanos(start));
+    size_t finish = end_ns == std::numeric_limits<int64_t>::max() ? s->count : lowerBound(*s, end_ns + 1);
+
+    const Record* records = s->records();
+    size_t visited = 0;
+    for (size_t i = begin; i < finish; ++i) {
+        // Superseded by a later record with the same timestamp
+        if (i + 1 < s->count && records[i + 1].timestamp_ns == records[i].timestamp_ns) {
+            continue;
+        }
+        ++visited;
+        if (!visitor(records[i])) {
+            break;
+        }
+    }
+    return visited;
+}
+
+size_t BarJournal::size(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stream* s = stream(symbol, false);
+    return s ? s->count : 0;
+}
+
+} // namespace TradingSystem
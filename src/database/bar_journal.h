@@ -0,0 +1,115 @@
+#ifndef BAR_JOURNAL_H
+#define BAR_JOURNAL_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include "../common/data_types.h"
+
+namespace TradingSystem {
+
+// Append-only bar store used in place of the market_data table: one
+// memory-mapped file per symbol holding fixed-size records in time order.
+// Appends are a store into the mapping; reads copy straight out of it.
+// Every kIndexStride-th timestamp is also kept in memory, so a range seek
+// is a binary search over that sparse index followed by one over a single
+// stride of records.
+//
+// The file grows kGrowRecords at a time, with the blocks allocated up
+// front, and is trimmed to its committed length on close. Readers must
+// go by the header's record_count, which is published only after the
+// record it covers is written, so the files can be mapped by another
+// process (bar_journal.py uses np.memmap) while the trading system is
+// still appending.
+//
+// File layout (<directory>/<symbol>.journal, little-endian):
+//   header : magic u32, version u16, record_size u16, record_count u64,
+//            symbol char[48] (NUL-padded)
+//   records: timestamp_ns i64, open f64, high f64, low f64, close f64, volume f64
+//
+// A bar with the same timestamp as the newest record is appended after it
+// (a bar still forming is fetched more than once) and readers keep the last
+// record of each timestamp, so a record is never rewritten under a reader.
+// Older bars are dropped.
+class BarJournal {
+public:
+    static constexpr uint32_t kFileMagic = 0x4A425354;  // "TSBJ"
+    static constexpr uint16_t kFileVersion = 1;
+    static constexpr size_t kHeaderSize = 64;
+    static constexpr size_t kIndexStride = 256;
+    static constexpr size_t kGrowRecords = 16384;
+
+    struct Record {
+        int64_t timestamp_ns;
+        double open;
+        double high;
+        double low;
+        double close;
+        double volume;
+    };
+
+    // Return false to stop a scan
+    using Visitor = std::function<bool(const Record&)>;
+
+    explicit BarJournal(std::string directory);
+    ~BarJournal();
+
+    BarJournal(const BarJournal&) = delete;
+    BarJournal& operator=(const BarJournal&) = delete;
+
+    // Creates the directory if needed
+    bool open();
+    void close();
+
+    bool append(const MarketData& data);
+
+    // Up to limit most recent bars, newest first (getMarketData order).
+    // Here and in the range reads a timestamp yields only its last record.
+    std::vector<MarketData> latest(const std::string& symbol, size_t limit);
+
+    // Bars with start <= timestamp <= end, oldest first
+    std::vector<MarketData> range(const std::string& symbol,
+                                  const std::chrono::system_clock::time_point& start,
+                                  const std::chrono::system_clock::time_point& end);
+    // Streaming form of range(); records are visited in place, under the
+    // journal's lock. Returns the number visited.
+    size_t scanRange(const std::string& symbol,
+                     const std::chrono::system_clock::time_point& start,
+                     const std::chrono::system_clock::time_point& end,
+                     const Visitor& visitor);
+
+    // Records stored, superseded ones included
+    size_t size(const std::string& symbol);
+    const std::string& directory() const { return root; }
+
+    static std::string fileName(const std::string& symbol);
+
+private:
+    struct Header;
+    struct Stream;
+
+    std::string root;
+    bool opened;
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<Stream>> streams;
+
+    // Opens or creates the symbol's file; nullptr if create is false and
+    // there is none
+    Stream* stream(const std::string& symbol, bool create);
+    bool openStream(Stream& stream, const std::string& symbol, bool create);
+    bool grow(Stream& stream, size_t min_records);
+    void closeStream(Stream& stream);
+
+    static size_t lowerBound(const Stream& stream, int64_t timestamp_ns);
+    static MarketData toMarketData(const std::string& symbol, const Record& record);
+};
+
+} // namespace TradingSystem
+
+#endif // BAR_JOURNAL_H
@@ -1,12 +1,92 @@
 #include "database_manager.h"
+#include "../analysis/bar_series.h"
 #include <iostream>
-#include <sstream>
 #include <ctime>
-#include <iomanip>
 
 namespace TradingSystem {
 
-DatabaseManager::DatabaseManager(const std::string& db_path) : db(nullptr), db_path(db_path) {
+namespace {
+
+// SQL for each cached statement, indexed by DatabaseManager::Statement
+const char* const kStatementSql[] = {
+    // INSERT_MARKET_DATA
+    "INSERT INTO market_data (symbol, open, high, low, close, volume, timestamp, ts_us) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?);",
+    // SELECT_MARKET_DATA (answered from idx_market_data_symbol_ts alone)
+    "SELECT open, high, low, close, volume, ts_us "
+    "FROM market_data WHERE symbol = ? "
+    "ORDER BY ts_us DESC LIMIT ?;",
+    // SELECT_MARKET_DATA_RANGE
+    "SELECT open, high, low, close, volume, ts_us "
+    "FROM market_data WHERE symbol = ? AND ts_us BETWEEN ? AND ? "
+    "ORDER BY ts_us ASC;",
+    // INSERT_TRADING_SIGNAL
+    "INSERT INTO trading_signals (symbol, confidence, action, suggested_position_size, timestamp, ts_us) "
+    "VALUES (?, ?, ?, ?, ?, ?);",
+    // SELECT_LATEST_SIGNALS
+    "SELECT symbol, confidence, action, suggested_position_size, ts_us "
+    "FROM trading_signals "
+    "ORDER BY ts_us DESC LIMIT ?;",
+    // INSERT_POSITION
+    "INSERT INTO positions (symbol, quantity, entry_price, current_price, unrealized_pnl, entry_time, entry_ts_us) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?);",
+    // UPDATE_POSITION
+    "UPDATE positions SET quantity = ?, entry_price = ?, current_price = ?, unrealized_pnl = ? "
+    "WHERE symbol = ? AND status = 'OPEN';",
+    // SELECT_OPEN_POSITIONS
+    "SELECT symbol, quantity, entry_price, current_price, unrealized_pnl, entry_ts_us "
+    "FROM positions WHERE status = 'OPEN';",
+    // INSERT_ORDER
+    "INSERT INTO orders (order_id, symbol, side, quantity, price, order_type, status, timestamp, ts_us) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);",
+    // UPDATE_ORDER_STATUS
+    "UPDATE orders SET status = ? WHERE order_id = ?;",
+    // SELECT_PENDING_ORDERS
+    "SELECT order_id, symbol, side, quantity, price, order_type, status, ts_us "
+    "FROM orders WHERE status = 'PENDING';",
+    // SELECT_TOTAL_PNL
+    "SELECT SUM(realized_pnl) FROM positions WHERE status = 'CLOSED';",
+    // COUNT_WINNING_TRADES
+    "SELECT COUNT(*) FROM positions WHERE status = 'CLOSED' AND realized_pnl > 0;",
+    // COUNT_LOSING_TRADES
+    "SELECT COUNT(*) FROM positions WHERE status = 'CLOSED' AND realized_pnl < 0;",
+    // BEGIN
+    "BEGIN IMMEDIATE;",
+    // COMMIT
+    "COMMIT;",
+    // ROLLBACK
+    "ROLLBACK;"
+};
+
+inline const char* columnText(sqlite3_stmt* stmt, int col) {
+    const unsigned char* text = sqlite3_column_text(stmt, col);
+    return text ? reinterpret_cast<const char*>(text) : "";
+}
+
+// Integer epoch-micros twin of each TEXT timestamp column. The TEXT
+// columns are still written for the analyzer and for people reading the
+// file; everything the manager reads or orders by uses the integers.
+struct TimestampColumn {
+    const char* table;
+    const char* text_column;
+    const char* micros_column;
+};
+
+const TimestampColumn kTimestampColumns[] = {
+    {"market_data", "timestamp", "ts_us"},
+    {"trading_signals", "timestamp", "ts_us"},
+    {"positions", "entry_time", "entry_ts_us"},
+    {"orders", "timestamp", "ts_us"},
+};
+
+} // namespace
+
+DatabaseManager::DatabaseManager(const std::string& db_path)
+    : db(nullptr), db_path(db_path), statements{}, transaction_depth(0),
+      transaction_rollback_only(false) {
+    static_assert(sizeof(kStatementSql) / sizeof(kStatementSql[0]) == static_cast<size_t>(Statement::COUNT),
+                  "statement SQL table out of sync");
+    
     int rc = sqlite3_open(db_path.c_str(), &db);
     if (rc) {
         std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
@@ -16,13 +96,45 @@ DatabaseManager::DatabaseManager(const std::string& db_path) : db(nullptr), db_p
 }
 
 DatabaseManager::~DatabaseManager() {
+    for (auto& stmt : statements) {
+        if (stmt) {
+            sqlite3_finalize(stmt);
+            stmt = nullptr;
+        }
+    }
+    
     if (db) {
         sqlite3_close(db);
     }
 }
 
 bool DatabaseManager::initialize() {
-    return createTables();
+    if (!db) {
+        return false;
+    }
+    return configureConnection() && createTables() && migrateSchema() && createIndexes();
+}
+
+bool DatabaseManager::configureConnection() {
+    // WAL lets the Python analyzer read while we write, and NORMAL sync is
+    // durable across application crashes without an fsync per commit
+    std::vector<std::string> pragmas = {
+        "PRAGMA journal_mode = WAL;",
+        "PRAGMA synchronous = NORMAL;",
+        "PRAGMA temp_store = MEMORY;",
+        "PRAGMA cache_size = -16000;",
+        "PRAGMA mmap_size = 268435456;",
+        "PRAGMA foreign_keys = OFF;"
+    };
+    
+    for (const auto& pragma : pragmas) {
+        if (!executeQuery(pragma)) {
+            return false;
+        }
+    }
+    
+    sqlite3_busy_timeout(db, 5000);
+    return true;
 }
 
 bool DatabaseManager::createTables() {
@@ -37,6 +149,7 @@ bool DatabaseManager::createTables() {
         "close REAL NOT NULL,"
         "volume REAL NOT NULL,"
         "timestamp DATETIME NOT NULL,"
+        "ts_us INTEGER NOT NULL,"
         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP"
         ");",
         
@@ -48,6 +161,7 @@ bool DatabaseManager::createTables() {
         "action TEXT NOT NULL,"
         "suggested_position_size REAL NOT NULL,"
         "timestamp DATETIME NOT NULL,"
+        "ts_us INTEGER NOT NULL,"
         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP"
         ");",
         
@@ -60,6 +174,7 @@ bool DatabaseManager::createTables() {
         "current_price REAL,"
         "unrealized_pnl REAL,"
         "entry_time DATETIME NOT NULL,"
+        "entry_ts_us INTEGER NOT NULL,"
         "exit_time DATETIME,"
         "exit_price REAL,"
         "realized_pnl REAL,"
@@ -78,12 +193,26 @@ bool DatabaseManager::createTables() {
         "order_type TEXT NOT NULL,"
         "status TEXT NOT NULL,"
         "timestamp DATETIME NOT NULL,"
+        "ts_us INTEGER NOT NULL,"
         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP"
-        ");",
-        
-        // Create indexes for performance
-        "CREATE INDEX IF NOT EXISTS idx_market_data_symbol_timestamp ON market_data(symbol, timestamp);",
-        "CREATE INDEX IF NOT EXISTS idx_trading_signals_timestamp ON trading_signals(timestamp);",
+        ");"
+    };
+    
+    for (const auto& query : queries) {
+        if (!executeQuery(query)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::createIndexes() {
+    std::vector<std::string> queries = {
+        // Covering: history reads never touch the table rows
+        "CREATE INDEX IF NOT EXISTS idx_market_data_symbol_ts "
+        "ON market_data(symbol, ts_us, open, high, low, close, volume);",
+        "CREATE INDEX IF NOT EXISTS idx_trading_signals_ts ON trading_signals(ts_us);",
         "CREATE INDEX IF NOT EXISTS idx_positions_status ON positions(status);",
         "CREATE INDEX IF NOT EXISTS idx_orders_status ON orders(status);"
     };
@@ -97,7 +226,82 @@ bool DatabaseManager::createTables() {
     return true;
 }
 
+int DatabaseManager::schemaVersion() {
+    sqlite3_stmt* stmt = nullptr;
+    int version = -1;
+    if (sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        version = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    return version;
+}
+
+bool DatabaseManager::hasColumn(const std::string& table, const std::string& column) {
+    sqlite3_stmt* stmt = nullptr;
+    std::string query = "PRAGMA table_info(" + table + ");";
+    bool found = false;
+    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+        while (!found && sqlite3_step(stmt) == SQLITE_ROW) {
+            found = column == columnText(stmt, 1);
+        }
+    }
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+bool DatabaseManager::migrateSchema() {
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    int version = schemaVersion();
+    if (version < 0) {
+        std::cerr << "Failed to read schema version: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    if (version >= kSchemaVersion) {
+        return true;
+    }
+    
+    // Version 0 kept timestamps only as TEXT. Add the integer columns and
+    // fill them from the text, which was always written in UTC (SQLite's
+    // strftime reads it as UTC too), in one transaction so a failed run
+    // leaves the file as it was.
+    Transaction tx(*this);
+    bool altered = false;
+    for (const auto& column : kTimestampColumns) {
+        std::string table = column.table;
+        std::string micros = column.micros_column;
+        if (!hasColumn(table, micros)) {
+            if (!executeQuery("ALTER TABLE " + table + " ADD COLUMN " + micros + " INTEGER NOT NULL DEFAULT 0;")) {
+                return false;
+            }
+            altered = true;
+        }
+        if (!executeQuery("UPDATE " + table + " SET " + micros + " = "
+                          "CAST(strftime('%s', " + column.text_column + ") AS INTEGER) * 1000000 "
+                          "WHERE " + micros + " = 0;")) {
+            return false;
+        }
+    }
+    
+    // Superseded by the ts_us indexes
+    if (!executeQuery("DROP INDEX IF EXISTS idx_market_data_symbol_timestamp;") ||
+        !executeQuery("DROP INDEX IF EXISTS idx_trading_signals_timestamp;") ||
+        !executeQuery("PRAGMA user_version = " + std::to_string(kSchemaVersion) + ";")) {
+        return false;
+    }
+    
+    if (!tx.commit()) {
+        return false;
+    }
+    if (altered) {
+        std::cerr << "Migrated database schema from version " << version
+                  << " to " << kSchemaVersion << std::endl;
+    }
+    return true;
+}
+
 bool DatabaseManager::executeQuery(const std::string& query) {
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
     char* errMsg = nullptr;
     int rc = sqlite3_exec(db, query.c_str(), nullptr, nullptr, &errMsg);
     
@@ -110,194 +314,550 @@ bool DatabaseManager::executeQuery(const std::string& query) {
     return true;
 }
 
+sqlite3_stmt* DatabaseManager::getStatement(Statement id) {
+    sqlite3_stmt*& stmt = statements[static_cast<size_t>(id)];
+    
+    if (!stmt) {
+        if (sqlite3_prepare_v3(db, kStatementSql[static_cast<size_t>(id)], -1,
+                               SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+            stmt = nullptr;
+        }
+    }
+    
+    return stmt;
+}
+
+bool DatabaseManager::stepStatement(sqlite3_stmt* stmt) {
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
+        std::cerr << "SQL error: " << sqlite3_errmsg(db) << std::endl;
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return rc == SQLITE_DONE || rc == SQLITE_ROW;
+}
+
+std::string DatabaseManager::formatTimestamp(const std::chrono::system_clock::time_point& tp) {
+    auto time_t = std::chrono::system_clock::to_time_t(tp);
+    std::tm tm;
+    gmtime_r(&time_t, &tm);
+    char buffer[32];
+    size_t len = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+    return std::string(buffer, len);
+}
+
+int64_t DatabaseManager::toMicros(const std::chrono::system_clock::time_point& tp) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point DatabaseManager::fromMicros(int64_t micros) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(micros)));
+}
+
+// Transaction scope
+bool DatabaseManager::beginTransaction() {
+    if (transaction_depth++ > 0) {
+        return true;
+    }
+    
+    sqlite3_stmt* stmt = getStatement(Statement::BEGIN);
+    if (!stmt || !stepStatement(stmt)) {
+        transaction_depth = 0;
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::commitTransaction() {
+    if (transaction_depth == 0) {
+        return false;
+    }
+    if (--transaction_depth > 0) {
+        return !transaction_rollback_only;
+    }
+    
+    if (transaction_rollback_only) {
+        // An inner scope failed, so its partial writes must not land
+        transaction_rollback_only = false;
+        sqlite3_stmt* stmt = getStatement(Statement::ROLLBACK);
+        if (stmt) {
+            stepStatement(stmt);
+        }
+        return false;
+    }
+    
+    sqlite3_stmt* stmt = getStatement(Statement::COMMIT);
+    return stmt && stepStatement(stmt);
+}
+
+void DatabaseManager::rollbackTransaction() {
+    if (transaction_depth == 0) {
+        return;
+    }
+    if (--transaction_depth > 0) {
+        // Inner scope failed: the whole transaction rolls back when the outermost scope ends
+        transaction_rollback_only = true;
+        return;
+    }
+    
+    transaction_rollback_only = false;
+    sqlite3_stmt* stmt = getStatement(Statement::ROLLBACK);
+    if (stmt) {
+        stepStatement(stmt);
+    }
+}
+
+DatabaseManager::Transaction::Transaction(DatabaseManager& db)
+    : db(db), lock(db.db_mutex), active(db.beginTransaction()) {
+}
+
+DatabaseManager::Transaction::~Transaction() {
+    if (active) {
+        db.rollbackTransaction();
+    }
+}
+
+bool DatabaseManager::Transaction::commit() {
+    if (!active) {
+        return false;
+    }
+    active = false;
+    return db.commitTransaction();
+}
+
+void DatabaseManager::Transaction::rollback() {
+    if (active) {
+        active = false;
+        db.rollbackTransaction();
+    }
+}
+
+bool DatabaseManager::enableBarJournal(const std::string& directory) {
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    auto journal = std::make_unique<BarJournal>(directory);
+    if (!journal->open() || !importMarketData(*journal)) {
+        return false;
+    }
+    bar_journal = std::move(journal);
+    return true;
+}
+
+bool DatabaseManager::importMarketData(BarJournal& journal) {
+    // Bars recorded before the journal was enabled move into it once, so
+    // both readers (and the analyzer, which maps the files) keep history.
+    // A symbol whose journal already has bars is left alone; after the
+    // first import that is every symbol, and a start reads only the
+    // distinct symbols off the (symbol, ts_us) index.
+    std::vector<std::string> symbols;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "SELECT DISTINCT symbol FROM market_data;", -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to read market data for the bar journal: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_finalize(stmt);
+        return false;
+    }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        std::string symbol = columnText(stmt, 0);
+        if (journal.size(symbol) == 0) {
+            symbols.push_back(std::move(symbol));
+        }
+    }
+    sqlite3_finalize(stmt);
+    if (symbols.empty()) {
+        return true;
+    }
+    
+    const char* query =
+        "SELECT open, high, low, close, volume, ts_us FROM market_data WHERE symbol = ? ORDER BY ts_us;";
+    if (sqlite3_prepare_v2(db, query, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to read market data for the bar journal: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_finalize(stmt);
+        return false;
+    }
+    
+    bool ok = true;
+    size_t imported = 0;
+    MarketData bar;
+    for (const auto& symbol : symbols) {
+        sqlite3_bind_text(stmt, 1, symbol.c_str(), -1, SQLITE_STATIC);
+        bar.symbol = symbol;
+        while (ok && sqlite3_step(stmt) == SQLITE_ROW) {
+            bar.open = sqlite3_column_double(stmt, 0);
+            bar.high = sqlite3_column_double(stmt, 1);
+            bar.low = sqlite3_column_double(stmt, 2);
+            bar.close = sqlite3_column_double(stmt, 3);
+            bar.volume = sqlite3_column_double(stmt, 4);
+            bar.timestamp = fromMicros(sqlite3_column_int64(stmt, 5));
+            ok = journal.append(bar);
+            imported += ok ? 1 : 0;
+        }
+        sqlite3_reset(stmt);
+        if (!ok) {
+            break;
+        }
+    }
+    sqlite3_finalize(stmt);
+    
+    if (imported > 0) {
+        std::cerr << "Imported " << imported << " market_data rows for " << symbols.size()
+                  << " symbols into the bar journal" << std::endl;
+    }
+    return ok;
+}
+
 bool DatabaseManager::insertMarketData(const MarketData& data) {
-    auto time_t = std::chrono::system_clock::to_time_t(data.timestamp);
-    std::stringstream ss;
-    ss << std::put_time(std::gmtime(&time_t), "%Y-%m-%d %H:%M:%S");
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    return insertMarketDataLocked(data);
+}
+
+bool DatabaseManager::insertMarketDataLocked(const MarketData& data) {
+    if (bar_journal) {
+        return bar_journal->append(data);
+    }
     
-    std::string query = "INSERT INTO market_data (symbol, open, high, low, close, volume, timestamp) VALUES ('"
-        + data.symbol + "', "
-        + std::to_string(data.open) + ", "
-        + std::to_string(data.high) + ", "
-        + std::to_string(data.low) + ", "
-        + std::to_string(data.close) + ", "
-        + std::to_string(data.volume) + ", '"
-        + ss.str() + "');";
+    sqlite3_stmt* stmt = getStatement(Statement::INSERT_MARKET_DATA);
+    if (!stmt) return false;
     
-    return executeQuery(query);
+    std::string timestamp = formatTimestamp(data.timestamp);
+    sqlite3_bind_text(stmt, 1, data.symbol.c_str(), static_cast<int>(data.symbol.size()), SQLITE_STATIC);
+    sqlite3_bind_double(stmt, 2, data.open);
+    sqlite3_bind_double(stmt, 3, data.high);
+    sqlite3_bind_double(stmt, 4, data.low);
+    sqlite3_bind_double(stmt, 5, data.close);
+    sqlite3_bind_double(stmt, 6, data.volume);
+    sqlite3_bind_text(stmt, 7, timestamp.c_str(), static_cast<int>(timestamp.size()), SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 8, toMicros(data.timestamp));
+    
+    return stepStatement(stmt);
+}
+
+bool DatabaseManager::insertMarketDataBatch(const std::vector<MarketData>& data) {
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    if (bar_journal) {
+        // No SQLite transaction to open: each append is a store into the mapping
+        bool ok = true;
+        for (const auto& bar : data) {
+            ok = bar_journal->append(bar) && ok;
+        }
+        return ok;
+    }
+    
+    Transaction tx(*this);
+    
+    for (const auto& bar : data) {
+        if (!insertMarketDataLocked(bar)) {
+            return false;
+        }
+    }
+    
+    return tx.commit();
 }
 
 std::vector<MarketData> DatabaseManager::getMarketData(const std::string& symbol, int limit) {
     std::vector<MarketData> results;
-    sqlite3_stmt* stmt;
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
     
-    std::string query = "SELECT symbol, open, high, low, close, volume, timestamp "
-                       "FROM market_data WHERE symbol = ? "
-                       "ORDER BY timestamp DESC LIMIT ?;";
+    if (bar_journal) {
+        return bar_journal->latest(symbol, limit > 0 ? static_cast<size_t>(limit) : 0);
+    }
     
-    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, symbol.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_int(stmt, 2, limit);
+    sqlite3_stmt* stmt = getStatement(Statement::SELECT_MARKET_DATA);
+    if (!stmt) return results;
+    
+    sqlite3_bind_text(stmt, 1, symbol.c_str(), static_cast<int>(symbol.size()), SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, limit);
+    
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        MarketData data;
+        data.symbol = symbol;
+        data.open = sqlite3_column_double(stmt, 0);
+        data.high = sqlite3_column_double(stmt, 1);
+        data.low = sqlite3_column_double(stmt, 2);
+        data.close = sqlite3_column_double(stmt, 3);
+        data.volume = sqlite3_column_double(stmt, 4);
+        data.timestamp = fromMicros(sqlite3_column_int64(stmt, 5));
         
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            MarketData data;
-            data.symbol = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            data.open = sqlite3_column_double(stmt, 1);
-            data.high = sqlite3_column_double(stmt, 2);
-            data.low = sqlite3_column_double(stmt, 3);
-            data.close = sqlite3_column_double(stmt, 4);
-            data.volume = sqlite3_column_double(stmt, 5);
-            
-            // Parse timestamp
-            std::string timestamp_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
-            std::tm tm = {};
-            std::istringstream ss(timestamp_str);
-            ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-            data.timestamp = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-            
-            results.push_back(data);
+        results.push_back(data);
+    }
+    
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return results;
+}
+
+size_t DatabaseManager::getMarketDataRange(const std::string& symbol,
+                                           const std::chrono::system_clock::time_point& start,
+                                           const std::chrono::system_clock::time_point& end,
+                                           const BarVisitor& visitor) {
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    
+    if (bar_journal) {
+        return bar_journal->scanRange(symbol, start, end, visitor);
+    }
+    
+    sqlite3_stmt* stmt = getStatement(Statement::SELECT_MARKET_DATA_RANGE);
+    if (!stmt) return 0;
+    
+    sqlite3_bind_text(stmt, 1, symbol.c_str(), static_cast<int>(symbol.size()), SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 2, toMicros(start));
+    sqlite3_bind_int64(stmt, 3, toMicros(end));
+    
+    size_t visited = 0;
+    BarRow row;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        row.open = sqlite3_column_double(stmt, 0);
+        row.high = sqlite3_column_double(stmt, 1);
+        row.low = sqlite3_column_double(stmt, 2);
+        row.close = sqlite3_column_double(stmt, 3);
+        row.volume = sqlite3_column_double(stmt, 4);
+        row.timestamp_ns = sqlite3_column_int64(stmt, 5) * 1000;
+        ++visited;
+        if (!visitor(row)) {
+            break;
         }
-        
-        sqlite3_finalize(stmt);
     }
     
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return visited;
+}
+
+size_t DatabaseManager::getMarketDataRange(const std::string& symbol,
+                                           const std::chrono::system_clock::time_point& start,
+                                           const std::chrono::system_clock::time_point& end,
+                                           BarSeries& series) {
+    return getMarketDataRange(symbol, start, end, [&series](const BarRow& row) {
+        series.append(row.open, row.high, row.low, row.close, row.volume, row.timestamp_ns);
+        return true;
+    });
+}
+
+std::vector<MarketData> DatabaseManager::getMarketDataRange(const std::string& symbol,
+                                                           const std::chrono::system_clock::time_point& start,
+                                                           const std::chrono::system_clock::time_point& end) {
+    std::vector<MarketData> results;
+    getMarketDataRange(symbol, start, end, [&](const BarRow& row) {
+        MarketData data;
+        data.symbol = symbol;
+        data.open = row.open;
+        data.high = row.high;
+        data.low = row.low;
+        data.close = row.close;
+        data.volume = row.volume;
+        data.timestamp = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(row.timestamp_ns)));
+        results.push_back(std::move(data));
+        return true;
+    });
     return results;
 }
 
 bool DatabaseManager::insertTradingSignal(const TradingSignal& signal) {
-    auto time_t = std::chrono::system_clock::to_time_t(signal.timestamp);
-    std::stringstream ss;
-    ss << std::put_time(std::gmtime(&time_t), "%Y-%m-%d %H:%M:%S");
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    
+    sqlite3_stmt* stmt = getStatement(Statement::INSERT_TRADING_SIGNAL);
+    if (!stmt) return false;
     
-    std::string query = "INSERT INTO trading_signals (symbol, confidence, action, suggested_position_size, timestamp) VALUES ('"
-        + signal.symbol + "', "
-        + std::to_string(signal.confidence) + ", '"
-        + signal.action + "', "
-        + std::to_string(signal.suggested_position_size) + ", '"
-        + ss.str() + "');";
+    std::string timestamp = formatTimestamp(signal.timestamp);
+    sqlite3_bind_text(stmt, 1, signal.symbol.c_str(), static_cast<int>(signal.symbol.size()), SQLITE_STATIC);
+    sqlite3_bind_double(stmt, 2, signal.confidence);
+    sqlite3_bind_text(stmt, 3, toString(signal.action), -1, SQLITE_STATIC);
+    sqlite3_bind_double(stmt, 4, signal.suggested_position_size);
+    sqlite3_bind_text(stmt, 5, timestamp.c_str(), static_cast<int>(timestamp.size()), SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 6, toMicros(signal.timestamp));
     
-    return executeQuery(query);
+    return stepStatement(stmt);
 }
 
 std::vector<TradingSignal> DatabaseManager::getLatestSignals(int limit) {
     std::vector<TradingSignal> results;
-    sqlite3_stmt* stmt;
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
     
-    std::string query = "SELECT symbol, confidence, action, suggested_position_size, timestamp "
-                       "FROM trading_signals "
-                       "ORDER BY timestamp DESC LIMIT ?;";
+    sqlite3_stmt* stmt = getStatement(Statement::SELECT_LATEST_SIGNALS);
+    if (!stmt) return results;
     
-    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_int(stmt, 1, limit);
-        
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            TradingSignal signal;
-            signal.symbol = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            signal.confidence = sqlite3_column_double(stmt, 1);
-            signal.action = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-            signal.suggested_position_size = sqlite3_column_double(stmt, 3);
-            
-            // Parse timestamp
-            std::string timestamp_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-            std::tm tm = {};
-            std::istringstream ss(timestamp_str);
-            ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-            signal.timestamp = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-            
-            results.push_back(signal);
-        }
+    sqlite3_bind_int(stmt, 1, limit);
+    
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        TradingSignal signal;
+        signal.symbol = columnText(stmt, 0);
+        signal.confidence = sqlite3_column_double(stmt, 1);
+        signal.symbol_id = SymbolTable::getInstance().intern(signal.symbol);
+        fromString(columnText(stmt, 2), signal.action);
+        signal.suggested_position_size = sqlite3_column_double(stmt, 3);
+        signal.timestamp = fromMicros(sqlite3_column_int64(stmt, 4));
         
-        sqlite3_finalize(stmt);
+        results.push_back(signal);
     }
     
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
     return results;
 }
 
 bool DatabaseManager::insertPosition(const Position& position) {
-    auto time_t = std::chrono::system_clock::to_time_t(position.entry_time);
-    std::stringstream ss;
-    ss << std::put_time(std::gmtime(&time_t), "%Y-%m-%d %H:%M:%S");
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
     
-    std::string query = "INSERT INTO positions (symbol, quantity, entry_price, current_price, unrealized_pnl, entry_time) VALUES ('"
-        + position.symbol + "', "
-        + std::to_string(position.quantity) + ", "
-        + std::to_string(position.entry_price) + ", "
-        + std::to_string(position.current_price) + ", "
-        + std::to_string(position.unrealized_pnl) + ", '"
-        + ss.str() + "');";
+    sqlite3_stmt* stmt = getStatement(Statement::INSERT_POSITION);
+    if (!stmt) return false;
     
-    return executeQuery(query);
+    std::string entry_time = formatTimestamp(position.entry_time);
+    const std::string& symbol = position.symbolName();
+    sqlite3_bind_text(stmt, 1, symbol.c_str(), static_cast<int>(symbol.size()), SQLITE_STATIC);
+    sqlite3_bind_double(stmt, 2, position.quantity);
+    sqlite3_bind_double(stmt, 3, position.entry_price);
+    sqlite3_bind_double(stmt, 4, position.current_price);
+    sqlite3_bind_double(stmt, 5, position.unrealized_pnl);
+    sqlite3_bind_text(stmt, 6, entry_time.c_str(), static_cast<int>(entry_time.size()), SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 7, toMicros(position.entry_time));
+    
+    return stepStatement(stmt);
+}
+
+bool DatabaseManager::updatePosition(const Position& position) {
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    
+    sqlite3_stmt* stmt = getStatement(Statement::UPDATE_POSITION);
+    if (!stmt) return false;
+    
+    sqlite3_bind_double(stmt, 1, position.quantity);
+    sqlite3_bind_double(stmt, 2, position.entry_price);
+    sqlite3_bind_double(stmt, 3, position.current_price);
+    sqlite3_bind_double(stmt, 4, position.unrealized_pnl);
+    const std::string& symbol = position.symbolName();
+    sqlite3_bind_text(stmt, 5, symbol.c_str(), static_cast<int>(symbol.size()), SQLITE_STATIC);
+    
+    return stepStatement(stmt);
 }
 
 std::vector<Position> DatabaseManager::getOpenPositions() {
     std::vector<Position> results;
-    sqlite3_stmt* stmt;
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
     
-    std::string query = "SELECT symbol, quantity, entry_price, current_price, unrealized_pnl, entry_time "
-                       "FROM positions WHERE status = 'OPEN';";
+    sqlite3_stmt* stmt = getStatement(Statement::SELECT_OPEN_POSITIONS);
+    if (!stmt) return results;
     
-    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            Position position;
-            position.symbol = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            position.quantity = sqlite3_column_double(stmt, 1);
-            position.entry_price = sqlite3_column_double(stmt, 2);
-            position.current_price = sqlite3_column_double(stmt, 3);
-            position.unrealized_pnl = sqlite3_column_double(stmt, 4);
-            
-            // Parse timestamp
-            std::string timestamp_str = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-            std::tm tm = {};
-            std::istringstream ss(timestamp_str);
-            ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-            position.entry_time = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-            
-            results.push_back(position);
-        }
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        Position position;
+        position.symbol_id = SymbolTable::getInstance().intern(columnText(stmt, 0));
+        position.quantity = sqlite3_column_double(stmt, 1);
+        position.entry_price = sqlite3_column_double(stmt, 2);
+        position.current_price = sqlite3_column_double(stmt, 3);
+        position.unrealized_pnl = sqlite3_column_double(stmt, 4);
+        position.entry_time = fromMicros(sqlite3_column_int64(stmt, 5));
         
-        sqlite3_finalize(stmt);
+        results.push_back(position);
     }
     
+    sqlite3_reset(stmt);
     return results;
 }
 
 bool DatabaseManager::insertOrder(const Order& order) {
-    auto time_t = std::chrono::system_clock::to_time_t(order.timestamp);
-    std::stringstream ss;
-    ss << std::put_time(std::gmtime(&time_t), "%Y-%m-%d %H:%M:%S");
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    
+    sqlite3_stmt* stmt = getStatement(Statement::INSERT_ORDER);
+    if (!stmt) return false;
+    
+    std::string timestamp = formatTimestamp(order.timestamp);
+    const std::string& symbol = order.symbolName();
+    // order_id is a TEXT column; SQLite stores the integer in its text form
+    sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(order.order_id));
+    sqlite3_bind_text(stmt, 2, symbol.c_str(), static_cast<int>(symbol.size()), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, toString(order.side), -1, SQLITE_STATIC);
+    sqlite3_bind_double(stmt, 4, order.quantity);
+    sqlite3_bind_double(stmt, 5, order.price);
+    sqlite3_bind_text(stmt, 6, toString(order.order_type), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 7, toString(order.status), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 8, timestamp.c_str(), static_cast<int>(timestamp.size()), SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 9, toMicros(order.timestamp));
     
-    std::string query = "INSERT INTO orders (order_id, symbol, side, quantity, price, order_type, status, timestamp) VALUES ('"
-        + order.order_id + "', '"
-        + order.symbol + "', '"
-        + order.side + "', "
-        + std::to_string(order.quantity) + ", "
-        + std::to_string(order.price) + ", '"
-        + order.order_type + "', '"
-        + order.status + "', '"
-        + ss.str() + "');";
+    return stepStatement(stmt);
+}
+
+bool DatabaseManager::updateOrderStatus(OrderId order_id, OrderStatus status) {
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    
+    sqlite3_stmt* stmt = getStatement(Statement::UPDATE_ORDER_STATUS);
+    if (!stmt) return false;
+    
+    sqlite3_bind_text(stmt, 1, toString(status), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(order_id));
     
-    return executeQuery(query);
+    return stepStatement(stmt);
 }
 
-bool DatabaseManager::updateOrderStatus(const std::string& order_id, const std::string& status) {
-    std::string query = "UPDATE orders SET status = '" + status + "' WHERE order_id = '" + order_id + "';";
-    return executeQuery(query);
+std::vector<Order> DatabaseManager::getPendingOrders() {
+    std::vector<Order> results;
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    
+    sqlite3_stmt* stmt = getStatement(Statement::SELECT_PENDING_ORDERS);
+    if (!stmt) return results;
+    
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        Order order;
+        // Ids written before numeric order ids read back as 0
+        order.order_id = static_cast<OrderId>(sqlite3_column_int64(stmt, 0));
+        order.symbol_id = SymbolTable::getInstance().intern(columnText(stmt, 1));
+        fromString(columnText(stmt, 2), order.side);
+        order.quantity = sqlite3_column_double(stmt, 3);
+        order.price = sqlite3_column_double(stmt, 4);
+        fromString(columnText(stmt, 5), order.order_type);
+        fromString(columnText(stmt, 6), order.status);
+        order.timestamp = fromMicros(sqlite3_column_int64(stmt, 7));
+        
+        results.push_back(order);
+    }
+    
+    sqlite3_reset(stmt);
+    return results;
 }
 
 double DatabaseManager::getTotalPnL() {
     double total_pnl = 0.0;
-    sqlite3_stmt* stmt;
-    
-    std::string query = "SELECT SUM(realized_pnl) FROM positions WHERE status = 'CLOSED';";
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
     
-    if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+    sqlite3_stmt* stmt = getStatement(Statement::SELECT_TOTAL_PNL);
+    if (stmt) {
         if (sqlite3_step(stmt) == SQLITE_ROW) {
             total_pnl = sqlite3_column_double(stmt, 0);
         }
-        sqlite3_finalize(stmt);
+        sqlite3_reset(stmt);
     }
     
     return total_pnl;
 }
 
+int DatabaseManager::getWinningTrades() {
+    int count = 0;
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    
+    sqlite3_stmt* stmt = getStatement(Statement::COUNT_WINNING_TRADES);
+    if (stmt) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            count = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_reset(stmt);
+    }
+    
+    return count;
+}
+
+int DatabaseManager::getLosingTrades() {
+    int count = 0;
+    std::lock_guard<std::recursive_mutex> lock(db_mutex);
+    
+    sqlite3_stmt* stmt = getStatement(Statement::COUNT_LOSING_TRADES);
+    if (stmt) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            count = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_reset(stmt);
+    }
+    
+    return count;
+}
+
 } // namespace TradingSystem
\ No newline at end of file
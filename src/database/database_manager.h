@@ -4,23 +4,82 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <functional>
 #include <sqlite3.h>
 #include "../common/data_types.h"
+#include "bar_journal.h"
 
 namespace TradingSystem {
 
+class BarSeries;
+
 class DatabaseManager {
 public:
+    // PRAGMA user_version this build writes; older files are migrated on
+    // initialize(). Version 1 added integer epoch-micros timestamp columns.
+    static constexpr int kSchemaVersion = 1;
+    
+    // One stored bar as handed to streaming readers (timestamp in ns, as
+    // everywhere else in memory)
+    using BarRow = BarJournal::Record;
+    // Return false to stop the scan
+    using BarVisitor = std::function<bool(const BarRow&)>;
+    
     DatabaseManager(const std::string& db_path = "trading_system.db");
     ~DatabaseManager();
     
+    DatabaseManager(const DatabaseManager&) = delete;
+    DatabaseManager& operator=(const DatabaseManager&) = delete;
+    
+    // RAII transaction scope. Everything written through the manager while a
+    // Transaction is alive commits together; it rolls back unless commit() is
+    // called. Scopes nest: only the outermost one talks to SQLite, and once an
+    // inner scope rolls back the outermost commit() rolls back too. The scope
+    // holds the manager's lock, so keep it on one thread and keep it short.
+    class Transaction {
+    public:
+        explicit Transaction(DatabaseManager& db);
+        ~Transaction();
+        
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+        
+        bool commit();
+        void rollback();
+        
+    private:
+        DatabaseManager& db;
+        std::unique_lock<std::recursive_mutex> lock;
+        bool active;
+    };
+    
     // Initialize database schema
     bool initialize();
     
-    // Market data operations
+    // Market data operations. Once a bar journal is enabled, bars are
+    // written to and read from it and the market_data table is left alone;
+    // enabling it imports the table's rows for symbols it has no bars for.
+    bool enableBarJournal(const std::string& directory);
+    BarJournal* barJournal() { return bar_journal.get(); }
+    
     bool insertMarketData(const MarketData& data);
+    bool insertMarketDataBatch(const std::vector<MarketData>& data);
     std::vector<MarketData> getMarketData(const std::string& symbol, 
                                          int limit = 100);
+    
+    // Bars with start <= timestamp <= end, oldest first. The visitor and
+    // BarSeries forms stream rows straight from the statement (or journal)
+    // and return how many were delivered; the vector form is built on them.
+    // The visitor runs under the manager's lock and must not call back in.
+    size_t getMarketDataRange(const std::string& symbol,
+                              const std::chrono::system_clock::time_point& start,
+                              const std::chrono::system_clock::time_point& end,
+                              const BarVisitor& visitor);
+    size_t getMarketDataRange(const std::string& symbol,
+                              const std::chrono::system_clock::time_point& start,
+                              const std::chrono::system_clock::time_point& end,
+                              BarSeries& series);
     std::vector<MarketData> getMarketDataRange(const std::string& symbol,
                                               const std::chrono::system_clock::time_point& start,
                                               const std::chrono::system_clock::time_point& end);
@@ -36,7 +95,7 @@ public:
     
     // Order operations
     bool insertOrder(const Order& order);
-    bool updateOrderStatus(const std::string& order_id, const std::string& status);
+    bool updateOrderStatus(OrderId order_id, OrderStatus status);
     std::vector<Order> getPendingOrders();
     
     // Performance metrics
@@ -45,11 +104,56 @@ public:
     int getLosingTrades();
     
 private:
+    // Statements prepared once and kept for the manager's lifetime
+    enum class Statement {
+        INSERT_MARKET_DATA,
+        SELECT_MARKET_DATA,
+        SELECT_MARKET_DATA_RANGE,
+        INSERT_TRADING_SIGNAL,
+        SELECT_LATEST_SIGNALS,
+        INSERT_POSITION,
+        UPDATE_POSITION,
+        SELECT_OPEN_POSITIONS,
+        INSERT_ORDER,
+        UPDATE_ORDER_STATUS,
+        SELECT_PENDING_ORDERS,
+        SELECT_TOTAL_PNL,
+        COUNT_WINNING_TRADES,
+        COUNT_LOSING_TRADES,
+        BEGIN,
+        COMMIT,
+        ROLLBACK,
+        COUNT
+    };
+    
     sqlite3* db;
     std::string db_path;
+    sqlite3_stmt* statements[static_cast<size_t>(Statement::COUNT)];
+    std::recursive_mutex db_mutex;
+    int transaction_depth;
+    // Set when an inner scope rolls back; the outermost scope cannot commit
+    bool transaction_rollback_only;
+    std::unique_ptr<BarJournal> bar_journal;
     
     bool executeQuery(const std::string& query);
     bool createTables();
+    bool createIndexes();
+    bool migrateSchema();
+    int schemaVersion();
+    bool hasColumn(const std::string& table, const std::string& column);
+    bool configureConnection();
+    sqlite3_stmt* getStatement(Statement id);
+    bool stepStatement(sqlite3_stmt* stmt);
+    bool insertMarketDataLocked(const MarketData& data);
+    bool importMarketData(BarJournal& journal);
+    
+    bool beginTransaction();
+    bool commitTransaction();
+    void rollbackTransaction();
+    
+    static std::string formatTimestamp(const std::chrono::system_clock::time_point& tp);
+    static int64_t toMicros(const std::chrono::system_clock::time_point& tp);
+    static std::chrono::system_clock::time_point fromMicros(int64_t micros);
 };
 
 } // namespace TradingSystem
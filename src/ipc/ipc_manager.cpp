@@ -5,13 +5,15 @@
 #include <unistd.h>
 #include <signal.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
 #include <cstring>
+#include <algorithm>
 
 namespace TradingSystem {
 
-IPCManager::IPCManager(const std::string& pipe_name) 
-    : pipe_name(pipe_name), write_fd(-1), read_fd(-1), 
-      connected(false), running(false) {
+IPCManager::IPCManager(const std::string& pipe_name, IPCTransport transport, size_t shm_capacity) 
+    : pipe_name(pipe_name), transport(transport), shm_capacity(shm_capacity),
+      write_fd(-1), read_fd(-1), connected(false), running(false) {
 }
 
 IPCManager::~IPCManager() {
@@ -20,9 +22,37 @@ IPCManager::~IPCManager() {
 }
 
 bool IPCManager::initialize() {
+#if !defined(__x86_64__)
+    // shm_transport.py reads and publishes the ring positions with plain
+    // loads and stores, which are only acquire/release on x86-64
+    if (transport == IPCTransport::SHARED_MEMORY) {
+        std::cerr << "Shared-memory IPC needs x86-64 on the Python side, using pipes" << std::endl;
+        transport = IPCTransport::PIPE;
+    }
+#endif
+    if (transport == IPCTransport::SHARED_MEMORY) {
+        return createSharedMemory();
+    }
     return createNamedPipe();
 }
 
+IPCTransport IPCManager::parseTransport(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    
+    if (lower == "shm" || lower == "shared_memory") {
+        return IPCTransport::SHARED_MEMORY;
+    }
+    return IPCTransport::PIPE;
+}
+
+std::string IPCManager::shmSegmentName(const std::string& suffix) const {
+    // POSIX shm names are a single path component, so drop the directory
+    size_t slash = pipe_name.find_last_of('/');
+    std::string base = (slash == std::string::npos) ? pipe_name : pipe_name.substr(slash + 1);
+    return "/" + base + suffix;
+}
+
 bool IPCManager::createNamedPipe() {
     // Create two pipes for bidirectional communication
     std::string write_pipe = pipe_name + "_to_python";
@@ -44,6 +74,29 @@ bool IPCManager::createNamedPipe() {
         return false;
     }
     
+    // Make sure a stale shared-memory segment is not mistaken for ours
+    shm_unlink(shmSegmentName("_to_python").c_str());
+    shm_unlink(shmSegmentName("_to_cpp").c_str());
+    
+    connected = true;
+    return true;
+}
+
+bool IPCManager::createSharedMemory() {
+    // Remove FIFOs from a previous pipe-mode run so the analyzer picks shm
+    unlink((pipe_name + "_to_python").c_str());
+    unlink((pipe_name + "_to_cpp").c_str());
+    
+    // Create the inbound ring first; the analyzer attaches once both exist
+    if (!shm_to_cpp.create(shmSegmentName("_to_cpp"), shm_capacity)) {
+        return false;
+    }
+    
+    if (!shm_to_python.create(shmSegmentName("_to_python"), shm_capacity)) {
+        shm_to_cpp.close();
+        return false;
+    }
+    
     connected = true;
     return true;
 }
@@ -52,7 +105,11 @@ void IPCManager::start() {
     if (running) return;
     
     running = true;
-    reader_thread = std::thread(&IPCManager::readerLoop, this);
+    if (transport == IPCTransport::SHARED_MEMORY) {
+        reader_thread = std::thread(&IPCManager::shmReaderLoop, this);
+    } else {
+        reader_thread = std::thread(&IPCManager::readerLoop, this);
+    }
 }
 
 void IPCManager::stop() {
@@ -66,6 +123,15 @@ void IPCManager::stop() {
 bool IPCManager::sendMessage(const std::string& message) {
     if (!connected) return false;
     
+    if (transport == IPCTransport::SHARED_MEMORY) {
+        std::lock_guard<std::mutex> lock(shm_write_mutex);
+        if (!shm_to_python.write(message.data(), message.size(), 1000)) {
+            std::cerr << "Failed to write to shared memory ring (full or message too large)" << std::endl;
+            return false;
+        }
+        return true;
+    }
+    
     std::string write_pipe = pipe_name + "_to_python";
     
     // Open pipe for writing if not already open
@@ -98,18 +164,53 @@ bool IPCManager::sendMessage(const std::string& message) {
 std::string IPCManager::receiveMessage(int timeout_ms) {
     std::unique_lock<std::mutex> lock(queue_mutex);
     
-    if (queue_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), 
-                         [this] { return !message_queue.empty(); })) {
-        std::string message = message_queue.front();
-        message_queue.pop();
-        return message;
+    std::string message;
+    queue_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                      [this, &message] { return pending_messages.tryPop(message); });
+    return message;
+}
+
+void IPCManager::setMessageCallback(MessageCallback callback) {
+    message_callback = std::move(callback);
+}
+
+void IPCManager::deliverMessage(std::string_view message) {
+    // A registered consumer (normally MessageDispatcher::dispatch) owns
+    // every message and applies its own backpressure
+    if (message_callback) {
+        message_callback(message);
+        return;
     }
     
-    return "";
+    // Otherwise keep a bounded backlog for receiveMessage()
+    if (!pending_messages.tryPush(std::string(message))) {
+        uint64_t dropped = ++dropped_messages;
+        if ((dropped & (dropped - 1)) == 0) {
+            std::cerr << "IPC backlog full, dropped " << dropped << " messages" << std::endl;
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    queue_cv.notify_one();
 }
 
-void IPCManager::setMessageCallback(std::function<void(const std::string&)> callback) {
-    message_callback = callback;
+void IPCManager::shmReaderLoop() {
+    while (running) {
+        if (!shm_to_cpp.waitForData(100)) {
+            continue;
+        }
+        
+        // Drain everything that is ready before waiting again. Frames are
+        // delivered in place and released afterwards, so the dispatcher's
+        // pooled buffer is the only copy.
+        std::string_view frame;
+        while (shm_to_cpp.peek(frame)) {
+            if (!frame.empty()) {
+                deliverMessage(frame);
+            }
+            shm_to_cpp.consume();
+        }
+    }
 }
 
 void IPCManager::readerLoop() {
@@ -117,46 +218,38 @@ void IPCManager::readerLoop() {
     
     while (running) {
         if (read_fd == -1) {
-            read_fd = open(read_pipe.c_str(), O_RDONLY);
+            // Non-blocking so an analyzer that never attaches cannot hold
+            // this thread in open(2) past stop(); reads block again after
+            read_fd = open(read_pipe.c_str(), O_RDONLY | O_NONBLOCK);
             if (read_fd == -1) {
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
                 continue;
             }
+            fcntl(read_fd, F_SETFL, fcntl(read_fd, F_GETFL) & ~O_NONBLOCK);
         }
         
         char buffer[4096];
         ssize_t bytes_read = read(read_fd, buffer, sizeof(buffer) - 1);
         
         if (bytes_read > 0) {
-            buffer[bytes_read] = '\0';
-            std::string message(buffer);
+            // Messages are newline-delimited and may span reads, so keep
+            // the unterminated tail for the next one
+            pipe_read_buffer.append(buffer, static_cast<size_t>(bytes_read));
             
-            // Split by newlines in case multiple messages
-            size_t pos = 0;
-            while ((pos = message.find('\n')) != std::string::npos) {
-                std::string msg = message.substr(0, pos);
-                
-                if (!msg.empty()) {
-                    // Add to queue
-                    {
-                        std::lock_guard<std::mutex> lock(queue_mutex);
-                        message_queue.push(msg);
-                    }
-                    queue_cv.notify_one();
-                    
-                    // Call callback if set
-                    if (message_callback) {
-                        message_callback(msg);
-                    }
+            size_t start = 0;
+            size_t pos;
+            while ((pos = pipe_read_buffer.find('\n', start)) != std::string::npos) {
+                if (pos > start) {
+                    deliverMessage(std::string_view(pipe_read_buffer).substr(start, pos - start));
                 }
-                
-                message.erase(0, pos + 1);
+                start = pos + 1;
             }
+            pipe_read_buffer.erase(0, start);
         } else if (bytes_read == 0) {
-            // Pipe closed, wait and retry
-            close(read_fd);
-            read_fd = -1;
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            // No writer yet, or it went away. The read end stays open so
+            // the analyzer's open of the write end never waits on us.
+            pipe_read_buffer.clear();
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
         }
     }
     
@@ -183,6 +276,10 @@ void IPCManager::cleanup() {
     unlink(write_pipe.c_str());
     unlink(read_pipe.c_str());
     
+    // Unmap and unlink shared-memory rings
+    shm_to_python.close();
+    shm_to_cpp.close();
+    
     connected = false;
 }
 
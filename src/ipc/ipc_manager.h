@@ -5,15 +5,23 @@
 #include <thread>
 #include <atomic>
 #include <functional>
-#include <queue>
 #include <mutex>
 #include <condition_variable>
+#include "shm_ring_buffer.h"
+#include "../common/bounded_queue.h"
 
 namespace TradingSystem {
 
+enum class IPCTransport {
+    PIPE,           // Newline-delimited text over a pair of named pipes
+    SHARED_MEMORY   // Length-prefixed frames over shared-memory SPSC rings
+};
+
 class IPCManager {
 public:
-    IPCManager(const std::string& pipe_name = "/tmp/trading_system_pipe");
+    IPCManager(const std::string& pipe_name = "/tmp/trading_system_pipe",
+               IPCTransport transport = IPCTransport::PIPE,
+               size_t shm_capacity = 1 << 20);
     ~IPCManager();
     
     // Initialize IPC
@@ -22,34 +30,57 @@ public:
     // Send message to Python process
     bool sendMessage(const std::string& message);
     
-    // Receive message from Python process
+    // Receive message from Python process. Only used when no callback is
+    // set; returns an empty string on timeout.
     std::string receiveMessage(int timeout_ms = 5000);
     
-    // Set callback for incoming messages
-    void setMessageCallback(std::function<void(const std::string&)> callback);
+    // Set callback for incoming messages. It runs on the reader thread, so
+    // it should hand off quickly (see MessageDispatcher). The view points
+    // into the pipe buffer or the ring itself and is only valid for the
+    // duration of the call.
+    using MessageCallback = std::function<void(std::string_view)>;
+    void setMessageCallback(MessageCallback callback);
     
     // Start/stop message processing
     void start();
     void stop();
     
     bool isConnected() const { return connected; }
+    IPCTransport getTransport() const { return transport; }
+    
+    static IPCTransport parseTransport(const std::string& name);
     
 private:
     std::string pipe_name;
+    IPCTransport transport;
+    size_t shm_capacity;
     int write_fd;
     int read_fd;
     std::atomic<bool> connected;
     std::atomic<bool> running;
     
     std::thread reader_thread;
-    std::queue<std::string> message_queue;
+    std::string pipe_read_buffer;
+    
+    // Backlog for receiveMessage() when no callback consumes messages
+    BoundedQueue<std::string> pending_messages{1024};
+    std::atomic<uint64_t> dropped_messages{0};
     std::mutex queue_mutex;
     std::condition_variable queue_cv;
     
-    std::function<void(const std::string&)> message_callback;
+    MessageCallback message_callback;
+    
+    // Shared-memory transport
+    ShmRingBuffer shm_to_python;
+    ShmRingBuffer shm_to_cpp;
+    std::mutex shm_write_mutex;
     
     void readerLoop();
+    void shmReaderLoop();
+    void deliverMessage(std::string_view message);
     bool createNamedPipe();
+    bool createSharedMemory();
+    std::string shmSegmentName(const std::string& suffix) const;
     void cleanup();
 };
 
@@ -0,0 +1,207 @@
+#include "message_dispatcher.h"
+#include <chrono>
+
+namespace TradingSystem {
+
+namespace {
+
+size_t skipSpace(std::string_view s, size_t pos) {
+    while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\n' || s[pos] == '\r')) {
+        ++pos;
+    }
+    return pos;
+}
+
+// Position just past the ':' following "key", or npos
+size_t findValue(std::string_view s, std::string_view quoted_key) {
+    size_t pos = s.find(quoted_key);
+    if (pos == std::string_view::npos) return pos;
+    pos = skipSpace(s, pos + quoted_key.size());
+    if (pos >= s.size() || s[pos] != ':') return std::string_view::npos;
+    return skipSpace(s, pos + 1);
+}
+
+// End of the JSON value starting at pos (one past it), or npos if unbalanced
+size_t valueEnd(std::string_view s, size_t pos) {
+    int depth = 0;
+    bool in_string = false;
+    for (size_t i = pos; i < s.size(); ++i) {
+        char c = s[i];
+        if (in_string) {
+            if (c == '\\') ++i;
+            else if (c == '"') in_string = false;
+            continue;
+        }
+        if (c == '"') {
+            in_string = true;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) return i;  // end of the enclosing array
+            if (--depth == 0) return i + 1;
+        } else if (c == ',' && depth == 0) {
+            return i;
+        }
+    }
+    return std::string_view::npos;
+}
+
+} // namespace
+
+MessageDispatcher::MessageDispatcher(size_t worker_count, size_t queue_capacity)
+    : buffers((worker_count > 0 ? worker_count : 1) * queue_capacity, [] {
+          std::string buffer;
+          buffer.reserve(kBufferReserve);
+          return buffer;
+      }),
+      running(false), accepting(false), dispatched(0), backpressure(0) {
+    if (worker_count == 0) worker_count = 1;
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers.push_back(std::make_unique<Worker>(queue_capacity));
+    }
+}
+
+MessageDispatcher::~MessageDispatcher() {
+    stop();
+}
+
+void MessageDispatcher::start() {
+    if (running) return;
+
+    running = true;
+    accepting = true;
+    for (auto& worker : workers) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w] { workerLoop(*w); });
+    }
+}
+
+void MessageDispatcher::stop() {
+    if (!running) return;
+
+    accepting = false;
+    running = false;
+    for (auto& worker : workers) {
+        wake(*worker);
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+std::string_view MessageDispatcher::symbolOf(std::string_view message) {
+    size_t pos = findValue(message, "\"symbol\"");
+    if (pos == std::string_view::npos || pos >= message.size() || message[pos] != '"') {
+        return {};
+    }
+    size_t end = message.find('"', pos + 1);
+    if (end == std::string_view::npos) return {};
+    return message.substr(pos + 1, end - pos - 1);
+}
+
+bool MessageDispatcher::splitResults(std::string_view message, std::vector<std::string_view>& out) {
+    size_t pos = findValue(message, "\"results\"");
+    if (pos == std::string_view::npos || pos >= message.size() || message[pos] != '[') {
+        return false;
+    }
+
+    out.clear();
+    pos = skipSpace(message, pos + 1);
+    while (pos < message.size() && message[pos] != ']') {
+        size_t end = valueEnd(message, pos);
+        if (end == std::string_view::npos) return false;
+        out.push_back(message.substr(pos, end - pos));
+        pos = skipSpace(message, end);
+        if (pos < message.size() && message[pos] == ',') {
+            pos = skipSpace(message, pos + 1);
+        }
+    }
+    return true;
+}
+
+bool MessageDispatcher::dispatch(std::string_view message) {
+    if (!accepting.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // Reused per reader thread so splitting does not allocate either
+    thread_local std::vector<std::string_view> results;
+    if (splitResults(message, results)) {
+        if (!split_results) {
+            enqueue(message, *workers[0]);
+            return true;
+        }
+        for (auto result : results) {
+            enqueue(result);
+        }
+    } else {
+        enqueue(message);
+    }
+    return true;
+}
+
+void MessageDispatcher::enqueue(std::string_view text) {
+    std::string_view symbol = symbolOf(text);
+    size_t shard = symbol.empty() ? 0 : std::hash<std::string_view>()(symbol) % workers.size();
+    enqueue(text, *workers[shard]);
+}
+
+void MessageDispatcher::enqueue(std::string_view text, Worker& worker) {
+
+    std::string message = buffers.acquire();
+    message.assign(text.data(), text.size());
+
+    if (!worker.queue.tryPush(std::move(message))) {
+        // Backpressure: hold the reader until the worker makes room
+        backpressure.fetch_add(1, std::memory_order_relaxed);
+        do {
+            wake(worker);
+            std::this_thread::yield();
+        } while (!worker.queue.tryPush(std::move(message)));
+    }
+    dispatched.fetch_add(1, std::memory_order_relaxed);
+
+    if (worker.sleeping.load()) {
+        wake(worker);
+    }
+}
+
+void MessageDispatcher::wake(Worker& worker) {
+    std::lock_guard<std::mutex> lock(worker.wake_mutex);
+    worker.wake_cv.notify_one();
+}
+
+void MessageDispatcher::workerLoop(Worker& worker) {
+    std::string message;
+    for (;;) {
+        if (worker.queue.tryPop(message)) {
+            if (handler) {
+                handler(message);
+            }
+            buffers.release(std::move(message));
+            continue;
+        }
+        if (!running) {
+            break;
+        }
+
+        // Announce the sleep before re-checking so a producer that pushes
+        // in between sees the flag and notifies; the timeout is a backstop
+        std::unique_lock<std::mutex> lock(worker.wake_mutex);
+        worker.sleeping = true;
+        if (worker.queue.sizeApprox() == 0 && running) {
+            worker.wake_cv.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        worker.sleeping = false;
+    }
+}
+
+size_t MessageDispatcher::queueDepth() const {
+    size_t depth = 0;
+    for (const auto& worker : workers) {
+        depth += worker->queue.sizeApprox();
+    }
+    return depth;
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,94 @@
+#ifndef MESSAGE_DISPATCHER_H
+#define MESSAGE_DISPATCHER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "../common/bounded_queue.h"
+#include "../common/object_pool.h"
+
+namespace TradingSystem {
+
+// Second stage of the IPC pipeline: the reader thread hands each message
+// to dispatch(), which routes it to one of N worker threads over a bounded
+// lock-free queue. Messages carrying a "symbol" always go to the same
+// worker, so per-symbol order is preserved while different symbols run in
+// parallel. A full queue blocks the reader (backpressure reaches Python
+// through the pipe or ring) instead of growing memory. Message buffers
+// come from a pool and return to it once handled, so a warm dispatcher
+// moves messages without allocating.
+class MessageDispatcher {
+public:
+    using Handler = std::function<void(const std::string&)>;
+
+    MessageDispatcher(size_t worker_count = 2, size_t queue_capacity = 4096);
+    ~MessageDispatcher();
+
+    MessageDispatcher(const MessageDispatcher&) = delete;
+    MessageDispatcher& operator=(const MessageDispatcher&) = delete;
+
+    // Set before start(); called on worker threads
+    void setHandler(Handler handler) { this->handler = std::move(handler); }
+    // With splitting off, {"results": [...]} replies reach the handler
+    // whole, on the first worker, for callers that act on the batch
+    void setSplitResults(bool split) { split_results = split; }
+
+    void start();
+    // Stop accepting, run what is already queued, then join the workers
+    void stop();
+
+    // Queue a message. {"results": [...]} replies are split so each
+    // result is routed by its own symbol, unless splitting is turned off.
+    // Returns false once stopped.
+    bool dispatch(std::string_view message);
+
+    size_t workerCount() const { return workers.size(); }
+    size_t queueDepth() const;
+    uint64_t dispatchedCount() const { return dispatched.load(std::memory_order_relaxed); }
+    // Times the reader had to wait for a full worker queue
+    uint64_t backpressureCount() const { return backpressure.load(std::memory_order_relaxed); }
+    // Messages that needed a freshly allocated buffer
+    uint64_t bufferMissCount() const { return buffers.missCount(); }
+
+    // Value of the top-level "symbol" field, empty if there is none
+    static std::string_view symbolOf(std::string_view message);
+    // Elements of a {"results": [...]} array; false if message is not one
+    static bool splitResults(std::string_view message, std::vector<std::string_view>& out);
+
+private:
+    struct Worker {
+        explicit Worker(size_t capacity) : queue(capacity) {}
+
+        BoundedQueue<std::string> queue;
+        std::thread thread;
+        std::mutex wake_mutex;
+        std::condition_variable wake_cv;
+        std::atomic<bool> sleeping{false};
+    };
+
+    void enqueue(std::string_view message);
+    void enqueue(std::string_view message, Worker& worker);
+    void workerLoop(Worker& worker);
+    void wake(Worker& worker);
+
+    static constexpr size_t kBufferReserve = 1024;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    ObjectPool<std::string> buffers;
+    Handler handler;
+    bool split_results = true;
+    std::atomic<bool> running;
+    std::atomic<bool> accepting;
+    std::atomic<uint64_t> dispatched;
+    std::atomic<uint64_t> backpressure;
+};
+
+} // namespace TradingSystem
+
+#endif // MESSAGE_DISPATCHER_H
@@ -0,0 +1,325 @@
+#include "shm_ring_buffer.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+namespace TradingSystem {
+
+static_assert(offsetof(ShmRingHeader, write_pos) == 64, "shm layout changed");
+static_assert(offsetof(ShmRingHeader, read_pos) == 128, "shm layout changed");
+static_assert(offsetof(ShmRingHeader, data_seq) == 192, "shm layout changed");
+static_assert(offsetof(ShmRingHeader, space_seq) == 256, "shm layout changed");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shm ring needs lock-free 64-bit atomics");
+
+namespace {
+
+// Shared (not FUTEX_PRIVATE) futexes so the Python process can wake us
+void futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms) {
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+} // namespace
+
+ShmRingBuffer::ShmRingBuffer()
+    : header(nullptr), data(nullptr), mapped_size(0), owner(false), pending_read_pos(0) {
+}
+
+ShmRingBuffer::~ShmRingBuffer() {
+    close();
+}
+
+bool ShmRingBuffer::create(const std::string& segment_name, size_t capacity) {
+    close();
+
+    // Round capacity up to a power of two so positions can be masked
+    size_t rounded = 4096;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+
+    shm_unlink(segment_name.c_str());
+    int fd = shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd == -1) {
+        std::cerr << "Failed to create shared memory " << segment_name << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    size_t total_size = kDataOffset + rounded;
+    if (ftruncate(fd, static_cast<off_t>(total_size)) == -1) {
+        std::cerr << "Failed to size shared memory " << segment_name << ": " << strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(segment_name.c_str());
+        return false;
+    }
+
+    bool mapped = mapSegment(fd, total_size);
+    ::close(fd);
+    if (!mapped) {
+        shm_unlink(segment_name.c_str());
+        return false;
+    }
+
+    // Initialize the control block; magic is written last so an attaching
+    // process never sees a half-initialized header
+    new (header) ShmRingHeader();
+    header->version = kVersion;
+    header->capacity = rounded;
+    header->write_pos.store(0, std::memory_order_relaxed);
+    header->read_pos.store(0, std::memory_order_relaxed);
+    header->data_seq.store(0, std::memory_order_relaxed);
+    header->consumer_waiting.store(0, std::memory_order_relaxed);
+    header->space_seq.store(0, std::memory_order_relaxed);
+    header->producer_waiting.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = kMagic;
+
+    name = segment_name;
+    owner = true;
+    pending_read_pos = 0;
+    return true;
+}
+
+bool ShmRingBuffer::attach(const std::string& segment_name) {
+    close();
+
+    int fd = shm_open(segment_name.c_str(), O_RDWR, 0666);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) <= kDataOffset) {
+        ::close(fd);
+        return false;
+    }
+
+    bool mapped = mapSegment(fd, static_cast<size_t>(st.st_size));
+    ::close(fd);
+    if (!mapped) {
+        return false;
+    }
+
+    if (header->magic != kMagic || header->version != kVersion ||
+        kDataOffset + header->capacity != mapped_size) {
+        std::cerr << "Shared memory " << segment_name << " has an incompatible layout" << std::endl;
+        close();
+        return false;
+    }
+
+    name = segment_name;
+    owner = false;
+    pending_read_pos = header->read_pos.load(std::memory_order_relaxed);
+    return true;
+}
+
+bool ShmRingBuffer::mapSegment(int fd, size_t size) {
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        std::cerr << "Failed to map shared memory: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    header = static_cast<ShmRingHeader*>(addr);
+    data = static_cast<char*>(addr) + kDataOffset;
+    mapped_size = size;
+    return true;
+}
+
+void ShmRingBuffer::close() {
+    if (header) {
+        munmap(header, mapped_size);
+        header = nullptr;
+        data = nullptr;
+        mapped_size = 0;
+    }
+
+    if (owner && !name.empty()) {
+        shm_unlink(name.c_str());
+    }
+    owner = false;
+    name.clear();
+}
+
+size_t ShmRingBuffer::maxFrameSize() const {
+    // A frame may need to skip the tail of the buffer, so cap it at half
+    return header ? header->capacity / 2 - sizeof(uint32_t) : 0;
+}
+
+bool ShmRingBuffer::tryWrite(const char* payload, size_t length) {
+    if (!header || length > maxFrameSize()) {
+        return false;
+    }
+
+    const uint64_t capacity = header->capacity;
+    const uint64_t mask = capacity - 1;
+    const size_t needed = frameSize(length);
+
+    uint64_t write = header->write_pos.load(std::memory_order_relaxed);
+    uint64_t read = header->read_pos.load(std::memory_order_acquire);
+
+    uint64_t offset = write & mask;
+    uint64_t to_end = capacity - offset;
+    uint64_t skip = (to_end < needed) ? to_end : 0;
+
+    if ((write - read) + skip + needed > capacity) {
+        return false;
+    }
+
+    if (skip) {
+        uint32_t marker = kWrapMarker;
+        std::memcpy(data + offset, &marker, sizeof(marker));
+        write += skip;
+        offset = 0;
+    }
+
+    uint32_t frame_length = static_cast<uint32_t>(length);
+    std::memcpy(data + offset, &frame_length, sizeof(frame_length));
+    std::memcpy(data + offset + sizeof(frame_length), payload, length);
+
+    // Publish, then wake the consumer only if it went to sleep
+    header->write_pos.store(write + needed, std::memory_order_seq_cst);
+    if (header->consumer_waiting.load(std::memory_order_seq_cst)) {
+        header->data_seq.fetch_add(1, std::memory_order_seq_cst);
+        futexWake(&header->data_seq);
+    }
+
+    return true;
+}
+
+bool ShmRingBuffer::write(const char* payload, size_t length, int timeout_ms) {
+    if (tryWrite(payload, length)) {
+        return true;
+    }
+    if (!header || length > maxFrameSize()) {
+        return false;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    for (int spin = 0; spin < kSpinIterations; ++spin) {
+        cpuRelax();
+        if (tryWrite(payload, length)) {
+            return true;
+        }
+    }
+
+    // Ring is full: sleep until the consumer frees space
+    while (std::chrono::steady_clock::now() < deadline) {
+        header->producer_waiting.store(1, std::memory_order_seq_cst);
+        uint32_t seq = header->space_seq.load(std::memory_order_seq_cst);
+        if (tryWrite(payload, length)) {
+            header->producer_waiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        futexWait(&header->space_seq, seq, 10);
+        header->producer_waiting.store(0, std::memory_order_relaxed);
+        if (tryWrite(payload, length)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ShmRingBuffer::peek(std::string_view& frame) {
+    if (!header) {
+        return false;
+    }
+
+    const uint64_t mask = header->capacity - 1;
+    uint64_t read = header->read_pos.load(std::memory_order_relaxed);
+    uint64_t write = header->write_pos.load(std::memory_order_acquire);
+
+    while (read != write) {
+        uint64_t offset = read & mask;
+        uint32_t frame_length;
+        std::memcpy(&frame_length, data + offset, sizeof(frame_length));
+
+        if (frame_length == kWrapMarker) {
+            read += header->capacity - offset;
+            header->read_pos.store(read, std::memory_order_release);
+            continue;
+        }
+
+        frame = std::string_view(data + offset + sizeof(frame_length), frame_length);
+        pending_read_pos = read + frameSize(frame_length);
+        return true;
+    }
+
+    return false;
+}
+
+void ShmRingBuffer::consume() {
+    if (!header) {
+        return;
+    }
+
+    header->read_pos.store(pending_read_pos, std::memory_order_seq_cst);
+    if (header->producer_waiting.load(std::memory_order_seq_cst)) {
+        header->space_seq.fetch_add(1, std::memory_order_seq_cst);
+        futexWake(&header->space_seq);
+    }
+}
+
+bool ShmRingBuffer::waitForData(int timeout_ms) {
+    if (!header) {
+        return false;
+    }
+
+    auto hasData = [this] {
+        return header->read_pos.load(std::memory_order_relaxed) !=
+               header->write_pos.load(std::memory_order_acquire);
+    };
+
+    // Spin briefly so back-to-back frames never touch the kernel
+    for (int spin = 0; spin < kSpinIterations; ++spin) {
+        if (hasData()) {
+            return true;
+        }
+        cpuRelax();
+    }
+
+    // A wake can be stale: the producer bumps data_seq after publishing a
+    // frame, and that frame may already have been consumed. Sleep again
+    // until data shows up or the deadline passes.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    header->consumer_waiting.store(1, std::memory_order_seq_cst);
+    while (!hasData()) {
+        uint32_t seq = header->data_seq.load(std::memory_order_seq_cst);
+        if (hasData()) {
+            break;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            break;
+        }
+        futexWait(&header->data_seq, seq, static_cast<int>(remaining.count()));
+    }
+    header->consumer_waiting.store(0, std::memory_order_relaxed);
+
+    return hasData();
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,83 @@
+#ifndef SHM_RING_BUFFER_H
+#define SHM_RING_BUFFER_H
+
+#include <string>
+#include <string_view>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace TradingSystem {
+
+// Control block at the start of every shared-memory ring.
+// The layout is fixed so market_data_analyzer.py can map the same segment
+// (see shm_transport.py); keep both sides in sync when changing it.
+struct ShmRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;                                  // Size of the data region, power of two
+
+    alignas(64) std::atomic<uint64_t> write_pos;        // Owned by the producer
+    alignas(64) std::atomic<uint64_t> read_pos;         // Owned by the consumer
+
+    alignas(64) std::atomic<uint32_t> data_seq;         // Futex word, bumped when data arrives
+    std::atomic<uint32_t> consumer_waiting;
+
+    alignas(64) std::atomic<uint32_t> space_seq;        // Futex word, bumped when space frees up
+    std::atomic<uint32_t> producer_waiting;
+};
+
+// Single-producer/single-consumer ring of length-prefixed frames living in
+// a POSIX shared-memory segment. Frames are [uint32 length][payload] padded
+// to 8 bytes; a length of kWrapMarker tells the reader to skip to offset 0.
+// Futex wakeups are only issued when the other side is actually asleep, so
+// the steady-state send/receive path makes no system calls.
+class ShmRingBuffer {
+public:
+    static constexpr uint32_t kMagic = 0x544D5242;      // "TMRB"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kWrapMarker = 0xFFFFFFFFu;
+    static constexpr size_t kDataOffset = sizeof(ShmRingHeader);
+
+    ShmRingBuffer();
+    ~ShmRingBuffer();
+
+    ShmRingBuffer(const ShmRingBuffer&) = delete;
+    ShmRingBuffer& operator=(const ShmRingBuffer&) = delete;
+
+    // Create (replacing any stale segment) or attach to an existing segment
+    bool create(const std::string& name, size_t capacity);
+    bool attach(const std::string& name);
+    void close();
+
+    // Producer side
+    bool tryWrite(const char* data, size_t length);
+    bool write(const char* data, size_t length, int timeout_ms);
+
+    // Consumer side: peek() hands out a view straight into shared memory
+    // which stays valid until consume() is called.
+    bool peek(std::string_view& frame);
+    void consume();
+    bool waitForData(int timeout_ms);
+
+    bool isOpen() const { return header != nullptr; }
+    size_t maxFrameSize() const;
+    const std::string& getName() const { return name; }
+
+private:
+    std::string name;
+    ShmRingHeader* header;
+    char* data;
+    size_t mapped_size;
+    bool owner;
+    uint64_t pending_read_pos;
+
+    static constexpr int kSpinIterations = 2000;
+
+    bool mapSegment(int fd, size_t size);
+    static size_t frameSize(size_t length) { return (sizeof(uint32_t) + length + 7) & ~size_t(7); }
+};
+
+} // namespace TradingSystem
+
+#endif // SHM_RING_BUFFER_H
@@ -0,0 +1,153 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace TradingSystem {
+
+// Cheap monotonic tick source for log timestamps: the TSC on x86, the
+// steady clock elsewhere. The logger calibrates ticks to wall time once.
+inline uint64_t readTimestampCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// Fixed header of every binary log record; typed arguments follow it
+struct LogRecordHeader {
+    uint32_t size;        // header + arguments, before padding
+    uint16_t format_id;
+    uint8_t level;
+    uint8_t arg_count;
+    uint64_t tsc;
+};
+static_assert(sizeof(LogRecordHeader) == 16, "LogRecordHeader layout");
+
+enum LogArgTag : uint8_t {
+    LOG_ARG_INT = 1,
+    LOG_ARG_UINT = 2,
+    LOG_ARG_DOUBLE = 3,
+    LOG_ARG_STRING = 4
+};
+
+// Single-producer/single-consumer byte ring owned by one logging thread
+// and drained by the logger's writer thread. Records are 8-byte aligned
+// and never straddle the end of the buffer; a wrap marker tells the reader
+// to continue from offset 0.
+class LogRing {
+public:
+    static constexpr uint32_t kWrapMarker = 0xFFFFFFFFu;
+
+    explicit LogRing(size_t requested_capacity) {
+        size_t capacity = 4096;
+        while (capacity < requested_capacity) {
+            capacity <<= 1;
+        }
+        mask = capacity - 1;
+        buffer.reset(new char[capacity]);
+    }
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    // Producer: space for a record of size bytes, or nullptr if the ring is full
+    char* reserve(size_t size) {
+        size_t need = align(size);
+        uint64_t pos = head.load(std::memory_order_relaxed);
+        size_t offset = static_cast<size_t>(pos & mask);
+        size_t contiguous = mask + 1 - offset;
+        size_t pad = (contiguous < need) ? contiguous : 0;
+
+        if (!hasSpace(pos, pad + need)) {
+            return nullptr;
+        }
+
+        if (pad > 0) {
+            uint32_t marker = kWrapMarker;
+            std::memcpy(buffer.get() + offset, &marker, sizeof(marker));
+            offset = 0;
+        }
+        pending_pad = pad;
+        return buffer.get() + offset;
+    }
+
+    // Producer: publish the record written into the last reserve()
+    void commit(size_t size) {
+        uint64_t pos = head.load(std::memory_order_relaxed);
+        head.store(pos + pending_pad + align(size), std::memory_order_release);
+    }
+
+    // Consumer: next record, or nullptr if the ring is empty
+    const char* peek() {
+        uint64_t pos = tail.load(std::memory_order_relaxed);
+        if (pos == head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        size_t offset = static_cast<size_t>(pos & mask);
+        uint32_t size;
+        std::memcpy(&size, buffer.get() + offset, sizeof(size));
+        if (size == kWrapMarker) {
+            pos += mask + 1 - offset;
+            tail.store(pos, std::memory_order_relaxed);
+            offset = 0;
+        }
+        return buffer.get() + offset;
+    }
+
+    // Consumer: retire the record returned by peek()
+    void release(size_t size) {
+        uint64_t pos = tail.load(std::memory_order_relaxed);
+        tail.store(pos + align(size), std::memory_order_release);
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Largest record reserve() is sure to place once the ring drains: the
+    // padding that skips to the start can take up to the record's size
+    size_t maxRecordSize() const { return (mask + 1) / 2; }
+
+    // Records discarded because the ring was full
+    std::atomic<uint64_t> dropped{0};
+    // Set when the owning thread exits; the writer frees the ring once drained
+    std::atomic<bool> abandoned{false};
+
+private:
+    static size_t align(size_t size) { return (size + 7) & ~size_t(7); }
+
+    bool hasSpace(uint64_t pos, size_t need) {
+        if (pos + need - cached_tail <= mask + 1) {
+            return true;
+        }
+        cached_tail = tail.load(std::memory_order_acquire);
+        return pos + need - cached_tail <= mask + 1;
+    }
+
+    std::unique_ptr<char[]> buffer;
+    size_t mask;
+
+    alignas(64) std::atomic<uint64_t> head{0};
+    uint64_t cached_tail = 0;   // producer-local
+    size_t pending_pad = 0;     // producer-local
+
+    alignas(64) std::atomic<uint64_t> tail{0};
+};
+
+} // namespace TradingSystem
+
+#endif // LOG_RING_H
@@ -1,31 +1,131 @@
 #include "logger.h"
 #include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace TradingSystem {
 
-void Logger::initialize(const std::string& log_file_path, LogLevel level) {
-    std::lock_guard<std::mutex> lock(log_mutex);
-    
-    // Close existing file if open
-    if (log_file.is_open()) {
-        log_file.close();
+namespace {
+
+constexpr uint16_t kMaxFormats = 4096;
+constexpr uint16_t kPlainMessageFormat = 0;
+
+// Call-site format strings, registered once and never removed
+std::mutex format_mutex;
+const char* format_table[kMaxFormats] = {"{}"};
+std::atomic<uint16_t> format_count(1);
+
+const char* const kLevelNames[] = {"DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+
+// Keeps the calling thread's ring registered until the thread exits
+struct ThreadRingHandle {
+    std::shared_ptr<LogRing> ring;
+    ~ThreadRingHandle() {
+        if (ring) ring->abandoned.store(true, std::memory_order_release);
     }
-    
-    // Open new log file
-    log_file.open(log_file_path, std::ios::app);
-    if (!log_file.is_open()) {
-        std::cerr << "Failed to open log file: " << log_file_path << std::endl;
-        console_output = true; // Force console output if file fails
+};
+thread_local ThreadRingHandle thread_ring;
+
+void writeAll(int fd, const std::string& data) {
+    const char* p = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        ssize_t n = ::write(fd, p, remaining);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        p += n;
+        remaining -= static_cast<size_t>(n);
+    }
+}
+
+template <typename T>
+T readValue(const char*& p) {
+    T value;
+    std::memcpy(&value, p, sizeof(value));
+    p += sizeof(value);
+    return value;
+}
+
+// Append the next encoded argument as text
+void appendArg(const char*& p, std::string& out) {
+    char buf[32];
+    LogArgTag tag = static_cast<LogArgTag>(*p++);
+    switch (tag) {
+        case LOG_ARG_INT: {
+            auto r = std::to_chars(buf, buf + sizeof(buf), readValue<int64_t>(p));
+            out.append(buf, r.ptr);
+            break;
+        }
+        case LOG_ARG_UINT: {
+            auto r = std::to_chars(buf, buf + sizeof(buf), readValue<uint64_t>(p));
+            out.append(buf, r.ptr);
+            break;
+        }
+        case LOG_ARG_DOUBLE: {
+            auto r = std::to_chars(buf, buf + sizeof(buf), readValue<double>(p));
+            out.append(buf, r.ptr);
+            break;
+        }
+        case LOG_ARG_STRING: {
+            uint32_t length = readValue<uint32_t>(p);
+            out.append(p, length);
+            p += length;
+            break;
+        }
+    }
+}
+
+// Substitute each "{}" in format with the next argument; leftover
+// arguments are appended so nothing is silently lost
+void appendMessage(const char* format, const char* args, uint8_t arg_count, std::string& out) {
+    uint8_t used = 0;
+    for (const char* f = format; *f; ++f) {
+        if (f[0] == '{' && f[1] == '}' && used < arg_count) {
+            appendArg(args, out);
+            ++used;
+            ++f;
+        } else {
+            out.push_back(*f);
+        }
+    }
+    for (; used < arg_count; ++used) {
+        out.push_back(' ');
+        appendArg(args, out);
+    }
+}
+
+} // namespace
+
+void Logger::initialize(const std::string& log_file_path, LogLevel level) {
+    {
+        std::lock_guard<std::mutex> lock(log_mutex);
+        
+        // Close existing file if open
+        if (log_file.is_open()) {
+            log_file.close();
+        }
+        
+        // Open new log file
+        log_path = log_file_path;
+        log_file.open(log_file_path, std::ios::app);
+        if (!log_file.is_open()) {
+            std::cerr << "Failed to open log file: " << log_file_path << std::endl;
+            console_output = true; // Force console output if file fails
+        }
+        
+        log_level.store(level, std::memory_order_relaxed);
     }
     
-    log_level = level;
-    
-    // Write initialization message
+    // Write initialization message (writeLog takes log_mutex itself)
     writeLog("INFO", "Logger initialized - Level: " + levelToString(level));
 }
 
 void Logger::setLogLevel(const std::string& level) {
-    log_level = stringToLevel(level);
+    log_level.store(stringToLevel(level), std::memory_order_relaxed);
 }
 
 void Logger::debug(const std::string& message) {
@@ -49,12 +149,18 @@ void Logger::critical(const std::string& message) {
 }
 
 void Logger::log(LogLevel level, const std::string& message) {
-    if (level >= log_level) {
+    if (!isEnabled(level)) {
+        return;
+    }
+    if (isAsync()) {
+        logFormat(level, kPlainMessageFormat, message);
+    } else {
         writeLog(levelToString(level), message);
     }
 }
 
 void Logger::logPerformance(const std::string& operation, double duration_ms) {
+    if (!isEnabled(LogLevel::DEBUG)) return;
     std::stringstream ss;
     ss << "Performance - " << operation << ": " 
        << std::fixed << std::setprecision(2) << duration_ms << " ms";
@@ -63,6 +169,7 @@ void Logger::logPerformance(const std::string& operation, double duration_ms) {
 
 void Logger::logTrade(const std::string& symbol, const std::string& side, 
                      double quantity, double price) {
+    if (!isEnabled(LogLevel::INFO)) return;
     std::stringstream ss;
     ss << "TRADE - " << side << " " << quantity << " " << symbol 
        << " @ $" << std::fixed << std::setprecision(2) << price;
@@ -71,6 +178,7 @@ void Logger::logTrade(const std::string& symbol, const std::string& side,
 
 void Logger::logSignal(const std::string& symbol, const std::string& action, 
                       double confidence) {
+    if (!isEnabled(LogLevel::INFO)) return;
     std::stringstream ss;
     ss << "SIGNAL - " << symbol << ": " << action 
        << " (confidence: " << std::fixed << std::setprecision(2) 
@@ -80,6 +188,7 @@ void Logger::logSignal(const std::string& symbol, const std::string& action,
 
 void Logger::logPosition(const std::string& symbol, double quantity, 
                         double entry_price, double current_pnl) {
+    if (!isEnabled(LogLevel::INFO)) return;
     std::stringstream ss;
     ss << "POSITION - " << symbol << ": " << quantity << " units @ $" 
        << std::fixed << std::setprecision(2) << entry_price
@@ -88,6 +197,17 @@ void Logger::logPosition(const std::string& symbol, double quantity,
 }
 
 void Logger::flush() {
+    if (isAsync()) {
+        // Wait for the writer to drain every ring queued before this call
+        std::unique_lock<std::mutex> lock(flush_mutex);
+        uint64_t target = ++flush_requested;
+        flush_cv.notify_all();
+        flush_cv.wait_for(lock, std::chrono::seconds(5), [this, target] {
+            return flush_completed >= target || !writer_running.load();
+        });
+        return;
+    }
+    
     std::lock_guard<std::mutex> lock(log_mutex);
     if (log_file.is_open()) {
         log_file.flush();
@@ -155,4 +275,268 @@ void Logger::writeLog(const std::string& level_str, const std::string& message)
     }
 }
 
-} // namespace TradingSystem
\ No newline at end of file
+// ----------------------------------------------------------------------------
+// Asynchronous mode
+
+uint16_t Logger::registerFormat(const char* format) {
+    std::lock_guard<std::mutex> lock(format_mutex);
+    uint16_t id = format_count.load(std::memory_order_relaxed);
+    if (id >= kMaxFormats) {
+        return kPlainMessageFormat;
+    }
+    format_table[id] = format;
+    format_count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+LogOverflowPolicy Logger::parseOverflowPolicy(const std::string& policy) {
+    std::string upper = policy;
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    if (upper == "DROP") return LogOverflowPolicy::DROP;
+    if (upper == "BLOCK") return LogOverflowPolicy::BLOCK;
+    return LogOverflowPolicy::COUNT;
+}
+
+void Logger::startAsync(const AsyncLogOptions& options) {
+    if (isAsync()) return;
+    
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(log_mutex);
+        async_options = options;
+        if (!log_path.empty()) {
+            file_fd = ::open(log_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        }
+    }
+    
+    // Calibrate the tick source against the wall clock
+    uint64_t t0 = readTimestampCounter();
+    auto c0 = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    uint64_t t1 = readTimestampCounter();
+    auto c1 = std::chrono::steady_clock::now();
+    double elapsed_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(c1 - c0).count());
+    ticks_per_ns = elapsed_ns > 0 ? static_cast<double>(t1 - t0) / elapsed_ns : 1.0;
+    tsc_base = t1;
+    wall_base_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    writer_running = true;
+    writer_thread = std::thread(&Logger::writerLoop, this);
+    async_enabled.store(true, std::memory_order_release);
+}
+
+void Logger::stopAsync() {
+    if (!async_enabled.exchange(false)) return;
+    
+    writer_running = false;
+    flush_cv.notify_all();
+    if (writer_thread.joinable()) {
+        writer_thread.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (file_fd >= 0) {
+        ::close(file_fd);
+        file_fd = -1;
+    }
+}
+
+uint64_t Logger::droppedCount() const {
+    uint64_t total = retired_dropped.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(rings_mutex));
+    for (const auto& ring : rings) {
+        total += ring->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+LogRing* Logger::threadRing() {
+    if (!thread_ring.ring) {
+        auto ring = std::make_shared<LogRing>(async_options.ring_bytes);
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        rings.push_back(ring);
+        thread_ring.ring = std::move(ring);
+    }
+    return thread_ring.ring.get();
+}
+
+char* Logger::reserveRecord(LogRing* ring, size_t size) {
+    char* out = ring->reserve(size);
+    if (out) return out;
+    
+    if (async_options.overflow == LogOverflowPolicy::BLOCK) {
+        while (!out && writer_running.load(std::memory_order_relaxed)) {
+            std::this_thread::yield();
+            out = ring->reserve(size);
+        }
+        if (out) return out;
+    }
+    
+    ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void Logger::writeSyncRecord(const char* record) {
+    LogRecordHeader header;
+    std::memcpy(&header, record, sizeof(header));
+    uint16_t count = format_count.load(std::memory_order_acquire);
+    const char* format = header.format_id < count ? format_table[header.format_id] : "{}";
+    
+    std::string message;
+    appendMessage(format, record + sizeof(header), header.arg_count, message);
+    writeLog(levelToString(static_cast<LogLevel>(header.level)), message);
+}
+
+void Logger::appendTimestamp(uint64_t tsc, std::string& line) {
+    // Records can be stamped slightly before the calibration point
+    double offset_ns = (static_cast<double>(tsc) - static_cast<double>(tsc_base)) / ticks_per_ns;
+    int64_t wall_ns = wall_base_ns + static_cast<int64_t>(offset_ns);
+    time_t seconds = static_cast<time_t>(wall_ns / 1000000000);
+    int millis = static_cast<int>((wall_ns / 1000000) % 1000);
+    
+    // localtime_r and strftime only when the second changes
+    static thread_local time_t cached_second = -1;
+    static thread_local char cached_prefix[32];
+    if (seconds != cached_second) {
+        struct tm tm_buf;
+        localtime_r(&seconds, &tm_buf);
+        strftime(cached_prefix, sizeof(cached_prefix), "%Y-%m-%d %H:%M:%S", &tm_buf);
+        cached_second = seconds;
+    }
+    
+    char millis_buf[5] = {'.', static_cast<char>('0' + millis / 100),
+                          static_cast<char>('0' + (millis / 10) % 10),
+                          static_cast<char>('0' + millis % 10), '\0'};
+    line.append(cached_prefix);
+    line.append(millis_buf, 4);
+}
+
+void Logger::formatRecord(const char* record, std::string& line) {
+    LogRecordHeader header;
+    std::memcpy(&header, record, sizeof(header));
+    uint16_t count = format_count.load(std::memory_order_acquire);
+    const char* format = header.format_id < count ? format_table[header.format_id] : "{}";
+    const char* level = header.level <= static_cast<uint8_t>(LogLevel::CRITICAL)
+        ? kLevelNames[header.level] : "UNKNOWN";
+    
+    line.push_back('[');
+    appendTimestamp(header.tsc, line);
+    line.append("] [");
+    line.append(level);
+    line.append("] ");
+    appendMessage(format, record + sizeof(header), header.arg_count, line);
+    line.push_back('\n');
+}
+
+size_t Logger::drainRings(std::string& file_buf, std::string& out_buf, std::string& err_buf) {
+    std::vector<std::shared_ptr<LogRing>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        snapshot = rings;
+    }
+    
+    size_t records = 0;
+    std::string line;
+    for (auto& ring : snapshot) {
+        // Report what a COUNT ring lost since the last report
+        if (async_options.overflow == LogOverflowPolicy::COUNT) {
+            uint64_t lost = ring->dropped.exchange(0, std::memory_order_relaxed);
+            if (lost > 0) {
+                retired_dropped.fetch_add(lost, std::memory_order_relaxed);
+                line.clear();
+                line.append("[");
+                appendTimestamp(readTimestampCounter(), line);
+                line.append("] [WARNING] Logger dropped " + std::to_string(lost) +
+                            " records (ring full)\n");
+                file_buf += line;
+                if (console_output || file_fd < 0) err_buf += line;
+            }
+        }
+        
+        while (const char* record = ring->peek()) {
+            LogRecordHeader header;
+            std::memcpy(&header, record, sizeof(header));
+            line.clear();
+            formatRecord(record, line);
+            ring->release(header.size);
+            ++records;
+            
+            file_buf += line;
+            if (console_output || file_fd < 0) {
+                (header.level >= static_cast<uint8_t>(LogLevel::ERROR) ? err_buf : out_buf) += line;
+            }
+            if (file_buf.size() >= async_options.batch_bytes) {
+                writeBuffers(file_buf, out_buf, err_buf);
+            }
+        }
+    }
+    
+    // Free rings whose threads have exited once they are drained. Under
+    // COUNT a ring that lost records after this pass's report is kept for
+    // the next pass, so the loss still reaches the log.
+    bool report_losses = async_options.overflow == LogOverflowPolicy::COUNT;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        auto retire = [this, report_losses](const std::shared_ptr<LogRing>& ring) {
+            if (ring->abandoned.load(std::memory_order_acquire) && ring->empty() &&
+                !(report_losses && ring->dropped.load(std::memory_order_relaxed) > 0)) {
+                retired_dropped.fetch_add(ring->dropped.load(std::memory_order_relaxed),
+                                          std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        };
+        rings.erase(std::remove_if(rings.begin(), rings.end(), retire), rings.end());
+    }
+    
+    return records;
+}
+
+void Logger::writeBuffers(std::string& file_buf, std::string& out_buf, std::string& err_buf) {
+    if (file_fd >= 0 && !file_buf.empty()) writeAll(file_fd, file_buf);
+    if (!out_buf.empty()) writeAll(STDOUT_FILENO, out_buf);
+    if (!err_buf.empty()) writeAll(STDERR_FILENO, err_buf);
+    file_buf.clear();
+    out_buf.clear();
+    err_buf.clear();
+}
+
+void Logger::writerLoop() {
+    std::string file_buf;
+    std::string out_buf;
+    std::string err_buf;
+    file_buf.reserve(async_options.batch_bytes * 2);
+    
+    for (;;) {
+        // Read both before draining: an empty pass only covers what was
+        // committed before it started, so stopping needs a pass begun
+        // after stopAsync cleared the flag
+        uint64_t flush_target;
+        bool running = writer_running.load();
+        {
+            std::lock_guard<std::mutex> lock(flush_mutex);
+            flush_target = flush_requested;
+        }
+        
+        size_t records = drainRings(file_buf, out_buf, err_buf);
+        if (records > 0) {
+            continue;
+        }
+        
+        // Idle: everything queued so far is formatted, so write it out
+        writeBuffers(file_buf, out_buf, err_buf);
+        
+        std::unique_lock<std::mutex> lock(flush_mutex);
+        flush_completed = flush_target;
+        flush_cv.notify_all();
+        if (!running) {
+            break;
+        }
+        flush_cv.wait_for(lock, std::chrono::milliseconds(async_options.idle_wait_ms), [this] {
+            return flush_requested > flush_completed || !writer_running.load();
+        });
+    }
+}
+
+} // namespace TradingSystem
@@ -9,6 +9,14 @@
 #include <iomanip>
 #include <mutex>
 #include <memory>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <vector>
+#include <string_view>
+#include <type_traits>
+#include "log_ring.h"
+#include "../metrics/metrics_registry.h"
 
 namespace TradingSystem {
 
@@ -20,6 +28,61 @@ enum class LogLevel {
     CRITICAL = 4
 };
 
+// What a logging thread does when its ring is full in async mode
+enum class LogOverflowPolicy {
+    DROP,   // Discard the record silently (still counted in droppedCount)
+    BLOCK,  // Wait for the writer thread to make room
+    COUNT   // Discard, and have the writer report how many were lost
+};
+
+struct AsyncLogOptions {
+    size_t ring_bytes = 256 * 1024;       // per logging thread
+    LogOverflowPolicy overflow = LogOverflowPolicy::COUNT;
+    size_t batch_bytes = 64 * 1024;       // write() once this much is formatted
+    int idle_wait_ms = 2;                 // writer sleep when all rings are empty
+};
+
+// Encoding of hot-path log arguments into a binary record
+struct LogArgCodec {
+    template <typename T>
+    static size_t size(const T& value) {
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+            return 1 + sizeof(uint64_t);
+        } else {
+            return 1 + sizeof(uint32_t) + std::string_view(value).size();
+        }
+    }
+
+    template <typename T>
+    static void encode(char*& out, const T& value) {
+        if constexpr (std::is_floating_point_v<T>) {
+            put(out, LOG_ARG_DOUBLE, static_cast<double>(value));
+        } else if constexpr (std::is_enum_v<T>) {
+            put(out, LOG_ARG_INT, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            put(out, LOG_ARG_INT, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<T>) {
+            put(out, LOG_ARG_UINT, static_cast<uint64_t>(value));
+        } else {
+            std::string_view text(value);
+            uint32_t length = static_cast<uint32_t>(text.size());
+            *out++ = static_cast<char>(LOG_ARG_STRING);
+            std::memcpy(out, &length, sizeof(length));
+            out += sizeof(length);
+            std::memcpy(out, text.data(), length);
+            out += length;
+        }
+    }
+
+private:
+    template <typename V>
+    static void put(char*& out, LogArgTag tag, V value) {
+        *out++ = static_cast<char>(tag);
+        std::memcpy(out, &value, sizeof(value));
+        out += sizeof(value);
+    }
+};
+
 class Logger {
 public:
     static Logger& getInstance() {
@@ -32,9 +95,54 @@ public:
                    LogLevel level = LogLevel::INFO);
     
     // Set log level
-    void setLogLevel(LogLevel level) { log_level = level; }
+    void setLogLevel(LogLevel level) { log_level.store(level, std::memory_order_relaxed); }
     void setLogLevel(const std::string& level);
     
+    // Echo records to stdout/stderr as well as the file (the default).
+    // Set before startAsync: the writer thread reads it unlocked.
+    void setConsoleOutput(bool enabled) { console_output = enabled; }
+    
+    // One relaxed load; the LOG_ macros test this before building messages
+    bool isEnabled(LogLevel level) const {
+        return level >= log_level.load(std::memory_order_relaxed);
+    }
+    
+    // Asynchronous mode: logging threads push binary records into their
+    // own lock-free rings and a background thread formats and writes them
+    void startAsync(const AsyncLogOptions& options = AsyncLogOptions());
+    void stopAsync();
+    bool isAsync() const { return async_enabled.load(std::memory_order_acquire); }
+    uint64_t droppedCount() const;
+    static LogOverflowPolicy parseOverflowPolicy(const std::string& policy);
+    
+    // Hot-path logging with a pre-registered format ("{}" placeholders).
+    // In async mode only the raw arguments are copied on the calling thread.
+    static uint16_t registerFormat(const char* format);
+    
+    template <typename... Args>
+    void logFormat(LogLevel level, uint16_t format_id, const Args&... args) {
+        if (!isEnabled(level)) return;
+        size_t size = sizeof(LogRecordHeader) + (size_t(0) + ... + LogArgCodec::size(args));
+        
+        if (isAsync()) {
+            LogRing* ring = threadRing();
+            if (size <= ring->maxRecordSize()) {
+                char* out = reserveRecord(ring, size);
+                if (!out) return;
+                encodeRecord(out, size, level, format_id, args...);
+                ring->commit(size);
+                return;
+            }
+            // A record the ring can never hold is written on this thread,
+            // after the writer has drained what was queued before it
+            flush();
+        }
+        
+        std::string record(size, '\0');
+        encodeRecord(&record[0], size, level, format_id, args...);
+        writeSyncRecord(record.data());
+    }
+    
     // Logging methods
     void debug(const std::string& message);
     void info(const std::string& message);
@@ -62,6 +170,7 @@ public:
 private:
     Logger() : log_level(LogLevel::INFO), console_output(true) {}
     ~Logger() { 
+        stopAsync();
         if (log_file.is_open()) {
             log_file.close();
         }
@@ -71,40 +180,114 @@ private:
     Logger& operator=(const Logger&) = delete;
     
     std::ofstream log_file;
-    LogLevel log_level;
+    std::string log_path;
+    std::atomic<LogLevel> log_level;
     bool console_output;
     std::mutex log_mutex;
     
+    // Async state
+    AsyncLogOptions async_options;
+    std::atomic<bool> async_enabled{false};
+    std::atomic<bool> writer_running{false};
+    std::thread writer_thread;
+    int file_fd = -1;
+    std::mutex rings_mutex;
+    std::vector<std::shared_ptr<LogRing>> rings;
+    std::atomic<uint64_t> retired_dropped{0};
+    
+    std::mutex flush_mutex;
+    std::condition_variable flush_cv;
+    uint64_t flush_requested = 0;
+    uint64_t flush_completed = 0;
+    
+    // TSC to wall-clock calibration
+    uint64_t tsc_base = 0;
+    int64_t wall_base_ns = 0;
+    double ticks_per_ns = 1.0;
+    
     std::string getCurrentTimestamp();
     std::string levelToString(LogLevel level);
     LogLevel stringToLevel(const std::string& level);
     void writeLog(const std::string& level_str, const std::string& message);
+    
+    LogRing* threadRing();
+    char* reserveRecord(LogRing* ring, size_t size);
+    void writeSyncRecord(const char* record);
+    void writerLoop();
+    size_t drainRings(std::string& file_buf, std::string& out_buf, std::string& err_buf);
+    void formatRecord(const char* record, std::string& line);
+    void appendTimestamp(uint64_t tsc, std::string& line);
+    void writeBuffers(std::string& file_buf, std::string& out_buf, std::string& err_buf);
+    
+    template <typename... Args>
+    static void encodeRecord(char* out, size_t size, LogLevel level, uint16_t format_id,
+                             const Args&... args) {
+        LogRecordHeader header;
+        header.size = static_cast<uint32_t>(size);
+        header.format_id = format_id;
+        header.level = static_cast<uint8_t>(level);
+        header.arg_count = static_cast<uint8_t>(sizeof...(Args));
+        header.tsc = readTimestampCounter();
+        std::memcpy(out, &header, sizeof(header));
+        char* cursor = out + sizeof(header);
+        (LogArgCodec::encode(cursor, args), ...);
+    }
 };
 
-// Convenience macros
-#define LOG_DEBUG(msg) TradingSystem::Logger::getInstance().debug(msg)
-#define LOG_INFO(msg) TradingSystem::Logger::getInstance().info(msg)
-#define LOG_WARNING(msg) TradingSystem::Logger::getInstance().warning(msg)
-#define LOG_ERROR(msg) TradingSystem::Logger::getInstance().error(msg)
-#define LOG_CRITICAL(msg) TradingSystem::Logger::getInstance().critical(msg)
+// Convenience macros. The level is checked before msg is evaluated, so a
+// disabled level costs one branch and never builds the message string.
+#define TS_LOG_AT(level, method, msg) \
+    do { \
+        auto& ts_logger_ = TradingSystem::Logger::getInstance(); \
+        if (ts_logger_.isEnabled(level)) ts_logger_.method(msg); \
+    } while (0)
+
+#define LOG_DEBUG(msg) TS_LOG_AT(TradingSystem::LogLevel::DEBUG, debug, msg)
+#define LOG_INFO(msg) TS_LOG_AT(TradingSystem::LogLevel::INFO, info, msg)
+#define LOG_WARNING(msg) TS_LOG_AT(TradingSystem::LogLevel::WARNING, warning, msg)
+#define LOG_ERROR(msg) TS_LOG_AT(TradingSystem::LogLevel::ERROR, error, msg)
+#define LOG_CRITICAL(msg) TS_LOG_AT(TradingSystem::LogLevel::CRITICAL, critical, msg)
+
+// Hot-path variant: LOG_FAST(LogLevel::INFO, "Fetched {} at {}", symbol, price).
+// The format string is registered once per call site.
+#define LOG_FAST(level, format, ...) \
+    do { \
+        auto& ts_logger_ = TradingSystem::Logger::getInstance(); \
+        if (ts_logger_.isEnabled(level)) { \
+            static const uint16_t ts_format_id_ = TradingSystem::Logger::registerFormat(format); \
+            ts_logger_.logFormat(level, ts_format_id_, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+// Time the enclosing scope into the metrics registry (and a DEBUG line)
+#define PERF_TIMER(name) \
+    TradingSystem::PerformanceTimer TS_METRICS_CONCAT(ts_perf_timer_, __LINE__)(METRIC_TIMER_ID(name))
 
 // Performance timer helper
 class PerformanceTimer {
 public:
-    PerformanceTimer(const std::string& operation_name) 
-        : operation(operation_name), 
-          start_time(std::chrono::high_resolution_clock::now()) {}
+    // Hot paths should use PERF_TIMER, which registers the name only once
+    explicit PerformanceTimer(MetricId timer_id)
+        : timer(timer_id),
+          start_time(std::chrono::steady_clock::now()) {}
+    
+    explicit PerformanceTimer(const std::string& operation_name)
+        : PerformanceTimer(MetricsRegistry::getInstance().registerTimer(operation_name)) {}
     
     ~PerformanceTimer() {
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>
-                       (end_time - start_time).count();
-        Logger::getInstance().logPerformance(operation, duration / 1000.0);
+        uint64_t duration_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>
+                       (std::chrono::steady_clock::now() - start_time).count());
+        MetricsRegistry& metrics = MetricsRegistry::getInstance();
+        metrics.recordLatency(timer, duration_ns);
+        
+        if (Logger::getInstance().isEnabled(LogLevel::DEBUG)) {
+            Logger::getInstance().logPerformance(metrics.timerName(timer), duration_ns / 1e6);
+        }
     }
     
 private:
-    std::string operation;
-    std::chrono::high_resolution_clock::time_point start_time;
+    MetricId timer;
+    std::chrono::steady_clock::time_point start_time;
 };
 
 } // namespace TradingSystem
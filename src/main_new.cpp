@@ -6,225 +6,764 @@
 #include <memory>
 #include <vector>
 #include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <cstdlib>
 
 #include "api.h"
 #include "config/config_manager.h"
+#include "config/config_watcher.h"
 #include "logging/logger.h"
 #include "database/database_manager.h"
+#include "database/async_db_writer.h"
 #include "ipc/ipc_manager.h"
-#include "trading/trading_engine.h"
+#include "ipc/message_dispatcher.h"
+#include "trading/sharded_trading_engine.h"
+#include "market_data/market_data_cache.h"
+#include "market_data/pricing_service.h"
+#include "analysis/indicator_engine.h"
+#include "analysis/warm_snapshot.h"
+#include "analysis/model_signals.h"
+#include "analysis/simd_kernels.h"
+#include "metrics/metrics_exporter.h"
+#include "core/event_loop.h"
+#include "core/startup_orchestrator.h"
 #include "common/data_types.h"
+#include "common/wire_format.h"
 
 using namespace TradingSystem;
 
 std::atomic<bool> running(true);
+std::atomic<int> shutdown_signal(0);
+EventLoop* main_loop = nullptr;
+std::atomic<ConfigWatcher*> config_watcher(nullptr);
 
+// Only async-signal-safe work here; the loop logs the signal once it exits
 void signalHandler(int signum) {
-    LOG_INFO("Received signal " + std::to_string(signum) + ", shutting down...");
+    shutdown_signal = signum;
     running = false;
+    if (main_loop) {
+        main_loop->stop();
+    }
+}
+
+// SIGHUP: re-read config.ini on the loop thread
+void reloadHandler(int) {
+    if (ConfigWatcher* watcher = config_watcher.load()) {
+        watcher->trigger();
+    }
 }
 
 class TradingSystemApp {
 private:
     std::unique_ptr<StockApi> api;
     std::shared_ptr<DatabaseManager> db_manager;
+    std::shared_ptr<AsyncDbWriter> db_writer;
+    std::shared_ptr<MarketDataCache> market_data_cache;
+    std::shared_ptr<PricingService> pricing_service;
+    std::unique_ptr<IndicatorEngine> indicator_engine;
+    std::unique_ptr<ModelSignalGenerator> model_signals;  // null = Python analyzes every symbol
     std::unique_ptr<IPCManager> ipc_manager;
+    std::unique_ptr<MessageDispatcher> message_dispatcher;
     std::unique_ptr<PythonProcessManager> python_manager;
-    std::unique_ptr<TradingEngine> trading_engine;
+    std::unique_ptr<ShardedTradingEngine> trading_engine;
+    std::unique_ptr<MetricsExporter> metrics_exporter;
+    std::unique_ptr<EventLoop> event_loop;
+    std::unique_ptr<ConfigWatcher> watcher;
+    // Settings as started; reloads update only the fields applied live
     TradingConfig config;
     
+    // Market data is fetched off the loop thread, one request at a time
+    std::thread fetch_thread;
+    std::atomic<bool> fetch_in_flight{false};
+    std::vector<MarketData> fetched_bars;
+    // Set by events that change what displayStatus would print
+    std::atomic<bool> status_dirty{true};
+    
+    // Monotonic send time of the outstanding analysis request, 0 if none
+    std::atomic<int64_t> analysis_sent_ns{0};
+    // Requests wait for the analyzer's ready message; one that came due
+    // before it is run when it arrives
+    std::atomic<bool> python_ready{false};
+    std::atomic<bool> analysis_deferred{false};
+    std::atomic<int64_t> python_started_ns{0};
+    // Ask the analyzer for binary wire-format replies instead of JSON
+    bool binary_replies = false;
+    MetricId ipc_round_trip_timer = MetricsRegistry::getInstance().registerTimer("IpcRoundTrip");
+    MetricId bars_fetched_counter = MetricsRegistry::getInstance().registerCounter(
+        "ts_market_data_bars_total", "Bars received from the market data API");
+    MetricId signals_counter = MetricsRegistry::getInstance().registerCounter(
+        "ts_trading_signals_total", "Trading signals received from the analyzer");
+    
 public:
     bool initialize() {
+        // Every event is dispatched on the thread that calls run()
+        event_loop = std::make_unique<EventLoop>();
+        if (!event_loop->isValid()) {
+            std::cerr << "Failed to create event loop" << std::endl;
+            return false;
+        }
+        main_loop = event_loop.get();
+        
         // Set up signal handlers
         signal(SIGINT, signalHandler);
         signal(SIGTERM, signalHandler);
+        signal(SIGHUP, reloadHandler);
         
         // Load configuration
         LOG_INFO("Loading configuration...");
         ConfigManager::getInstance().loadConfig("config.ini");
-        config = TradingConfig::loadFromConfig();
+        config = *ConfigManager::getInstance().snapshot();
         
         // Initialize logger
         Logger::getInstance().initialize(config.log_file, LogLevel::INFO);
         Logger::getInstance().setLogLevel(config.log_level);
+        if (config.log_async) {
+            AsyncLogOptions log_options;
+            log_options.ring_bytes = static_cast<size_t>(config.log_ring_kb) * 1024;
+            log_options.overflow = Logger::parseOverflowPolicy(config.log_overflow);
+            Logger::getInstance().startAsync(log_options);
+        }
         LOG_INFO("Trading System starting...");
         
-        // Initialize database
+        // Set while this is the only thread: inherited by the analyzer so
+        // it maps the same journal files
+        if (!config.db_journal_dir.empty()) {
+            setenv("TS_BAR_JOURNAL_DIR", config.db_journal_dir.c_str(), 1);
+        }
+        
+        // Latest bars live in memory; SQLite is only the historical record
+        market_data_cache = std::make_shared<MarketDataCache>(config.market_data_history_depth);
+        indicator_engine = std::make_unique<IndicatorEngine>();
+        
+        // Independent subsystems come up in parallel; each step waits only
+        // for what it reads. Python is launched, not waited for: it
+        // announces itself with a ready message and analysis requests are
+        // held back until then.
+        StartupOrchestrator startup;
+        auto database = startup.add("database", [this] { return initializeDatabase(); });
+        startup.add("warm_indicators", [this] { return warmIndicators(); }, {database});
+        startup.add("trading_engine", [this] { return initializeTradingEngine(); }, {database});
+        startup.add("model", [this] { return loadModel(); });
+        startup.add("api", [this] { return initializeApi(); });
+        auto ipc = startup.add("ipc", [this] { return initializeIpc(); });
+        startup.add("python", [this] { return startPython(); }, {ipc});
+        
+        bool started = startup.run();
+        for (const auto& step : startup.timings()) {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(1) << "Startup step " << step.name << ": ";
+            if (!step.ran) {
+                ss << "skipped";
+            } else {
+                ss << (step.ok ? "" : "failed after ") << step.duration_ms << " ms (at +" << step.start_ms << " ms)";
+            }
+            LOG_INFO(ss.str());
+        }
+        if (!started) {
+            LOG_ERROR("System initialization failed");
+            return false;
+        }
+        
+        startMetrics();
+        
+        // Edits to config.ini (or a SIGHUP) apply risk limits and the log
+        // level without a restart
+        watcher = std::make_unique<ConfigWatcher>();
+        if (watcher->start(*event_loop, "config.ini", [this] { reloadConfig(); })) {
+            config_watcher = watcher.get();
+        }
+        
+        LOG_INFO("System initialization complete (" + std::to_string(startup.totalMs()) + " ms for the parallel steps)");
+        return true;
+    }
+    
+    void run() {
+        LOG_INFO("Trading system running in " + config.trading_mode + " mode");
+        LOG_INFO("Initial balance: $" + std::to_string(config.initial_balance));
+        LOG_INFO("Tracking symbols: " + vectorToString(config.symbols));
+        
+        // Each event does only the work it invalidates: fresh prices re-mark
+        // positions, signals go straight to the engine, timers drive fetches
+        // and analysis, and status is printed only after something changed.
+        const int fetch_ms = std::max(1, config.data_fetch_interval_seconds) * 1000;
+        const int analysis_ms = std::max(1, config.analysis_interval_seconds) * 1000;
+        const int status_ms = 30 * 1000;
+        event_loop->addTimer(fetch_ms, fetch_ms, [this] { startMarketDataFetch(); });
+        event_loop->addTimer(analysis_ms, analysis_ms, [this] { runAnalysis(); });
+        event_loop->addTimer(status_ms, status_ms, [this] { displayStatus(); });
+        
+        if (running) {
+            event_loop->run();
+        }
+        running = false;
+        main_loop = nullptr;
+        config_watcher = nullptr;
+        
+        if (shutdown_signal != 0) {
+            LOG_INFO("Received signal " + std::to_string(shutdown_signal.load()) + ", shutting down...");
+        }
+    }
+    
+    void shutdown() {
+        LOG_INFO("Shutting down trading system...");
+        
+        // Let an in-flight fetch finish; its completion is never dispatched
+        if (fetch_thread.joinable()) {
+            fetch_thread.join();
+        }
+        
+        // Indicator state for the next start; nothing updates it from here
+        if (!config.warm_snapshot.empty() && indicator_engine && market_data_cache) {
+            if (WarmSnapshot::save(config.warm_snapshot, config.symbols, *indicator_engine, *market_data_cache)) {
+                LOG_INFO("Saved indicator state to " + config.warm_snapshot);
+            } else {
+                LOG_WARNING("Could not save indicator state to " + config.warm_snapshot);
+            }
+        }
+        
+        // Stop Python process
+        if (python_manager) {
+            python_manager->stop();
+        }
+        
+        // Stop IPC, then run whatever the reader already handed off
+        if (ipc_manager) {
+            ipc_manager->stop();
+        }
+        if (message_dispatcher) {
+            message_dispatcher->stop();
+        }
+        
+        // Let the engine shards finish queued signals and price updates
+        if (trading_engine) {
+            trading_engine->stop();
+        }
+        
+        // Flush queued orders and positions before reporting final state
+        if (db_writer) {
+            if (!db_writer->flush()) {
+                LOG_WARNING("Timed out flushing " + std::to_string(db_writer->queueDepth()) +
+                           " pending database writes");
+            }
+            db_writer->stop();
+            LOG_INFO("Persisted " + std::to_string(db_writer->committedCount()) + " mutations (" +
+                    std::to_string(db_writer->coalescedCount()) + " coalesced)");
+        }
+        
+        // Final portfolio status
+        if (trading_engine) {
+            PortfolioSnapshot portfolio = trading_engine->getPortfolioSnapshot();
+            LOG_INFO("Final portfolio value: $" + 
+                    std::to_string(portfolio.equity));
+            LOG_INFO("Total P&L: $" + 
+                    std::to_string(trading_engine->getTotalPnL()));
+        }
+        
+        // Last snapshot includes the shutdown flush latencies
+        if (metrics_exporter) {
+            metrics_exporter->stop();
+            metrics_exporter->writeSnapshot();
+            MetricsRegistry::getInstance().removeGaugeCallback("ts_db_writer_queue_depth");
+            MetricsRegistry::getInstance().removeGaugeCallback("ts_engine_queue_depth");
+            MetricsRegistry::getInstance().removeGaugeCallback("ts_ipc_dispatch_queue_depth");
+            MetricsRegistry::getInstance().removeGaugeCallback("ts_ipc_dispatch_backpressure_total");
+            MetricsRegistry::getInstance().removeGaugeCallback("ts_ipc_buffer_pool_misses_total");
+        }
+        
+        LOG_INFO("Shutdown complete");
+        Logger::getInstance().stopAsync();
+    }
+    
+private:
+    static int64_t steadyNowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+    // Startup steps, run concurrently by initialize()
+    bool initializeDatabase() {
         LOG_INFO("Initializing database...");
         db_manager = std::make_shared<DatabaseManager>(config.db_path);
         if (!db_manager->initialize()) {
             LOG_ERROR("Failed to initialize database");
             return false;
         }
+        if (!config.db_journal_dir.empty()) {
+            if (!db_manager->enableBarJournal(config.db_journal_dir)) {
+                LOG_ERROR("Failed to open bar journal in " + config.db_journal_dir);
+                return false;
+            }
+            LOG_INFO("Market data journaled under " + config.db_journal_dir);
+        }
         
-        // Initialize API
+        // Write-behind persistence keeps SQLite off the order path
+        if (config.db_async_writes) {
+            db_writer = std::make_shared<AsyncDbWriter>(db_manager,
+                                                        static_cast<size_t>(config.db_writer_queue_size),
+                                                        config.db_writer_max_lag_ms);
+            db_writer->start();
+        }
+        return true;
+    }
+    
+    // Restore streaming indicators and latest bars from the shutdown
+    // snapshot and replay only the bars stored since; symbols it does not
+    // cover are warmed from stored history so features are ready without
+    // Python re-reading it
+    bool warmIndicators() {
+        std::vector<WarmSnapshot::Restored> restored;
+        if (!config.warm_snapshot.empty() &&
+            WarmSnapshot::load(config.warm_snapshot, *indicator_engine, *market_data_cache, restored)) {
+            LOG_INFO("Restored indicator state for " + std::to_string(restored.size()) +
+                     " symbols from " + config.warm_snapshot);
+        }
+        
+        size_t replayed = 0;
+        auto now = std::chrono::system_clock::now();
+        for (const auto& symbol : config.symbols) {
+            auto snapshot = std::find_if(restored.begin(), restored.end(),
+                                         [&symbol](const WarmSnapshot::Restored& r) { return r.symbol == symbol; });
+            if (snapshot == restored.end()) {
+                auto history = db_manager->getMarketData(symbol, config.indicator_warmup_bars);
+                std::reverse(history.begin(), history.end());
+                BarSeries series = BarSeries::fromMarketData(symbol, history);
+                indicator_engine->warmUp(series);
+                if (!series.empty()) {
+                    market_data_cache->update(series.row(series.size() - 1));
+                }
+                continue;
+            }
+            
+            SymbolId id = SymbolTable::getInstance().intern(symbol);
+            CachedBar last;
+            bool any = false;
+            replayed += db_manager->getMarketDataRange(symbol, fromEpochNanos(snapshot->timestamp_ns + 1), now,
+                [&](const DatabaseManager::BarRow& row) {
+                    indicator_engine->update(id, row.high, row.low, row.close, row.volume);
+                    last = CachedBar{row.open, row.high, row.low, row.close, row.volume, row.timestamp_ns};
+                    any = true;
+                    return true;
+                });
+            if (any) {
+                market_data_cache->update(id, last);
+            }
+        }
+        if (!restored.empty()) {
+            LOG_INFO("Replayed " + std::to_string(replayed) + " bars stored since the snapshot");
+        }
+        return true;
+    }
+    
+    // Optional in-process scoring; Python stays the fallback for
+    // symbols still warming up and for everything if the model is off
+    bool loadModel() {
+        if (config.model_path.empty()) {
+            return true;
+        }
+        auto model = std::make_shared<MlpModel>();
+        if (!model->load(config.model_path)) {
+            LOG_WARNING("Could not load model " + config.model_path + ", analysis stays in Python");
+        } else if (model->inputSize() != IndicatorEngine::kFeatureCount) {
+            LOG_WARNING("Model " + config.model_path + " takes " + std::to_string(model->inputSize()) +
+                        " features, expected " + std::to_string(IndicatorEngine::kFeatureCount) +
+                        "; analysis stays in Python");
+        } else {
+            model_signals = std::make_unique<ModelSignalGenerator>(model, config.model_signal_fraction);
+            LOG_INFO("Scoring signals in-process with " + config.model_path + " (" +
+                     std::to_string(model->layerCount()) + " layers, " +
+                     kernelSetName(activeKernelSet()) + " kernels)");
+        }
+        return true;
+    }
+    
+    bool initializeApi() {
         LOG_INFO("Initializing API connection...");
         api = std::make_unique<StockApi>();
         if (!api->isInitialized()) {
             LOG_ERROR("Failed to initialize API - check API_KEY in .env file");
             return false;
         }
-        
-        // Initialize IPC
-        LOG_INFO("Setting up IPC communication...");
-        ipc_manager = std::make_unique<IPCManager>(config.ipc_pipe_name);
+        return true;
+    }
+    
+    bool initializeIpc() {
+        LOG_INFO("Setting up IPC communication (" + config.ipc_transport + " transport)...");
+        ipc_manager = std::make_unique<IPCManager>(config.ipc_pipe_name,
+                                                   IPCManager::parseTransport(config.ipc_transport),
+                                                   static_cast<size_t>(config.ipc_shm_capacity_kb) * 1024);
         if (!ipc_manager->initialize()) {
             LOG_ERROR("Failed to initialize IPC");
             return false;
         }
         
-        // Set up message callback
-        ipc_manager->setMessageCallback([this](const std::string& message) {
+        if (config.ipc_wire_format == "binary") {
+            binary_replies = ipc_manager->getTransport() == IPCTransport::SHARED_MEMORY;
+            if (!binary_replies) {
+                LOG_WARNING("Binary wire format needs the shm transport, replies stay JSON");
+            }
+        } else if (config.ipc_wire_format != "json") {
+            LOG_WARNING("Unknown IPC wire format '" + config.ipc_wire_format + "', using json");
+        }
+        
+        // Reader thread -> bounded per-symbol queues -> dispatch workers
+        message_dispatcher = std::make_unique<MessageDispatcher>(
+            static_cast<size_t>(std::max(1, config.ipc_dispatch_workers)),
+            static_cast<size_t>(std::max(1, config.ipc_dispatch_queue_size)));
+        message_dispatcher->setHandler([this](const std::string& message) {
             handlePythonMessage(message);
         });
+        // batch_analyze replies are sized and risk-checked as one batch
+        message_dispatcher->setSplitResults(false);
+        message_dispatcher->start();
+        ipc_manager->setMessageCallback([this](std::string_view message) {
+            // The analyzer's ready message is handled on the reader thread
+            if (!python_ready.load(std::memory_order_acquire) &&
+                message.find("\"event\":\"ready\"") != std::string::npos) {
+                onPythonReady();
+                return;
+            }
+            message_dispatcher->dispatch(message);
+        });
         
-        // Start IPC
         ipc_manager->start();
-        
-        // Initialize Python process
+        return true;
+    }
+    
+    bool startPython() {
         LOG_INFO("Starting Python analyzer process...");
         python_manager = std::make_unique<PythonProcessManager>("market_data_analyzer.py");
         python_manager->attachIPC(ipc_manager.get());
         
+        python_started_ns = steadyNowNs();
         if (!python_manager->start()) {
             LOG_ERROR("Failed to start Python process");
             return false;
         }
-        
-        // Wait for Python to be ready
-        std::this_thread::sleep_for(std::chrono::seconds(2));
-        
-        // Initialize trading engine
+        return true;
+    }
+    
+    bool initializeTradingEngine() {
         LOG_INFO("Initializing trading engine...");
         TradingMode mode = (config.trading_mode == "live") ? 
                           TradingMode::LIVE : TradingMode::PAPER;
         
-        trading_engine = std::make_unique<TradingEngine>(mode, config.initial_balance);
-        trading_engine->initialize(db_manager);
+        // Symbols are sharded across engine workers; cash and drawdown
+        // are shared through the engine's portfolio aggregator
+        trading_engine = std::make_unique<ShardedTradingEngine>(
+            mode, config.initial_balance, static_cast<size_t>(std::max(1, config.engine_shards)));
+        trading_engine->setAsyncWriter(db_writer);
+        trading_engine->setMarketDataCache(market_data_cache);
+        pricing_service = std::make_shared<PricingService>(
+            market_data_cache, std::chrono::seconds(std::max(0, config.max_price_age_seconds)),
+            config.quote_spread);
+        trading_engine->setPricingService(pricing_service);
         trading_engine->setMaxPositionSize(config.max_position_size);
         trading_engine->setMaxDrawdown(config.max_drawdown);
+        trading_engine->setStopLoss(config.stop_loss_percentage);
+        trading_engine->setTakeProfit(config.take_profit_percentage);
+        return trading_engine->initialize(db_manager);
+    }
+    
+    // IPC reader thread: the analyzer has attached and can take requests.
+    // An analysis held back while it was starting runs now.
+    void onPythonReady() {
+        python_ready.store(true, std::memory_order_release);
+        double ready_ms = static_cast<double>(steadyNowNs() - python_started_ns.load()) / 1e6;
+        LOG_INFO("Python analyzer ready " + std::to_string(ready_ms) + " ms after launch");
+        if (analysis_deferred.exchange(false)) {
+            event_loop->post([this] { runAnalysis(); });
+        }
+    }
+    
+    static RiskLimits riskLimits(const TradingConfig& settings) {
+        RiskLimits limits;
+        limits.max_position_size = settings.max_position_size;
+        limits.max_drawdown = settings.max_drawdown;
+        limits.stop_loss_percentage = settings.stop_loss_percentage;
+        limits.take_profit_percentage = settings.take_profit_percentage;
+        return limits;
+    }
+    
+    // Loop thread, after config.ini changed or SIGHUP
+    void reloadConfig() {
+        ConfigManager& config_manager = ConfigManager::getInstance();
+        if (!config_manager.reload()) {
+            LOG_WARNING("Config reload failed, keeping the current settings");
+            return;
+        }
+        std::shared_ptr<const TradingConfig> next = config_manager.snapshot();
         
-        LOG_INFO("System initialization complete");
-        return true;
+        std::vector<std::string> applied;
+        if (next->log_level != config.log_level) {
+            Logger::getInstance().setLogLevel(next->log_level);
+            config.log_level = next->log_level;
+            applied.push_back("log level " + next->log_level);
+        }
+        if (next->max_position_size != config.max_position_size ||
+            next->max_drawdown != config.max_drawdown ||
+            next->stop_loss_percentage != config.stop_loss_percentage ||
+            next->take_profit_percentage != config.take_profit_percentage) {
+            trading_engine->updateRiskLimits(riskLimits(*next));
+            config.max_position_size = next->max_position_size;
+            config.max_drawdown = next->max_drawdown;
+            config.stop_loss_percentage = next->stop_loss_percentage;
+            config.take_profit_percentage = next->take_profit_percentage;
+            applied.push_back("risk limits (max position $" + std::to_string(config.max_position_size) +
+                              ", max drawdown " + std::to_string(config.max_drawdown * 100.0) +
+                              "%, stop-loss " + std::to_string(config.stop_loss_percentage * 100.0) +
+                              "%, take-profit " + std::to_string(config.take_profit_percentage * 100.0) + "%)");
+        }
+        
+        // Everything else is wired into threads and files at startup
+        std::vector<std::string> restart;
+        if (next->symbols != config.symbols) restart.push_back("symbols");
+        if (next->trading_mode != config.trading_mode) restart.push_back("trading mode");
+        if (next->initial_balance != config.initial_balance) restart.push_back("initial balance");
+        if (next->engine_shards != config.engine_shards) restart.push_back("engine shards");
+        if (next->db_path != config.db_path) restart.push_back("database path");
+        if (next->ipc_transport != config.ipc_transport) restart.push_back("IPC transport");
+        if (next->ipc_wire_format != config.ipc_wire_format) restart.push_back("IPC wire format");
+        
+        LOG_INFO(applied.empty() ? std::string("Config reloaded, nothing to apply")
+                                 : "Config reloaded, applied " + vectorToString(applied));
+        if (!restart.empty()) {
+            LOG_WARNING("Changed " + vectorToString(restart) + " take effect after a restart");
+        }
     }
     
-    void run() {
-        LOG_INFO("Trading system running in " + config.trading_mode + " mode");
-        LOG_INFO("Initial balance: $" + std::to_string(config.initial_balance));
-        LOG_INFO("Tracking symbols: " + vectorToString(config.symbols));
+    void startMetrics() {
+        if (!config.metrics_enabled) return;
         
-        auto last_fetch = std::chrono::steady_clock::now();
-        auto last_analysis = std::chrono::steady_clock::now();
+        MetricsRegistry& metrics = MetricsRegistry::getInstance();
+        if (db_writer) {
+            metrics.registerGaugeCallback("ts_db_writer_queue_depth",
+                                          "Mutations waiting for the write-behind thread",
+                                          [this] { return static_cast<double>(db_writer->queueDepth()); });
+        }
+        metrics.registerGaugeCallback("ts_engine_queue_depth", "Tasks waiting for an engine shard",
+                                      [this] { return static_cast<double>(trading_engine->queueDepth()); });
+        if (message_dispatcher) {
+            metrics.registerGaugeCallback("ts_ipc_dispatch_queue_depth",
+                                          "Python messages waiting for a dispatch worker",
+                                          [this] { return static_cast<double>(message_dispatcher->queueDepth()); });
+            metrics.registerGaugeCallback("ts_ipc_dispatch_backpressure_total",
+                                          "Times the IPC reader waited on a full dispatch queue",
+                                          [this] { return static_cast<double>(message_dispatcher->backpressureCount()); });
+            metrics.registerGaugeCallback("ts_ipc_buffer_pool_misses_total",
+                                          "Dispatched messages that needed a newly allocated buffer",
+                                          [this] { return static_cast<double>(message_dispatcher->bufferMissCount()); });
+        }
+        metrics.registerGaugeCallback("ts_log_dropped_records", "Log records lost to full rings",
+                                      [] { return static_cast<double>(Logger::getInstance().droppedCount()); });
         
-        while (running) {
-            auto now = std::chrono::steady_clock::now();
-            
-            // Fetch market data at intervals
-            if (std::chrono::duration_cast<std::chrono::seconds>
-                (now - last_fetch).count() >= config.data_fetch_interval_seconds) {
-                
-                fetchMarketData();
-                last_fetch = now;
+        metrics_exporter = std::make_unique<MetricsExporter>();
+        if (metrics_exporter->start(config.metrics_port, config.metrics_bind_address,
+                                    config.metrics_snapshot_file,
+                                    config.metrics_snapshot_interval_seconds)) {
+            if (metrics_exporter->boundPort() > 0) {
+                LOG_INFO("Serving metrics on http://" + config.metrics_bind_address + ":" +
+                        std::to_string(metrics_exporter->boundPort()) + "/metrics");
             }
+            if (!config.metrics_snapshot_file.empty()) {
+                LOG_INFO("Writing metrics snapshots to " + config.metrics_snapshot_file);
+            }
+        } else {
+            LOG_WARNING("Metrics export not started");
+            metrics_exporter.reset();
+        }
+    }
+    
+    void startMarketDataFetch() {
+        if (fetch_in_flight.exchange(true)) {
+            LOG_WARNING("Previous market data fetch still running, skipping this interval");
+            return;
+        }
+        if (fetch_thread.joinable()) {
+            fetch_thread.join();
+        }
+        fetch_thread = std::thread([this] {
+            fetchMarketData();
+            fetch_in_flight = false;
+            event_loop->post([this] { onMarketDataUpdated(); });
+        });
+    }
+    
+    // Loop thread: prices moved, so re-mark positions (stop-loss and
+    // take-profit run here) and let the next status print show it
+    void onMarketDataUpdated() {
+        updatePortfolio();
+        status_dirty = true;
+    }
+    
+    void fetchMarketData() {
+        PERF_TIMER("FetchMarketData");
+        
+        try {
+            // One concurrent round trip for the whole universe
+            // Reused across cycles; only one fetch is ever in flight
+            std::vector<MarketData>& bars = fetched_bars;
+            api->fetchLatestBars(config.symbols, config.api_timeout_ms, bars);
             
-            // Run analysis at intervals
-            if (std::chrono::duration_cast<std::chrono::seconds>
-                (now - last_analysis).count() >= config.analysis_interval_seconds) {
-                
-                runAnalysis();
-                last_analysis = now;
+            MetricsRegistry::getInstance().increment(bars_fetched_counter, bars.size());
+            
+            // Save the whole batch in one transaction
+            {
+                PERF_TIMER("DbInsertMarketDataBatch");
+                if (!db_manager->insertMarketDataBatch(bars)) {
+                    LOG_ERROR("Failed to store market data batch");
+                }
             }
             
-            // Update portfolio positions with current prices
-            updatePortfolio();
+            for (const auto& data : bars) {
+                market_data_cache->update(data);
+                indicator_engine->update(data);
+                LOG_FAST(LogLevel::INFO, "Fetched {} price: ${}", data.symbol, data.close);
+            }
             
-            // Display status
-            displayStatus();
+            if (bars.size() < config.symbols.size()) {
+                LOG_WARNING("Fetched " + std::to_string(bars.size()) + " of " +
+                           std::to_string(config.symbols.size()) + " symbols");
+            }
             
-            // Sleep for a bit
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to fetch market data: " + std::string(e.what()));
         }
     }
     
-    void shutdown() {
-        LOG_INFO("Shutting down trading system...");
+    void runAnalysis() {
+        PERF_TIMER("RunAnalysis");
+        LOG_INFO("Running market analysis...");
         
-        // Stop Python process
-        if (python_manager) {
-            python_manager->stop();
+        // With a model loaded, warmed-up symbols are scored here and only
+        // the cold ones go to Python
+        if (model_signals) {
+            std::vector<std::string> cold_symbols;
+            auto signals = model_signals->generate(*indicator_engine, config.symbols, cold_symbols);
+            for (const auto& signal : signals) {
+                MetricsRegistry::getInstance().increment(signals_counter);
+                LOG_FAST(LogLevel::INFO, "Model signal: {} {} (confidence: {})",
+                         signal.symbol, toString(signal.action), signal.confidence);
+            }
+            if (!signals.empty()) {
+                trading_engine->processTradingSignals(signals.data(), signals.size());
+                status_dirty = true;
+            }
+            if (!cold_symbols.empty()) {
+                sendAnalysisRequest(cold_symbols, "");
+            }
+            return;
         }
         
-        // Stop IPC
-        if (ipc_manager) {
-            ipc_manager->stop();
-        }
+        // Create analysis request. Warmed-up symbols carry their features
+        // and indicators; the rest are left for Python to compute.
+        std::vector<std::string> cold_symbols;
+        std::stringstream features;
+        features << std::setprecision(12);
+        size_t ready = 0;
         
-        // Final portfolio status
-        if (trading_engine) {
-            Portfolio portfolio = trading_engine->getPortfolio();
-            LOG_INFO("Final portfolio value: $" + 
-                    std::to_string(portfolio.getEquity()));
-            LOG_INFO("Total P&L: $" + 
-                    std::to_string(trading_engine->getTotalPnL()));
+        for (const auto& symbol : config.symbols) {
+            IndicatorSnapshot snap;
+            if (!indicator_engine->snapshot(symbol, snap) || snap.bars < IndicatorEngine::kMinBars) {
+                cold_symbols.push_back(symbol);
+                continue;
+            }
+            if (ready++ > 0) features << ",";
+            appendFeatureEntry(features, symbol, snap);
         }
         
-        LOG_INFO("Shutdown complete");
+        sendAnalysisRequest(cold_symbols, features.str());
     }
     
-private:
-    void fetchMarketData() {
-        PerformanceTimer timer("FetchMarketData");
-        
-        for (const auto& symbol : config.symbols) {
-            try {
-                LOG_DEBUG("Fetching data for " + symbol);
-                
-                // For now, we're using BTC price for all symbols
-                // In production, you'd fetch each symbol's data
-                CryptoPrice price = api->getBTCPrice();
-                
-                // Convert to MarketData
-                MarketData data;
-                data.symbol = symbol;
-                data.open = price.open;
-                data.high = price.high;
-                data.low = price.low;
-                data.close = price.price;
-                data.volume = price.volume;
-                data.timestamp = std::chrono::system_clock::now();
-                
-                // Save to database
-                db_manager->insertMarketData(data);
-                
-                LOG_INFO("Fetched " + symbol + " price: $" + 
-                        std::to_string(price.price));
-                
-            } catch (const std::exception& e) {
-                LOG_ERROR("Failed to fetch data for " + symbol + ": " + e.what());
+    void sendAnalysisRequest(const std::vector<std::string>& cold_symbols, const std::string& features) {
+        if (!python_ready.load(std::memory_order_acquire)) {
+            if (!analysis_deferred.exchange(true)) {
+                LOG_INFO("Python analyzer not ready yet, analysis deferred");
+            }
+            // Ready may have landed after the check, before onPythonReady
+            // could see the flag. Whoever clears the flag runs the analysis.
+            if (!python_ready.load(std::memory_order_acquire) || !analysis_deferred.exchange(false)) {
+                return;
             }
         }
-    }
-    
-    void runAnalysis() {
-        PerformanceTimer timer("RunAnalysis");
-        LOG_INFO("Running market analysis...");
         
-        // Create analysis request
         std::stringstream ss;
         ss << "{\"command\":\"batch_analyze\",\"symbols\":[";
-        for (size_t i = 0; i < config.symbols.size(); ++i) {
+        for (size_t i = 0; i < cold_symbols.size(); ++i) {
             if (i > 0) ss << ",";
-            ss << "\"" << config.symbols[i] << "\"";
+            ss << "\"" << cold_symbols[i] << "\"";
+        }
+        ss << "],\"features\":[" << features << "]";
+        if (binary_replies) {
+            ss << ",\"reply_format\":\"binary\"";
         }
-        ss << "]}";
+        ss << "}";
         
         // Send to Python analyzer
-        if (!ipc_manager->sendMessage(ss.str())) {
+        auto sent_at = std::chrono::steady_clock::now().time_since_epoch();
+        if (ipc_manager->sendMessage(ss.str())) {
+            analysis_sent_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(sent_at).count();
+        } else {
             LOG_ERROR("Failed to send analysis request");
         }
     }
     
+    static void appendJsonNumber(std::stringstream& ss, double value) {
+        if (std::isfinite(value)) {
+            ss << value;
+        } else {
+            ss << "null";
+        }
+    }
+    
+    void appendFeatureEntry(std::stringstream& ss, const std::string& symbol,
+                            const IndicatorSnapshot& snap) {
+        ss << "{\"symbol\":\"" << symbol << "\",\"bars\":" << snap.bars << ",\"features\":[";
+        auto vec = IndicatorEngine::toFeatures(snap);
+        for (size_t i = 0; i < vec.size(); ++i) {
+            if (i > 0) ss << ",";
+            appendJsonNumber(ss, vec[i]);
+        }
+        
+        const std::pair<const char*, double> indicators[] = {
+            {"close", snap.close}, {"rsi", snap.rsi}, {"macd", snap.macd},
+            {"macd_signal", snap.macd_signal}, {"sma_5", snap.sma_5}, {"sma_20", snap.sma_20},
+            {"bb_upper", snap.bb_upper}, {"bb_lower", snap.bb_lower},
+            {"volume_ratio", snap.volume_ratio}
+        };
+        ss << "],\"indicators\":{";
+        for (size_t i = 0; i < sizeof(indicators) / sizeof(indicators[0]); ++i) {
+            if (i > 0) ss << ",";
+            ss << "\"" << indicators[i].first << "\":";
+            appendJsonNumber(ss, indicators[i].second);
+        }
+        ss << "}}";
+    }
+    
     void handlePythonMessage(const std::string& message) {
+        // The first reply after a request closes the IPC round trip
+        int64_t sent_ns = analysis_sent_ns.exchange(0);
+        if (sent_ns != 0) {
+            MetricsRegistry::getInstance().recordLatency(ipc_round_trip_timer,
+                                                         static_cast<uint64_t>(steadyNowNs() - sent_ns));
+        }
+        
+        // A binary batch_analyze reply: symbol table frame, then signals
+        WireHeader header;
+        if (WireDecoder::peekHeader(message, header)) {
+            LOG_DEBUG("Received from Python: " + std::to_string(message.size()) + " byte binary reply");
+            PERF_TIMER("SignalBatchToOrders");
+            std::vector<TradingSignal> signals;
+            WireDecoder decoder;
+            if (decoder.decodeAll(message, nullptr, &signals) != message.size()) {
+                LOG_ERROR("Malformed binary reply from Python (" + std::to_string(message.size()) + " bytes)");
+                return;
+            }
+            processSignalBatch(signals);
+            return;
+        }
+        
         LOG_DEBUG("Received from Python: " + message);
         
         try {
@@ -234,16 +773,35 @@ private:
                 return;
             }
             
+            // A batch_analyze reply: every result in one engine batch
+            std::vector<std::string_view> results;
+            if (MessageDispatcher::splitResults(message, results)) {
+                PERF_TIMER("SignalBatchToOrders");
+                std::vector<TradingSignal> signals;
+                signals.reserve(results.size());
+                for (auto result : results) {
+                    if (result.find("\"action\"") == std::string_view::npos ||
+                        result.find("\"error\"") != std::string_view::npos) {
+                        continue;
+                    }
+                    signals.push_back(TradingSignal::fromJson(std::string(result)));
+                }
+                processSignalBatch(signals);
+                return;
+            }
+            
             // Look for trading signals
             if (message.find("\"action\"") != std::string::npos) {
+                PERF_TIMER("SignalToOrder");
+                MetricsRegistry::getInstance().increment(signals_counter);
                 TradingSignal signal = TradingSignal::fromJson(message);
                 
-                LOG_INFO("Received signal: " + signal.symbol + " " + 
-                        signal.action + " (confidence: " + 
-                        std::to_string(signal.confidence) + ")");
+                LOG_FAST(LogLevel::INFO, "Received signal: {} {} (confidence: {})",
+                         signal.symbol, toString(signal.action), signal.confidence);
                 
                 // Process signal through trading engine
                 trading_engine->processTradingSignal(signal);
+                status_dirty = true;
             }
             
         } catch (const std::exception& e) {
@@ -251,14 +809,26 @@ private:
         }
     }
     
+    void processSignalBatch(const std::vector<TradingSignal>& signals) {
+        for (const auto& signal : signals) {
+            LOG_FAST(LogLevel::INFO, "Received signal: {} {} (confidence: {})",
+                     signal.symbol, toString(signal.action), signal.confidence);
+        }
+        MetricsRegistry::getInstance().increment(signals_counter, signals.size());
+        if (!signals.empty()) {
+            trading_engine->processTradingSignals(signals.data(), signals.size());
+            status_dirty = true;
+        }
+    }
+    
     void updatePortfolio() {
         // Get current prices for all positions
         std::map<std::string, double> current_prices;
         
         for (const auto& symbol : config.symbols) {
-            auto market_data = db_manager->getMarketData(symbol, 1);
-            if (!market_data.empty()) {
-                current_prices[symbol] = market_data[0].close;
+            double price;
+            if (market_data_cache->latestClose(symbol, price)) {
+                current_prices[symbol] = price;
             }
         }
         
@@ -267,22 +837,30 @@ private:
     }
     
     void displayStatus() {
-        static int counter = 0;
-        if (++counter % 30 == 0) { // Display every 30 seconds
-            Portfolio portfolio = trading_engine->getPortfolio();
+        if (status_dirty.exchange(false)) {
+            PortfolioSnapshot portfolio = trading_engine->getPortfolioSnapshot();
             
             LOG_INFO("=== Portfolio Status ===");
             LOG_INFO("Cash: $" + std::to_string(portfolio.cash_balance));
-            LOG_INFO("Total Equity: $" + std::to_string(portfolio.getEquity()));
-            LOG_INFO("P&L: $" + std::to_string(trading_engine->getTotalPnL()));
+            LOG_INFO("Total Equity: $" + std::to_string(portfolio.equity));
+            LOG_INFO("Gross Exposure: $" + std::to_string(portfolio.gross_exposure) +
+                    " (net $" + std::to_string(portfolio.net_exposure) + ")");
+            LOG_INFO("Unrealized P&L: $" + std::to_string(portfolio.unrealized_pnl) +
+                    ", drawdown " + std::to_string(portfolio.drawdown * 100.0) + "%");
+            LOG_INFO("P&L: $" + std::to_string(trading_engine->getTotalPnL()) +
+                    ", win rate " + std::to_string(trading_engine->getWinRate() * 100.0) +
+                    "%, Sharpe " + std::to_string(trading_engine->getSharpeRatio()));
             
             auto positions = trading_engine->getAllPositions();
             if (!positions.empty()) {
                 LOG_INFO("Open Positions:");
                 for (const auto& pos : positions) {
-                    LOG_INFO("  " + pos.symbol + ": " + 
+                    double last = pos.current_price;
+                    market_data_cache->latestClose(pos.symbolName(), last);
+                    LOG_INFO("  " + pos.symbolName() + ": " + 
                             std::to_string(pos.quantity) + " @ $" + 
                             std::to_string(pos.entry_price) + 
+                            " last $" + std::to_string(last) +
                             " (P&L: " + std::to_string(pos.getPnlPercentage()) + "%)");
                 }
             }
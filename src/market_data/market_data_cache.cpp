@@ -0,0 +1,168 @@
+#include "market_data_cache.h"
+#include <cstring>
+#include <algorithm>
+
+namespace TradingSystem {
+
+CachedBar CachedBar::fromMarketData(const MarketData& data) {
+    CachedBar bar;
+    bar.open = data.open;
+    bar.high = data.high;
+    bar.low = data.low;
+    bar.close = data.close;
+    bar.volume = data.volume;
+    bar.timestamp_ns = toEpochNanos(data.timestamp);
+    return bar;
+}
+
+MarketData CachedBar::toMarketData(const std::string& symbol) const {
+    MarketData data;
+    data.symbol = symbol;
+    data.open = open;
+    data.high = high;
+    data.low = low;
+    data.close = close;
+    data.volume = volume;
+    data.timestamp = fromEpochNanos(timestamp_ns);
+    return data;
+}
+
+void MarketDataCache::AtomicBar::store(const CachedBar& bar) {
+    uint64_t raw[kBarWords];
+    std::memcpy(raw, &bar, sizeof(raw));
+    for (size_t i = 0; i < kBarWords; ++i) {
+        words[i].store(raw[i], std::memory_order_relaxed);
+    }
+}
+
+CachedBar MarketDataCache::AtomicBar::load() const {
+    uint64_t raw[kBarWords];
+    for (size_t i = 0; i < kBarWords; ++i) {
+        raw[i] = words[i].load(std::memory_order_relaxed);
+    }
+    CachedBar bar;
+    std::memcpy(&bar, raw, sizeof(raw));
+    return bar;
+}
+
+MarketDataCache::MarketDataCache(size_t history_depth, size_t max_symbols)
+    : history_depth(history_depth), max_symbols(max_symbols),
+      slots(new Slot[max_symbols]) {
+    if (history_depth > 0) {
+        history.reset(new AtomicBar[max_symbols * history_depth]);
+    }
+}
+
+void MarketDataCache::beginWrite(Slot& slot) {
+    // Take the slot by moving the sequence from even to odd; concurrent
+    // writers to the same symbol spin here, readers are never held up
+    uint32_t seq = slot.sequence.load(std::memory_order_relaxed);
+    for (;;) {
+        if ((seq & 1) == 0 &&
+            slot.sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                                std::memory_order_relaxed)) {
+            break;
+        }
+        seq = slot.sequence.load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void MarketDataCache::endWrite(Slot& slot) {
+    slot.sequence.fetch_add(1, std::memory_order_release);
+}
+
+bool MarketDataCache::update(const MarketData& data) {
+    SymbolId id = SymbolTable::getInstance().intern(data.symbol);
+    return update(id, CachedBar::fromMarketData(data));
+}
+
+bool MarketDataCache::update(SymbolId id, const CachedBar& bar) {
+    if (id >= max_symbols) {
+        return false;
+    }
+
+    Slot& slot = slots[id];
+    beginWrite(slot);
+
+    uint64_t n = slot.updates.load(std::memory_order_relaxed);
+    slot.bar.store(bar);
+    if (history_depth > 0) {
+        history[id * history_depth + (n % history_depth)].store(bar);
+    }
+    slot.updates.store(n + 1, std::memory_order_relaxed);
+
+    endWrite(slot);
+    return true;
+}
+
+bool MarketDataCache::latest(SymbolId id, CachedBar& out) const {
+    if (id >= max_symbols) {
+        return false;
+    }
+
+    const Slot& slot = slots[id];
+    uint32_t before, after;
+    uint64_t n;
+    do {
+        before = slot.sequence.load(std::memory_order_acquire);
+        n = slot.updates.load(std::memory_order_relaxed);
+        out = slot.bar.load();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = slot.sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    return n > 0;
+}
+
+bool MarketDataCache::latest(std::string_view symbol, MarketData& out) const {
+    SymbolId id = SymbolTable::getInstance().find(symbol);
+    CachedBar bar;
+    if (id == kInvalidSymbolId || !latest(id, bar)) {
+        return false;
+    }
+    out = bar.toMarketData(std::string(symbol));
+    return true;
+}
+
+bool MarketDataCache::latestClose(std::string_view symbol, double& price) const {
+    SymbolId id = SymbolTable::getInstance().find(symbol);
+    CachedBar bar;
+    if (id == kInvalidSymbolId || !latest(id, bar)) {
+        return false;
+    }
+    price = bar.close;
+    return true;
+}
+
+size_t MarketDataCache::recent(SymbolId id, CachedBar* out, size_t max_bars) const {
+    if (id >= max_symbols || history_depth == 0 || max_bars == 0) {
+        return 0;
+    }
+
+    const Slot& slot = slots[id];
+    const AtomicBar* ring = &history[id * history_depth];
+    uint32_t before, after;
+    size_t count;
+    do {
+        before = slot.sequence.load(std::memory_order_acquire);
+        uint64_t n = slot.updates.load(std::memory_order_relaxed);
+        count = static_cast<size_t>(std::min<uint64_t>(n, std::min(history_depth, max_bars)));
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = ring[(n - count + i) % history_depth].load();
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = slot.sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    return count;
+}
+
+uint64_t MarketDataCache::updateCount(SymbolId id) const {
+    if (id >= max_symbols) {
+        return 0;
+    }
+    return slots[id].updates.load(std::memory_order_acquire);
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,90 @@
+#ifndef MARKET_DATA_CACHE_H
+#define MARKET_DATA_CACHE_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include "../common/data_types.h"
+#include "../common/symbol_table.h"
+
+namespace TradingSystem {
+
+// Plain bar as stored in the cache; trivially copyable so it can be moved
+// through the seqlock word by word
+struct CachedBar {
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    int64_t timestamp_ns = 0;
+
+    static CachedBar fromMarketData(const MarketData& data);
+    MarketData toMarketData(const std::string& symbol) const;
+};
+
+// Latest bar per symbol, indexed by interned SymbolId, with an optional
+// fixed-depth ring of recent bars. Each symbol slot is guarded by its own
+// seqlock: writers bump the sequence to odd, store, and bump it back to
+// even; readers copy the slot and retry if the sequence moved. Readers
+// never take a lock and never block a writer.
+class MarketDataCache {
+public:
+    explicit MarketDataCache(size_t history_depth = 0,
+                             size_t max_symbols = SymbolTable::kMaxSymbols);
+
+    MarketDataCache(const MarketDataCache&) = delete;
+    MarketDataCache& operator=(const MarketDataCache&) = delete;
+
+    // Store a new bar (interns the symbol). Returns false if the symbol ID
+    // is outside the cache's capacity.
+    bool update(const MarketData& data);
+    bool update(SymbolId id, const CachedBar& bar);
+
+    // Latest bar for a symbol; false if nothing has been stored yet
+    bool latest(SymbolId id, CachedBar& out) const;
+    bool latest(std::string_view symbol, MarketData& out) const;
+    bool latestClose(std::string_view symbol, double& price) const;
+
+    // Copy up to max_bars of the most recent bars, oldest first. Returns
+    // the number copied (bounded by history_depth).
+    size_t recent(SymbolId id, CachedBar* out, size_t max_bars) const;
+
+    // Number of updates ever applied to a symbol (0 = never seen)
+    uint64_t updateCount(SymbolId id) const;
+
+    size_t historyDepth() const { return history_depth; }
+    size_t capacity() const { return max_symbols; }
+
+private:
+    static constexpr size_t kBarWords = sizeof(CachedBar) / sizeof(uint64_t);
+    static_assert(sizeof(CachedBar) % sizeof(uint64_t) == 0, "CachedBar must be word-sized");
+
+    // Bar stored as relaxed atomic words so concurrent copies are race-free
+    struct AtomicBar {
+        std::atomic<uint64_t> words[kBarWords];
+
+        void store(const CachedBar& bar);
+        CachedBar load() const;
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> sequence{0};
+        std::atomic<uint64_t> updates{0};
+        AtomicBar bar;
+    };
+
+    size_t history_depth;
+    size_t max_symbols;
+    std::unique_ptr<Slot[]> slots;
+    std::unique_ptr<AtomicBar[]> history;  // max_symbols * history_depth
+
+    void beginWrite(Slot& slot);
+    void endWrite(Slot& slot);
+};
+
+} // namespace TradingSystem
+
+#endif // MARKET_DATA_CACHE_H
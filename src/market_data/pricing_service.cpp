@@ -0,0 +1,44 @@
+#include "pricing_service.h"
+
+namespace TradingSystem {
+
+PricingService::PricingService(std::shared_ptr<MarketDataCache> cache,
+                               std::chrono::nanoseconds max_age,
+                               double spread_rate)
+    : market_data_cache(std::move(cache)), max_age_ns(max_age.count()),
+      half_spread(spread_rate * 0.5) {
+}
+
+PricingService::Status PricingService::snapshot(SymbolId id,
+                                                std::chrono::system_clock::time_point now,
+                                                PriceSnapshot& out) const {
+    CachedBar bar;
+    if (!market_data_cache || !market_data_cache->latest(id, bar) || bar.close <= 0) {
+        return Status::MISSING;
+    }
+    out = quoteAt(bar.close, bar.timestamp_ns);
+    if (max_age_ns > 0 && toEpochNanos(now) - bar.timestamp_ns > max_age_ns) {
+        return Status::STALE;
+    }
+    return Status::OK;
+}
+
+PriceSnapshot PricingService::quoteAt(double last, int64_t timestamp_ns) const {
+    PriceSnapshot quote;
+    quote.last = last;
+    quote.bid = last * (1.0 - half_spread);
+    quote.ask = last * (1.0 + half_spread);
+    quote.timestamp_ns = timestamp_ns;
+    return quote;
+}
+
+const char* toString(PricingService::Status status) {
+    switch (status) {
+        case PricingService::Status::OK: return "ok";
+        case PricingService::Status::MISSING: return "missing";
+        case PricingService::Status::STALE: return "stale";
+    }
+    return "unknown";
+}
+
+} // namespace TradingSystem
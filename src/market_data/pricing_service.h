@@ -0,0 +1,76 @@
+#ifndef PRICING_SERVICE_H
+#define PRICING_SERVICE_H
+
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include "market_data_cache.h"
+#include "../common/data_types.h"
+
+namespace TradingSystem {
+
+// One consistent view of a symbol's price: every field comes from the
+// same cached bar
+struct PriceSnapshot {
+    double bid = 0.0;
+    double ask = 0.0;
+    double last = 0.0;
+    int64_t timestamp_ns = 0;
+
+    bool valid() const { return last > 0; }
+    double mid() const { return (bid + ask) * 0.5; }
+    // The side of the quote a market order takes
+    double crossing(OrderSide side) const { return side == OrderSide::BUY ? ask : bid; }
+};
+
+// Quotes for the engine, built on the latest-price cache. A snapshot is
+// one seqlock read of the symbol's slot, so it is O(1), lock-free and
+// never mixes two bars.
+//
+// The feed carries bars, not quotes, so bid and ask sit half of
+// spread_rate either side of the last close. The default spread is zero,
+// which leaves the spread on fills to the paper simulator; with a nonzero
+// rate fills cross this quote's spread instead and sizing and risk checks
+// see it too.
+//
+// A snapshot older than max_age (measured against the caller's clock,
+// which is simulated in replays) is rejected as stale; a zero max_age
+// accepts any age.
+class PricingService {
+public:
+    enum class Status {
+        OK,
+        MISSING,  // nothing cached for the symbol
+        STALE
+    };
+
+    explicit PricingService(std::shared_ptr<MarketDataCache> cache,
+                            std::chrono::nanoseconds max_age = std::chrono::nanoseconds::zero(),
+                            double spread_rate = 0.0);
+
+    Status snapshot(SymbolId id, std::chrono::system_clock::time_point now, PriceSnapshot& out) const;
+    // snapshot() == Status::OK
+    bool fresh(SymbolId id, std::chrono::system_clock::time_point now, PriceSnapshot& out) const {
+        return snapshot(id, now, out) == Status::OK;
+    }
+
+    // Quote around a price the caller already has (a mark or a trigger)
+    PriceSnapshot quoteAt(double last, int64_t timestamp_ns) const;
+
+    void setMaxAge(std::chrono::nanoseconds age) { max_age_ns = age.count(); }
+    void setSpreadRate(double rate) { half_spread = rate * 0.5; }
+
+    std::chrono::nanoseconds maxAge() const { return std::chrono::nanoseconds(max_age_ns); }
+    const std::shared_ptr<MarketDataCache>& cache() const { return market_data_cache; }
+
+private:
+    std::shared_ptr<MarketDataCache> market_data_cache;
+    int64_t max_age_ns;
+    double half_spread;
+};
+
+const char* toString(PricingService::Status status);
+
+} // namespace TradingSystem
+
+#endif // PRICING_SERVICE_H
@@ -6,17 +6,65 @@ import numpy as np
 import pandas as pd
 from datetime import datetime, timedelta
 import os
+import fcntl
 import sys
 import time
-from typing import List, Dict, Tuple
+from typing import List, Dict, Tuple, Union
 import signal
 
 # Import our neural network
 from stock_ranking_nn import StockRanker
+import shm_transport
+import bar_journal
+import wire_format
+
+# Replies are compact: the C++ side matches keys like "symbol":"BTC"
+# without whitespace
+JSON_SEPARATORS = (',', ':')
+
+# Length of prepare_features' vector (IndicatorEngine::kFeatureCount)
+FEATURE_COUNT = 10
+
+# How often to look for the IPC endpoints and for input on an idle pipe
+POLL_INTERVAL_S = 0.05
+
+
+class PipeTransport:
+    """Newline-delimited text over the FIFO pair created by IPCManager"""
+
+    def __init__(self, pipe_to_python: str, pipe_to_cpp: str):
+        # The C++ side opens its write end only on the first request, so a
+        # blocking open here would hold back the ready message. Open
+        # without waiting, then read blocking; until a writer appears each
+        # read is an immediate EOF and read_message just polls.
+        fd = os.open(pipe_to_python, os.O_RDONLY | os.O_NONBLOCK)
+        fcntl.fcntl(fd, fcntl.F_SETFL, fcntl.fcntl(fd, fcntl.F_GETFL) & ~os.O_NONBLOCK)
+        self.pipe_in = os.fdopen(fd, 'r')
+        self.pipe_out = open(pipe_to_cpp, 'w')
+
+    def read_message(self, timeout_s: float = POLL_INTERVAL_S):
+        line = self.pipe_in.readline().strip()
+        if not line:
+            time.sleep(timeout_s)
+            return None
+        return line
+
+    def write_message(self, message: str) -> bool:
+        self.pipe_out.write(message + '\n')
+        self.pipe_out.flush()
+        return True
+
+    def close(self):
+        self.pipe_in.close()
+        self.pipe_out.close()
+
 
 class MarketDataAnalyzer:
-    def __init__(self, db_path="trading_system.db", pipe_base="/tmp/trading_system_pipe"):
+    def __init__(self, db_path="trading_system.db", pipe_base="/tmp/trading_system_pipe",
+                 journal_dir=None):
         self.db_path = db_path
+        self.journal_dir = journal_dir
+        self.pipe_base = pipe_base
         self.pipe_to_python = pipe_base + "_to_python"
         self.pipe_to_cpp = pipe_base + "_to_cpp"
         self.running = True
@@ -36,23 +84,28 @@ class MarketDataAnalyzer:
         self.cursor = self.conn.cursor()
         
     def fetch_market_data(self, symbol: str, days: int = 30) -> pd.DataFrame:
-        """Fetch market data from database"""
-        end_date = datetime.now()
-        start_date = end_date - timedelta(days=days)
+        """Fetch market data from the bar journal, or the database without one"""
+        end_ns = time.time_ns()
+        start_ns = end_ns - days * 86400 * 10**9
+        
+        if self.journal_dir:
+            records = bar_journal.read_range(self.journal_dir, symbol, start_ns, end_ns)
+            return bar_journal.to_frame(symbol, records)
         
+        # ts_us is epoch microseconds (UTC); the range is served by the
+        # covering (symbol, ts_us, ...) index
         query = """
-        SELECT symbol, open, high, low, close, volume, timestamp
+        SELECT symbol, open, high, low, close, volume, ts_us
         FROM market_data
-        WHERE symbol = ? AND timestamp >= ? AND timestamp <= ?
-        ORDER BY timestamp DESC
+        WHERE symbol = ? AND ts_us BETWEEN ? AND ?
+        ORDER BY ts_us ASC
         """
         
-        df = pd.read_sql_query(query, self.conn, 
-                              params=(symbol, start_date.strftime('%Y-%m-%d'), 
-                                     end_date.strftime('%Y-%m-%d')))
+        df = pd.read_sql_query(query, self.conn,
+                              params=(symbol, start_ns // 1000, end_ns // 1000))
         
         if not df.empty:
-            df['timestamp'] = pd.to_datetime(df['timestamp'])
+            df['timestamp'] = pd.to_datetime(df.pop('ts_us'), unit='us')
             df.set_index('timestamp', inplace=True)
         
         return df
@@ -157,12 +210,40 @@ class MarketDataAnalyzer:
                 'reason': 'Insufficient data for analysis'
             }
         
+        latest = df.iloc[-1]
+        volatility = float(features[9])
+        return self.generate_signal(symbol, latest, features, volatility)
+    
+    def analyze_features(self, entry: Dict) -> Dict:
+        """Generate a signal from indicators computed by the C++ IndicatorEngine.
+        
+        The entry carries the 10-element feature vector and the latest
+        indicator values, so no history is read from the database.
+        """
+        symbol = entry['symbol']
+        features = np.array(entry['features'], dtype=float)
+        indicators = {key: (np.nan if value is None else value)
+                      for key, value in entry.get('indicators', {}).items()}
+        latest = {
+            'close': indicators.get('close', np.nan),
+            'RSI': indicators.get('rsi', np.nan),
+            'MACD': indicators.get('macd', np.nan),
+            'MACD_signal': indicators.get('macd_signal', np.nan),
+            'SMA_5': indicators.get('sma_5', np.nan),
+            'SMA_20': indicators.get('sma_20', np.nan),
+            'BB_upper': indicators.get('bb_upper', np.nan),
+            'BB_lower': indicators.get('bb_lower', np.nan),
+            'Volume_ratio': indicators.get('volume_ratio', np.nan),
+        }
+        return self.generate_signal(symbol, latest, features, float(features[9]))
+    
+    def generate_signal(self, symbol: str, latest, features: np.ndarray, volatility: float) -> Dict:
+        """Rule-based signal from the latest indicator values"""
         # Initialize ranker if needed
         if self.ranker is None:
             self.ranker = StockRanker(input_features=len(features))
         
         # Get prediction (for now, using rule-based logic until we train on real data)
-        latest = df.iloc[-1]
         
         # Simple trading rules
         action = 'HOLD'
@@ -249,20 +330,22 @@ class MarketDataAnalyzer:
     def save_signal(self, signal: Dict):
         """Save trading signal to database"""
         query = """
-        INSERT INTO trading_signals (symbol, confidence, action, suggested_position_size, timestamp)
-        VALUES (?, ?, ?, ?, ?)
+        INSERT INTO trading_signals (symbol, confidence, action, suggested_position_size, timestamp, ts_us)
+        VALUES (?, ?, ?, ?, ?, ?)
         """
         
+        now_us = time.time_ns() // 1000
         self.cursor.execute(query, (
             signal['symbol'],
             signal['confidence'],
             signal['action'],
             signal['suggested_position_size'],
-            datetime.now().strftime('%Y-%m-%d %H:%M:%S')
+            datetime.utcfromtimestamp(now_us / 1e6).strftime('%Y-%m-%d %H:%M:%S'),
+            now_us
         ))
         self.conn.commit()
     
-    def handle_message(self, message: str) -> str:
+    def handle_message(self, message: str) -> Union[str, bytes]:
         """Handle incoming messages from C++"""
         try:
             data = json.loads(message)
@@ -272,27 +355,40 @@ class MarketDataAnalyzer:
                 symbol = data.get('symbol', 'BTC')
                 result = self.analyze_symbol(symbol)
                 self.save_signal(result)
-                return json.dumps(result)
+                return json.dumps(result, separators=JSON_SEPARATORS)
                 
             elif command == 'batch_analyze':
                 symbols = data.get('symbols', [])
                 results = []
+                # Symbols the C++ indicator engine has warmed up arrive with
+                # ready features; the rest fall back to reading history
+                for entry in data.get('features', []):
+                    result = self.analyze_features(entry)
+                    self.save_signal(result)
+                    results.append(result)
                 for symbol in symbols:
                     result = self.analyze_symbol(symbol)
                     self.save_signal(result)
                     results.append(result)
-                return json.dumps({'results': results})
+                if data.get('reply_format') == 'binary':
+                    # Each reply carries its own symbol table, so the C++
+                    # side needs no state across replies
+                    now_ns = time.time_ns()
+                    signals = [dict(r, timestamp_ns=now_ns) for r in results
+                               if 'action' in r and 'error' not in r]
+                    return wire_format.encode_signals(signals, {})
+                return json.dumps({'results': results}, separators=JSON_SEPARATORS)
                 
             elif command == 'get_positions':
                 # Return current recommended positions
                 query = """
                 SELECT symbol, action, confidence, suggested_position_size, timestamp
                 FROM trading_signals
-                WHERE timestamp > datetime('now', '-1 hour')
+                WHERE ts_us > ?
                 ORDER BY confidence DESC
                 LIMIT 10
                 """
-                self.cursor.execute(query)
+                self.cursor.execute(query, (time.time_ns() // 1000 - 3600 * 10**6,))
                 positions = []
                 for row in self.cursor.fetchall():
                     positions.append({
@@ -302,13 +398,13 @@ class MarketDataAnalyzer:
                         'suggested_position_size': row[3],
                         'timestamp': row[4]
                     })
-                return json.dumps({'positions': positions})
+                return json.dumps({'positions': positions}, separators=JSON_SEPARATORS)
                 
             else:
-                return json.dumps({'error': 'Unknown command'})
+                return json.dumps({'error': 'Unknown command'}, separators=JSON_SEPARATORS)
                 
         except Exception as e:
-            return json.dumps({'error': str(e)})
+            return json.dumps({'error': str(e)}, separators=JSON_SEPARATORS)
     
     def run(self):
         """Main loop for the analyzer"""
@@ -317,42 +413,50 @@ class MarketDataAnalyzer:
         # Connect to database
         self.connect_database()
         
-        # Wait for pipes to be created
-        while not os.path.exists(self.pipe_to_python) or not os.path.exists(self.pipe_to_cpp):
-            print("Waiting for IPC pipes...")
-            time.sleep(1)
-            if not self.running:
-                return
-        
-        print("IPC pipes found, opening connections...")
-        
-        # Open pipes
-        pipe_in = open(self.pipe_to_python, 'r')
-        pipe_out = open(self.pipe_to_cpp, 'w')
+        # Wait for the C++ side to create either the FIFOs or the shm rings
+        transport = None
+        while transport is None:
+            if (shm_transport.segment_exists(self.pipe_base, '_to_python') and
+                    shm_transport.segment_exists(self.pipe_base, '_to_cpp')):
+                print("Shared-memory rings found, attaching...")
+                transport = shm_transport.ShmTransport(self.pipe_base)
+            elif os.path.exists(self.pipe_to_python) and os.path.exists(self.pipe_to_cpp):
+                print("IPC pipes found, opening connections...")
+                transport = PipeTransport(self.pipe_to_python, self.pipe_to_cpp)
+            else:
+                time.sleep(POLL_INTERVAL_S)
+                if not self.running:
+                    return
         
+        # Build the ranker before announcing readiness so the first request
+        # does not pay for it, then tell the trading system it can send
+        if self.ranker is None:
+            self.ranker = StockRanker(input_features=FEATURE_COUNT)
+        transport.write_message(json.dumps({'event': 'ready', 'pid': os.getpid()},
+                                           separators=JSON_SEPARATORS))
         print("Market Data Analyzer ready")
         
         try:
             while self.running:
                 # Read message from C++
-                line = pipe_in.readline().strip()
-                if line:
-                    print(f"Received: {line}")
-                    response = self.handle_message(line)
-                    print(f"Sending: {response}")
-                    pipe_out.write(response + '\n')
-                    pipe_out.flush()
-                else:
-                    time.sleep(0.1)
+                message = transport.read_message()
+                if message:
+                    print(f"Received: {message}")
+                    response = self.handle_message(message)
+                    if isinstance(response, bytes):
+                        print(f"Sending: {len(response)} byte binary reply")
+                    else:
+                        print(f"Sending: {response}")
+                    transport.write_message(response)
                     
         except KeyboardInterrupt:
             print("Shutting down...")
         finally:
-            pipe_in.close()
-            pipe_out.close()
+            transport.close()
             self.conn.close()
             print("Market Data Analyzer stopped")
 
 if __name__ == "__main__":
-    analyzer = MarketDataAnalyzer()
+    # Set by the trading system when [database] journal_dir is configured
+    analyzer = MarketDataAnalyzer(journal_dir=os.environ.get("TS_BAR_JOURNAL_DIR"))
     analyzer.run()
\ No newline at end of file
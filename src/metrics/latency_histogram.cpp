@@ -0,0 +1,74 @@
+#include "latency_histogram.h"
+
+namespace TradingSystem {
+
+LatencyHistogram::LatencyHistogram() : counts(new std::atomic<uint64_t>[kBucketCount]) {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::mergeFrom(const LatencyHistogram& other) {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        uint64_t c = other.counts[i].load(std::memory_order_relaxed);
+        if (c != 0) bump(counts[i], c);
+    }
+    bump(total_count, other.count());
+    bump(total_sum, other.sum());
+    if (other.max() > max()) {
+        max_value.store(other.max(), std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+    total_count.store(0, std::memory_order_relaxed);
+    total_sum.store(0, std::memory_order_relaxed);
+    max_value.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t n = count();
+    return n > 0 ? static_cast<double>(sum()) / static_cast<double>(n) : 0.0;
+}
+
+uint64_t LatencyHistogram::highestEquivalentValue(size_t index) {
+    if (index < kSubBucketCount) {
+        return index;
+    }
+    size_t shift = index / kSubBucketHalf - 1;
+    uint64_t sub = index - shift * kSubBucketHalf;
+    return ((sub + 1) << shift) - 1;
+}
+
+uint64_t LatencyHistogram::valueAtQuantile(double q) const {
+    // Sum the buckets rather than trusting total_count, which a concurrent
+    // writer may have bumped ahead of the bucket it belongs to
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        total += counts[i].load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total) + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            uint64_t value = highestEquivalentValue(i);
+            uint64_t top = max();
+            return (top != 0 && value > top) ? top : value;
+        }
+    }
+    return max();
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,81 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace TradingSystem {
+
+// HDR-style log-linear histogram of nanosecond latencies. Values below
+// 256ns are exact; above that each power of two is split into 128 linear
+// sub-buckets, so any recorded value is reported within 1% (two significant
+// digits). Values beyond kMaxTrackableNs (~18 minutes) land in the top bucket.
+//
+// One thread records (relaxed load/store, no read-modify-write); any thread
+// may read or merge concurrently and sees a slightly stale but untorn view.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 8;
+    static constexpr uint64_t kSubBucketCount = uint64_t(1) << kSubBucketBits;
+    static constexpr uint64_t kSubBucketHalf = kSubBucketCount / 2;
+    static constexpr int kMaxValueBits = 40;
+    static constexpr uint64_t kMaxTrackableNs = (uint64_t(1) << kMaxValueBits) - 1;
+    static constexpr size_t kBucketCount =
+        (kMaxValueBits - kSubBucketBits + 1) * kSubBucketHalf + kSubBucketCount;
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // Single writer
+    void record(uint64_t value_ns) {
+        if (value_ns > kMaxTrackableNs) value_ns = kMaxTrackableNs;
+        bump(counts[bucketIndex(value_ns)], 1);
+        bump(total_count, 1);
+        bump(total_sum, value_ns);
+        if (value_ns > max_value.load(std::memory_order_relaxed)) {
+            max_value.store(value_ns, std::memory_order_relaxed);
+        }
+    }
+
+    // Add other's counts into this histogram; safe while other is recording,
+    // but this histogram must not be recorded into concurrently
+    void mergeFrom(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t count() const { return total_count.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return total_sum.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_value.load(std::memory_order_relaxed); }
+    double mean() const;
+
+    // Highest value equivalent to the q-quantile sample (0 <= q <= 1)
+    uint64_t valueAtQuantile(double q) const;
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < kSubBucketCount) {
+            return static_cast<size_t>(value);
+        }
+        int msb = 63 - __builtin_clzll(value);
+        int shift = msb - (kSubBucketBits - 1);
+        return static_cast<size_t>(shift) * kSubBucketHalf + static_cast<size_t>(value >> shift);
+    }
+
+    static uint64_t highestEquivalentValue(size_t index);
+
+private:
+    static void bump(std::atomic<uint64_t>& slot, uint64_t by) {
+        slot.store(slot.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<std::atomic<uint64_t>[]> counts;
+    std::atomic<uint64_t> total_count{0};
+    std::atomic<uint64_t> total_sum{0};
+    std::atomic<uint64_t> max_value{0};
+};
+
+} // namespace TradingSystem
+
+#endif // LATENCY_HISTOGRAM_H
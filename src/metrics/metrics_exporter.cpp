@@ -0,0 +1,188 @@
+#include "metrics_exporter.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace TradingSystem {
+
+namespace {
+
+void sendAll(int fd, const std::string& data) {
+    const char* p = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        ssize_t n = ::send(fd, p, remaining, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        p += n;
+        remaining -= static_cast<size_t>(n);
+    }
+}
+
+std::string httpResponse(const char* status, const std::string& body) {
+    std::string response = "HTTP/1.1 ";
+    response += status;
+    response += "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: ";
+    response += std::to_string(body.size());
+    response += "\r\nConnection: close\r\n\r\n";
+    response += body;
+    return response;
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter(MetricsRegistry& registry)
+    : registry(registry), running(false), listen_fd(-1), bound_port(0), snapshot_interval_ms(0) {
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start(int port, const std::string& bind_address,
+                            const std::string& snapshot_path, int snapshot_interval_seconds) {
+    if (running) return true;
+
+    snapshot_file = snapshot_path;
+    snapshot_interval_ms = snapshot_interval_seconds > 0 ? snapshot_interval_seconds * 1000 : 0;
+
+    if (port > 0) {
+        listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listen_fd < 0) {
+            std::cerr << "Failed to create metrics socket: " << strerror(errno) << std::endl;
+            return false;
+        }
+        int reuse = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1) {
+            std::cerr << "Invalid metrics bind address: " << bind_address << std::endl;
+            ::close(listen_fd);
+            listen_fd = -1;
+            return false;
+        }
+        if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            ::listen(listen_fd, 16) < 0) {
+            std::cerr << "Failed to listen for metrics on " << bind_address << ":" << port
+                      << ": " << strerror(errno) << std::endl;
+            ::close(listen_fd);
+            listen_fd = -1;
+            return false;
+        }
+
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        bound_port = ntohs(addr.sin_port);
+    }
+
+    if (listen_fd < 0 && (snapshot_file.empty() || snapshot_interval_ms == 0)) {
+        return false;
+    }
+
+    running = true;
+    server_thread = std::thread(&MetricsExporter::serveLoop, this);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!running.exchange(false)) return;
+
+    if (server_thread.joinable()) {
+        server_thread.join();
+    }
+    if (listen_fd >= 0) {
+        ::close(listen_fd);
+        listen_fd = -1;
+    }
+}
+
+bool MetricsExporter::writeSnapshot() {
+    if (snapshot_file.empty()) return false;
+
+    std::string tmp_path = snapshot_file + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Failed to write metrics snapshot: " << tmp_path << std::endl;
+            return false;
+        }
+        out << registry.renderPrometheus();
+    }
+    return std::rename(tmp_path.c_str(), snapshot_file.c_str()) == 0;
+}
+
+void MetricsExporter::serveLoop() {
+    using Clock = std::chrono::steady_clock;
+    auto next_snapshot = Clock::now() + std::chrono::milliseconds(snapshot_interval_ms);
+    // Short poll timeout so stop() never waits long for the thread
+    const int kPollMs = 200;
+
+    while (running) {
+        if (snapshot_interval_ms > 0 && Clock::now() >= next_snapshot) {
+            writeSnapshot();
+            next_snapshot = Clock::now() + std::chrono::milliseconds(snapshot_interval_ms);
+        }
+
+        if (listen_fd < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kPollMs));
+            continue;
+        }
+
+        pollfd pfd{listen_fd, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, kPollMs);
+        if (ready <= 0 || !(pfd.revents & POLLIN)) {
+            continue;
+        }
+
+        int client_fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client_fd >= 0) {
+            handleClient(client_fd);
+            ::close(client_fd);
+        }
+    }
+}
+
+void MetricsExporter::handleClient(int client_fd) {
+    // Read just the request line; scrapers send small GETs
+    char request[1024];
+    size_t used = 0;
+    while (used < sizeof(request) - 1) {
+        pollfd pfd{client_fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 1000) <= 0) break;
+        ssize_t n = ::recv(client_fd, request + used, sizeof(request) - 1 - used, 0);
+        if (n <= 0) break;
+        used += static_cast<size_t>(n);
+        request[used] = '\0';
+        if (std::strstr(request, "\r\n") || std::strchr(request, '\n')) break;
+    }
+    request[used] = '\0';
+
+    if (std::strncmp(request, "GET ", 4) != 0) {
+        sendAll(client_fd, httpResponse("405 Method Not Allowed", "only GET is supported\n"));
+        return;
+    }
+
+    const char* path = request + 4;
+    const char* path_end = std::strchr(path, ' ');
+    std::string target = path_end ? std::string(path, path_end) : std::string(path);
+    if (target == "/metrics" || target == "/") {
+        sendAll(client_fd, httpResponse("200 OK", registry.renderPrometheus()));
+    } else {
+        sendAll(client_fd, httpResponse("404 Not Found", "try /metrics\n"));
+    }
+}
+
+} // namespace TradingSystem
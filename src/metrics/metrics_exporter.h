@@ -0,0 +1,49 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include "metrics_registry.h"
+
+namespace TradingSystem {
+
+// Publishes MetricsRegistry::renderPrometheus() from a background thread:
+// over HTTP (GET /metrics) when a port is configured, and/or by rewriting
+// a snapshot file every interval (atomically, via rename, so it can feed
+// node_exporter's textfile collector or a tail -f).
+class MetricsExporter {
+public:
+    MetricsExporter(MetricsRegistry& registry = MetricsRegistry::getInstance());
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // port 0 disables the endpoint; empty snapshot_path disables the file
+    bool start(int port, const std::string& bind_address,
+               const std::string& snapshot_path, int snapshot_interval_seconds);
+    void stop();
+
+    bool isRunning() const { return running.load(); }
+    int boundPort() const { return bound_port; }
+
+    // Write one snapshot now; also used for a final dump at shutdown
+    bool writeSnapshot();
+
+private:
+    void serveLoop();
+    void handleClient(int client_fd);
+
+    MetricsRegistry& registry;
+    std::atomic<bool> running;
+    std::thread server_thread;
+    int listen_fd;
+    int bound_port;
+    std::string snapshot_file;
+    int snapshot_interval_ms;
+};
+
+} // namespace TradingSystem
+
+#endif // METRICS_EXPORTER_H
@@ -0,0 +1,231 @@
+#include "metrics_registry.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace TradingSystem {
+
+// Keeps the calling thread's histograms registered until the thread exits
+struct ThreadTimersHandle {
+    std::shared_ptr<MetricsRegistry::ThreadTimers> timers;
+    ~ThreadTimersHandle() {
+        if (timers) timers->abandoned.store(true, std::memory_order_release);
+    }
+};
+
+namespace {
+
+thread_local ThreadTimersHandle thread_timers;
+
+const double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+void appendSeconds(std::ostringstream& out, uint64_t nanoseconds) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", static_cast<double>(nanoseconds) / 1e9);
+    out << buf;
+}
+
+// Label values are escaped per the exposition format
+std::string escapeLabel(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped.push_back('\\');
+            escaped.push_back(c);
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped.push_back(c);
+        }
+    }
+    return escaped;
+}
+
+} // namespace
+
+MetricsRegistry::ThreadTimers::ThreadTimers() {
+    for (auto& slot : histograms) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+MetricsRegistry::ThreadTimers::~ThreadTimers() {
+    for (auto& slot : histograms) {
+        delete slot.load(std::memory_order_relaxed);
+    }
+}
+
+MetricId MetricsRegistry::registerNamed(std::vector<std::string>& names, std::vector<std::string>* helps,
+                                        std::atomic<size_t>& count, size_t max,
+                                        const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it != names.end()) {
+        return static_cast<MetricId>(it - names.begin());
+    }
+    if (names.size() >= max) {
+        return kInvalidMetricId;
+    }
+    names.push_back(name);
+    if (helps) helps->push_back(help);
+    count.store(names.size(), std::memory_order_release);
+    return static_cast<MetricId>(names.size() - 1);
+}
+
+MetricId MetricsRegistry::registerTimer(const std::string& name) {
+    return registerNamed(timer_names, nullptr, timer_count, kMaxTimers, name, "");
+}
+
+MetricId MetricsRegistry::registerCounter(const std::string& name, const std::string& help) {
+    return registerNamed(counter_names, &counter_help, counter_count, kMaxCounters, name, help);
+}
+
+MetricId MetricsRegistry::registerGauge(const std::string& name, const std::string& help) {
+    return registerNamed(gauge_names, &gauge_help, gauge_count, kMaxGauges, name, help);
+}
+
+void MetricsRegistry::registerGaugeCallback(const std::string& name, const std::string& help,
+                                            std::function<double()> callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& gauge : callback_gauges) {
+        if (gauge.name == name) {
+            gauge.help = help;
+            gauge.callback = std::move(callback);
+            return;
+        }
+    }
+    callback_gauges.push_back({name, help, std::move(callback)});
+}
+
+void MetricsRegistry::removeGaugeCallback(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    callback_gauges.erase(std::remove_if(callback_gauges.begin(), callback_gauges.end(),
+                                         [&name](const CallbackGauge& g) { return g.name == name; }),
+                          callback_gauges.end());
+}
+
+MetricsRegistry::ThreadTimers* MetricsRegistry::threadTimers() {
+    if (!thread_timers.timers) {
+        auto timers = std::make_shared<ThreadTimers>();
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.push_back(timers);
+        thread_timers.timers = std::move(timers);
+    }
+    return thread_timers.timers.get();
+}
+
+void MetricsRegistry::recordLatency(MetricId timer, uint64_t nanoseconds) {
+    if (timer >= kMaxTimers) return;
+
+    ThreadTimers* timers = threadTimers();
+    LatencyHistogram* histogram = timers->histograms[timer].load(std::memory_order_relaxed);
+    if (!histogram) {
+        histogram = new LatencyHistogram();
+        timers->histograms[timer].store(histogram, std::memory_order_release);
+    }
+    histogram->record(nanoseconds);
+}
+
+void MetricsRegistry::retireAbandonedLocked() const {
+    auto it = threads.begin();
+    while (it != threads.end()) {
+        if (!(*it)->abandoned.load(std::memory_order_acquire)) {
+            ++it;
+            continue;
+        }
+        for (size_t id = 0; id < kMaxTimers; ++id) {
+            LatencyHistogram* histogram = (*it)->histograms[id].load(std::memory_order_acquire);
+            if (!histogram) continue;
+            if (retired.size() <= id) retired.resize(id + 1);
+            if (!retired[id]) retired[id].reset(new LatencyHistogram());
+            retired[id]->mergeFrom(*histogram);
+        }
+        it = threads.erase(it);
+    }
+}
+
+bool MetricsRegistry::timerSnapshot(MetricId timer, LatencyHistogram& out) const {
+    if (timer >= timer_count.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    retireAbandonedLocked();
+    out.reset();
+    if (timer < retired.size() && retired[timer]) {
+        out.mergeFrom(*retired[timer]);
+    }
+    for (const auto& timers : threads) {
+        LatencyHistogram* histogram = timers->histograms[timer].load(std::memory_order_acquire);
+        if (histogram) out.mergeFrom(*histogram);
+    }
+    return true;
+}
+
+std::string MetricsRegistry::timerName(MetricId timer) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return timer < timer_names.size() ? timer_names[timer] : std::string();
+}
+
+uint64_t MetricsRegistry::counterValue(MetricId counter) const {
+    return counter < kMaxCounters ? counters[counter].value.load(std::memory_order_relaxed) : 0;
+}
+
+std::string MetricsRegistry::renderPrometheus() const {
+    std::ostringstream out;
+    LatencyHistogram merged;
+
+    size_t timers = timer_count.load(std::memory_order_acquire);
+    if (timers > 0) {
+        out << "# HELP ts_latency_seconds Scope latency by timer\n";
+        out << "# TYPE ts_latency_seconds summary\n";
+        std::ostringstream max_lines;
+        for (MetricId id = 0; id < timers; ++id) {
+            timerSnapshot(id, merged);
+            std::string label = "timer=\"" + escapeLabel(timerName(id)) + "\"";
+            for (double q : kQuantiles) {
+                out << "ts_latency_seconds{" << label << ",quantile=\"" << q << "\"} ";
+                appendSeconds(out, merged.valueAtQuantile(q));
+                out << "\n";
+            }
+            out << "ts_latency_seconds_sum{" << label << "} ";
+            appendSeconds(out, merged.sum());
+            out << "\nts_latency_seconds_count{" << label << "} " << merged.count() << "\n";
+
+            max_lines << "ts_latency_max_seconds{" << label << "} ";
+            appendSeconds(max_lines, merged.max());
+            max_lines << "\n";
+        }
+        out << "# HELP ts_latency_max_seconds Slowest recorded scope by timer\n";
+        out << "# TYPE ts_latency_max_seconds gauge\n";
+        out << max_lines.str();
+    }
+
+    std::vector<CallbackGauge> sampled;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < counter_names.size(); ++i) {
+            out << "# HELP " << counter_names[i] << " " << counter_help[i] << "\n";
+            out << "# TYPE " << counter_names[i] << " counter\n";
+            out << counter_names[i] << " " << counters[i].value.load(std::memory_order_relaxed) << "\n";
+        }
+        for (size_t i = 0; i < gauge_names.size(); ++i) {
+            out << "# HELP " << gauge_names[i] << " " << gauge_help[i] << "\n";
+            out << "# TYPE " << gauge_names[i] << " gauge\n";
+            out << gauge_names[i] << " " << gauges[i].value.load(std::memory_order_relaxed) << "\n";
+        }
+        sampled = callback_gauges;
+    }
+
+    // Callbacks run outside the lock so they may use the registry themselves
+    for (const auto& gauge : sampled) {
+        out << "# HELP " << gauge.name << " " << gauge.help << "\n";
+        out << "# TYPE " << gauge.name << " gauge\n";
+        out << gauge.name << " " << gauge.callback() << "\n";
+    }
+
+    return out.str();
+}
+
+} // namespace TradingSystem
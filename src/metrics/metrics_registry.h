@@ -0,0 +1,153 @@
+#ifndef METRICS_REGISTRY_H
+#define METRICS_REGISTRY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "latency_histogram.h"
+
+namespace TradingSystem {
+
+using MetricId = uint16_t;
+constexpr MetricId kInvalidMetricId = 0xFFFF;
+
+// Process-wide registry of latency timers, counters and gauges.
+//
+// Timers are registered once (usually through a function-local static, see
+// PERF_TIMER) and recorded by id. Every thread records into its own
+// histograms, so the hot path is a thread_local lookup and a few relaxed
+// stores; readers merge all threads' histograms on demand.
+class MetricsRegistry {
+public:
+    static constexpr size_t kMaxTimers = 128;
+    static constexpr size_t kMaxCounters = 128;
+    static constexpr size_t kMaxGauges = 128;
+
+    static MetricsRegistry& getInstance() {
+        static MetricsRegistry instance;
+        return instance;
+    }
+
+    // Registration is idempotent by name. Returns kInvalidMetricId once the
+    // table is full; recording against it is a no-op.
+    MetricId registerTimer(const std::string& name);
+    MetricId registerCounter(const std::string& name, const std::string& help = "");
+    MetricId registerGauge(const std::string& name, const std::string& help = "");
+
+    // Gauge sampled at export time (queue depths and the like). The
+    // callback must stay valid until removed.
+    void registerGaugeCallback(const std::string& name, const std::string& help,
+                               std::function<double()> callback);
+    void removeGaugeCallback(const std::string& name);
+
+    void recordLatency(MetricId timer, uint64_t nanoseconds);
+    void increment(MetricId counter, uint64_t by = 1) {
+        if (counter < kMaxCounters) counters[counter].value.fetch_add(by, std::memory_order_relaxed);
+    }
+    void setGauge(MetricId gauge, double value) {
+        if (gauge < kMaxGauges) gauges[gauge].value.store(value, std::memory_order_relaxed);
+    }
+
+    // Merged view of one timer across all threads
+    bool timerSnapshot(MetricId timer, LatencyHistogram& out) const;
+    std::string timerName(MetricId timer) const;
+    uint64_t counterValue(MetricId counter) const;
+
+    // Prometheus text exposition format (version 0.0.4)
+    std::string renderPrometheus() const;
+
+private:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    // One thread's histograms, allocated lazily per timer
+    struct ThreadTimers {
+        std::atomic<LatencyHistogram*> histograms[kMaxTimers];
+        std::atomic<bool> abandoned{false};
+
+        ThreadTimers();
+        ~ThreadTimers();
+    };
+    friend struct ThreadTimersHandle;
+
+    struct alignas(64) CounterSlot {
+        std::atomic<uint64_t> value{0};
+    };
+    struct alignas(64) GaugeSlot {
+        std::atomic<double> value{0.0};
+    };
+    struct CallbackGauge {
+        std::string name;
+        std::string help;
+        std::function<double()> callback;
+    };
+
+    ThreadTimers* threadTimers();
+    void retireAbandonedLocked() const;
+    MetricId registerNamed(std::vector<std::string>& names, std::vector<std::string>* helps,
+                           std::atomic<size_t>& count, size_t max,
+                           const std::string& name, const std::string& help);
+
+    mutable std::mutex mutex;
+    std::vector<std::string> timer_names;
+    std::vector<std::string> counter_names;
+    std::vector<std::string> counter_help;
+    std::vector<std::string> gauge_names;
+    std::vector<std::string> gauge_help;
+    std::atomic<size_t> timer_count{0};
+    std::atomic<size_t> counter_count{0};
+    std::atomic<size_t> gauge_count{0};
+
+    mutable std::vector<std::shared_ptr<ThreadTimers>> threads;
+    // Histograms of threads that have exited, folded in on read
+    mutable std::vector<std::unique_ptr<LatencyHistogram>> retired;
+
+    CounterSlot counters[kMaxCounters];
+    GaugeSlot gauges[kMaxGauges];
+    std::vector<CallbackGauge> callback_gauges;
+};
+
+// Scoped timer recording into a registered latency histogram
+class ScopedLatency {
+public:
+    explicit ScopedLatency(MetricId timer_id)
+        : timer(timer_id), start_time(std::chrono::steady_clock::now()) {}
+
+    ~ScopedLatency() {
+        MetricsRegistry::getInstance().recordLatency(timer, elapsedNanos());
+    }
+
+    uint64_t elapsedNanos() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_time).count());
+    }
+
+private:
+    MetricId timer;
+    std::chrono::steady_clock::time_point start_time;
+};
+
+} // namespace TradingSystem
+
+#define TS_METRICS_CONCAT_INNER(a, b) a##b
+#define TS_METRICS_CONCAT(a, b) TS_METRICS_CONCAT_INNER(a, b)
+
+// Id of a timer registered on first use at this call site
+#define METRIC_TIMER_ID(name) \
+    ([]() -> TradingSystem::MetricId { \
+        static const TradingSystem::MetricId ts_timer_id_ = \
+            TradingSystem::MetricsRegistry::getInstance().registerTimer(name); \
+        return ts_timer_id_; \
+    }())
+
+// Time the rest of the enclosing scope into the named histogram
+#define METRIC_SCOPE(name) \
+    TradingSystem::ScopedLatency TS_METRICS_CONCAT(ts_scoped_latency_, __LINE__)(METRIC_TIMER_ID(name))
+
+#endif // METRICS_REGISTRY_H
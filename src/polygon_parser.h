@@ -0,0 +1,418 @@
+#ifndef POLYGON_PARSER_H
+#define POLYGON_PARSER_H
+
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+// One OHLCV bar from a Polygon aggregates response
+struct PolygonBar {
+	double open = 0.0;          // "o"
+	double high = 0.0;          // "h"
+	double low = 0.0;           // "l"
+	double close = 0.0;         // "c"
+	double volume = 0.0;        // "v"
+	double vwap = 0.0;          // "vw"
+	int64_t timestamp_ms = 0;   // "t", bar start in Unix milliseconds
+	int64_t transactions = 0;   // "n"
+};
+
+// Single-pass push parser for Polygon /v2/aggs responses.
+// Chunks are fed as they arrive from curl; the parser keeps only a small
+// fixed amount of state between chunks (container stack, the current key
+// and any scalar split across a chunk boundary), so it never allocates and
+// never copies the response body. Bars from the "results" array are written
+// into the caller's buffer; bars beyond its capacity are counted but dropped.
+class PolygonAggParser {
+	public:
+		PolygonAggParser(PolygonBar* bars = nullptr, size_t capacity = 0) {
+			reset(bars, capacity);
+		}
+
+		// Start a new response, writing bars into the given buffer
+		void reset(PolygonBar* bars, size_t capacity) {
+			m_Bars = bars;
+			m_Capacity = capacity;
+			m_BarCount = 0;
+			m_TotalBars = 0;
+			m_Depth = 0;
+			m_Expect = Expect::VALUE;
+			m_InString = false;
+			m_Escape = false;
+			m_StringTarget = StringTarget::DISCARD;
+			m_StrLen = 0;
+			m_TokenLen = 0;
+			m_RootKey = RootKey::OTHER;
+			m_BarKey = BarKey::OTHER;
+			m_ResultsOpen = false;
+			m_InBar = false;
+			m_Failed = false;
+			m_JustOpened = false;
+			m_StatusLen = 0;
+			m_TickerLen = 0;
+			m_Current = PolygonBar();
+		}
+
+		// Feed the next chunk of the response body; returns false once the
+		// input is known to be malformed
+		bool feed(std::string_view chunk) {
+			size_t i = 0;
+			const size_t n = chunk.size();
+
+			while (i < n && !m_Failed) {
+				if (m_InString) {
+					i = scanString(chunk, i);
+					continue;
+				}
+
+				if (m_TokenLen > 0) {
+					// Continue a scalar that started in the previous chunk
+					size_t end = scalarEnd(chunk, i);
+					if (!appendToken(chunk.data() + i, end - i)) {
+						return false;
+					}
+					i = end;
+					if (i < n) {
+						finishScalar(std::string_view(m_Token, m_TokenLen));
+						m_TokenLen = 0;
+					}
+					continue;
+				}
+
+				char c = chunk[i];
+				if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+					++i;
+					continue;
+				}
+
+				switch (m_Expect) {
+					case Expect::VALUE:
+						i = beginValue(chunk, i);
+						break;
+					case Expect::KEY:
+						if (c == '"') {
+							m_JustOpened = false;
+							m_InString = true;
+							m_StringTarget = StringTarget::KEY;
+							m_StrLen = 0;
+						} else if (c == '}' && m_JustOpened) {
+							closeContainer();
+						} else {
+							m_Failed = true;
+						}
+						++i;
+						break;
+					case Expect::COLON:
+						if (c == ':') {
+							m_Expect = Expect::VALUE;
+						} else {
+							m_Failed = true;
+						}
+						++i;
+						break;
+					case Expect::COMMA_OR_END:
+						if (c == ',') {
+							m_JustOpened = false;
+							m_Expect = (m_Depth > 0 && m_Stack[m_Depth - 1] == '{') ? Expect::KEY : Expect::VALUE;
+						} else if ((c == '}' || c == ']') && m_Depth > 0) {
+							if ((c == '}') != (m_Stack[m_Depth - 1] == '{')) {
+								m_Failed = true;
+							} else {
+								closeContainer();
+							}
+						} else {
+							m_Failed = true;
+						}
+						++i;
+						break;
+				}
+			}
+
+			return !m_Failed;
+		}
+
+		// Signal end of input; returns true if a complete document was parsed
+		bool finish() {
+			if (m_TokenLen > 0) {
+				finishScalar(std::string_view(m_Token, m_TokenLen));
+				m_TokenLen = 0;
+			}
+			return !m_Failed && !m_InString && m_Depth == 0 && m_Expect == Expect::COMMA_OR_END;
+		}
+
+		size_t barCount() const { return m_BarCount; }
+		size_t totalBars() const { return m_TotalBars; }
+		bool truncated() const { return m_TotalBars > m_BarCount; }
+		bool failed() const { return m_Failed; }
+		std::string_view status() const { return std::string_view(m_Status, m_StatusLen); }
+		std::string_view ticker() const { return std::string_view(m_Ticker, m_TickerLen); }
+		bool statusOk() const { return status() == "OK"; }
+
+	private:
+		enum class Expect { VALUE, KEY, COLON, COMMA_OR_END };
+		enum class StringTarget { DISCARD, KEY, STATUS, TICKER };
+		enum class RootKey { OTHER, STATUS, TICKER, RESULTS };
+		enum class BarKey { OTHER, OPEN, HIGH, LOW, CLOSE, VOLUME, VWAP, TIMESTAMP, TRANSACTIONS };
+
+		static constexpr size_t kMaxDepth = 32;
+		static constexpr size_t kMaxString = 32;
+		static constexpr size_t kMaxToken = 64;
+
+		PolygonBar* m_Bars;
+		size_t m_Capacity;
+		size_t m_BarCount;
+		size_t m_TotalBars;
+
+		char m_Stack[kMaxDepth];
+		size_t m_Depth;
+		Expect m_Expect;
+
+		bool m_InString;
+		bool m_Escape;
+		StringTarget m_StringTarget;
+		char m_Str[kMaxString];
+		size_t m_StrLen;
+
+		char m_Token[kMaxToken];
+		size_t m_TokenLen;
+
+		RootKey m_RootKey;
+		BarKey m_BarKey;
+		bool m_ResultsOpen;
+		bool m_InBar;
+		bool m_Failed;
+		bool m_JustOpened;           // Last token opened a container
+		PolygonBar m_Current;
+
+		char m_Status[16];
+		size_t m_StatusLen;
+		char m_Ticker[kMaxString];
+		size_t m_TickerLen;
+
+		// Depth 1 is the root object, 2 the results array, 3 a bar object
+		bool atRoot() const { return m_Depth == 1; }
+		bool inResultsArray() const { return m_ResultsOpen && m_Depth == 2; }
+
+		static bool isDelimiter(char c) {
+			return c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t';
+		}
+
+		static size_t scalarEnd(std::string_view chunk, size_t i) {
+			while (i < chunk.size() && !isDelimiter(chunk[i])) {
+				++i;
+			}
+			return i;
+		}
+
+		bool appendToken(const char* data, size_t len) {
+			if (m_TokenLen + len > kMaxToken) {
+				m_Failed = true;
+				return false;
+			}
+			std::memcpy(m_Token + m_TokenLen, data, len);
+			m_TokenLen += len;
+			return true;
+		}
+
+		size_t beginValue(std::string_view chunk, size_t i) {
+			char c = chunk[i];
+
+			if (c == '{' || c == '[') {
+				if (m_Depth >= kMaxDepth) {
+					m_Failed = true;
+					return i + 1;
+				}
+
+				if (c == '[' && atRoot() && m_RootKey == RootKey::RESULTS) {
+					m_ResultsOpen = true;
+				} else if (c == '{' && inResultsArray()) {
+					m_InBar = true;
+					m_Current = PolygonBar();
+				}
+
+				m_Stack[m_Depth++] = c;
+				m_Expect = (c == '{') ? Expect::KEY : Expect::VALUE;
+				m_JustOpened = true;
+				return i + 1;
+			}
+			if (c == ']' && m_JustOpened && m_Stack[m_Depth - 1] == '[') {
+				// Empty array
+				closeContainer();
+				return i + 1;
+			}
+			m_JustOpened = false;
+
+			if (c == '"') {
+				m_InString = true;
+				m_StrLen = 0;
+				m_StringTarget = StringTarget::DISCARD;
+				if (atRoot() && m_RootKey == RootKey::STATUS) {
+					m_StringTarget = StringTarget::STATUS;
+				} else if (atRoot() && m_RootKey == RootKey::TICKER) {
+					m_StringTarget = StringTarget::TICKER;
+				}
+				return i + 1;
+			}
+
+			// Number or literal: parse in place if it ends inside this chunk
+			size_t end = scalarEnd(chunk, i);
+			if (end == i) {
+				m_Failed = true;
+				return i + 1;
+			}
+			if (end < chunk.size()) {
+				finishScalar(chunk.substr(i, end - i));
+			} else {
+				appendToken(chunk.data() + i, end - i);
+			}
+			return end;
+		}
+
+		size_t scanString(std::string_view chunk, size_t i) {
+			const size_t n = chunk.size();
+			size_t start = i;
+
+			while (i < n) {
+				char c = chunk[i];
+				if (m_Escape) {
+					m_Escape = false;
+				} else if (c == '\\') {
+					m_Escape = true;
+				} else if (c == '"') {
+					captureString(chunk.data() + start, i - start);
+					finishString();
+					return i + 1;
+				}
+				++i;
+			}
+
+			captureString(chunk.data() + start, n - start);
+			return n;
+		}
+
+		void captureString(const char* data, size_t len) {
+			if (m_StringTarget == StringTarget::DISCARD) {
+				return;
+			}
+			size_t room = kMaxString - m_StrLen;
+			size_t take = len < room ? len : room;
+			std::memcpy(m_Str + m_StrLen, data, take);
+			m_StrLen += take;
+		}
+
+		void finishString() {
+			m_InString = false;
+			std::string_view value(m_Str, m_StrLen);
+
+			switch (m_StringTarget) {
+				case StringTarget::KEY:
+					classifyKey(value);
+					m_Expect = Expect::COLON;
+					return;
+				case StringTarget::STATUS:
+					m_StatusLen = value.size() < sizeof(m_Status) ? value.size() : sizeof(m_Status);
+					std::memcpy(m_Status, value.data(), m_StatusLen);
+					break;
+				case StringTarget::TICKER:
+					m_TickerLen = value.size();
+					std::memcpy(m_Ticker, value.data(), m_TickerLen);
+					break;
+				case StringTarget::DISCARD:
+					break;
+			}
+			m_Expect = Expect::COMMA_OR_END;
+		}
+
+		void classifyKey(std::string_view key) {
+			if (atRoot()) {
+				m_RootKey = RootKey::OTHER;
+				if (key == "status") m_RootKey = RootKey::STATUS;
+				else if (key == "ticker") m_RootKey = RootKey::TICKER;
+				else if (key == "results") m_RootKey = RootKey::RESULTS;
+				m_StringTarget = StringTarget::DISCARD;
+			} else if (m_InBar && m_Depth == 3) {
+				m_BarKey = BarKey::OTHER;
+				if (key.size() == 1) {
+					switch (key[0]) {
+						case 'o': m_BarKey = BarKey::OPEN; break;
+						case 'h': m_BarKey = BarKey::HIGH; break;
+						case 'l': m_BarKey = BarKey::LOW; break;
+						case 'c': m_BarKey = BarKey::CLOSE; break;
+						case 'v': m_BarKey = BarKey::VOLUME; break;
+						case 't': m_BarKey = BarKey::TIMESTAMP; break;
+						case 'n': m_BarKey = BarKey::TRANSACTIONS; break;
+					}
+				} else if (key == "vw") {
+					m_BarKey = BarKey::VWAP;
+				}
+			}
+			m_StringTarget = StringTarget::DISCARD;
+		}
+
+		void finishScalar(std::string_view token) {
+			m_Expect = Expect::COMMA_OR_END;
+			if (!m_InBar || m_Depth != 3 || m_BarKey == BarKey::OTHER) {
+				return;
+			}
+
+			const char* first = token.data();
+			const char* last = first + token.size();
+
+			if (m_BarKey == BarKey::TIMESTAMP || m_BarKey == BarKey::TRANSACTIONS) {
+				int64_t value = 0;
+				auto result = std::from_chars(first, last, value);
+				if (result.ec != std::errc() || result.ptr != last) {
+					// Polygon occasionally sends integral fields as floats
+					double as_double = 0.0;
+					auto retry = std::from_chars(first, last, as_double);
+					if (retry.ec != std::errc() || retry.ptr != last) {
+						m_Failed = true;
+						return;
+					}
+					value = static_cast<int64_t>(as_double);
+				}
+				(m_BarKey == BarKey::TIMESTAMP ? m_Current.timestamp_ms : m_Current.transactions) = value;
+				return;
+			}
+
+			// The whole token must be the number; "12.5x" is malformed, not 12.5
+			double value = 0.0;
+			auto result = std::from_chars(first, last, value);
+			if (result.ec != std::errc() || result.ptr != last) {
+				m_Failed = true;
+				return;
+			}
+
+			switch (m_BarKey) {
+				case BarKey::OPEN: m_Current.open = value; break;
+				case BarKey::HIGH: m_Current.high = value; break;
+				case BarKey::LOW: m_Current.low = value; break;
+				case BarKey::CLOSE: m_Current.close = value; break;
+				case BarKey::VOLUME: m_Current.volume = value; break;
+				case BarKey::VWAP: m_Current.vwap = value; break;
+				default: break;
+			}
+		}
+
+		void closeContainer() {
+			char open = m_Stack[--m_Depth];
+
+			if (open == '{' && m_InBar && m_Depth == 2) {
+				// Finished a bar object inside results
+				m_InBar = false;
+				if (m_BarCount < m_Capacity) {
+					m_Bars[m_BarCount++] = m_Current;
+				}
+				++m_TotalBars;
+			} else if (open == '[' && m_ResultsOpen && m_Depth == 1) {
+				m_ResultsOpen = false;
+			}
+
+			m_BarKey = BarKey::OTHER;
+			m_Expect = Expect::COMMA_OR_END;
+		}
+};
+
+#endif // POLYGON_PARSER_H
@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+
+"""Python side of the shared-memory SPSC ring used by IPCManager.
+
+The segment layout mirrors ShmRingHeader in src/ipc/shm_ring_buffer.h:
+
+    offset   0  u32 magic, u32 version, u64 capacity
+    offset  64  u64 write_pos            (producer)
+    offset 128  u64 read_pos             (consumer)
+    offset 192  u32 data_seq, u32 consumer_waiting
+    offset 256  u32 space_seq, u32 producer_waiting
+    offset 320  data region (capacity bytes)
+
+Frames are [u32 length][payload] padded to 8 bytes; a length of 0xFFFFFFFF
+means "skip to the start of the buffer". Positions only ever grow and are
+masked with capacity - 1. Aligned 8-byte loads/stores through ctypes are
+single instructions, which together with x86-64 store ordering gives the
+acquire/release semantics the C++ side relies on. Python has no portable
+fence, so this module refuses to run elsewhere; IPCManager falls back to
+pipes on other architectures.
+"""
+
+import ctypes
+import mmap
+import os
+import struct
+import time
+
+MAGIC = 0x544D5242
+VERSION = 1
+WRAP_MARKER = 0xFFFFFFFF
+DATA_OFFSET = 320
+
+_FUTEX_WAIT = 0
+_FUTEX_WAKE = 1
+_SYS_FUTEX = {'x86_64': 202, 'aarch64': 98}.get(os.uname().machine, 202)
+_SPIN_ITERATIONS = 200
+
+# How long to wait for the C++ side to finish initializing a segment it
+# has just created (sized and mapped, magic not yet written)
+_ATTACH_TIMEOUT_S = 5.0
+_ATTACH_POLL_S = 0.01
+
+_libc = ctypes.CDLL(None, use_errno=True)
+
+
+class _Timespec(ctypes.Structure):
+    _fields_ = [('tv_sec', ctypes.c_long), ('tv_nsec', ctypes.c_long)]
+
+
+def _futex_wait(word: ctypes.c_uint32, expected: int, timeout_s: float):
+    ts = _Timespec(int(timeout_s), int((timeout_s % 1) * 1e9))
+    _libc.syscall(_SYS_FUTEX, ctypes.byref(word), _FUTEX_WAIT, ctypes.c_uint32(expected),
+                  ctypes.byref(ts), None, 0)
+
+
+def _futex_wake(word: ctypes.c_uint32):
+    _libc.syscall(_SYS_FUTEX, ctypes.byref(word), _FUTEX_WAKE, 1, None, None, 0)
+
+
+def segment_name(pipe_base: str, suffix: str) -> str:
+    """Derive the shm segment name the same way IPCManager does"""
+    return os.path.basename(pipe_base) + suffix
+
+
+def segment_exists(pipe_base: str, suffix: str) -> bool:
+    return os.path.exists(os.path.join('/dev/shm', segment_name(pipe_base, suffix)))
+
+
+class ShmRing:
+    """One direction of the shared-memory transport"""
+
+    def __init__(self, name: str, timeout_s: float = _ATTACH_TIMEOUT_S):
+        if os.uname().machine != 'x86_64':
+            raise RuntimeError("The shared-memory transport is only supported on x86-64")
+
+        # The segment can be seen between shm_open and the header being
+        # written (magic goes last), so poll until it is complete
+        path = os.path.join('/dev/shm', name.lstrip('/'))
+        deadline = time.monotonic() + timeout_s
+        while True:
+            self.mm = self._map_if_ready(path)
+            if self.mm is not None:
+                break
+            if time.monotonic() >= deadline:
+                raise RuntimeError(f"Shared memory segment {name} was not initialized "
+                                   f"within {timeout_s}s or has an incompatible layout")
+            time.sleep(_ATTACH_POLL_S)
+
+        capacity = struct.unpack_from('<Q', self.mm, 8)[0]
+
+        self.capacity = capacity
+        self.mask = capacity - 1
+        self.write_pos = ctypes.c_uint64.from_buffer(self.mm, 64)
+        self.read_pos = ctypes.c_uint64.from_buffer(self.mm, 128)
+        self.data_seq = ctypes.c_uint32.from_buffer(self.mm, 192)
+        self.consumer_waiting = ctypes.c_uint32.from_buffer(self.mm, 196)
+        self.space_seq = ctypes.c_uint32.from_buffer(self.mm, 256)
+        self.producer_waiting = ctypes.c_uint32.from_buffer(self.mm, 260)
+        self.data = memoryview(self.mm)[DATA_OFFSET:DATA_OFFSET + capacity]
+
+    @staticmethod
+    def _map_if_ready(path: str):
+        """Map the segment if its header is complete, else return None"""
+        try:
+            fd = os.open(path, os.O_RDWR)
+        except FileNotFoundError:
+            return None  # Replaced by a restarting trading system
+        try:
+            size = os.fstat(fd).st_size
+            if size <= DATA_OFFSET:
+                return None
+            mm = mmap.mmap(fd, size, mmap.MAP_SHARED, mmap.PROT_READ | mmap.PROT_WRITE)
+        finally:
+            os.close(fd)
+
+        magic, version, capacity = struct.unpack_from('<IIQ', mm, 0)
+        if magic != MAGIC or version != VERSION or DATA_OFFSET + capacity != size:
+            mm.close()
+            return None
+        return mm
+
+    @staticmethod
+    def _frame_size(length: int) -> int:
+        return (4 + length + 7) & ~7
+
+    def try_write(self, payload: bytes) -> bool:
+        needed = self._frame_size(len(payload))
+        if needed > self.capacity // 2:
+            raise ValueError("Frame larger than half the ring capacity")
+
+        write = self.write_pos.value
+        read = self.read_pos.value
+        offset = write & self.mask
+        to_end = self.capacity - offset
+        skip = to_end if to_end < needed else 0
+
+        if (write - read) + skip + needed > self.capacity:
+            return False
+
+        if skip:
+            struct.pack_into('<I', self.data, offset, WRAP_MARKER)
+            write += skip
+            offset = 0
+
+        struct.pack_into('<I', self.data, offset, len(payload))
+        self.data[offset + 4:offset + 4 + len(payload)] = payload
+
+        self.write_pos.value = write + needed
+        if self.consumer_waiting.value:
+            self.data_seq.value = (self.data_seq.value + 1) & 0xFFFFFFFF
+            _futex_wake(self.data_seq)
+        return True
+
+    def write(self, payload: bytes, timeout_s: float = 1.0) -> bool:
+        deadline = time.monotonic() + timeout_s
+        while not self.try_write(payload):
+            if time.monotonic() >= deadline:
+                return False
+            self.producer_waiting.value = 1
+            seq = self.space_seq.value
+            if self.try_write(payload):
+                self.producer_waiting.value = 0
+                return True
+            _futex_wait(self.space_seq, seq, 0.01)
+            self.producer_waiting.value = 0
+        return True
+
+    def try_read(self):
+        """Return the next frame as bytes, or None if the ring is empty"""
+        read = self.read_pos.value
+        while read != self.write_pos.value:
+            offset = read & self.mask
+            (length,) = struct.unpack_from('<I', self.data, offset)
+            if length == WRAP_MARKER:
+                read += self.capacity - offset
+                self.read_pos.value = read
+                continue
+
+            payload = bytes(self.data[offset + 4:offset + 4 + length])
+            self.read_pos.value = read + self._frame_size(length)
+            if self.producer_waiting.value:
+                self.space_seq.value = (self.space_seq.value + 1) & 0xFFFFFFFF
+                _futex_wake(self.space_seq)
+            return payload
+        return None
+
+    def read(self, timeout_s: float = 0.1):
+        """Block for up to timeout_s waiting for a frame"""
+        for _ in range(_SPIN_ITERATIONS):
+            frame = self.try_read()
+            if frame is not None:
+                return frame
+
+        # A wake can be stale (bumped for a frame already read), so sleep
+        # again until a frame arrives or the timeout runs out
+        deadline = time.monotonic() + timeout_s
+        self.consumer_waiting.value = 1
+        while True:
+            seq = self.data_seq.value
+            frame = self.try_read()
+            remaining = deadline - time.monotonic()
+            if frame is not None or remaining <= 0:
+                break
+            _futex_wait(self.data_seq, seq, remaining)
+        self.consumer_waiting.value = 0
+        return frame
+
+    def close(self):
+        # Drop exported buffers before closing the mapping
+        del self.write_pos, self.read_pos, self.data_seq, self.consumer_waiting
+        del self.space_seq, self.producer_waiting
+        self.data.release()
+        self.mm.close()
+
+
+class ShmTransport:
+    """Analyzer endpoint: reads <base>_to_python, writes <base>_to_cpp"""
+
+    def __init__(self, pipe_base: str):
+        self.rx = ShmRing(segment_name(pipe_base, '_to_python'))
+        self.tx = ShmRing(segment_name(pipe_base, '_to_cpp'))
+
+    def read_message(self, timeout_s: float = 0.1):
+        frame = self.rx.read(timeout_s)
+        return frame.decode('utf-8') if frame is not None else None
+
+    def write_message(self, message) -> bool:
+        # Binary wire-format replies are written as-is
+        if isinstance(message, str):
+            message = message.encode('utf-8')
+        return self.tx.write(message)
+
+    def close(self):
+        self.rx.close()
+        self.tx.close()
@@ -1,3 +1,5 @@
+import struct
+import sys
 import numpy as np
 import torch
 import torch.nn as nn
@@ -152,6 +154,64 @@ class StockRanker:
         
         rankings = np.argsort(-scores)
         return rankings, scores
+    
+    MODEL_FILE_MAGIC = 0x504C4D54  # "TMLP", read by MlpModel in analysis/mlp_model.h
+    MODEL_FILE_VERSION = 1
+    
+    def export_weights(self, path: str):
+        """Write the model as a flat chain of dense layers for the C++ engine.
+        
+        The fitted StandardScaler is folded into the first Linear layer and
+        each eval-mode BatchNorm into the Linear layer that follows it, so
+        inference needs no preprocessing and no normalization. Dropout is an
+        identity at inference and is dropped.
+        """
+        self.model.eval()
+        modules = list(self.model.network)
+        
+        layers = []       # [weight (out, in), bias (out,), relu]
+        pending = None    # BatchNorm scale/shift waiting for the next Linear
+        
+        for module in modules:
+            if isinstance(module, nn.Linear):
+                weight = module.weight.detach().cpu().double().numpy()
+                bias = module.bias.detach().cpu().double().numpy()
+                if pending is not None:
+                    scale, shift = pending
+                    bias = bias + weight @ shift
+                    weight = weight * scale[np.newaxis, :]
+                    pending = None
+                layers.append([weight, bias, False])
+            elif isinstance(module, nn.ReLU):
+                layers[-1][2] = True
+            elif isinstance(module, nn.BatchNorm1d):
+                mean = module.running_mean.detach().cpu().double().numpy()
+                var = module.running_var.detach().cpu().double().numpy()
+                gamma = module.weight.detach().cpu().double().numpy()
+                beta = module.bias.detach().cpu().double().numpy()
+                scale = gamma / np.sqrt(var + module.eps)
+                pending = (scale, beta - scale * mean)
+        
+        if pending is not None:
+            raise ValueError("BatchNorm after the last Linear layer cannot be folded")
+        
+        # x_scaled = (x - mean) / scale, so W x_scaled + b = (W / scale) x + (b - W (mean / scale))
+        if hasattr(self.scaler, 'mean_'):
+            weight, bias, relu = layers[0]
+            inv_scale = 1.0 / self.scaler.scale_
+            bias = bias - weight @ (self.scaler.mean_ * inv_scale)
+            weight = weight * inv_scale[np.newaxis, :]
+            layers[0] = [weight, bias, relu]
+        
+        input_size = layers[0][0].shape[1]
+        with open(path, 'wb') as f:
+            f.write(struct.pack('<IIII', self.MODEL_FILE_MAGIC, self.MODEL_FILE_VERSION,
+                                input_size, len(layers)))
+            for weight, bias, relu in layers:
+                out_size, in_size = weight.shape
+                f.write(struct.pack('<IIII', in_size, out_size, 1 if relu else 0, 0))
+                f.write(weight.astype('<f4').tobytes(order='C'))
+                f.write(bias.astype('<f4').tobytes())
 
 
 def create_mock_stock_data(n_stocks: int = 100, n_features: int = 10) -> Tuple[pd.DataFrame, np.ndarray]:
@@ -205,4 +265,8 @@ if __name__ == "__main__":
     print("\nTop 10 ranked stocks:")
     for i in range(min(10, len(rankings))):
         stock_idx = rankings[i]
-        print(f"{i+1}. {val_data.iloc[stock_idx]['ticker']} - Score: {scores[stock_idx]:.4f}")
\ No newline at end of file
+        print(f"{i+1}. {val_data.iloc[stock_idx]['ticker']} - Score: {scores[stock_idx]:.4f}")
+    
+    if len(sys.argv) > 1:
+        ranker.export_weights(sys.argv[1])
+        print(f"\nExported weights to {sys.argv[1]}")
\ No newline at end of file
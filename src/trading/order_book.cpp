@@ -0,0 +1,68 @@
+#include "order_book.h"
+
+namespace TradingSystem {
+
+OrderBook::Trigger OrderBook::triggerFor(OrderSide side, OrderType type) {
+    // A buy limit waits for the price to come down to it, a buy stop for
+    // the price to rise through it; sells are the mirror image
+    bool buy = side == OrderSide::BUY;
+    if (type == OrderType::STOP) {
+        return buy ? Trigger::AT_OR_ABOVE : Trigger::AT_OR_BELOW;
+    }
+    return buy ? Trigger::AT_OR_BELOW : Trigger::AT_OR_ABOVE;
+}
+
+void OrderBook::add(OrderId id, double price, Trigger trigger) {
+    cancel(id);
+    Level& level = trigger == Trigger::AT_OR_BELOW ? below[price] : above[price];
+    level.ids.push_back(id);
+    ++level.live;
+    index[id] = Entry{price, trigger};
+}
+
+bool OrderBook::cancel(OrderId id) {
+    Entry* entry = index.find(id);
+    if (!entry) {
+        return false;
+    }
+    Entry removed = *entry;
+    index.erase(id);
+
+    auto release = [](auto& levels, double price) {
+        auto level = levels.find(price);
+        if (level != levels.end() && --level->second.live == 0) {
+            levels.erase(level);
+        }
+    };
+    if (removed.trigger == Trigger::AT_OR_BELOW) {
+        release(below, removed.price);
+    } else {
+        release(above, removed.price);
+    }
+    return true;
+}
+
+void OrderBook::collectCrossed(double market_price, std::vector<OrderId>& out) {
+    while (!below.empty() && market_price <= below.begin()->first) {
+        drain(below, below.begin(), out);
+    }
+    while (!above.empty() && market_price >= above.begin()->first) {
+        drain(above, above.begin(), out);
+    }
+}
+
+template <typename Levels>
+void OrderBook::drain(Levels& levels, typename Levels::iterator level, std::vector<OrderId>& out) {
+    double price = level->first;
+    for (OrderId id : level->second.ids) {
+        // Skip cancelled ids and ids re-added at another price
+        const Entry* entry = index.find(id);
+        if (entry && entry->price == price) {
+            out.push_back(id);
+            index.erase(id);
+        }
+    }
+    levels.erase(level);
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,64 @@
+#ifndef ORDER_BOOK_H
+#define ORDER_BOOK_H
+
+#include <map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "../common/data_types.h"
+#include "../common/flat_hash_map.h"
+
+namespace TradingSystem {
+
+// Resting orders for one symbol, indexed by the price that sets them off.
+// An entry fires either when the market trades at or below its price (buy
+// limits, sell stops) or at or above it (sell limits, buy stops,
+// take-profits). Each side is a map of price levels with the next level to
+// fire at begin(), so checking a price is O(1) when nothing crosses and
+// otherwise costs the levels crossed. Levels keep arrival order. Cancels
+// are O(1) in the id index; the cancelled id is skipped when its level is
+// drained, and a level is dropped as soon as it has no live entries.
+class OrderBook {
+public:
+    enum class Trigger : uint8_t {
+        AT_OR_BELOW,
+        AT_OR_ABOVE
+    };
+
+    // Which way an order of this side and type fires
+    static Trigger triggerFor(OrderSide side, OrderType type);
+
+    void add(OrderId id, double price, Trigger trigger);
+    bool cancel(OrderId id);
+    bool contains(OrderId id) const { return index.contains(id); }
+
+    // Removes every entry market_price sets off and appends the ids to
+    // out, best price first and in arrival order within a level
+    void collectCrossed(double market_price, std::vector<OrderId>& out);
+
+    size_t size() const { return index.size(); }
+    bool empty() const { return index.empty(); }
+
+private:
+    struct Level {
+        std::vector<OrderId> ids;
+        size_t live = 0;
+    };
+
+    struct Entry {
+        double price = 0.0;
+        Trigger trigger = Trigger::AT_OR_BELOW;
+    };
+
+    std::map<double, Level, std::greater<double>> below;  // highest fires first
+    std::map<double, Level> above;                         // lowest fires first
+    FlatHashMap<OrderId, Entry> index;
+
+    template <typename Levels>
+    void drain(Levels& levels, typename Levels::iterator level, std::vector<OrderId>& out);
+};
+
+} // namespace TradingSystem
+
+#endif // ORDER_BOOK_H
@@ -0,0 +1,129 @@
+#include "performance_stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace TradingSystem {
+
+PerformanceStats::PerformanceStats(double initial_equity, size_t window)
+    : window_returns(std::max<size_t>(window, 2), 0.0) {
+    reset(initial_equity);
+}
+
+void PerformanceStats::reset(double initial_equity) {
+    return_count = 0;
+    mean = m2 = downside_sq = 0.0;
+    std::fill(window_returns.begin(), window_returns.end(), 0.0);
+    window_next = window_count = 0;
+    window_mean = window_m2 = 0.0;
+    current_day = -1;
+    day_start_equity = last_equity = peak_equity = initial_equity;
+    max_drawdown = 0.0;
+    wins = losses = 0;
+    gross_profit = gross_loss = 0.0;
+}
+
+void PerformanceStats::onEquity(std::chrono::system_clock::time_point time, double equity) {
+    int64_t day = std::chrono::duration_cast<std::chrono::hours>(time.time_since_epoch()).count() / 24;
+    if (day != current_day) {
+        // last_equity is still the previous day's close
+        if (current_day >= 0 && day_start_equity > 0) {
+            addReturn((last_equity - day_start_equity) / day_start_equity);
+        }
+        current_day = day;
+        day_start_equity = last_equity;
+    }
+
+    last_equity = equity;
+    if (equity > peak_equity) {
+        peak_equity = equity;
+    }
+    max_drawdown = std::max(max_drawdown, drawdown());
+}
+
+void PerformanceStats::onTrade(double realized_pnl) {
+    if (realized_pnl > 0) {
+        ++wins;
+        gross_profit += realized_pnl;
+    } else if (realized_pnl < 0) {
+        ++losses;
+        gross_loss -= realized_pnl;
+    }
+}
+
+void PerformanceStats::seedTrades(uint64_t wins, uint64_t losses) {
+    this->wins += wins;
+    this->losses += losses;
+}
+
+void PerformanceStats::addReturn(double r) {
+    ++return_count;
+    double delta = r - mean;
+    mean += delta / static_cast<double>(return_count);
+    m2 += delta * (r - mean);
+    if (r < 0) {
+        downside_sq += r * r;
+    }
+
+    // Evict the oldest return once the ring is full (Welford in reverse),
+    // then add the new one in its slot
+    size_t capacity = window_returns.size();
+    if (window_count == capacity) {
+        double old = window_returns[window_next];
+        --window_count;
+        if (window_count == 0) {
+            window_mean = window_m2 = 0.0;
+        } else {
+            double old_mean = window_mean;
+            window_mean -= (old - window_mean) / static_cast<double>(window_count);
+            window_m2 -= (old - old_mean) * (old - window_mean);
+        }
+    }
+    window_returns[window_next] = r;
+    window_next = (window_next + 1) % capacity;
+    ++window_count;
+    double window_delta = r - window_mean;
+    window_mean += window_delta / static_cast<double>(window_count);
+    window_m2 += window_delta * (r - window_mean);
+}
+
+double PerformanceStats::returnStdDev() const {
+    return return_count > 1 ? std::sqrt(m2 / static_cast<double>(return_count - 1)) : 0.0;
+}
+
+double PerformanceStats::sharpeRatio() const {
+    double stddev = returnStdDev();
+    return stddev > 0 ? mean / stddev * std::sqrt(kPeriodsPerYear) : 0.0;
+}
+
+double PerformanceStats::sortinoRatio() const {
+    if (return_count < 2 || downside_sq <= 0) {
+        return 0.0;
+    }
+    double downside = std::sqrt(downside_sq / static_cast<double>(return_count));
+    return mean / downside * std::sqrt(kPeriodsPerYear);
+}
+
+double PerformanceStats::rollingSharpeRatio() const {
+    if (window_count < 2) {
+        return 0.0;
+    }
+    // Removal can leave a tiny negative m2 when the window is flat
+    double variance = std::max(window_m2, 0.0) / static_cast<double>(window_count - 1);
+    double stddev = std::sqrt(variance);
+    return stddev > 0 ? window_mean / stddev * std::sqrt(kPeriodsPerYear) : 0.0;
+}
+
+double PerformanceStats::drawdown() const {
+    return peak_equity > 0 ? (peak_equity - last_equity) / peak_equity : 0.0;
+}
+
+double PerformanceStats::winRate() const {
+    uint64_t total = wins + losses;
+    return total > 0 ? static_cast<double>(wins) / static_cast<double>(total) : 0.0;
+}
+
+double PerformanceStats::profitFactor() const {
+    return gross_loss > 0 ? gross_profit / gross_loss : 0.0;
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,95 @@
+#ifndef PERFORMANCE_STATS_H
+#define PERFORMANCE_STATS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TradingSystem {
+
+// Online performance statistics fed by equity marks and closed trades.
+// Every update and every read is O(1): daily returns go into a Welford
+// accumulator (Sharpe) and a running downside sum (Sortino), the last
+// window of them into a fixed ring with its own add/remove Welford state
+// (rolling Sharpe), and drawdown and trade counters are plain running
+// values. Nothing is kept per sample beyond the ring.
+//
+// Days are UTC days of the timestamps passed to onEquity, so a replay on
+// a simulated clock gets the same statistics as live trading would. A
+// day's return is closed by the first mark of the next day, measured
+// from the last equity of the day before it to the last equity of the
+// day itself.
+class PerformanceStats {
+public:
+    static constexpr size_t kDefaultWindow = 30;
+    // Returns are annualised over 365 periods: the traded symbols are
+    // crypto, which trade every day
+    static constexpr double kPeriodsPerYear = 365.0;
+
+    explicit PerformanceStats(double initial_equity = 0.0, size_t window = kDefaultWindow);
+
+    void reset(double initial_equity);
+
+    void onEquity(std::chrono::system_clock::time_point time, double equity);
+    // Realized P&L of a sell; zero counts as neither a win nor a loss
+    void onTrade(double realized_pnl);
+    // Carry over trade counts recorded before this process started
+    void seedTrades(uint64_t wins, uint64_t losses);
+
+    // Daily returns
+    uint64_t returnCount() const { return return_count; }
+    double meanReturn() const { return mean; }
+    double returnStdDev() const;
+    double sharpeRatio() const;
+    double sortinoRatio() const;
+    double rollingSharpeRatio() const;
+    size_t rollingCount() const { return window_count; }
+
+    // Equity
+    double equity() const { return last_equity; }
+    double dailyPnL() const { return last_equity - day_start_equity; }
+    double peakEquity() const { return peak_equity; }
+    double drawdown() const;
+    double maxDrawdown() const { return max_drawdown; }
+
+    // Trades
+    uint64_t winningTrades() const { return wins; }
+    uint64_t losingTrades() const { return losses; }
+    double winRate() const;
+    double grossProfit() const { return gross_profit; }
+    double grossLoss() const { return gross_loss; }
+    // Gross profit over gross loss; 0 until there is a losing trade
+    double profitFactor() const;
+
+private:
+    void addReturn(double r);
+
+    // Whole-history Welford state
+    uint64_t return_count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double downside_sq = 0.0;  // sum of min(r, 0)^2
+
+    // Rolling window: ring of the last window returns, Welford over them
+    std::vector<double> window_returns;
+    size_t window_next = 0;
+    size_t window_count = 0;
+    double window_mean = 0.0;
+    double window_m2 = 0.0;
+
+    int64_t current_day = -1;
+    double day_start_equity = 0.0;
+    double last_equity = 0.0;
+    double peak_equity = 0.0;
+    double max_drawdown = 0.0;
+
+    uint64_t wins = 0;
+    uint64_t losses = 0;
+    double gross_profit = 0.0;
+    double gross_loss = 0.0;
+};
+
+} // namespace TradingSystem
+
+#endif // PERFORMANCE_STATS_H
@@ -0,0 +1,67 @@
+#include "portfolio_aggregator.h"
+
+namespace TradingSystem {
+
+PortfolioAggregator::PortfolioAggregator(double initial_cash, size_t shard_count)
+    : shard_count(shard_count > 0 ? shard_count : 1),
+      shards(new ShardSlot[shard_count > 0 ? shard_count : 1]),
+      initial_cash(initial_cash),
+      cash_balance(initial_cash),
+      peak_equity(initial_cash) {
+}
+
+size_t PortfolioAggregator::shardOf(const std::string& symbol) const {
+    return shardOf(SymbolTable::getInstance().intern(symbol));
+}
+
+bool PortfolioAggregator::tryDebitCash(size_t shard, double amount) {
+    if (shard >= shard_count) return false;
+    double current = cash_balance.load(std::memory_order_relaxed);
+    do {
+        if (current < amount) {
+            return false;
+        }
+    } while (!cash_balance.compare_exchange_weak(current, current - amount,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed));
+    shards[shard].cash_flow -= amount;
+    return true;
+}
+
+void PortfolioAggregator::creditCash(size_t shard, double amount) {
+    if (shard >= shard_count) return;
+    double current = cash_balance.load(std::memory_order_relaxed);
+    while (!cash_balance.compare_exchange_weak(current, current + amount,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_relaxed)) {
+    }
+    shards[shard].cash_flow += amount;
+}
+
+void PortfolioAggregator::publishShardValue(size_t shard, double market_value) {
+    if (shard >= shard_count) return;
+    shards[shard].net_value.store(market_value + shards[shard].cash_flow, std::memory_order_release);
+    updatePeak(equity());
+}
+
+double PortfolioAggregator::equity() const {
+    double total = initial_cash;
+    for (size_t i = 0; i < shard_count; ++i) {
+        total += shards[i].net_value.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+double PortfolioAggregator::drawdown() const {
+    double peak = peakEquity();
+    return peak > 0 ? (peak - equity()) / peak : 0.0;
+}
+
+void PortfolioAggregator::updatePeak(double current_equity) {
+    double peak = peak_equity.load(std::memory_order_relaxed);
+    while (current_equity > peak &&
+           !peak_equity.compare_exchange_weak(peak, current_equity, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace TradingSystem
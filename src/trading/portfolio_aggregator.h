@@ -0,0 +1,62 @@
+#ifndef PORTFOLIO_AGGREGATOR_H
+#define PORTFOLIO_AGGREGATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "../common/symbol_table.h"
+
+namespace TradingSystem {
+
+// Portfolio-wide state shared by the shards of a ShardedTradingEngine.
+// Cash is one atomic balance debited with a CAS, so two shards can never
+// spend the same dollars. For equity each shard publishes a single number,
+// its positions' market value plus the net cash it has spent or received,
+// so a reader always sums self-consistent shard states: a fill in progress
+// (cash debited, position not yet published) never shows up as a swing in
+// equity, drawdown or the peak.
+class PortfolioAggregator {
+public:
+    PortfolioAggregator(double initial_cash, size_t shard_count);
+
+    PortfolioAggregator(const PortfolioAggregator&) = delete;
+    PortfolioAggregator& operator=(const PortfolioAggregator&) = delete;
+
+    size_t shardCount() const { return shard_count; }
+    // Owning shard of a symbol; stable for the life of the process.
+    // Interned ids are dense, so consecutive symbols spread evenly.
+    size_t shardOf(SymbolId symbol_id) const { return symbol_id % shard_count; }
+    size_t shardOf(const std::string& symbol) const;
+
+    double cash() const { return cash_balance.load(std::memory_order_acquire); }
+
+    // Called only from the shard's own thread. Debit succeeds only if the
+    // balance covers amount; the shard's published value catches up on
+    // the next publishShardValue().
+    bool tryDebitCash(size_t shard, double amount);
+    void creditCash(size_t shard, double amount);
+    void publishShardValue(size_t shard, double market_value);
+
+    double equity() const;
+    double peakEquity() const { return peak_equity.load(std::memory_order_relaxed); }
+    double drawdown() const;
+
+private:
+    struct alignas(64) ShardSlot {
+        std::atomic<double> net_value{0.0};  // market value + cash_flow
+        double cash_flow = 0.0;              // owner thread only
+    };
+
+    void updatePeak(double current_equity);
+
+    size_t shard_count;
+    std::unique_ptr<ShardSlot[]> shards;
+    double initial_cash;
+    alignas(64) std::atomic<double> cash_balance;
+    alignas(64) std::atomic<double> peak_equity;
+};
+
+} // namespace TradingSystem
+
+#endif // PORTFOLIO_AGGREGATOR_H
@@ -0,0 +1,294 @@
+#include "sharded_trading_engine.h"
+#include <algorithm>
+#include <chrono>
+
+namespace TradingSystem {
+
+ShardedTradingEngine::ShardedTradingEngine(TradingMode mode, double initial_balance,
+                                           size_t shard_count, size_t queue_capacity)
+    : initial_balance(initial_balance),
+      aggregator(std::make_shared<PortfolioAggregator>(initial_balance, shard_count)),
+      running(false), submitted(0), completed(0) {
+    for (size_t i = 0; i < aggregator->shardCount(); ++i) {
+        shards.push_back(std::make_unique<Shard>(mode, initial_balance, queue_capacity));
+        shards.back()->engine.attachAggregator(aggregator, i);
+    }
+}
+
+ShardedTradingEngine::~ShardedTradingEngine() {
+    stop();
+}
+
+void ShardedTradingEngine::setAsyncWriter(std::shared_ptr<AsyncDbWriter> writer) {
+    for (auto& shard : shards) shard->engine.setAsyncWriter(writer);
+}
+
+void ShardedTradingEngine::setMarketDataCache(std::shared_ptr<MarketDataCache> cache) {
+    for (auto& shard : shards) shard->engine.setMarketDataCache(cache);
+}
+
+void ShardedTradingEngine::setPricingService(std::shared_ptr<PricingService> service) {
+    for (auto& shard : shards) shard->engine.setPricingService(service);
+}
+
+void ShardedTradingEngine::setMaxPositionSize(double max_size) {
+    max_position_size.store(max_size, std::memory_order_relaxed);
+    for (auto& shard : shards) shard->engine.setMaxPositionSize(max_size);
+}
+
+void ShardedTradingEngine::setMaxDrawdown(double max_dd) {
+    for (auto& shard : shards) shard->engine.setMaxDrawdown(max_dd);
+}
+
+void ShardedTradingEngine::setStopLoss(double percentage) {
+    for (auto& shard : shards) shard->engine.setStopLoss(percentage);
+}
+
+void ShardedTradingEngine::setTakeProfit(double percentage) {
+    for (auto& shard : shards) shard->engine.setTakeProfit(percentage);
+}
+
+void ShardedTradingEngine::updateRiskLimits(const RiskLimits& limits) {
+    max_position_size.store(limits.max_position_size, std::memory_order_relaxed);
+    for (size_t i = 0; i < shards.size(); ++i) {
+        TradingEngine* engine = &shards[i]->engine;
+        ShardTask task;
+        task.call = [engine, limits] { engine->setRiskLimits(limits); };
+        enqueue(i, std::move(task));
+    }
+}
+
+bool ShardedTradingEngine::initialize(std::shared_ptr<DatabaseManager> db_manager) {
+    // One read for every shard; each keeps the positions it owns
+    auto positions = db_manager->getOpenPositions();
+    for (auto& shard : shards) {
+        if (!shard->engine.initialize(db_manager, positions)) {
+            return false;
+        }
+    }
+
+    running = true;
+    for (auto& shard : shards) {
+        Shard* s = shard.get();
+        s->thread = std::thread([this, s] { workerLoop(*s); });
+    }
+    return true;
+}
+
+void ShardedTradingEngine::stop() {
+    if (!running.exchange(false)) return;
+
+    for (auto& shard : shards) {
+        wake(*shard);
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+    }
+}
+
+void ShardedTradingEngine::processTradingSignal(const TradingSignal& signal) {
+    size_t index = signal.symbol_id != kInvalidSymbolId ? aggregator->shardOf(signal.symbol_id)
+                                                        : shardOf(signal.symbol);
+    ShardTask task;
+    task.signal = signal;
+    enqueue(index, std::move(task));
+}
+
+void ShardedTradingEngine::processTradingSignals(const TradingSignal* signals, size_t count) {
+    std::vector<std::vector<TradingSignal>> per_shard(shards.size());
+    std::vector<double> demand(shards.size(), 0.0);
+    double total_demand = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const TradingSignal& signal = signals[i];
+        size_t index = signal.symbol_id != kInvalidSymbolId ? aggregator->shardOf(signal.symbol_id)
+                                                            : shardOf(signal.symbol);
+        per_shard[index].push_back(signal);
+        if (signal.action == SignalAction::BUY) {
+            // An upper bound: shards skip BUYs for symbols already held
+            double size = std::max(std::min(signal.suggested_position_size * signal.confidence,
+                                            max_position_size.load(std::memory_order_relaxed)), 0.0);
+            demand[index] += size;
+            total_demand += size;
+        }
+    }
+    
+    double budget = aggregator->cash() * TradingEngine::kDeployableCash;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if (per_shard[i].empty()) continue;
+        double share = total_demand > 0 ? budget * demand[i] / total_demand : budget;
+        TradingEngine* engine = &shards[i]->engine;
+        ShardTask task;
+        task.call = [engine, batch = std::move(per_shard[i]), share] {
+            engine->processTradingSignals(batch.data(), batch.size(), share);
+        };
+        enqueue(i, std::move(task));
+    }
+}
+
+void ShardedTradingEngine::updatePositionPrices(const std::map<std::string, double>& current_prices) {
+    // One task per shard carrying only the prices it owns
+    std::vector<std::map<std::string, double>> per_shard(shards.size());
+    for (const auto& [symbol, price] : current_prices) {
+        per_shard[shardOf(symbol)][symbol] = price;
+    }
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if (per_shard[i].empty()) continue;
+        TradingEngine* engine = &shards[i]->engine;
+        ShardTask task;
+        task.call = [engine, prices = std::move(per_shard[i])] {
+            engine->updatePositionPrices(prices);
+        };
+        enqueue(i, std::move(task));
+    }
+}
+
+void ShardedTradingEngine::submit(const std::string& symbol, Task task) {
+    size_t index = shardOf(symbol);
+    TradingEngine* engine = &shards[index]->engine;
+    ShardTask work;
+    work.call = [engine, task = std::move(task)] { task(*engine); };
+    enqueue(index, std::move(work));
+}
+
+void ShardedTradingEngine::enqueue(size_t index, ShardTask task) {
+    Shard& shard = *shards[index];
+    submitted.fetch_add(1, std::memory_order_relaxed);
+
+    if (!running.load(std::memory_order_acquire)) {
+        // Not started (or already stopped): run inline so nothing is lost
+        runTask(shard, task);
+        completed.fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    // Backpressure: wait for the shard rather than drop an order
+    while (!shard.queue.tryPush(std::move(task))) {
+        wake(shard);
+        std::this_thread::yield();
+    }
+    if (shard.sleeping.load()) {
+        wake(shard);
+    }
+}
+
+void ShardedTradingEngine::wake(Shard& shard) {
+    std::lock_guard<std::mutex> lock(shard.wake_mutex);
+    shard.wake_cv.notify_one();
+}
+
+void ShardedTradingEngine::runTask(Shard& shard, ShardTask& task) {
+    if (task.call) {
+        task.call();
+        task.call = nullptr;
+    } else {
+        shard.engine.processTradingSignal(task.signal);
+    }
+}
+
+void ShardedTradingEngine::workerLoop(Shard& shard) {
+    ShardTask task;
+    for (;;) {
+        if (shard.queue.tryPop(task)) {
+            runTask(shard, task);
+            completed.fetch_add(1, std::memory_order_release);
+            if (shard.queue.sizeApprox() == 0) {
+                std::lock_guard<std::mutex> lock(idle_mutex);
+                idle_cv.notify_all();
+            }
+            continue;
+        }
+        if (!running) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(shard.wake_mutex);
+        shard.sleeping = true;
+        if (shard.queue.sizeApprox() == 0 && running) {
+            shard.wake_cv.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        shard.sleeping = false;
+    }
+}
+
+bool ShardedTradingEngine::waitIdle(int timeout_ms) {
+    uint64_t target = submitted.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(idle_mutex);
+    return idle_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this, target] {
+        return completed.load(std::memory_order_acquire) >= target;
+    });
+}
+
+Portfolio ShardedTradingEngine::getPortfolio() const {
+    Portfolio merged;
+    for (const auto& shard : shards) {
+        Portfolio part = shard->engine.getPortfolio();
+        for (const auto& [symbol_id, position] : part.positions) {
+            merged.positions[symbol_id] = position;
+        }
+    }
+    merged.cash_balance = aggregator->cash();
+    merged.resyncExposure();
+    merged.total_value = merged.getEquity();
+    return merged;
+}
+
+PortfolioSnapshot ShardedTradingEngine::getPortfolioSnapshot() const {
+    PortfolioSnapshot snapshot;
+    for (const auto& shard : shards) {
+        PortfolioSnapshot part = shard->engine.getPortfolioSnapshot();
+        snapshot.net_exposure += part.net_exposure;
+        snapshot.gross_exposure += part.gross_exposure;
+        snapshot.unrealized_pnl += part.unrealized_pnl;
+        snapshot.position_count += part.position_count;
+    }
+    snapshot.cash_balance = aggregator->cash();
+    snapshot.equity = aggregator->equity();
+    snapshot.peak_equity = aggregator->peakEquity();
+    snapshot.drawdown = aggregator->drawdown();
+    return snapshot;
+}
+
+std::vector<Position> ShardedTradingEngine::getAllPositions() const {
+    std::vector<Position> positions;
+    for (const auto& shard : shards) {
+        auto part = shard->engine.getAllPositions();
+        positions.insert(positions.end(), part.begin(), part.end());
+    }
+    return positions;
+}
+
+double ShardedTradingEngine::getTotalPnL() const {
+    return aggregator->equity() - initial_balance;
+}
+
+double ShardedTradingEngine::getWinRate() const {
+    uint64_t wins = 0;
+    uint64_t losses = 0;
+    for (const auto& shard : shards) {
+        wins += shard->engine.getWinningTradeCount();
+        losses += shard->engine.getLosingTradeCount();
+    }
+    uint64_t total = wins + losses;
+    return total > 0 ? static_cast<double>(wins) / static_cast<double>(total) : 0.0;
+}
+
+double ShardedTradingEngine::getSharpeRatio() const {
+    PerformanceStats best;
+    for (const auto& shard : shards) {
+        PerformanceStats stats = shard->engine.getPerformanceStats();
+        if (stats.returnCount() > best.returnCount()) {
+            best = stats;
+        }
+    }
+    return best.sharpeRatio();
+}
+
+size_t ShardedTradingEngine::queueDepth() const {
+    size_t depth = 0;
+    for (const auto& shard : shards) {
+        depth += shard->queue.sizeApprox();
+    }
+    return depth;
+}
+
+} // namespace TradingSystem
@@ -0,0 +1,125 @@
+#ifndef SHARDED_TRADING_ENGINE_H
+#define SHARDED_TRADING_ENGINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "trading_engine.h"
+#include "portfolio_aggregator.h"
+#include "../common/bounded_queue.h"
+
+namespace TradingSystem {
+
+// Runs one TradingEngine per shard, each on its own worker thread and
+// owning the positions and orders of the symbols hashed to it. Callers
+// post work; nothing in a shard is touched by another thread except for
+// read-only snapshots. Cash, equity and drawdown live in a shared
+// PortfolioAggregator, so risk checks stay portfolio-wide without a
+// global lock.
+class ShardedTradingEngine {
+public:
+    using Task = std::function<void(TradingEngine&)>;
+
+    ShardedTradingEngine(TradingMode mode = TradingMode::PAPER,
+                         double initial_balance = 10000.0,
+                         size_t shard_count = 2,
+                         size_t queue_capacity = 4096);
+    ~ShardedTradingEngine();
+
+    ShardedTradingEngine(const ShardedTradingEngine&) = delete;
+    ShardedTradingEngine& operator=(const ShardedTradingEngine&) = delete;
+
+    // Configure before initialize(); applied to every shard
+    void setAsyncWriter(std::shared_ptr<AsyncDbWriter> writer);
+    void setMarketDataCache(std::shared_ptr<MarketDataCache> cache);
+    void setPricingService(std::shared_ptr<PricingService> service);
+    void setMaxPositionSize(double max_size);
+    void setMaxDrawdown(double max_dd);
+    void setStopLoss(double percentage);
+    void setTakeProfit(double percentage);
+    // Safe while running: queued on every shard behind the work already
+    // there, so each shard switches between decisions, on its own thread
+    void updateRiskLimits(const RiskLimits& limits);
+
+    // Load each shard's positions and start the workers
+    bool initialize(std::shared_ptr<DatabaseManager> db_manager);
+    // Run what is queued, then join the workers
+    void stop();
+
+    // Asynchronous: queued on the symbol's shard and applied in order
+    void processTradingSignal(const TradingSignal& signal);
+    // Split by shard, each shard deciding its part as one batch. The cash
+    // budget is taken once here and divided by each shard's BUY demand, so
+    // shards do not both plan to spend the same shared cash.
+    void processTradingSignals(const TradingSignal* signals, size_t count);
+    void updatePositionPrices(const std::map<std::string, double>& current_prices);
+    void submit(const std::string& symbol, Task task);
+
+    // Block until every task queued so far has run
+    bool waitIdle(int timeout_ms = 5000);
+
+    // Merged snapshots; cash and P&L come from the aggregator
+    Portfolio getPortfolio() const;
+    // Sums of the shards' running aggregates; no positions are copied
+    PortfolioSnapshot getPortfolioSnapshot() const;
+    std::vector<Position> getAllPositions() const;
+    double getTotalPnL() const;
+    // Trades summed over the shards. Every shard samples the shared
+    // equity, so return statistics come from the one that has seen the
+    // most days of it.
+    double getWinRate() const;
+    double getSharpeRatio() const;
+    double getTotalEquity() const { return aggregator->equity(); }
+    double getAvailableCash() const { return aggregator->cash(); }
+
+    size_t shardCount() const { return shards.size(); }
+    size_t shardOf(const std::string& symbol) const { return aggregator->shardOf(symbol); }
+    size_t queueDepth() const;
+
+private:
+    // Queued unit of work. Signals, the steady-state traffic, travel by
+    // value in the queue cell so they never pay for a std::function
+    // allocation; everything else is a call.
+    struct ShardTask {
+        TradingSignal signal;
+        std::function<void()> call;  // Empty for a signal
+    };
+
+    struct Shard {
+        Shard(TradingMode mode, double initial_balance, size_t capacity)
+            : engine(mode, initial_balance), queue(capacity) {}
+
+        TradingEngine engine;
+        BoundedQueue<ShardTask> queue;
+        std::thread thread;
+        std::mutex wake_mutex;
+        std::condition_variable wake_cv;
+        std::atomic<bool> sleeping{false};
+    };
+
+    void enqueue(size_t shard, ShardTask task);
+    void runTask(Shard& shard, ShardTask& task);
+    void workerLoop(Shard& shard);
+    void wake(Shard& shard);
+
+    double initial_balance;
+    std::atomic<double> max_position_size{5000.0};  // Mirrors the shards', for batch demand
+    std::shared_ptr<PortfolioAggregator> aggregator;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<bool> running;
+
+    std::atomic<uint64_t> submitted;
+    std::atomic<uint64_t> completed;
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+};
+
+} // namespace TradingSystem
+
+#endif // SHARDED_TRADING_ENGINE_H
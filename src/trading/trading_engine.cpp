@@ -1,246 +1,570 @@
 #include "trading_engine.h"
+#include "../metrics/metrics_registry.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
-#include <numeric>
-#include <random>
+#include <optional>
 
 namespace TradingSystem {
 
 TradingEngine::TradingEngine(TradingMode mode, double initial_balance)
-    : mode(mode), initial_balance(initial_balance), peak_balance(initial_balance),
+    : mode(mode),
       max_position_size(5000.0), max_drawdown(0.20), 
       stop_loss_percentage(0.02), take_profit_percentage(0.05),
-      order_counter(0) {
+      initial_balance(initial_balance), stats(initial_balance),
+      order_counter(static_cast<uint64_t>(std::time(nullptr)) << 20) {
     
     portfolio.cash_balance = initial_balance;
     portfolio.total_value = initial_balance;
+    
+    pending_orders.reserve(64);
+    filled_orders.reserve(kFilledOrderHistory);
+    filled_ring.assign(kFilledOrderHistory, kInvalidOrderId);
 }
 
 TradingEngine::~TradingEngine() {
 }
 
 bool TradingEngine::initialize(std::shared_ptr<DatabaseManager> db_manager) {
+    // Load existing positions from database
+    return initialize(db_manager, db_manager->getOpenPositions());
+}
+
+bool TradingEngine::initialize(std::shared_ptr<DatabaseManager> db_manager,
+                               const std::vector<Position>& open_positions) {
     this->db_manager = db_manager;
     
-    // Load existing positions from database
-    auto positions = db_manager->getOpenPositions();
-    for (const auto& pos : positions) {
-        portfolio.positions[pos.symbol] = pos;
+    for (const auto& pos : open_positions) {
+        if (aggregator && aggregator->shardOf(pos.symbol_id) != shard_index) {
+            continue;
+        }
+        portfolio.positions[pos.symbol_id] = pos;
+        if (resting_exits) {
+            placeProtectiveExits(pos.symbol_id);
+        }
+    }
+    portfolio.resyncExposure();
+    portfolio.total_value = portfolio.getEquity();
+    publishShardValue();
+    recordEquity();
+    
+    // Trades closed in earlier runs; the shards share one database, so
+    // only the first takes them
+    if (!aggregator || shard_index == 0) {
+        int wins = db_manager->getWinningTrades();
+        int losses = db_manager->getLosingTrades();
+        stats.seedTrades(static_cast<uint64_t>(std::max(wins, 0)), static_cast<uint64_t>(std::max(losses, 0)));
     }
     
     return true;
 }
 
-std::string TradingEngine::generateOrderId() {
-    int order_num = ++order_counter;
-    return "ORD_" + std::to_string(std::time(nullptr)) + "_" + std::to_string(order_num);
+OrderId TradingEngine::generateOrderId() {
+    // The counter starts at the startup time shifted left, so ids keep
+    // increasing across restarts; shards number their orders independently
+    // and the low byte carries the shard to keep ids unique
+    uint64_t order_num = ++order_counter;
+    return (order_num << 8) | (shard_index & 0xFF);
 }
 
-std::string TradingEngine::placeOrder(const std::string& symbol, 
-                                     const std::string& side,
-                                     double quantity,
-                                     const std::string& order_type,
-                                     double price) {
+OrderId TradingEngine::placeOrder(SymbolId symbol_id,
+                                  OrderSide side,
+                                  double quantity,
+                                  OrderType order_type,
+                                  double price) {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    
+    // Market orders without an explicit price take the service's quote
+    PriceSnapshot quote;
+    if (order_type == OrderType::MARKET) {
+        if (price > 0) {
+            quote = quoteAt(price);
+        } else if (!freshQuote(symbol_id, quote)) {
+            return kInvalidOrderId;
+        }
+    }
+    return submitOrder(symbol_id, side, quantity, order_type, price, quote);
+}
+
+OrderId TradingEngine::submitOrder(SymbolId symbol_id,
+                                   OrderSide side,
+                                   double quantity,
+                                   OrderType order_type,
+                                   double price,
+                                   const PriceSnapshot& quote) {
+    METRIC_SCOPE("PlaceOrder");
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
     
     // Validate order
     if (quantity <= 0) {
-        std::cerr << "Invalid order quantity: " << quantity << std::endl;
-        return "";
+        if (verbose) {
+            std::cerr << "Invalid order quantity: " << quantity << std::endl;
+        }
+        return kInvalidOrderId;
     }
     
-    // Check risk limits
-    if (!checkRiskLimits(symbol, quantity, price)) {
-        std::cerr << "Order rejected due to risk limits" << std::endl;
-        return "";
+    // A market order is recorded at last and risk-checked at the price it
+    // will fill at, so a BUY that passes cannot run out of cash at the fill
+    double risk_price = price;
+    if (order_type == OrderType::MARKET) {
+        price = quote.last;
+        risk_price = marketFillPrice(quote, side, quantity);
+    }
+    
+    // Risk limits gate new exposure only. Sells reduce it, so exits
+    // (stop-loss in a drawdown, or with the cash fully invested) always go
+    // through.
+    if (side == OrderSide::BUY && !checkRiskLimits(symbol_id, quantity, risk_price)) {
+        if (verbose) {
+            std::cerr << "Order rejected due to risk limits" << std::endl;
+        }
+        return kInvalidOrderId;
     }
     
     // Create order
     Order order;
     order.order_id = generateOrderId();
-    order.symbol = symbol;
+    order.symbol_id = symbol_id;
     order.side = side;
     order.quantity = quantity;
     order.price = price;
     order.order_type = order_type;
-    order.status = "PENDING";
-    order.timestamp = std::chrono::system_clock::now();
+    order.status = OrderStatus::PENDING;
+    order.timestamp = now();
     
     // Store order
-    {
-        std::lock_guard<std::mutex> lock(order_mutex);
-        pending_orders[order.order_id] = order;
+    pending_orders[order.order_id] = order;
+    
+    // Persist the order and any immediate fill in a single transaction.
+    // With a write-behind writer attached the mutations are queued instead
+    // and the writer batches them into its own transaction.
+    std::optional<DatabaseManager::Transaction> tx;
+    if (db_manager && !async_writer) {
+        tx.emplace(*db_manager);
     }
+    persistOrder(order);
     
-    // Save to database
-    if (db_manager) {
-        db_manager->insertOrder(order);
+    // In paper trading mode, simulate immediate fill for market orders.
+    // Limit and stop orders get a first check against the latest price and
+    // otherwise rest in the book until an update crosses them.
+    if (mode == TradingMode::PAPER && order_type == OrderType::MARKET) {
+        simulateFill(order, quote);
+    } else if (mode == TradingMode::PAPER) {
+        if (order_type == OrderType::LIMIT) {
+            // The latest bar's volume stands in for the depth at the limit
+            simulator.joinQueue(order, latestVolume(symbol_id));
+        }
+        // A stale quote only means the first check waits for the next mark
+        PriceSnapshot current;
+        bool have_quote = pricing && pricing->fresh(symbol_id, now(), current);
+        if (!have_quote || !workRestingOrder(order, current)) {
+            restOrder(order);
+        }
     }
     
-    // In paper trading mode, simulate immediate fill for market orders
-    if (mode == TradingMode::PAPER && order_type == "MARKET") {
-        simulateFill(order, price > 0 ? price : 100000.0); // Use provided price or default
+    if (tx) {
+        tx->commit();
     }
     
+    // Persisted as rejected, but no order was placed
+    if (order.status == OrderStatus::REJECTED) {
+        return kInvalidOrderId;
+    }
     return order.order_id;
 }
 
-bool TradingEngine::checkRiskLimits(const std::string& symbol, double quantity, double price) {
-    // Check position size limit
-    double position_value = quantity * price;
+bool TradingEngine::checkRiskLimits(SymbolId symbol_id, double quantity, double price) {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    // Check position size limit, counting what is already held in the
+    // symbol so repeated buys cannot build past it
+    double order_value = quantity * price;
+    double position_value = order_value;
+    if (const Position* held = portfolio.positions.find(symbol_id)) {
+        position_value += held->quantity * held->current_price;
+    }
     if (position_value > max_position_size) {
-        std::cerr << "Position size " << position_value << " exceeds limit " << max_position_size << std::endl;
+        if (verbose) {
+            std::cerr << "Position size " << position_value << " exceeds limit " << max_position_size << std::endl;
+        }
         return false;
     }
     
     // Check if we have enough cash
-    if (position_value > portfolio.cash_balance) {
-        std::cerr << "Insufficient funds. Required: " << position_value << ", Available: " << portfolio.cash_balance << std::endl;
+    double cash = availableCash();
+    if (order_value > cash) {
+        if (verbose) {
+            std::cerr << "Insufficient funds. Required: " << order_value << ", Available: " << cash << std::endl;
+        }
         return false;
     }
     
     // Check drawdown limit
-    double current_drawdown = (peak_balance - portfolio.getEquity()) / peak_balance;
+    double current_drawdown = currentDrawdown();
     if (current_drawdown > max_drawdown) {
-        std::cerr << "Maximum drawdown exceeded: " << current_drawdown << std::endl;
+        if (verbose) {
+            std::cerr << "Maximum drawdown exceeded: " << current_drawdown << std::endl;
+        }
         return false;
     }
     
     return true;
 }
 
-void TradingEngine::simulateFill(Order& order, double market_price) {
-    PaperTradingSimulator simulator;
-    
-    // Apply slippage and spread
-    double fill_price = simulator.simulateSlippage(market_price, order.quantity, order.side);
-    fill_price = simulator.simulateSpread(fill_price);
-    
-    // Execute order
-    if (order.order_type == "MARKET") {
-        executeMarketOrder(order, fill_price);
-    } else if (order.order_type == "LIMIT") {
-        if (simulator.simulateOrderFill(order, market_price)) {
-            executeLimitOrder(order, order.price);
+double TradingEngine::marketFillPrice(const PriceSnapshot& quote, OrderSide side, double quantity) {
+    double price = quote.crossing(side);
+    if (mode != TradingMode::PAPER) {
+        return price;
+    }
+    // Apply slippage, and the simulator's spread unless the quote already
+    // carries one (crossing it paid for the spread)
+    price = simulator.simulateSlippage(price, quantity, side);
+    if (quote.ask <= quote.bid) {
+        price = simulator.simulateSpread(price, side);
+    }
+    return price;
+}
+
+double TradingEngine::marketBuyQuantity(const PriceSnapshot& quote, double amount) {
+    // Slippage grows with quantity, so sizing at the price of the larger
+    // first guess keeps the cost within amount
+    double first_guess = amount / quote.ask;
+    return amount / marketFillPrice(quote, OrderSide::BUY, first_guess);
+}
+
+void TradingEngine::simulateFill(Order& order, const PriceSnapshot& quote) {
+    // A stop reaching simulateFill has triggered and fills as a market order
+    if (order.order_type == OrderType::MARKET || order.order_type == OrderType::STOP) {
+        executeMarketOrder(order, marketFillPrice(quote, order.side, order.quantity));
+    } else if (order.order_type == OrderType::LIMIT) {
+        double quantity = simulator.simulateLimitFill(order, quote.last, latestVolume(order.symbol_id));
+        if (quantity > 0) {
+            executeLimitOrder(order, quantity);
+        } else if (Order* resting = pending_orders.find(order.order_id)) {
+            *resting = order;  // Keep the queue position
         }
     }
 }
 
 bool TradingEngine::executeMarketOrder(Order& order, double market_price) {
     order.price = market_price;
-    order.status = "FILLED";
     
-    // Update portfolio
-    updatePortfolio(order);
+    // Update portfolio; a shard can lose the cash race to another shard
+    // between the risk check and the fill
+    if (!updatePortfolio(order)) {
+        order.status = OrderStatus::REJECTED;
+        pending_orders.erase(order.order_id);
+        persistOrderStatus(order.order_id, OrderStatus::REJECTED);
+        if (verbose) {
+            std::cerr << "Order " << order.order_id << " rejected: insufficient funds at fill" << std::endl;
+        }
+        return false;
+    }
+    order.status = OrderStatus::FILLED;
+    order.filled_quantity = order.quantity;
     
     // Move from pending to filled
     {
-        std::lock_guard<std::mutex> lock(order_mutex);
+        std::lock_guard<std::recursive_mutex> lock(engine_mutex);
         pending_orders.erase(order.order_id);
-        filled_orders[order.order_id] = order;
+        recordFilled(order);
+        ++fill_count;
     }
     
     // Update database
-    if (db_manager) {
-        db_manager->updateOrderStatus(order.order_id, "FILLED");
+    persistOrderStatus(order.order_id, OrderStatus::FILLED);
+    
+    if (verbose) {
+        std::cout << "Order " << order.order_id << " filled at " << market_price << std::endl;
+    }
+    return true;
+}
+
+bool TradingEngine::executeLimitOrder(Order& order, double fill_quantity) {
+    // Fills execute at the limit price; slippage only applies to orders
+    // that take liquidity
+    Order fill = order;
+    fill.quantity = std::min(fill_quantity, order.remainingQuantity());
+    if (!updatePortfolio(fill)) {
+        // Lost the cash race to another shard; leave the order working
+        if (Order* resting = pending_orders.find(order.order_id)) {
+            *resting = order;
+        }
+        return false;
+    }
+    order.filled_quantity += fill.quantity;
+    ++fill_count;
+    
+    if (order.remainingQuantity() > 1e-12) {
+        order.status = OrderStatus::PARTIALLY_FILLED;
+        pending_orders[order.order_id] = order;
+        persistOrderStatus(order.order_id, OrderStatus::PARTIALLY_FILLED);
+        if (verbose) {
+            std::cout << "Order " << order.order_id << " partially filled " << fill.quantity
+                      << " at " << order.price << ", " << order.remainingQuantity() << " remaining" << std::endl;
+        }
+        return true;
     }
     
-    std::cout << "Order " << order.order_id << " filled at " << market_price << std::endl;
+    order.status = OrderStatus::FILLED;
+    pending_orders.erase(order.order_id);
+    recordFilled(order);
+    persistOrderStatus(order.order_id, OrderStatus::FILLED);
+    if (verbose) {
+        std::cout << "Order " << order.order_id << " filled at " << order.price << std::endl;
+    }
     return true;
 }
 
-void TradingEngine::updatePortfolio(const Order& order) {
-    if (order.side == "BUY") {
+void TradingEngine::recordFilled(const Order& order) {
+    OrderId& slot = filled_ring[filled_next];
+    if (slot != kInvalidOrderId) {
+        filled_orders.erase(slot);
+    }
+    slot = order.order_id;
+    filled_orders[order.order_id] = order;
+    filled_next = (filled_next + 1) % filled_ring.size();
+}
+
+bool TradingEngine::updatePortfolio(const Order& order) {
+    if (order.side == OrderSide::BUY) {
         // Deduct cash
-        portfolio.cash_balance -= order.quantity * order.price;
+        double cost = order.quantity * order.price;
+        if (aggregator) {
+            if (!aggregator->tryDebitCash(shard_index, cost)) {
+                return false;
+            }
+        } else {
+            portfolio.cash_balance -= cost;
+        }
         
         // Add or update position
-        if (portfolio.positions.find(order.symbol) != portfolio.positions.end()) {
-            Position& pos = portfolio.positions[order.symbol];
+        if (Position* existing = portfolio.positions.find(order.symbol_id)) {
+            Position& pos = *existing;
+            portfolio.removeExposure(pos);
             double total_cost = (pos.quantity * pos.entry_price) + (order.quantity * order.price);
             pos.quantity += order.quantity;
             pos.entry_price = total_cost / pos.quantity; // Average price
             pos.current_price = order.price;
+            portfolio.addExposure(pos);
         } else {
             Position pos;
-            pos.symbol = order.symbol;
+            pos.symbol_id = order.symbol_id;
             pos.quantity = order.quantity;
             pos.entry_price = order.price;
             pos.current_price = order.price;
-            pos.entry_time = std::chrono::system_clock::now();
+            pos.entry_time = now();
             pos.unrealized_pnl = 0.0;
-            portfolio.positions[order.symbol] = pos;
+            portfolio.positions[order.symbol_id] = pos;
+            portfolio.addExposure(pos);
             
             // Save to database
-            if (db_manager) {
-                db_manager->insertPosition(pos);
-            }
+            persistNewPosition(pos);
         }
-    } else if (order.side == "SELL") {
-        if (portfolio.positions.find(order.symbol) != portfolio.positions.end()) {
-            Position& pos = portfolio.positions[order.symbol];
+        
+        // New average entry, so the exits move with it
+        if (resting_exits) {
+            placeProtectiveExits(order.symbol_id);
+        }
+    } else if (order.side == OrderSide::SELL) {
+        if (Position* existing = portfolio.positions.find(order.symbol_id)) {
+            Position& pos = *existing;
             
             // Calculate realized P&L
             double realized_pnl = order.quantity * (order.price - pos.entry_price);
-            portfolio.cash_balance += order.quantity * order.price;
+            stats.onTrade(realized_pnl);
+            double proceeds = order.quantity * order.price;
+            if (aggregator) {
+                aggregator->creditCash(shard_index, proceeds);
+            } else {
+                portfolio.cash_balance += proceeds;
+            }
             
             // Update position
+            portfolio.removeExposure(pos);
             pos.quantity -= order.quantity;
             if (pos.quantity <= 0) {
-                portfolio.positions.erase(order.symbol);
-            }
-            
-            // Track peak balance for drawdown calculation
-            double current_equity = portfolio.getEquity();
-            if (current_equity > peak_balance) {
-                peak_balance = current_equity;
+                portfolio.positions.erase(order.symbol_id);
+                cancelProtectiveExits(order.symbol_id);
+                if (portfolio.positions.empty()) {
+                    portfolio.resyncExposure();  // Flat: the sums are exactly zero
+                }
+            } else {
+                portfolio.addExposure(pos);
             }
         }
     }
+    
+    portfolio.total_value = portfolio.getEquity();
+    publishShardValue();
+    recordEquity();
+    return true;
+}
+
+double TradingEngine::availableCash() const {
+    return aggregator ? aggregator->cash() : portfolio.cash_balance;
+}
+
+void TradingEngine::publishShardValue() {
+    if (!aggregator) return;
+    aggregator->publishShardValue(shard_index, portfolio.net_exposure);
 }
 
 void TradingEngine::processTradingSignal(const TradingSignal& signal) {
-    std::cout << "Processing signal for " << signal.symbol 
-              << ": " << signal.action 
-              << " (confidence: " << signal.confidence << ")" << std::endl;
+    // Console output and interning stay outside the engine lock; only the
+    // position check and the order it leads to need to be atomic
+    if (verbose) {
+        std::cout << "Processing signal for " << signal.symbol 
+                  << ": " << toString(signal.action) 
+                  << " (confidence: " << signal.confidence << ")" << std::endl;
+    }
     
-    // Calculate position size based on confidence and risk parameters
-    double position_size = calculatePositionSize(signal);
+    SymbolId symbol_id = signal.symbol_id != kInvalidSymbolId
+                             ? signal.symbol_id
+                             : SymbolTable::getInstance().intern(signal.symbol);
     
-    if (position_size <= 0) {
-        std::cout << "Position size too small, skipping signal" << std::endl;
+    bool too_small = false;
+    {
+        std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+        
+        // Calculate position size based on confidence and risk parameters
+        double position_size = calculatePositionSize(signal);
+        
+        // Get current position if any
+        const Position* position = portfolio.positions.find(symbol_id);
+        bool has_position = (position != nullptr && position->quantity > 0);
+        
+        // Execute based on signal
+        if (position_size <= 0) {
+            too_small = true;
+        } else if (signal.action == SignalAction::BUY && !has_position) {
+            // Size at the fill price of the same snapshot the order fills
+            // against; no fresh price, no trade
+            PriceSnapshot quote;
+            if (freshQuote(symbol_id, quote)) {
+                double quantity = marketBuyQuantity(quote, position_size);
+                submitOrder(symbol_id, OrderSide::BUY, quantity, OrderType::MARKET, 0.0, quote);
+            }
+        } else if (signal.action == SignalAction::SELL && has_position) {
+            // Sell existing position
+            placeOrder(symbol_id, OrderSide::SELL, position->quantity, OrderType::MARKET);
+        }
+    }
+    
+    if (!verbose) {
         return;
     }
+    if (too_small) {
+        std::cout << "Position size too small, skipping signal" << std::endl;
+    } else if (signal.action == SignalAction::HOLD) {
+        std::cout << "Holding position for " << signal.symbol << std::endl;
+    }
+}
+
+size_t TradingEngine::processTradingSignals(const TradingSignal* signals, size_t count, double cash_budget) {
+    std::unique_lock<std::recursive_mutex> lock(engine_mutex);
+    if (count == 0) {
+        return 0;
+    }
+    
+    // One snapshot for the whole batch
+    if (cash_budget < 0) {
+        cash_budget = availableCash() * kDeployableCash;
+    }
+    bool drawdown_ok = currentDrawdown() <= max_drawdown;
     
-    // Get current position if any
-    auto pos_it = portfolio.positions.find(signal.symbol);
-    bool has_position = (pos_it != portfolio.positions.end() && pos_it->second.quantity > 0);
+    planned_buys.clear();
+    planned_sells.clear();
+    planned_symbols.clear();
+    planned_symbols.reserve(count);
+    double demand = 0.0;
+    size_t skipped = 0;
     
-    // Execute based on signal
-    if (signal.action == "BUY" && !has_position) {
-        // Calculate quantity based on position size and assumed price
-        double quantity = position_size / 100000.0; // Assuming BTC price around 100k
-        placeOrder(signal.symbol, "BUY", quantity, "MARKET");
-        
-    } else if (signal.action == "SELL" && has_position) {
-        // Sell existing position
-        placeOrder(signal.symbol, "SELL", pos_it->second.quantity, "MARKET");
+    for (size_t i = 0; i < count; ++i) {
+        const TradingSignal& signal = signals[i];
+        SymbolId symbol_id = signal.symbol_id != kInvalidSymbolId
+                                 ? signal.symbol_id
+                                 : SymbolTable::getInstance().intern(signal.symbol);
+        const Position* position = portfolio.positions.find(symbol_id);
+        bool has_position = (position != nullptr && position->quantity > 0);
         
-    } else if (signal.action == "HOLD") {
-        std::cout << "Holding position for " << signal.symbol << std::endl;
+        if (signal.action == SignalAction::BUY && !has_position) {
+            double size = std::min(signal.suggested_position_size * signal.confidence, max_position_size);
+            if (!drawdown_ok || size <= 0 || planned_symbols.contains(symbol_id)) {
+                ++skipped;
+                continue;
+            }
+            PriceSnapshot quote;
+            if (!freshQuote(symbol_id, quote)) {
+                ++skipped;
+                continue;
+            }
+            planned_buys.push_back({symbol_id, quote, size});
+            planned_symbols[symbol_id] = true;
+            demand += size;
+        } else if (signal.action == SignalAction::SELL && has_position) {
+            if (!planned_symbols.contains(symbol_id)) {
+                planned_sells.push_back({symbol_id, PriceSnapshot(), position->quantity});
+                planned_symbols[symbol_id] = true;
+            }
+        } else if (signal.action != SignalAction::HOLD) {
+            ++skipped;
+        }
+    }
+    
+    // Every BUY gets the same share of its request when the batch asks for
+    // more than the budget
+    double scale = demand > cash_budget ? std::max(cash_budget, 0.0) / demand : 1.0;
+    
+    std::unique_ptr<DatabaseManager::Transaction> tx;
+    if (db_manager && !async_writer) {
+        tx = std::make_unique<DatabaseManager::Transaction>(*db_manager);
     }
+    
+    // Orders rejected by the risk check or at the fill count as skipped
+    size_t placed = 0;
+    for (const auto& sell : planned_sells) {
+        if (placeOrder(sell.symbol_id, OrderSide::SELL, sell.amount, OrderType::MARKET) != kInvalidOrderId) {
+            ++placed;
+        } else {
+            ++skipped;
+        }
+    }
+    for (const auto& buy : planned_buys) {
+        double quantity = marketBuyQuantity(buy.quote, buy.amount * scale);
+        if (quantity > 0 &&
+            submitOrder(buy.symbol_id, OrderSide::BUY, quantity, OrderType::MARKET, 0.0, buy.quote) != kInvalidOrderId) {
+            ++placed;
+        } else {
+            ++skipped;
+        }
+    }
+    
+    if (tx) {
+        tx->commit();
+        tx.reset();  // Releases the database lock
+    }
+    
+    if (verbose) {
+        size_t buys = planned_buys.size();
+        size_t sells = planned_sells.size();
+        lock.unlock();
+        std::cout << "Processed " << count << " signals: " << buys << " buys"
+                  << (scale < 1.0 ? " (scaled to fit cash)" : "") << ", " << sells
+                  << " sells, " << placed << " orders placed, " << skipped << " skipped" << std::endl;
+    }
+    return placed;
 }
 
 double TradingEngine::calculatePositionSize(const TradingSignal& signal) {
     // Base position size on confidence and available capital
-    double available_capital = portfolio.cash_balance;
+    double available_capital = availableCash();
     double base_size = signal.suggested_position_size;
     
     // Adjust for confidence
     double adjusted_size = base_size * signal.confidence;
     
     // Ensure we don't exceed available capital
-    adjusted_size = std::min(adjusted_size, available_capital * 0.95); // Keep 5% reserve
+    adjusted_size = std::min(adjusted_size, available_capital * kDeployableCash);
     
     // Ensure we don't exceed max position size
     adjusted_size = std::min(adjusted_size, max_position_size);
@@ -249,34 +573,314 @@ double TradingEngine::calculatePositionSize(const TradingSignal& signal) {
 }
 
 void TradingEngine::updatePositionPrices(const std::map<std::string, double>& current_prices) {
-    for (auto& [symbol, position] : portfolio.positions) {
-        auto price_it = current_prices.find(symbol);
-        if (price_it != current_prices.end()) {
-            position.current_price = price_it->second;
-            position.unrealized_pnl = position.quantity * (position.current_price - position.entry_price);
-            
-            // Check stop loss and take profit
-            applyStopLoss(position, position.current_price);
-            applyTakeProfit(position, position.current_price);
-            
-            // Update in database
-            if (db_manager) {
-                db_manager->updatePosition(position);
-            }
-        }
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    
+    const SymbolTable& symbols = SymbolTable::getInstance();
+    for (const auto& [symbol, price] : current_prices) {
+        markPosition(symbols.find(symbol), price);
     }
     
     // Update portfolio total value
     portfolio.total_value = portfolio.getEquity();
+    publishShardValue();
+    recordEquity();
+}
+
+void TradingEngine::updatePositionPrice(SymbolId symbol_id, double price) {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    markPosition(symbol_id, price);
+    portfolio.total_value = portfolio.getEquity();
+    publishShardValue();
+    recordEquity();
+}
+
+void TradingEngine::markPosition(SymbolId symbol_id, double price) {
+    Position* position = portfolio.positions.find(symbol_id);
+    if (position) {
+        portfolio.mark(*position, price);
+        
+        // Update in database before a triggered exit closes it
+        persistPosition(*position);
+    }
+    
+    matchRestingOrders(symbol_id, price);
+    if (resting_exits) {
+        return;
+    }
+    
+    // Stop-loss and take-profit sells erase positions (and may move others
+    // in the flat map), so look the position up again after each one
+    position = portfolio.positions.find(symbol_id);
+    if (position) {
+        applyStopLoss(*position, price);
+    }
+    position = portfolio.positions.find(symbol_id);
+    if (position) {
+        applyTakeProfit(*position, price);
+    }
+}
+
+void TradingEngine::matchRestingOrders(SymbolId symbol_id, double price) {
+    OrderBook* book = books.find(symbol_id);
+    if (!book || book->empty()) {
+        return;
+    }
+    
+    // Handling a fill can place, cancel and re-rest orders, so work from
+    // a list taken out of the book first
+    std::vector<OrderId> crossed;
+    crossed.swap(crossed_orders);
+    crossed.clear();
+    book->collectCrossed(price, crossed);
+    
+    for (OrderId id : crossed) {
+        const ProtectiveExits* exits = protective_exits.find(symbol_id);
+        if (exits && (id == exits->stop_loss || id == exits->take_profit)) {
+            fireProtectiveExit(symbol_id, id, price);
+            continue;
+        }
+        
+        Order* resting = pending_orders.find(id);
+        if (!resting) {
+            continue;
+        }
+        Order order = *resting;
+        if (!workRestingOrder(order, quoteAt(price))) {
+            restOrder(order);
+        }
+    }
+    
+    crossed.swap(crossed_orders);
+}
+
+bool TradingEngine::workRestingOrder(Order& order, const PriceSnapshot& quote) {
+    if (order.order_type == OrderType::STOP) {
+        bool triggered = OrderBook::triggerFor(order.side, order.order_type) == OrderBook::Trigger::AT_OR_BELOW
+                             ? quote.last <= order.price
+                             : quote.last >= order.price;
+        if (!triggered) {
+            return false;
+        }
+    }
+    simulateFill(order, quote);
+    return order.status == OrderStatus::FILLED || order.status == OrderStatus::REJECTED;
+}
+
+void TradingEngine::restOrder(const Order& order) {
+    pending_orders[order.order_id] = order;
+    books[order.symbol_id].add(order.order_id, order.price, OrderBook::triggerFor(order.side, order.order_type));
+}
+
+void TradingEngine::placeProtectiveExits(SymbolId symbol_id) {
+    cancelProtectiveExits(symbol_id);
+    const Position* position = portfolio.positions.find(symbol_id);
+    if (!position || position->quantity <= 0) {
+        return;
+    }
+    
+    // Same thresholds as applyStopLoss / applyTakeProfit, as prices
+    ProtectiveExits exits;
+    exits.stop_loss = generateOrderId();
+    exits.take_profit = generateOrderId();
+    OrderBook& book = books[symbol_id];
+    book.add(exits.stop_loss, position->entry_price * (1.0 - stop_loss_percentage), OrderBook::Trigger::AT_OR_BELOW);
+    book.add(exits.take_profit, position->entry_price * (1.0 + take_profit_percentage), OrderBook::Trigger::AT_OR_ABOVE);
+    protective_exits[symbol_id] = exits;
+}
+
+void TradingEngine::cancelProtectiveExits(SymbolId symbol_id) {
+    const ProtectiveExits* exits = protective_exits.find(symbol_id);
+    if (!exits) {
+        return;
+    }
+    if (OrderBook* book = books.find(symbol_id)) {
+        book->cancel(exits->stop_loss);
+        book->cancel(exits->take_profit);
+    }
+    protective_exits.erase(symbol_id);
+}
+
+void TradingEngine::fireProtectiveExit(SymbolId symbol_id, OrderId exit_id, double price) {
+    // One cancels the other
+    bool stop_loss = protective_exits.find(symbol_id)->stop_loss == exit_id;
+    cancelProtectiveExits(symbol_id);
+    
+    const Position* position = portfolio.positions.find(symbol_id);
+    if (!position || position->quantity <= 0) {
+        return;
+    }
+    if (verbose) {
+        std::cout << (stop_loss ? "Stop loss" : "Take profit") << " triggered for "
+                  << position->symbolName() << " at " << price << std::endl;
+    }
+    placeOrder(symbol_id, OrderSide::SELL, position->quantity, OrderType::MARKET, price);
+}
+
+bool TradingEngine::cancelOrder(OrderId order_id) {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    Order* resting = pending_orders.find(order_id);
+    if (!resting) {
+        return false;
+    }
+    
+    Order order = *resting;
+    if (OrderBook* book = books.find(order.symbol_id)) {
+        book->cancel(order_id);
+    }
+    pending_orders.erase(order_id);
+    order.status = OrderStatus::CANCELLED;
+    recordFilled(order);
+    persistOrderStatus(order_id, OrderStatus::CANCELLED);
+    return true;
+}
+
+Order TradingEngine::getOrderStatus(OrderId order_id) {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    if (const Order* order = pending_orders.find(order_id)) {
+        return *order;
+    }
+    if (const Order* order = filled_orders.find(order_id)) {
+        return *order;
+    }
+    return Order();
+}
+
+void TradingEngine::setStopLoss(double percentage) {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    stop_loss_percentage = percentage;
+    setRestingExits(resting_exits);
+}
+
+void TradingEngine::setTakeProfit(double percentage) {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    take_profit_percentage = percentage;
+    setRestingExits(resting_exits);
+}
+
+void TradingEngine::setRiskLimits(const RiskLimits& limits) {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    max_position_size = limits.max_position_size;
+    max_drawdown = limits.max_drawdown;
+    stop_loss_percentage = limits.stop_loss_percentage;
+    take_profit_percentage = limits.take_profit_percentage;
+    setRestingExits(resting_exits);
+}
+
+void TradingEngine::setRestingExits(bool enabled) {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    resting_exits = enabled;
+    for (const auto& [symbol_id, position] : portfolio.positions) {
+        if (enabled) {
+            placeProtectiveExits(symbol_id);
+        } else {
+            cancelProtectiveExits(symbol_id);
+        }
+    }
+}
+
+double TradingEngine::currentEquity() const {
+    return aggregator ? aggregator->equity() : portfolio.getEquity();
+}
+
+double TradingEngine::currentDrawdown() const {
+    if (aggregator) {
+        return aggregator->drawdown();
+    }
+    return stats.drawdown();
+}
+
+void TradingEngine::recordEquity() {
+    stats.onEquity(now(), currentEquity());
+}
+
+void TradingEngine::setMarketDataCache(std::shared_ptr<MarketDataCache> cache) {
+    market_data_cache = cache;
+    if (!pricing && cache) {
+        pricing = std::make_shared<PricingService>(cache);
+    }
+}
+
+bool TradingEngine::freshQuote(SymbolId symbol_id, PriceSnapshot& quote) const {
+    if (!pricing) {
+        return false;
+    }
+    PricingService::Status status = pricing->snapshot(symbol_id, now(), quote);
+    if (status != PricingService::Status::OK) {
+        if (verbose) {
+            std::cerr << "No fresh price for " << SymbolTable::getInstance().name(symbol_id)
+                      << " (" << toString(status) << ")" << std::endl;
+        }
+        return false;
+    }
+    return true;
+}
+
+PriceSnapshot TradingEngine::quoteAt(double price) const {
+    int64_t timestamp_ns = toEpochNanos(now());
+    if (pricing) {
+        return pricing->quoteAt(price, timestamp_ns);
+    }
+    PriceSnapshot quote;
+    quote.bid = quote.ask = quote.last = price;
+    quote.timestamp_ns = timestamp_ns;
+    return quote;
+}
+
+double TradingEngine::latestVolume(SymbolId symbol_id) const {
+    CachedBar bar;
+    if (!market_data_cache || !market_data_cache->latest(symbol_id, bar)) {
+        return 0.0;
+    }
+    return bar.volume;
+}
+
+// Persistence helpers: queue on the write-behind writer when one is
+// attached and still accepting, otherwise write through synchronously
+void TradingEngine::persistOrder(const Order& order) {
+    if (async_writer && async_writer->insertOrder(order)) {
+        return;
+    }
+    if (db_manager) {
+        db_manager->insertOrder(order);
+    }
+}
+
+void TradingEngine::persistOrderStatus(OrderId order_id, OrderStatus status) {
+    if (async_writer && async_writer->updateOrderStatus(order_id, status)) {
+        return;
+    }
+    if (db_manager) {
+        db_manager->updateOrderStatus(order_id, status);
+    }
+}
+
+void TradingEngine::persistNewPosition(const Position& position) {
+    if (async_writer && async_writer->insertPosition(position)) {
+        return;
+    }
+    if (db_manager) {
+        db_manager->insertPosition(position);
+    }
+}
+
+void TradingEngine::persistPosition(const Position& position) {
+    if (async_writer && async_writer->updatePosition(position)) {
+        return;
+    }
+    if (db_manager) {
+        db_manager->updatePosition(position);
+    }
 }
 
 void TradingEngine::applyStopLoss(Position& position, double current_price) {
     double loss_percentage = (position.entry_price - current_price) / position.entry_price;
     
     if (loss_percentage >= stop_loss_percentage) {
-        std::cout << "Stop loss triggered for " << position.symbol 
-                  << " at " << current_price << std::endl;
-        placeOrder(position.symbol, "SELL", position.quantity, "MARKET", current_price);
+        if (verbose) {
+            std::cout << "Stop loss triggered for " << position.symbolName() 
+                      << " at " << current_price << std::endl;
+        }
+        placeOrder(position.symbol_id, OrderSide::SELL, position.quantity, OrderType::MARKET, current_price);
     }
 }
 
@@ -284,90 +888,166 @@ void TradingEngine::applyTakeProfit(Position& position, double current_price) {
     double profit_percentage = (current_price - position.entry_price) / position.entry_price;
     
     if (profit_percentage >= take_profit_percentage) {
-        std::cout << "Take profit triggered for " << position.symbol 
-                  << " at " << current_price << std::endl;
-        placeOrder(position.symbol, "SELL", position.quantity, "MARKET", current_price);
+        if (verbose) {
+            std::cout << "Take profit triggered for " << position.symbolName() 
+                      << " at " << current_price << std::endl;
+        }
+        placeOrder(position.symbol_id, OrderSide::SELL, position.quantity, OrderType::MARKET, current_price);
     }
 }
 
 Portfolio TradingEngine::getPortfolio() const {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
     return portfolio;
 }
 
-Position TradingEngine::getPosition(const std::string& symbol) {
-    auto it = portfolio.positions.find(symbol);
-    if (it != portfolio.positions.end()) {
-        return it->second;
+PortfolioSnapshot TradingEngine::getPortfolioSnapshot() const {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    PortfolioSnapshot snapshot;
+    snapshot.cash_balance = availableCash();
+    snapshot.equity = currentEquity();
+    snapshot.net_exposure = portfolio.net_exposure;
+    snapshot.gross_exposure = portfolio.gross_exposure;
+    snapshot.unrealized_pnl = portfolio.unrealizedPnL();
+    snapshot.peak_equity = aggregator ? aggregator->peakEquity() : stats.peakEquity();
+    snapshot.drawdown = currentDrawdown();
+    snapshot.position_count = portfolio.positions.size();
+    return snapshot;
+}
+
+Position TradingEngine::getPosition(SymbolId symbol_id) {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    if (const Position* position = portfolio.positions.find(symbol_id)) {
+        return *position;
     }
     return Position();
 }
 
 std::vector<Position> TradingEngine::getAllPositions() {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
     std::vector<Position> positions;
-    for (const auto& [symbol, pos] : portfolio.positions) {
+    positions.reserve(portfolio.positions.size());
+    for (const auto& [symbol_id, pos] : portfolio.positions) {
         positions.push_back(pos);
     }
     return positions;
 }
 
 double TradingEngine::getTotalPnL() const {
-    double total_pnl = portfolio.getEquity() - initial_balance;
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    double equity = currentEquity();
+    double total_pnl = equity - initial_balance;
     return total_pnl;
 }
 
+double TradingEngine::getDailyPnL() const {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    return stats.dailyPnL();
+}
+
 double TradingEngine::getWinRate() const {
-    if (db_manager) {
-        int wins = db_manager->getWinningTrades();
-        int losses = db_manager->getLosingTrades();
-        int total = wins + losses;
-        
-        if (total > 0) {
-            return static_cast<double>(wins) / total;
-        }
-    }
-    return 0.0;
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    return stats.winRate();
+}
+
+double TradingEngine::getSharpeRatio() const {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    return stats.sharpeRatio();
+}
+
+double TradingEngine::getSortinoRatio() const {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    return stats.sortinoRatio();
+}
+
+double TradingEngine::getRollingSharpeRatio() const {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    return stats.rollingSharpeRatio();
+}
+
+double TradingEngine::getMaxDrawdown() const {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    return stats.maxDrawdown();
+}
+
+uint64_t TradingEngine::getWinningTradeCount() const {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    return stats.winningTrades();
+}
+
+uint64_t TradingEngine::getLosingTradeCount() const {
+    std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+    return stats.losingTrades();
 }
 
 // PaperTradingSimulator implementation
-PaperTradingSimulator::PaperTradingSimulator() 
-    : slippage_rate(0.001), spread_rate(0.0005), fill_probability(0.95) {
+PaperTradingSimulator::PaperTradingSimulator(uint64_t seed)
+    : slippage_rate(0.001), spread_rate(0.0005), fill_probability(0.95),
+      participation_rate(0.10), queue_ahead_fraction(0.50), rng(seed) {
 }
 
-double PaperTradingSimulator::simulateSlippage(double price, double quantity, const std::string& side) {
+double PaperTradingSimulator::simulateSlippage(double price, double quantity, OrderSide side) {
     // Simulate slippage based on order size
     double slippage = price * slippage_rate * (1.0 + quantity / 100.0);
     
-    if (side == "BUY") {
+    if (side == OrderSide::BUY) {
         return price + slippage; // Pay more when buying
     } else {
         return price - slippage; // Receive less when selling
     }
 }
 
-double PaperTradingSimulator::simulateSpread(double price) {
-    // Add bid-ask spread
-    return price * (1.0 + spread_rate);
+double PaperTradingSimulator::simulateSpread(double price, OrderSide side) {
+    return side == OrderSide::BUY ? price * (1.0 + spread_rate) : price * (1.0 - spread_rate);
 }
 
 bool PaperTradingSimulator::simulateOrderFill(const Order& order, double market_price) {
     // For limit orders, check if price would be hit
-    if (order.order_type == "LIMIT") {
-        if (order.side == "BUY" && order.price >= market_price) {
+    if (order.order_type == OrderType::LIMIT) {
+        if (order.side == OrderSide::BUY && order.price >= market_price) {
             // Buy limit order fills if market price drops to or below limit
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_real_distribution<> dis(0.0, 1.0);
-            return dis(gen) < fill_probability;
-        } else if (order.side == "SELL" && order.price <= market_price) {
+            return rng.nextDouble() < fill_probability;
+        } else if (order.side == OrderSide::SELL && order.price <= market_price) {
             // Sell limit order fills if market price rises to or above limit
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_real_distribution<> dis(0.0, 1.0);
-            return dis(gen) < fill_probability;
+            return rng.nextDouble() < fill_probability;
         }
+        return false;
+    }
+    
+    return order.order_type == OrderType::MARKET; // Market orders always fill
+}
+
+void PaperTradingSimulator::joinQueue(Order& order, double level_volume) const {
+    order.queue_ahead = std::max(0.0, level_volume) * queue_ahead_fraction;
+}
+
+double PaperTradingSimulator::simulateLimitFill(Order& order, double market_price, double traded_volume) {
+    double remaining = order.remainingQuantity();
+    if (order.order_type != OrderType::LIMIT || remaining <= 0) {
+        return 0.0;
+    }
+    
+    bool buy = order.side == OrderSide::BUY;
+    bool marketable = buy ? market_price <= order.price : market_price >= order.price;
+    if (!marketable) {
+        return 0.0;
+    }
+    
+    if (traded_volume <= 0) {
+        return rng.nextDouble() < fill_probability ? remaining : 0.0;
+    }
+    
+    // Traded through the limit: the whole level, our order included, went
+    bool through = buy ? market_price < order.price : market_price > order.price;
+    if (through) {
+        order.queue_ahead = 0.0;
+        return remaining;
     }
     
-    return order.order_type == "MARKET"; // Market orders always fill
+    double at_level = traded_volume * participation_rate;
+    double past_queue = at_level - order.queue_ahead;
+    order.queue_ahead = std::max(0.0, -past_queue);
+    return past_queue > 0 ? std::min(remaining, past_queue) : 0.0;
 }
 
 } // namespace TradingSystem
\ No newline at end of file
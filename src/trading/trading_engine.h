@@ -7,8 +7,17 @@
 #include <memory>
 #include <atomic>
 #include <mutex>
+#include <cmath>
 #include "../common/data_types.h"
+#include "../common/flat_hash_map.h"
+#include "../common/fast_random.h"
 #include "../database/database_manager.h"
+#include "../database/async_db_writer.h"
+#include "../market_data/market_data_cache.h"
+#include "../market_data/pricing_service.h"
+#include "portfolio_aggregator.h"
+#include "performance_stats.h"
+#include "order_book.h"
 
 namespace TradingSystem {
 
@@ -20,17 +29,121 @@ enum class TradingMode {
 struct Portfolio {
     double cash_balance;
     double total_value;
-    std::map<std::string, Position> positions;
+    FlatHashMap<SymbolId, Position> positions;
     
-    double getEquity() const {
-        double equity = cash_balance;
+    // Running sums over positions so equity and exposure cost O(1). Every
+    // change to a position goes through removeExposure/addExposure (or
+    // mark); the sums are re-added from scratch every kResyncInterval
+    // updates so rounding error cannot build up.
+    static constexpr uint32_t kResyncInterval = 65536;
+    double net_exposure = 0.0;    // sum of quantity * current_price
+    double gross_exposure = 0.0;  // sum of |quantity * current_price|
+    double cost_basis = 0.0;      // sum of quantity * entry_price
+    uint32_t updates_since_resync = 0;
+    
+    double getEquity() const { return cash_balance + net_exposure; }
+    double unrealizedPnL() const { return net_exposure - cost_basis; }
+    
+    void addExposure(const Position& position) {
+        double value = position.quantity * position.current_price;
+        net_exposure += value;
+        gross_exposure += std::fabs(value);
+        cost_basis += position.quantity * position.entry_price;
+        if (++updates_since_resync >= kResyncInterval) {
+            resyncExposure();
+        }
+    }
+    void removeExposure(const Position& position) {
+        double value = position.quantity * position.current_price;
+        net_exposure -= value;
+        gross_exposure -= std::fabs(value);
+        cost_basis -= position.quantity * position.entry_price;
+    }
+    // Re-price a held position and keep the sums in step
+    void mark(Position& position, double price) {
+        removeExposure(position);
+        position.current_price = price;
+        position.unrealized_pnl = position.quantity * (price - position.entry_price);
+        addExposure(position);
+    }
+    void resyncExposure() {
+        net_exposure = gross_exposure = cost_basis = 0.0;
         for (const auto& [symbol, position] : positions) {
-            equity += position.quantity * position.current_price;
+            double value = position.quantity * position.current_price;
+            net_exposure += value;
+            gross_exposure += std::fabs(value);
+            cost_basis += position.quantity * position.entry_price;
         }
-        return equity;
+        updates_since_resync = 0;
     }
 };
 
+// Read-only view of the portfolio-level numbers, for status displays and
+// risk checks that do not need the positions themselves
+struct PortfolioSnapshot {
+    double cash_balance = 0.0;
+    double equity = 0.0;
+    double net_exposure = 0.0;
+    double gross_exposure = 0.0;
+    double unrealized_pnl = 0.0;
+    double peak_equity = 0.0;
+    double drawdown = 0.0;
+    size_t position_count = 0;
+};
+
+// The limits an operator can change while the engine runs
+struct RiskLimits {
+    double max_position_size = 5000.0;
+    double max_drawdown = 0.20;
+    double stop_loss_percentage = 0.02;
+    double take_profit_percentage = 0.05;
+};
+
+// Paper trading simulator. One lives in each engine for its lifetime, so
+// configured rates stick, and its random draws come from a seeded
+// xoshiro256** stream: the same seed and the same prices reproduce the
+// same fills.
+class PaperTradingSimulator {
+public:
+    static constexpr uint64_t kDefaultSeed = 0x5452414445ULL;
+    
+    explicit PaperTradingSimulator(uint64_t seed = kDefaultSeed);
+    
+    // Simulate market conditions
+    double simulateSlippage(double price, double quantity, OrderSide side);
+    // Cross the spread: buys pay spread_rate above price, sells receive
+    // spread_rate below it
+    double simulateSpread(double price, OrderSide side);
+    bool simulateOrderFill(const Order& order, double market_price);
+    
+    // Queue-position model for resting limit orders. joinQueue places the
+    // order behind queue_ahead_fraction of the level's volume; each
+    // simulateLimitFill then lets participation_rate of the traded volume
+    // print at the limit, which works through the queue ahead first and
+    // then fills the order, possibly in several partial fills. A price
+    // through the limit fills whatever remains. With no volume known
+    // (traded_volume <= 0) a marketable order fills in full with
+    // fill_probability, as before. Returns the quantity filled now.
+    void joinQueue(Order& order, double level_volume) const;
+    double simulateLimitFill(Order& order, double market_price, double traded_volume);
+    
+    // Set simulation parameters
+    void setSlippageRate(double rate) { slippage_rate = rate; }
+    void setSpreadRate(double rate) { spread_rate = rate; }
+    void setFillProbability(double prob) { fill_probability = prob; }
+    void setParticipationRate(double rate) { participation_rate = rate; }
+    void setQueueAheadFraction(double fraction) { queue_ahead_fraction = fraction; }
+    void setSeed(uint64_t seed) { rng.seed(seed); }
+    
+private:
+    double slippage_rate;        // Percentage slippage
+    double spread_rate;          // Bid-ask spread percentage
+    double fill_probability;     // Probability of limit order fill
+    double participation_rate;   // Share of traded volume printing at our limit
+    double queue_ahead_fraction; // Share of level volume queued ahead on arrival
+    Xoshiro256 rng;
+};
+
 class TradingEngine {
 public:
     TradingEngine(TradingMode mode = TradingMode::PAPER, 
@@ -39,48 +152,149 @@ public:
     
     // Initialize engine
     bool initialize(std::shared_ptr<DatabaseManager> db_manager);
+    // Same, with the open positions already read (shards share one read)
+    bool initialize(std::shared_ptr<DatabaseManager> db_manager,
+                    const std::vector<Position>& open_positions);
+    
+    // Route persistence through a write-behind writer instead of inline
+    // SQLite calls. Pass nullptr to go back to synchronous writes.
+    void setAsyncWriter(std::shared_ptr<AsyncDbWriter> writer) { async_writer = writer; }
     
-    // Order management
-    std::string placeOrder(const std::string& symbol, 
-                          const std::string& side,
-                          double quantity,
-                          const std::string& order_type = "MARKET",
-                          double price = 0.0);
+    // Latest bars. Without a pricing service of its own the engine quotes
+    // straight off this cache with no staleness limit.
+    void setMarketDataCache(std::shared_ptr<MarketDataCache> cache);
+    // Quotes for sizing, risk checks and paper fills. Orders and signals
+    // that need a price the service reports missing or stale are rejected.
+    void setPricingService(std::shared_ptr<PricingService> service) { pricing = service; }
     
-    bool cancelOrder(const std::string& order_id);
-    Order getOrderStatus(const std::string& order_id);
+    // Run as one shard of a ShardedTradingEngine: only symbols owned by
+    // shard_index are loaded, and cash, equity and drawdown come from the
+    // shared aggregator. Call before initialize().
+    void attachAggregator(std::shared_ptr<PortfolioAggregator> aggregator, size_t shard_index) {
+        this->aggregator = aggregator;
+        this->shard_index = shard_index;
+    }
+    
+    // Order management. Returns the new order's id, or kInvalidOrderId
+    // if the order was rejected, whether by the checks here or because
+    // the paper fill could not be paid for. In paper mode limit and stop orders that
+    // do not fill at once rest in the symbol's book and are matched on
+    // every price update; price is the limit or stop price. A market order
+    // given a price is quoted around it; without one it takes the pricing
+    // service's snapshot and is rejected if there is no fresh one.
+    OrderId placeOrder(SymbolId symbol_id,
+                       OrderSide side,
+                       double quantity,
+                       OrderType order_type = OrderType::MARKET,
+                       double price = 0.0);
+    
+    bool cancelOrder(OrderId order_id);
+    // Working, filled or cancelled order; order_id is kInvalidOrderId if
+    // the id is unknown or has aged out of the history window
+    Order getOrderStatus(OrderId order_id);
     
     // Position management
-    Position getPosition(const std::string& symbol);
+    Position getPosition(SymbolId symbol_id);
     std::vector<Position> getAllPositions();
     void updatePositionPrices(const std::map<std::string, double>& current_prices);
+    // Single-symbol form for replay, with no map to build per bar
+    void updatePositionPrice(SymbolId symbol_id, double price);
     
-    // Portfolio management
+    // Portfolio management. getPortfolio copies every position; prefer
+    // getPortfolioSnapshot when only the totals are needed.
     Portfolio getPortfolio() const;
-    double getAvailableCash() const { return portfolio.cash_balance; }
-    double getTotalEquity() const { return portfolio.getEquity(); }
+    PortfolioSnapshot getPortfolioSnapshot() const;
+    double getAvailableCash() const {
+        std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+        return portfolio.cash_balance;
+    }
+    double getTotalEquity() const {
+        std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+        return portfolio.getEquity();
+    }
+    double getDrawdown() const {
+        std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+        return currentDrawdown();
+    }
     
-    // Risk management
-    bool checkRiskLimits(const std::string& symbol, double quantity, double price);
+    // Risk management. A BUY of quantity at price passes if the symbol's
+    // whole position, at its last mark plus this order, stays within
+    // max_position_size, the order is covered by cash, and the drawdown
+    // is within max_drawdown.
+    bool checkRiskLimits(SymbolId symbol_id, double quantity, double price);
     void setMaxPositionSize(double max_size) { max_position_size = max_size; }
     void setMaxDrawdown(double max_dd) { max_drawdown = max_dd; }
+    void setStopLoss(double percentage);
+    void setTakeProfit(double percentage);
+    // All four at once; resting exits are re-placed once for the new bands
+    void setRiskLimits(const RiskLimits& limits);
+    // Keep each position's stop-loss and take-profit as a one-cancels-other
+    // pair in the order book (the default) instead of checking every
+    // position on every price update
+    void setRestingExits(bool enabled);
+    
+    // Paper fill model
+    void setSlippageRate(double rate) { simulator.setSlippageRate(rate); }
+    void setSpreadRate(double rate) { simulator.setSpreadRate(rate); }
+    void setSimulatorSeed(uint64_t seed) { simulator.setSeed(seed); }
+    
+    // Share of available cash a BUY may spend; the rest is kept in reserve
+    static constexpr double kDeployableCash = 0.95;
     
     // Trading signal processing
     void processTradingSignal(const TradingSignal& signal);
+    // One decision over a whole batch (a batch_analyze reply, a model
+    // ranking). Cash and drawdown are read once; BUYs are sized together
+    // and scaled down to fit cash_budget (kDeployableCash of available
+    // cash when negative) instead of each taking 95% of what the previous
+    // one left. SELLs run first. With synchronous persistence the batch's
+    // writes share one transaction. Returns the orders placed; those
+    // rejected by the risk check or at the fill are not counted.
+    size_t processTradingSignals(const TradingSignal* signals, size_t count, double cash_budget = -1.0);
     
-    // Performance metrics
+    // Performance metrics, all O(1) reads of the running statistics
     double getTotalPnL() const;
     double getDailyPnL() const;
     double getWinRate() const;
     double getSharpeRatio() const;
+    double getSortinoRatio() const;
+    double getRollingSharpeRatio() const;
+    double getMaxDrawdown() const;
+    // Sells closed at a profit or loss by this engine, plus those recorded
+    // in the database when it was initialized
+    uint64_t getWinningTradeCount() const;
+    uint64_t getLosingTradeCount() const;
+    PerformanceStats getPerformanceStats() const {
+        std::lock_guard<std::recursive_mutex> lock(engine_mutex);
+        return stats;
+    }
+    
+    // Paper trading specific. Market and triggered stop orders cross the
+    // quote (buys at the ask, sells at the bid); limits work against last.
+    void simulateFill(Order& order, const PriceSnapshot& quote);
     
-    // Paper trading specific
-    void simulateFill(Order& order, double market_price);
+    // Replay support: stamp orders and positions with a simulated clock
+    // instead of the wall clock, and silence per-order console output
+    void setSimulatedTime(std::chrono::system_clock::time_point time) {
+        simulated_time = time;
+        use_simulated_time = true;
+    }
+    void setVerbose(bool verbose) { this->verbose = verbose; }
+    uint64_t getFillCount() const { return fill_count; }
     
 private:
     TradingMode mode;
     Portfolio portfolio;
     std::shared_ptr<DatabaseManager> db_manager;
+    std::shared_ptr<AsyncDbWriter> async_writer;
+    std::shared_ptr<MarketDataCache> market_data_cache;
+    std::shared_ptr<PricingService> pricing;
+    std::shared_ptr<PortfolioAggregator> aggregator;
+    size_t shard_index = 0;
+    bool verbose = true;
+    bool use_simulated_time = false;
+    std::chrono::system_clock::time_point simulated_time;
+    uint64_t fill_count = 0;
     
     // Risk parameters
     double max_position_size;
@@ -88,48 +302,94 @@ private:
     double stop_loss_percentage;
     double take_profit_percentage;
     
-    // Performance tracking
+    // Performance tracking. stats sees every fill and price mark on the
+    // engine clock (simulated or wall); with an aggregator the equity it
+    // tracks is the whole portfolio's.
     double initial_balance;
-    double peak_balance;
-    std::vector<double> daily_returns;
+    PerformanceStats stats;
+    PaperTradingSimulator simulator;
+    
+    // Order management. Filled and cancelled orders stay available for
+    // status lookups in a fixed window: the oldest is recycled as each new
+    // one finishes, so the history never grows or rehashes once warm.
+    static constexpr size_t kFilledOrderHistory = 4096;
+    FlatHashMap<OrderId, Order> pending_orders;
+    FlatHashMap<OrderId, Order> filled_orders;
     
-    // Order management
-    std::map<std::string, Order> pending_orders;
-    std::map<std::string, Order> filled_orders;
-    std::atomic<int> order_counter;
-    std::mutex order_mutex;
+    // Resting paper orders per symbol, and the book ids of each position's
+    // protective exits
+    struct ProtectiveExits {
+        OrderId stop_loss = kInvalidOrderId;
+        OrderId take_profit = kInvalidOrderId;
+    };
+    FlatHashMap<SymbolId, OrderBook> books;
+    FlatHashMap<SymbolId, ProtectiveExits> protective_exits;
+    std::vector<OrderId> crossed_orders;
+    
+    // Batch scratch, reused between processTradingSignals calls
+    struct PlannedOrder {
+        SymbolId symbol_id;
+        PriceSnapshot quote;
+        double amount;  // notional for a BUY, quantity for a SELL
+    };
+    std::vector<PlannedOrder> planned_buys;
+    std::vector<PlannedOrder> planned_sells;
+    // Symbols already planned in this batch; one set covers both sides
+    // since a symbol is bought only when flat and sold only when held
+    FlatHashMap<SymbolId, bool> planned_symbols;
+    bool resting_exits = true;
+    std::vector<OrderId> filled_ring;
+    size_t filled_next = 0;
+    std::atomic<uint64_t> order_counter;
+    // Guards the portfolio and order books. Signals arrive on several
+    // dispatch workers and price updates on the event loop; recursive
+    // because stop-loss and signal handling re-enter placeOrder.
+    mutable std::recursive_mutex engine_mutex;
     
     // Helper methods
-    std::string generateOrderId();
+    OrderId generateOrderId();
+    // placeOrder with the market order's quote already taken
+    OrderId submitOrder(SymbolId symbol_id, OrderSide side, double quantity,
+                        OrderType order_type, double price, const PriceSnapshot& quote);
+    // What a market order of quantity pays (BUY) or receives (SELL) against
+    // quote: the crossing price, plus the paper simulator's slippage and
+    // spread in paper mode. Fills, risk checks and sizing all use it.
+    double marketFillPrice(const PriceSnapshot& quote, OrderSide side, double quantity);
+    // BUY quantity whose fill costs at most amount
+    double marketBuyQuantity(const PriceSnapshot& quote, double amount);
     bool executeMarketOrder(Order& order, double market_price);
-    bool executeLimitOrder(Order& order, double market_price);
-    void updatePortfolio(const Order& order);
+    bool executeLimitOrder(Order& order, double fill_quantity);
+    void recordFilled(const Order& order);
+    bool updatePortfolio(const Order& order);
+    double availableCash() const;
+    void publishShardValue();
+    void markPosition(SymbolId symbol_id, double price);
+    void matchRestingOrders(SymbolId symbol_id, double price);
+    bool workRestingOrder(Order& order, const PriceSnapshot& quote);
+    void restOrder(const Order& order);
+    void placeProtectiveExits(SymbolId symbol_id);
+    void cancelProtectiveExits(SymbolId symbol_id);
+    void fireProtectiveExit(SymbolId symbol_id, OrderId exit_id, double price);
+    double currentEquity() const;
+    double currentDrawdown() const;
+    void recordEquity();
+    std::chrono::system_clock::time_point now() const {
+        return use_simulated_time ? simulated_time : std::chrono::system_clock::now();
+    }
     double calculatePositionSize(const TradingSignal& signal);
+    // Fresh quote from the pricing service; false (logged when verbose)
+    // if it is missing or stale
+    bool freshQuote(SymbolId symbol_id, PriceSnapshot& quote) const;
+    PriceSnapshot quoteAt(double price) const;
+    double latestVolume(SymbolId symbol_id) const;
+    void persistOrder(const Order& order);
+    void persistOrderStatus(OrderId order_id, OrderStatus status);
+    void persistNewPosition(const Position& position);
+    void persistPosition(const Position& position);
     void applyStopLoss(Position& position, double current_price);
     void applyTakeProfit(Position& position, double current_price);
 };
 
-// Paper trading simulator
-class PaperTradingSimulator {
-public:
-    PaperTradingSimulator();
-    
-    // Simulate market conditions
-    double simulateSlippage(double price, double quantity, const std::string& side);
-    double simulateSpread(double price);
-    bool simulateOrderFill(const Order& order, double market_price);
-    
-    // Set simulation parameters
-    void setSlippageRate(double rate) { slippage_rate = rate; }
-    void setSpreadRate(double rate) { spread_rate = rate; }
-    void setFillProbability(double prob) { fill_probability = prob; }
-    
-private:
-    double slippage_rate;    // Percentage slippage
-    double spread_rate;      // Bid-ask spread percentage
-    double fill_probability; // Probability of limit order fill
-};
-
 } // namespace TradingSystem
 
 #endif // TRADING_ENGINE_H
\ No newline at end of file
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+
+"""Decoder for the binary wire format defined in src/common/wire_format.h.
+
+A stream is a sequence of frames: a 16-byte header (magic, version, type,
+record count, payload size) followed by the payload. Records carry symbol
+IDs that are resolved through SYMBOL_TABLE frames sent earlier in the same
+stream. Record arrays decode straight into numpy structured arrays without
+a per-row Python loop; the struct-based helpers are there for callers that
+only need a handful of records.
+"""
+
+import struct
+from typing import Dict, Iterator, List, Tuple
+
+import numpy as np
+
+WIRE_MAGIC = 0x46574D54  # "TMWF"
+WIRE_VERSION = 1
+
+SYMBOL_TABLE = 1
+MARKET_DATA = 2
+TRADING_SIGNAL = 3
+
+ACTIONS = {0: 'HOLD', 1: 'BUY', 2: 'SELL'}
+ACTION_CODES = {name: code for code, name in ACTIONS.items()}
+
+HEADER = struct.Struct('<IHHII')
+SYMBOL_ENTRY = struct.Struct('<IH')
+MARKET_DATA_RECORD = struct.Struct('<IIqddddd')
+TRADING_SIGNAL_RECORD = struct.Struct('<IB3xqdd')
+
+MARKET_DATA_DTYPE = np.dtype([
+    ('symbol_id', '<u4'),
+    ('reserved', '<u4'),
+    ('timestamp_ns', '<i8'),
+    ('open', '<f8'),
+    ('high', '<f8'),
+    ('low', '<f8'),
+    ('close', '<f8'),
+    ('volume', '<f8'),
+])
+
+TRADING_SIGNAL_DTYPE = np.dtype([
+    ('symbol_id', '<u4'),
+    ('action', 'u1'),
+    ('reserved', 'u1', (3,)),
+    ('timestamp_ns', '<i8'),
+    ('confidence', '<f8'),
+    ('suggested_position_size', '<f8'),
+])
+
+assert HEADER.size == 16
+assert MARKET_DATA_DTYPE.itemsize == MARKET_DATA_RECORD.size == 56
+assert TRADING_SIGNAL_DTYPE.itemsize == TRADING_SIGNAL_RECORD.size == 32
+
+
+def iter_frames(buffer) -> Iterator[Tuple[int, int, memoryview]]:
+    """Yield (type, count, payload) for every complete frame in buffer"""
+    view = memoryview(buffer)
+    offset = 0
+    while offset + HEADER.size <= len(view):
+        magic, version, msg_type, count, payload_size = HEADER.unpack_from(view, offset)
+        if magic != WIRE_MAGIC or version != WIRE_VERSION:
+            raise ValueError(f"Bad wire header at offset {offset}")
+        start = offset + HEADER.size
+        end = start + payload_size
+        if end > len(view):
+            break
+        yield msg_type, count, view[start:end]
+        offset = end
+
+
+def decode_symbol_table(payload, count: int) -> Dict[int, str]:
+    symbols = {}
+    pos = 0
+    for _ in range(count):
+        symbol_id, length = SYMBOL_ENTRY.unpack_from(payload, pos)
+        pos += SYMBOL_ENTRY.size
+        symbols[symbol_id] = bytes(payload[pos:pos + length]).decode('utf-8')
+        pos += length
+    return symbols
+
+
+class WireDecoder:
+    """Stateful decoder that remembers symbol tables across frames"""
+
+    def __init__(self):
+        self.symbols: Dict[int, str] = {}
+
+    def decode(self, buffer) -> Dict[str, List[np.ndarray]]:
+        """Decode a buffer into lists of numpy record arrays by frame kind"""
+        out = {'market_data': [], 'signals': []}
+        for msg_type, count, payload in iter_frames(buffer):
+            if msg_type == SYMBOL_TABLE:
+                self.symbols.update(decode_symbol_table(payload, count))
+            elif msg_type == MARKET_DATA:
+                out['market_data'].append(np.frombuffer(payload, dtype=MARKET_DATA_DTYPE, count=count))
+            elif msg_type == TRADING_SIGNAL:
+                out['signals'].append(np.frombuffer(payload, dtype=TRADING_SIGNAL_DTYPE, count=count))
+        return out
+
+    def symbol(self, symbol_id: int) -> str:
+        return self.symbols.get(int(symbol_id), '')
+
+    def market_data_rows(self, buffer) -> Iterator[Dict]:
+        """struct-based decoding of MARKET_DATA frames into dicts"""
+        for msg_type, count, payload in iter_frames(buffer):
+            if msg_type == SYMBOL_TABLE:
+                self.symbols.update(decode_symbol_table(payload, count))
+            elif msg_type == MARKET_DATA:
+                for fields in MARKET_DATA_RECORD.iter_unpack(payload):
+                    symbol_id, _, ts_ns, o, h, l, c, v = fields
+                    yield {'symbol': self.symbol(symbol_id), 'timestamp_ns': ts_ns,
+                           'open': o, 'high': h, 'low': l, 'close': c, 'volume': v}
+
+    def signal_rows(self, buffer) -> Iterator[Dict]:
+        """struct-based decoding of TRADING_SIGNAL frames into dicts"""
+        for msg_type, count, payload in iter_frames(buffer):
+            if msg_type == SYMBOL_TABLE:
+                self.symbols.update(decode_symbol_table(payload, count))
+            elif msg_type == TRADING_SIGNAL:
+                for symbol_id, action, ts_ns, confidence, size in TRADING_SIGNAL_RECORD.iter_unpack(payload):
+                    yield {'symbol': self.symbol(symbol_id), 'action': ACTIONS.get(action, 'HOLD'),
+                           'timestamp_ns': ts_ns, 'confidence': confidence,
+                           'suggested_position_size': size}
+
+
+def encode_signals(signals: List[Dict], symbol_ids: Dict[str, int]) -> bytes:
+    """Encode analyzer results as a symbol table frame plus a signal frame.
+
+    symbol_ids is updated in place with IDs for symbols seen for the first time.
+    """
+    new_entries = b''
+    new_count = 0
+    for signal in signals:
+        name = signal['symbol']
+        if name not in symbol_ids:
+            symbol_ids[name] = len(symbol_ids)
+            encoded = name.encode('utf-8')
+            new_entries += SYMBOL_ENTRY.pack(symbol_ids[name], len(encoded)) + encoded
+            new_count += 1
+
+    out = b''
+    if new_count:
+        out += HEADER.pack(WIRE_MAGIC, WIRE_VERSION, SYMBOL_TABLE, new_count, len(new_entries)) + new_entries
+
+    records = b''.join(
+        TRADING_SIGNAL_RECORD.pack(symbol_ids[s['symbol']], ACTION_CODES.get(s.get('action'), 0),
+                                   int(s.get('timestamp_ns', 0)), float(s.get('confidence', 0.0)),
+                                   float(s.get('suggested_position_size', 0.0)))
+        for s in signals)
+    out += HEADER.pack(WIRE_MAGIC, WIRE_VERSION, TRADING_SIGNAL, len(signals), len(records)) + records
+    return out
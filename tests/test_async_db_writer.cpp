@@ -0,0 +1,124 @@
+#include "database/async_db_writer.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace TradingSystem {
+namespace {
+
+class AsyncDbWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = "trading_tests_writer_" + std::to_string(getpid()) + ".db";
+        std::remove(path.c_str());
+        db = std::make_shared<DatabaseManager>(path);
+        ASSERT_TRUE(db->initialize());
+        writer = std::make_unique<AsyncDbWriter>(db, 1024, 100, 4096);
+        writer->start();
+    }
+
+    void TearDown() override {
+        writer.reset();
+        db.reset();
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::remove((path + suffix).c_str());
+        }
+    }
+
+    static Position position(const std::string& symbol, double quantity) {
+        Position p;
+        p.symbol_id = SymbolTable::getInstance().intern(symbol);
+        p.quantity = quantity;
+        p.entry_price = 10.0;
+        p.current_price = 10.0 + quantity;
+        p.entry_time = std::chrono::system_clock::now();
+        return p;
+    }
+
+    double storedQuantity(const std::string& symbol) {
+        for (const auto& p : db->getOpenPositions()) {
+            if (p.symbolName() == symbol) return p.quantity;
+        }
+        return -1.0;
+    }
+
+    // Parks the writer inside a commit so everything enqueued meanwhile
+    // lands in its next batch
+    std::unique_ptr<DatabaseManager::Transaction> holdWriter() {
+        auto hold = std::make_unique<DatabaseManager::Transaction>(*db);
+        MarketData bar;
+        bar.symbol = "TEST_WRITER_BLOCKER";
+        bar.open = bar.high = bar.low = bar.close = 1.0;
+        bar.timestamp = std::chrono::system_clock::now();
+        EXPECT_TRUE(writer->insertMarketData(bar));
+        while (writer->queueDepth() > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return hold;
+    }
+
+    std::string path;
+    std::shared_ptr<DatabaseManager> db;
+    std::unique_ptr<AsyncDbWriter> writer;
+};
+
+TEST_F(AsyncDbWriterTest, LastPositionUpdateInBatchWins) {
+    auto hold = holdWriter();
+    ASSERT_TRUE(writer->insertPosition(position("TEST_WRITER_A", 1.0)));
+    ASSERT_TRUE(writer->insertPosition(position("TEST_WRITER_B", 1.0)));
+    for (int i = 2; i <= 50; ++i) {
+        ASSERT_TRUE(writer->updatePosition(position("TEST_WRITER_A", i)));
+    }
+    ASSERT_TRUE(writer->updatePosition(position("TEST_WRITER_B", 7.0)));
+    ASSERT_TRUE(writer->updatePosition(position("TEST_WRITER_B", 8.0)));
+    hold.reset();
+
+    ASSERT_TRUE(writer->flush());
+    EXPECT_EQ(writer->committedCount(), 1u + 2u + 49u + 2u);
+    // 48 of A's updates and one of B's are superseded within the batch
+    EXPECT_EQ(writer->coalescedCount(), 49u);
+    EXPECT_DOUBLE_EQ(storedQuantity("TEST_WRITER_A"), 50.0);
+    EXPECT_DOUBLE_EQ(storedQuantity("TEST_WRITER_B"), 8.0);
+}
+
+TEST_F(AsyncDbWriterTest, UpdatesInSeparateBatchesAreAllApplied) {
+    ASSERT_TRUE(writer->insertPosition(position("TEST_WRITER_C", 1.0)));
+    ASSERT_TRUE(writer->flush());
+    for (int i = 2; i <= 4; ++i) {
+        ASSERT_TRUE(writer->updatePosition(position("TEST_WRITER_C", i)));
+        ASSERT_TRUE(writer->flush());
+        EXPECT_DOUBLE_EQ(storedQuantity("TEST_WRITER_C"), i);
+    }
+    EXPECT_EQ(writer->coalescedCount(), 0u);
+}
+
+TEST_F(AsyncDbWriterTest, OtherMutationsAreNeverCoalesced) {
+    auto hold = holdWriter();
+    TradingSignal signal;
+    signal.symbol = "TEST_WRITER_SIG";
+    signal.action = SignalAction::BUY;
+    signal.confidence = 0.5;
+    signal.timestamp = std::chrono::system_clock::now();
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(writer->insertTradingSignal(signal));
+    }
+    hold.reset();
+
+    ASSERT_TRUE(writer->flush());
+    EXPECT_EQ(writer->coalescedCount(), 0u);
+    EXPECT_EQ(db->getLatestSignals(100).size(), 5u);
+}
+
+TEST_F(AsyncDbWriterTest, StopCommitsQueuedMutationsAndRefusesNewOnes) {
+    ASSERT_TRUE(writer->insertPosition(position("TEST_WRITER_D", 3.0)));
+    writer->stop();
+    EXPECT_DOUBLE_EQ(storedQuantity("TEST_WRITER_D"), 3.0);
+    EXPECT_FALSE(writer->updatePosition(position("TEST_WRITER_D", 4.0)));
+}
+
+} // namespace
+} // namespace TradingSystem
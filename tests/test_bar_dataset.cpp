@@ -0,0 +1,113 @@
+#include "backtest/bar_dataset.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+namespace TradingSystem {
+namespace {
+
+class BarDatasetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = "trading_tests_dataset_" + std::to_string(getpid()) + ".bars";
+        // An odd-length name and bar count exercise the 8-byte padding
+        for (const auto& [name, bars] : {std::pair<const char*, size_t>{"TEST_DS_A", 1000},
+                                         std::pair<const char*, size_t>{"TEST_DS_BBB", 37}}) {
+            BarSeries series(name);
+            for (size_t i = 0; i < bars; ++i) {
+                double close = 100.0 + static_cast<double>(i) * 0.25;
+                series.append(close - 0.5, close + 1.0, close - 1.0, close, 1000.0 + i,
+                              1700000000000000000LL + static_cast<int64_t>(i) * 60000000000LL);
+            }
+            source.add(std::move(series));
+        }
+        ASSERT_TRUE(source.saveFile(path));
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    static void expectSameBars(const BarSeries& a, const BarSeries& b) {
+        ASSERT_EQ(a.symbol(), b.symbol());
+        EXPECT_EQ(a.symbolId(), b.symbolId());
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            EXPECT_EQ(a.open()[i], b.open()[i]);
+            EXPECT_EQ(a.high()[i], b.high()[i]);
+            EXPECT_EQ(a.low()[i], b.low()[i]);
+            EXPECT_EQ(a.close()[i], b.close()[i]);
+            EXPECT_EQ(a.volume()[i], b.volume()[i]);
+            EXPECT_EQ(a.timestamps()[i], b.timestamps()[i]);
+        }
+    }
+
+    std::string path;
+    BarDataset source;
+};
+
+TEST_F(BarDatasetTest, FileLoadsAsViewsOverTheMapping) {
+    BarDataset loaded;
+    ASSERT_TRUE(loaded.loadFile(path));
+    ASSERT_EQ(loaded.symbolCount(), 2u);
+    EXPECT_EQ(loaded.totalBars(), 1037u);
+    for (size_t s = 0; s < loaded.symbolCount(); ++s) {
+        EXPECT_TRUE(loaded.series()[s].isView());
+        EXPECT_FALSE(source.series()[s].isView());
+        expectSameBars(source.series()[s], loaded.series()[s]);
+    }
+    MarketData row = loaded.series()[1].row(36);
+    EXPECT_EQ(row.symbol, "TEST_DS_BBB");
+    EXPECT_DOUBLE_EQ(row.close, 109.0);
+}
+
+TEST_F(BarDatasetTest, CopiesKeepTheMappingAlive) {
+    BarDataset copy;
+    {
+        BarDataset loaded;
+        ASSERT_TRUE(loaded.loadFile(path));
+        copy = loaded;
+    }
+    std::remove(path.c_str());
+    expectSameBars(source.series()[0], copy.series()[0]);
+}
+
+TEST_F(BarDatasetTest, AppendingToAViewCopiesItFirst) {
+    BarDataset loaded;
+    ASSERT_TRUE(loaded.loadFile(path));
+    BarSeries grown = loaded.series()[1];
+    grown.append(1.0, 2.0, 0.5, 1.5, 10.0, 1800000000000000000LL);
+
+    EXPECT_FALSE(grown.isView());
+    ASSERT_EQ(grown.size(), 38u);
+    EXPECT_DOUBLE_EQ(grown.close()[37], 1.5);
+    EXPECT_DOUBLE_EQ(grown.close()[36], 109.0);
+    // The dataset's view is untouched
+    EXPECT_EQ(loaded.series()[1].size(), 37u);
+    expectSameBars(source.series()[1], loaded.series()[1]);
+}
+
+TEST_F(BarDatasetTest, SavedViewsRoundTrip) {
+    BarDataset loaded;
+    ASSERT_TRUE(loaded.loadFile(path));
+    std::string again = path + ".again";
+    ASSERT_TRUE(loaded.saveFile(again));
+
+    BarDataset reloaded;
+    ASSERT_TRUE(reloaded.loadFile(again));
+    std::remove(again.c_str());
+    for (size_t s = 0; s < reloaded.symbolCount(); ++s) {
+        expectSameBars(source.series()[s], reloaded.series()[s]);
+    }
+}
+
+TEST_F(BarDatasetTest, TruncatedFileIsRejected) {
+    ASSERT_EQ(truncate(path.c_str(), 200), 0);
+    BarDataset loaded;
+    EXPECT_FALSE(loaded.loadFile(path));
+    EXPECT_EQ(loaded.symbolCount(), 0u);
+}
+
+} // namespace
+} // namespace TradingSystem
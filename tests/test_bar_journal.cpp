@@ -0,0 +1,125 @@
+#include "database/bar_journal.h"
+#include "database/database_manager.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+
+namespace TradingSystem {
+namespace {
+
+using std::chrono::minutes;
+
+class BarJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = "trading_tests_journal_" + std::to_string(getpid());
+        std::filesystem::remove_all(directory);
+        start = fromEpochNanos(1700000000LL * 1000000000LL);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+    }
+
+    MarketData bar(int minute, double close) const {
+        MarketData data;
+        data.symbol = "TEST_JOURNAL";
+        data.open = data.high = data.low = data.close = close;
+        data.volume = 100.0 + minute;
+        data.timestamp = start + minutes(minute);
+        return data;
+    }
+
+    std::string directory;
+    std::chrono::system_clock::time_point start;
+};
+
+TEST_F(BarJournalTest, RangeAndLatestRoundTrip) {
+    BarJournal journal(directory);
+    ASSERT_TRUE(journal.open());
+    // Enough bars to cross several sparse index strides and one growth
+    const int kBars = static_cast<int>(BarJournal::kGrowRecords) + 700;
+    for (int i = 0; i < kBars; ++i) {
+        ASSERT_TRUE(journal.append(bar(i, 100.0 + i)));
+    }
+    EXPECT_EQ(journal.size("TEST_JOURNAL"), static_cast<size_t>(kBars));
+
+    auto window = journal.range("TEST_JOURNAL", start + minutes(300), start + minutes(1000));
+    ASSERT_EQ(window.size(), 701u);
+    EXPECT_EQ(window.front().timestamp, start + minutes(300));
+    EXPECT_EQ(window.back().timestamp, start + minutes(1000));
+    EXPECT_DOUBLE_EQ(window[10].close, 410.0);
+    EXPECT_DOUBLE_EQ(window[10].volume, 410.0);
+
+    auto recent = journal.latest("TEST_JOURNAL", 3);
+    ASSERT_EQ(recent.size(), 3u);
+    EXPECT_DOUBLE_EQ(recent[0].close, 100.0 + kBars - 1);
+    EXPECT_DOUBLE_EQ(recent[2].close, 100.0 + kBars - 3);
+}
+
+TEST_F(BarJournalTest, ReopenKeepsCommittedBars) {
+    {
+        BarJournal journal(directory);
+        ASSERT_TRUE(journal.open());
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_TRUE(journal.append(bar(i, 50.0 + i)));
+        }
+    }
+
+    BarJournal journal(directory);
+    ASSERT_TRUE(journal.open());
+    EXPECT_EQ(journal.size("TEST_JOURNAL"), 10u);
+    ASSERT_TRUE(journal.append(bar(10, 60.0)));
+    auto all = journal.range("TEST_JOURNAL", start, start + minutes(10));
+    ASSERT_EQ(all.size(), 11u);
+    EXPECT_DOUBLE_EQ(all[9].close, 59.0);
+    EXPECT_DOUBLE_EQ(all[10].close, 60.0);
+}
+
+TEST_F(BarJournalTest, RefetchedBarSupersedesOlderBarIsDropped) {
+    BarJournal journal(directory);
+    ASSERT_TRUE(journal.open());
+    ASSERT_TRUE(journal.append(bar(0, 10.0)));
+    ASSERT_TRUE(journal.append(bar(1, 11.0)));
+    ASSERT_TRUE(journal.append(bar(1, 11.5)));  // Same bar, still forming
+    ASSERT_TRUE(journal.append(bar(0, 9.0)));   // Older than the newest
+
+    EXPECT_EQ(journal.size("TEST_JOURNAL"), 3u);
+    auto all = journal.range("TEST_JOURNAL", start, start + minutes(1));
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_DOUBLE_EQ(all[0].close, 10.0);
+    EXPECT_DOUBLE_EQ(all[1].close, 11.5);
+    auto recent = journal.latest("TEST_JOURNAL", 1);
+    ASSERT_EQ(recent.size(), 1u);
+    EXPECT_DOUBLE_EQ(recent[0].close, 11.5);
+}
+
+TEST_F(BarJournalTest, EnablingImportsStoredBarsOnce) {
+    std::string path = directory + ".db";
+    {
+        DatabaseManager db(path);
+        ASSERT_TRUE(db.initialize());
+        for (int i = 0; i < 5; ++i) {
+            ASSERT_TRUE(db.insertMarketData(bar(i, 20.0 + i)));
+        }
+        ASSERT_TRUE(db.enableBarJournal(directory));
+        EXPECT_EQ(db.barJournal()->size("TEST_JOURNAL"), 5u);
+        EXPECT_EQ(db.getMarketData("TEST_JOURNAL", 10).size(), 5u);
+    }
+    {
+        // Already has bars: not imported again
+        DatabaseManager db(path);
+        ASSERT_TRUE(db.initialize());
+        ASSERT_TRUE(db.enableBarJournal(directory));
+        EXPECT_EQ(db.barJournal()->size("TEST_JOURNAL"), 5u);
+    }
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((path + suffix).c_str());
+    }
+}
+
+} // namespace
+} // namespace TradingSystem
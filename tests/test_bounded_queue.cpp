@@ -0,0 +1,86 @@
+#include "common/bounded_queue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TradingSystem {
+namespace {
+
+TEST(BoundedQueueTest, CapacityRoundsUpToPowerOfTwo) {
+    BoundedQueue<int> queue(5);
+    EXPECT_EQ(queue.capacity(), 8u);
+}
+
+TEST(BoundedQueueTest, FifoAndFullEmpty) {
+    BoundedQueue<int> queue(4);
+    int value = 0;
+    EXPECT_FALSE(queue.tryPop(value));
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(i));
+    }
+    EXPECT_FALSE(queue.tryPush(99));
+    EXPECT_EQ(queue.sizeApprox(), 4u);
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(BoundedQueueTest, WrapsAroundManyTimes) {
+    BoundedQueue<std::string> queue(2);
+    std::string out;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(queue.tryPush(std::to_string(i)));
+        ASSERT_TRUE(queue.tryPop(out));
+        EXPECT_EQ(out, std::to_string(i));
+    }
+}
+
+TEST(BoundedQueueTest, ConcurrentProducersAndConsumersLoseNothing) {
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 4;
+    constexpr int kPerProducer = 20000;
+    BoundedQueue<int> queue(256);
+
+    std::atomic<long long> sum{0};
+    std::atomic<int> popped{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&queue, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                int value = p * kPerProducer + i;
+                while (!queue.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&] {
+            int value;
+            while (popped.load() < kProducers * kPerProducer) {
+                if (queue.tryPop(value)) {
+                    sum += value;
+                    ++popped;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    long long n = static_cast<long long>(kProducers) * kPerProducer;
+    EXPECT_EQ(popped.load(), n);
+    EXPECT_EQ(sum.load(), n * (n - 1) / 2);
+}
+
+} // namespace
+} // namespace TradingSystem
@@ -0,0 +1,84 @@
+#include "config/config_manager.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+namespace TradingSystem {
+namespace {
+
+// ConfigManager is a process-wide singleton; each case loads its own file
+class ConfigReloadTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = "trading_tests_config_" + std::to_string(getpid()) + ".ini";
+        write("max_position_size = 5000\nmax_drawdown = 0.2\n");
+        ASSERT_TRUE(ConfigManager::getInstance().loadConfig(path));
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    void write(const std::string& trading_section) {
+        std::ofstream file(path, std::ios::trunc);
+        file << "[trading]\n" << trading_section;
+    }
+
+    std::string path;
+};
+
+TEST_F(ConfigReloadTest, ValidReloadPublishesNewSnapshot) {
+    auto before = ConfigManager::getInstance().snapshot();
+    write("max_position_size = 7500\nmax_drawdown = 0.1\n");
+    ASSERT_TRUE(ConfigManager::getInstance().reload());
+
+    auto after = ConfigManager::getInstance().snapshot();
+    EXPECT_NE(after, before);
+    EXPECT_DOUBLE_EQ(after->max_position_size, 7500.0);
+    EXPECT_DOUBLE_EQ(after->max_drawdown, 0.1);
+    // Readers holding the old snapshot still see the old values
+    EXPECT_DOUBLE_EQ(before->max_position_size, 5000.0);
+}
+
+TEST_F(ConfigReloadTest, TrailingGarbageRejectsWholeReload) {
+    auto before = ConfigManager::getInstance().snapshot();
+    // The good drawdown must not be applied alongside the bad size
+    write("max_position_size = 1,000\nmax_drawdown = 0.1\n");
+    EXPECT_FALSE(ConfigManager::getInstance().reload());
+
+    EXPECT_EQ(ConfigManager::getInstance().snapshot(), before);
+    EXPECT_DOUBLE_EQ(ConfigManager::getInstance().getDouble("trading", "max_drawdown"), 0.2);
+}
+
+TEST_F(ConfigReloadTest, NonNumericRejectsWholeReload) {
+    auto before = ConfigManager::getInstance().snapshot();
+    write("max_position_size = abc\n");
+    EXPECT_FALSE(ConfigManager::getInstance().reload());
+    EXPECT_EQ(ConfigManager::getInstance().snapshot(), before);
+}
+
+TEST_F(ConfigReloadTest, OutOfRangeLimitRejectsWholeReload) {
+    auto before = ConfigManager::getInstance().snapshot();
+    for (const char* bad : {"max_position_size = -5000\n", "max_position_size = 0\n",
+                            "max_drawdown = 1.5\n", "stop_loss_percentage = 0\n"}) {
+        write(bad);
+        EXPECT_FALSE(ConfigManager::getInstance().reload()) << bad;
+        EXPECT_EQ(ConfigManager::getInstance().snapshot(), before) << bad;
+    }
+}
+
+TEST_F(ConfigReloadTest, GettersRejectTrailingGarbage) {
+    ConfigManager& config = ConfigManager::getInstance();
+    config.setString("test", "count", "12abc");
+    config.setString("test", "ratio", "0.5x");
+    EXPECT_EQ(config.getInt("test", "count", 7), 7);
+    EXPECT_DOUBLE_EQ(config.getDouble("test", "ratio", 0.25), 0.25);
+
+    config.setString("test", "count", "12");
+    EXPECT_EQ(config.getInt("test", "count", 7), 12);
+}
+
+} // namespace
+} // namespace TradingSystem
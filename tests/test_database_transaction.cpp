@@ -0,0 +1,123 @@
+#include "database/database_manager.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+namespace TradingSystem {
+namespace {
+
+class DatabaseTransactionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = "trading_tests_tx_" + std::to_string(getpid()) + ".db";
+        std::remove(path.c_str());
+        db = std::make_unique<DatabaseManager>(path);
+        ASSERT_TRUE(db->initialize());
+    }
+
+    void TearDown() override {
+        db.reset();
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::remove((path + suffix).c_str());
+        }
+    }
+
+    bool insertSignal(const std::string& symbol) {
+        TradingSignal signal;
+        signal.symbol = symbol;
+        signal.action = SignalAction::BUY;
+        signal.confidence = 0.5;
+        signal.timestamp = std::chrono::system_clock::now();
+        return db->insertTradingSignal(signal);
+    }
+
+    size_t signalCount() { return db->getLatestSignals(100).size(); }
+
+    std::string path;
+    std::unique_ptr<DatabaseManager> db;
+};
+
+TEST_F(DatabaseTransactionTest, CommitPersists) {
+    {
+        DatabaseManager::Transaction tx(*db);
+        ASSERT_TRUE(insertSignal("AAPL"));
+        EXPECT_TRUE(tx.commit());
+    }
+    EXPECT_EQ(signalCount(), 1u);
+}
+
+TEST_F(DatabaseTransactionTest, ScopeWithoutCommitRollsBack) {
+    {
+        DatabaseManager::Transaction tx(*db);
+        ASSERT_TRUE(insertSignal("AAPL"));
+    }
+    EXPECT_EQ(signalCount(), 0u);
+}
+
+TEST_F(DatabaseTransactionTest, NestedCommitsCommitTogether) {
+    {
+        DatabaseManager::Transaction outer(*db);
+        ASSERT_TRUE(insertSignal("AAPL"));
+        {
+            DatabaseManager::Transaction inner(*db);
+            ASSERT_TRUE(insertSignal("MSFT"));
+            EXPECT_TRUE(inner.commit());
+        }
+        EXPECT_TRUE(outer.commit());
+    }
+    EXPECT_EQ(signalCount(), 2u);
+}
+
+TEST_F(DatabaseTransactionTest, InnerRollbackAbortsOuterCommit) {
+    {
+        DatabaseManager::Transaction outer(*db);
+        ASSERT_TRUE(insertSignal("AAPL"));
+        {
+            DatabaseManager::Transaction inner(*db);
+            ASSERT_TRUE(insertSignal("MSFT"));
+            inner.rollback();
+        }
+        EXPECT_FALSE(outer.commit());
+    }
+    EXPECT_EQ(signalCount(), 0u);
+}
+
+TEST_F(DatabaseTransactionTest, InnerScopeLeftWithoutCommitAbortsOuter) {
+    {
+        DatabaseManager::Transaction outer(*db);
+        ASSERT_TRUE(insertSignal("AAPL"));
+        {
+            DatabaseManager::Transaction inner(*db);
+            ASSERT_TRUE(insertSignal("MSFT"));
+        }
+        {
+            // A later sibling cannot commit either
+            DatabaseManager::Transaction sibling(*db);
+            EXPECT_FALSE(sibling.commit());
+        }
+        EXPECT_FALSE(outer.commit());
+    }
+    EXPECT_EQ(signalCount(), 0u);
+}
+
+TEST_F(DatabaseTransactionTest, NextTransactionStartsClean) {
+    {
+        DatabaseManager::Transaction outer(*db);
+        {
+            DatabaseManager::Transaction inner(*db);
+            inner.rollback();
+        }
+        EXPECT_FALSE(outer.commit());
+    }
+    {
+        DatabaseManager::Transaction tx(*db);
+        ASSERT_TRUE(insertSignal("AAPL"));
+        EXPECT_TRUE(tx.commit());
+    }
+    EXPECT_EQ(signalCount(), 1u);
+}
+
+} // namespace
+} // namespace TradingSystem
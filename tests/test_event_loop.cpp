@@ -0,0 +1,186 @@
+#include "core/event_loop.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <sys/epoll.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace TradingSystem {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+class EventLoopTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(loop.isValid());
+        // Backstop so a broken case fails instead of hanging
+        watchdog = loop.addTimer(5000, 0, [this] {
+            timed_out = true;
+            loop.stop();
+        });
+        ASSERT_GE(watchdog, 0);
+    }
+
+    void TearDown() override {
+        EXPECT_FALSE(timed_out);
+    }
+
+    static long elapsedMs(Clock::time_point since) {
+        return static_cast<long>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - since).count());
+    }
+
+    EventLoop loop;
+    EventLoop::TimerId watchdog = -1;
+    bool timed_out = false;
+};
+
+TEST_F(EventLoopTest, OneShotTimerFiresOnceAfterItsDelay) {
+    auto start = Clock::now();
+    long fired_after = -1;
+    int fired = 0;
+    EventLoop::TimerId timer = loop.addTimer(30, 0, [&] {
+        ++fired;
+        fired_after = elapsedMs(start);
+    });
+    ASSERT_GE(timer, 0);
+    loop.addTimer(100, 0, [&] { loop.stop(); });
+    loop.run();
+
+    EXPECT_EQ(fired, 1);
+    EXPECT_GE(fired_after, 30);
+    // A fired one-shot timer is gone
+    EXPECT_FALSE(loop.cancelTimer(timer));
+}
+
+TEST_F(EventLoopTest, ZeroDelayFiresImmediately) {
+    bool fired = false;
+    loop.addTimer(0, 0, [&] {
+        fired = true;
+        loop.stop();
+    });
+    auto start = Clock::now();
+    loop.run();
+    EXPECT_TRUE(fired);
+    EXPECT_LT(elapsedMs(start), 1000);
+}
+
+TEST_F(EventLoopTest, TimersFireInDeadlineOrder) {
+    std::vector<int> order;
+    loop.addTimer(90, 0, [&] {
+        order.push_back(90);
+        loop.stop();
+    });
+    loop.addTimer(10, 0, [&] { order.push_back(10); });
+    loop.addTimer(50, 0, [&] { order.push_back(50); });
+    loop.run();
+    EXPECT_EQ(order, (std::vector<int>{10, 50, 90}));
+}
+
+TEST_F(EventLoopTest, RepeatingTimerCanCancelItself) {
+    int fired = 0;
+    EventLoop::TimerId timer = -1;
+    timer = loop.addTimer(5, 5, [&] {
+        if (++fired == 3) {
+            EXPECT_TRUE(loop.cancelTimer(timer));
+            // Give a fourth expiry the chance to show up
+            loop.addTimer(30, 0, [&] { loop.stop(); });
+        }
+    });
+    loop.run();
+    EXPECT_EQ(fired, 3);
+}
+
+TEST_F(EventLoopTest, CancelledTimerNeverRuns) {
+    bool fired = false;
+    EventLoop::TimerId timer = loop.addTimer(10, 0, [&] { fired = true; });
+    EXPECT_TRUE(loop.cancelTimer(timer));
+    EXPECT_FALSE(loop.cancelTimer(timer));
+    loop.addTimer(40, 0, [&] { loop.stop(); });
+    loop.run();
+    EXPECT_FALSE(fired);
+}
+
+TEST_F(EventLoopTest, TimerCancelledByAnEarlierCallbackInTheSameWakeup) {
+    // Both expire before the loop first waits, so they arrive in one batch
+    int fired = 0;
+    EventLoop::TimerId second = -1;
+    EventLoop::TimerId first = loop.addTimer(10, 0, [&] {
+        ++fired;
+        loop.cancelTimer(second);
+    });
+    second = loop.addTimer(10, 0, [&] {
+        ++fired;
+        loop.cancelTimer(first);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    loop.addTimer(30, 0, [&] { loop.stop(); });
+    loop.run();
+    EXPECT_EQ(fired, 1);
+}
+
+TEST_F(EventLoopTest, PostedWorkRunsOnTheLoopThread) {
+    std::thread::id loop_thread;
+    std::thread::id ran_on;
+    std::thread loop_runner([&] {
+        loop_thread = std::this_thread::get_id();
+        loop.run();
+    });
+
+    int ran = 0;
+    std::thread poster([&] {
+        for (int i = 0; i < 100; ++i) {
+            loop.post([&] {
+                ++ran;
+                ran_on = std::this_thread::get_id();
+            });
+        }
+        loop.post([&] { loop.stop(); });
+    });
+    poster.join();
+    loop_runner.join();
+
+    EXPECT_EQ(ran, 100);
+    EXPECT_EQ(ran_on, loop_thread);
+}
+
+TEST_F(EventLoopTest, StopFromAnotherThreadWakesTheLoop) {
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        loop.stop();
+    });
+    auto start = Clock::now();
+    loop.run();
+    stopper.join();
+    EXPECT_TRUE(loop.isStopping());
+    EXPECT_LT(elapsedMs(start), 1000);
+}
+
+TEST_F(EventLoopTest, WatchedFdDeliversReadiness) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    std::string received;
+    ASSERT_TRUE(loop.watchFd(fds[0], EPOLLIN, [&](uint32_t events) {
+        EXPECT_TRUE(events & EPOLLIN);
+        char buf[16];
+        ssize_t n = ::read(fds[0], buf, sizeof(buf));
+        if (n > 0) received.append(buf, static_cast<size_t>(n));
+        EXPECT_TRUE(loop.unwatchFd(fds[0]));
+        loop.stop();
+    }));
+    loop.addTimer(10, 0, [&] {
+        ssize_t n = ::write(fds[1], "tick", 4);
+        EXPECT_EQ(n, 4);
+    });
+    loop.run();
+    EXPECT_EQ(received, "tick");
+    EXPECT_FALSE(loop.unwatchFd(fds[0]));
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+} // namespace
+} // namespace TradingSystem
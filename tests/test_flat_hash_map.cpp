@@ -0,0 +1,95 @@
+#include "common/flat_hash_map.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <map>
+#include <random>
+
+namespace TradingSystem {
+namespace {
+
+TEST(FlatHashMapTest, InsertFindErase) {
+    FlatHashMap<uint32_t, int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(7), nullptr);
+
+    map[7] = 70;
+    map[9] = 90;
+    ASSERT_NE(map.find(7), nullptr);
+    EXPECT_EQ(*map.find(7), 70);
+    EXPECT_TRUE(map.contains(9));
+    EXPECT_EQ(map.size(), 2u);
+
+    EXPECT_TRUE(map.erase(7));
+    EXPECT_FALSE(map.erase(7));
+    EXPECT_FALSE(map.contains(7));
+    EXPECT_TRUE(map.contains(9));
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(FlatHashMapTest, OperatorBracketDefaultsNewEntries) {
+    FlatHashMap<uint64_t, double> map;
+    EXPECT_EQ(map[42], 0.0);
+    map[42] += 1.5;
+    EXPECT_EQ(map[42], 1.5);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(FlatHashMapTest, GrowsPastInitialCapacity) {
+    FlatHashMap<uint32_t, uint32_t> map(4);
+    for (uint32_t i = 0; i < 1000; ++i) {
+        map[i] = i * 3;
+    }
+    EXPECT_EQ(map.size(), 1000u);
+    EXPECT_GE(map.capacity(), 1000u);
+    for (uint32_t i = 0; i < 1000; ++i) {
+        ASSERT_NE(map.find(i), nullptr);
+        EXPECT_EQ(*map.find(i), i * 3);
+    }
+}
+
+TEST(FlatHashMapTest, MatchesStdMapUnderRandomChurn) {
+    // Backward-shift erase must keep every probe run reachable
+    FlatHashMap<uint32_t, uint32_t> map(8);
+    std::map<uint32_t, uint32_t> reference;
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<uint32_t> key(0, 255);
+
+    for (int step = 0; step < 20000; ++step) {
+        uint32_t k = key(rng);
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(map.erase(k), reference.erase(k) == 1);
+        } else {
+            map[k] = static_cast<uint32_t>(step);
+            reference[k] = static_cast<uint32_t>(step);
+        }
+    }
+
+    ASSERT_EQ(map.size(), reference.size());
+    for (const auto& [k, v] : reference) {
+        ASSERT_NE(map.find(k), nullptr) << "key " << k;
+        EXPECT_EQ(*map.find(k), v);
+    }
+    size_t iterated = 0;
+    for (const auto& entry : map) {
+        EXPECT_EQ(reference.at(entry.first), entry.second);
+        ++iterated;
+    }
+    EXPECT_EQ(iterated, reference.size());
+}
+
+TEST(FlatHashMapTest, ClearKeepsCapacity) {
+    FlatHashMap<uint32_t, int> map;
+    for (uint32_t i = 0; i < 100; ++i) {
+        map[i] = 1;
+    }
+    size_t capacity = map.capacity();
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.capacity(), capacity);
+    EXPECT_FALSE(map.contains(5));
+    map[5] = 2;
+    EXPECT_EQ(*map.find(5), 2);
+}
+
+} // namespace
+} // namespace TradingSystem
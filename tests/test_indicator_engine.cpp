@@ -0,0 +1,169 @@
+#include "analysis/indicator_engine.h"
+#include "analysis/simd_kernels.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TradingSystem {
+namespace {
+
+// Replays one fixed bar series through IndicatorEngine and checks every bar
+// against the batch kernels, which follow calculate_technical_indicators,
+// and against prepare_features built from those columns
+class IndicatorEngineTest : public ::testing::Test {
+protected:
+    static constexpr size_t kBars = 160;
+
+    void SetUp() override {
+        // A random walk broken by a flat run (no gains or losses: RSI is
+        // NaN) and a steady climb (no losses: RSI is 100)
+        std::mt19937 rng(20240611);
+        double close = 100.0;
+        for (size_t i = 0; i < kBars; ++i) {
+            if (i >= 40 && i < 60) {
+                // flat
+            } else if (i >= 60 && i < 80) {
+                close += 0.25;
+            } else {
+                close *= 1.0 + (static_cast<int>(rng() % 2001) - 1000) / 50000.0;
+            }
+            double range = close * (rng() % 100) / 10000.0;
+            double volume = 1000.0 + rng() % 5000;
+            series.append(close, close + range, close - range, close, volume,
+                          static_cast<int64_t>(i) * 86400LL * 1000000000LL);
+        }
+        computeIndicators(series, columns);
+    }
+
+    static void expectSame(double incremental, double batch, const char* field, size_t bar) {
+        if (std::isnan(batch)) {
+            EXPECT_TRUE(std::isnan(incremental)) << field << " at bar " << bar << ": " << incremental;
+            return;
+        }
+        double tolerance = 1e-9 * std::max(1.0, std::fabs(batch));
+        EXPECT_NEAR(incremental, batch, tolerance) << field << " at bar " << bar;
+    }
+
+    // prepare_features' std of the one-bar changes over the last 30 bars
+    double batchVolatility(size_t bar) const {
+        const size_t window = IndicatorEngine::kVolatilityWindow;
+        size_t first = bar >= window ? bar + 1 - window : 1;
+        size_t count = bar + 1 - first;
+        if (count < 2) return std::nan("");
+        double mean = 0.0;
+        for (size_t i = first; i <= bar; ++i) mean += columns.price_change[i];
+        mean /= count;
+        double m2 = 0.0;
+        for (size_t i = first; i <= bar; ++i) {
+            double d = columns.price_change[i] - mean;
+            m2 += d * d;
+        }
+        return std::sqrt(m2 / (count - 1));
+    }
+
+    // prepare_features applied to row `bar` of the batch columns
+    IndicatorEngine::FeatureVector batchFeatures(size_t bar) const {
+        double close = series.close()[bar];
+        double high = series.high()[bar];
+        double low = series.low()[bar];
+        double sma_20 = columns.sma_20[bar];
+        double sma_5 = columns.sma_5[bar];
+        double bb_upper = sma_20 + 2.0 * columns.std_20[bar];
+        double bb_lower = sma_20 - 2.0 * columns.std_20[bar];
+        double rsi = columns.rsi_14[bar];
+        double volume_ratio = series.volume()[bar] / columns.volume_sma_20[bar];
+
+        IndicatorEngine::FeatureVector f;
+        f[0] = sma_20 > 0 ? close / sma_20 : 1.0;
+        f[1] = sma_5 > 0 ? close / sma_5 : 1.0;
+        f[2] = high > low ? (close - low) / (high - low) : 0.5;
+        f[3] = std::isnan(rsi) ? 0.5 : rsi / 100.0;
+        f[4] = close > 0 ? columns.macd[bar] / close : 0.0;
+        f[5] = bb_upper > bb_lower ? (close - bb_lower) / (bb_upper - bb_lower) : 0.5;
+        f[6] = std::isnan(volume_ratio) ? 1.0 : volume_ratio;
+        f[7] = std::isnan(columns.price_change[bar]) ? 0.0 : columns.price_change[bar];
+        f[8] = std::isnan(columns.price_change_5d[bar]) ? 0.0 : columns.price_change_5d[bar];
+        double volatility = batchVolatility(bar);
+        f[9] = std::isnan(volatility) ? 0.0 : volatility;
+        return f;
+    }
+
+    BarSeries series{"TEST_INDICATORS"};
+    IndicatorColumns columns;
+};
+
+TEST_F(IndicatorEngineTest, EveryBarMatchesTheBatchKernels) {
+    IndicatorEngine engine;
+    SymbolId id = SymbolTable::getInstance().intern("TEST_INDICATORS");
+    for (size_t i = 0; i < kBars; ++i) {
+        engine.update(id, series.high()[i], series.low()[i], series.close()[i], series.volume()[i]);
+
+        IndicatorSnapshot snap;
+        ASSERT_TRUE(engine.snapshot(id, snap));
+        ASSERT_EQ(snap.bars, i + 1);
+        expectSame(snap.sma_5, columns.sma_5[i], "sma_5", i);
+        expectSame(snap.sma_20, columns.sma_20[i], "sma_20", i);
+        expectSame(snap.ema_12, columns.ema_12[i], "ema_12", i);
+        expectSame(snap.ema_26, columns.ema_26[i], "ema_26", i);
+        expectSame(snap.macd, columns.macd[i], "macd", i);
+        expectSame(snap.macd_signal, columns.macd_signal[i], "macd_signal", i);
+        expectSame(snap.rsi, columns.rsi_14[i], "rsi", i);
+        expectSame(snap.bb_middle, columns.sma_20[i], "bb_middle", i);
+        expectSame(snap.bb_upper, columns.sma_20[i] + 2.0 * columns.std_20[i], "bb_upper", i);
+        expectSame(snap.bb_lower, columns.sma_20[i] - 2.0 * columns.std_20[i], "bb_lower", i);
+        expectSame(snap.volume_sma, columns.volume_sma_20[i], "volume_sma", i);
+        expectSame(snap.volume_ratio, series.volume()[i] / columns.volume_sma_20[i], "volume_ratio", i);
+        expectSame(snap.price_change, columns.price_change[i], "price_change", i);
+        expectSame(snap.price_change_5d, columns.price_change_5d[i], "price_change_5d", i);
+        expectSame(snap.volatility, batchVolatility(i), "volatility", i);
+
+        IndicatorEngine::FeatureVector features;
+        if (i + 1 < IndicatorEngine::kMinBars) {
+            EXPECT_FALSE(engine.features(id, features)) << "bar " << i;
+            continue;
+        }
+        ASSERT_TRUE(engine.features(id, features)) << "bar " << i;
+        IndicatorEngine::FeatureVector expected = batchFeatures(i);
+        for (size_t f = 0; f < IndicatorEngine::kFeatureCount; ++f) {
+            expectSame(features[f], expected[f], ("feature " + std::to_string(f)).c_str(), i);
+        }
+    }
+}
+
+TEST_F(IndicatorEngineTest, RsiEdgesAreCoveredBySeries) {
+    // The flat run leaves every 14-bar window from bar 54 to 59 without
+    // moves, the climb leaves bars 74 to 79 without losses
+    for (size_t i = 54; i < 60; ++i) {
+        EXPECT_TRUE(std::isnan(columns.rsi_14[i])) << "bar " << i;
+    }
+    for (size_t i = 74; i < 80; ++i) {
+        EXPECT_DOUBLE_EQ(columns.rsi_14[i], 100.0) << "bar " << i;
+    }
+    for (size_t i = 0; i < 13; ++i) {
+        EXPECT_TRUE(std::isnan(columns.rsi_14[i])) << "bar " << i;
+    }
+}
+
+TEST_F(IndicatorEngineTest, WarmUpMatchesBarByBarUpdates) {
+    IndicatorEngine stepped;
+    IndicatorEngine warmed;
+    SymbolId id = series.symbolId();
+    for (size_t i = 0; i < kBars; ++i) {
+        stepped.update(id, series.high()[i], series.low()[i], series.close()[i], series.volume()[i]);
+    }
+    warmed.warmUp(series);
+
+    IndicatorEngine::FeatureVector a;
+    IndicatorEngine::FeatureVector b;
+    ASSERT_TRUE(stepped.features(id, a));
+    ASSERT_TRUE(warmed.features(id, b));
+    for (size_t f = 0; f < IndicatorEngine::kFeatureCount; ++f) {
+        EXPECT_DOUBLE_EQ(a[f], b[f]) << "feature " << f;
+    }
+}
+
+} // namespace
+} // namespace TradingSystem
@@ -0,0 +1,102 @@
+#include "metrics/latency_histogram.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+
+namespace TradingSystem {
+namespace {
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (uint64_t v = 0; v < LatencyHistogram::kSubBucketCount; ++v) {
+        histogram.record(v);
+    }
+    EXPECT_EQ(histogram.count(), 256u);
+    EXPECT_EQ(histogram.max(), 255u);
+    EXPECT_EQ(histogram.valueAtQuantile(0.0), 0u);
+    EXPECT_EQ(histogram.valueAtQuantile(0.5), 127u);
+    EXPECT_EQ(histogram.valueAtQuantile(1.0), 255u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 127.5);
+}
+
+TEST(LatencyHistogramTest, BucketsCoverEveryValueWithinOnePercent) {
+    // Every bucket's top maps back to the bucket, and any value sits in a
+    // bucket whose top is at most 1/128 above it
+    for (size_t i = 0; i <= LatencyHistogram::bucketIndex(LatencyHistogram::kMaxTrackableNs); ++i) {
+        uint64_t top = LatencyHistogram::highestEquivalentValue(i);
+        ASSERT_EQ(LatencyHistogram::bucketIndex(top), i) << "bucket " << i;
+        ASSERT_EQ(LatencyHistogram::bucketIndex(top + 1), i + 1) << "bucket " << i;
+    }
+    EXPECT_LT(LatencyHistogram::bucketIndex(LatencyHistogram::kMaxTrackableNs), LatencyHistogram::kBucketCount);
+
+    const uint64_t values[] = {256, 257, 1000, 65535, 65536, 1234567, 987654321,
+                               LatencyHistogram::kMaxTrackableNs};
+    for (uint64_t v : values) {
+        uint64_t top = LatencyHistogram::highestEquivalentValue(LatencyHistogram::bucketIndex(v));
+        EXPECT_GE(top, v);
+        EXPECT_LE(static_cast<double>(top - v), static_cast<double>(v) / 128.0) << v;
+    }
+}
+
+TEST(LatencyHistogramTest, QuantilesOfUniformValues) {
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 100000; ++v) {
+        histogram.record(v);
+    }
+
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+        double expected = q * 100000.0;
+        double actual = static_cast<double>(histogram.valueAtQuantile(q));
+        EXPECT_GE(actual, expected) << q;
+        EXPECT_LE(actual, expected * 1.01) << q;
+    }
+    EXPECT_EQ(histogram.valueAtQuantile(0.0), 1u);
+    EXPECT_EQ(histogram.valueAtQuantile(1.0), 100000u);
+    // Out-of-range quantiles are clamped
+    EXPECT_EQ(histogram.valueAtQuantile(-1.0), 1u);
+    EXPECT_EQ(histogram.valueAtQuantile(2.0), 100000u);
+}
+
+TEST(LatencyHistogramTest, TopQuantileNeverExceedsMax) {
+    LatencyHistogram histogram;
+    histogram.record(1000);
+    histogram.record(100001);
+    // 100001's bucket reaches 100351; the recorded max is tighter
+    EXPECT_EQ(histogram.valueAtQuantile(1.0), 100001u);
+    EXPECT_EQ(histogram.valueAtQuantile(0.5), LatencyHistogram::highestEquivalentValue(
+                                                  LatencyHistogram::bucketIndex(1000)));
+}
+
+TEST(LatencyHistogramTest, EmptyHistogramReportsZero) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.valueAtQuantile(0.99), 0u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 0.0);
+}
+
+TEST(LatencyHistogramTest, ValuesPastTheRangeAreClamped) {
+    LatencyHistogram histogram;
+    histogram.record(LatencyHistogram::kMaxTrackableNs * 4);
+    EXPECT_EQ(histogram.max(), LatencyHistogram::kMaxTrackableNs);
+    EXPECT_EQ(histogram.valueAtQuantile(1.0), LatencyHistogram::kMaxTrackableNs);
+}
+
+TEST(LatencyHistogramTest, MergeAddsCountsAndResetClears) {
+    LatencyHistogram a;
+    LatencyHistogram b;
+    for (uint64_t v = 1; v <= 100; ++v) a.record(v);
+    for (uint64_t v = 101; v <= 200; ++v) b.record(v);
+
+    a.mergeFrom(b);
+    EXPECT_EQ(a.count(), 200u);
+    EXPECT_EQ(a.sum(), 200u * 201u / 2);
+    EXPECT_EQ(a.max(), 200u);
+    EXPECT_EQ(a.valueAtQuantile(0.5), 100u);
+    EXPECT_EQ(b.count(), 100u);
+
+    a.reset();
+    EXPECT_EQ(a.count(), 0u);
+    EXPECT_EQ(a.max(), 0u);
+    EXPECT_EQ(a.valueAtQuantile(0.5), 0u);
+}
+
+} // namespace
+} // namespace TradingSystem
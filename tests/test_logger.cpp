@@ -0,0 +1,194 @@
+#include "logging/logger.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <regex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace TradingSystem {
+namespace {
+
+TEST(LogRingTest, FullRingRefusesUntilReleased) {
+    LogRing ring(4096);
+    ASSERT_EQ(ring.capacity(), 4096u);
+
+    size_t written = 0;
+    while (char* out = ring.reserve(64)) {
+        std::memset(out, 0, 64);
+        uint32_t size = 64;
+        std::memcpy(out, &size, sizeof(size));
+        ring.commit(64);
+        ++written;
+    }
+    EXPECT_EQ(written, 4096u / 64);
+    EXPECT_EQ(ring.reserve(8), nullptr);
+
+    const char* record = ring.peek();
+    ASSERT_NE(record, nullptr);
+    ring.release(64);
+    EXPECT_NE(ring.reserve(64), nullptr);
+}
+
+TEST(LogRingTest, RecordsNeverStraddleTheEnd) {
+    LogRing ring(4096);
+    // Leave 1000 bytes at the end, then ask for more than that
+    for (size_t used = 0; used < 3096; used += 8) {
+        char* out = ring.reserve(8);
+        ASSERT_NE(out, nullptr);
+        uint32_t size = 8;
+        std::memcpy(out, &size, sizeof(size));
+        ring.commit(8);
+    }
+    while (const char* record = ring.peek()) {
+        (void)record;
+        ring.release(8);
+    }
+
+    char* out = ring.reserve(1500);
+    ASSERT_NE(out, nullptr);
+    uint32_t size = 1500;
+    std::memcpy(out, &size, sizeof(size));
+    ring.commit(1500);
+    const char* record = ring.peek();
+    ASSERT_EQ(record, out);
+    EXPECT_EQ(record, ring.peek());
+    ring.release(1500);
+    EXPECT_TRUE(ring.empty());
+}
+
+// The logger is a process-wide singleton; every case points it at its own
+// file and logs from a fresh thread, so the thread's ring is created with
+// the options under test
+class LoggerOverflowTest : public ::testing::Test {
+protected:
+    static constexpr int kRecords = 20000;
+
+    void SetUp() override {
+        path = "trading_tests_log_" + std::to_string(getpid()) + ".log";
+        std::remove(path.c_str());
+        Logger& logger = Logger::getInstance();
+        logger.setConsoleOutput(false);
+        logger.initialize(path, LogLevel::INFO);
+        dropped_before = logger.droppedCount();
+    }
+
+    void TearDown() override {
+        Logger& logger = Logger::getInstance();
+        logger.stopAsync();
+        logger.setConsoleOutput(true);
+        std::remove(path.c_str());
+    }
+
+    static void burst(int records) {
+        std::thread([records] {
+            for (int i = 0; i < records; ++i) {
+                LOG_FAST(LogLevel::INFO, "overflow record {}", i);
+            }
+        }).join();
+    }
+
+    // Indices of the burst records in the file, and the sum of the loss
+    // reports the writer added
+    void readBack(std::vector<int>& indices, uint64_t& reported) {
+        Logger::getInstance().stopAsync();
+        std::ifstream file(path);
+        std::string line;
+        std::regex record(R"(overflow record (\d+)$)");
+        std::regex report(R"(Logger dropped (\d+) records)");
+        std::smatch match;
+        while (std::getline(file, line)) {
+            if (std::regex_search(line, match, record)) {
+                indices.push_back(std::stoi(match[1]));
+            } else if (std::regex_search(line, match, report)) {
+                reported += std::stoull(match[1]);
+            }
+        }
+    }
+
+    static AsyncLogOptions options(LogOverflowPolicy policy, int idle_wait_ms) {
+        AsyncLogOptions opts;
+        opts.ring_bytes = 4096;
+        opts.overflow = policy;
+        opts.idle_wait_ms = idle_wait_ms;
+        return opts;
+    }
+
+    static bool increasing(const std::vector<int>& indices) {
+        for (size_t i = 1; i < indices.size(); ++i) {
+            if (indices[i] <= indices[i - 1]) return false;
+        }
+        return true;
+    }
+
+    std::string path;
+    uint64_t dropped_before = 0;
+};
+
+TEST_F(LoggerOverflowTest, DropDiscardsSilently) {
+    // A long idle wait keeps the writer parked while the burst fills the ring
+    Logger::getInstance().startAsync(options(LogOverflowPolicy::DROP, 1000));
+    burst(kRecords);
+    uint64_t dropped = Logger::getInstance().droppedCount() - dropped_before;
+
+    std::vector<int> indices;
+    uint64_t reported = 0;
+    readBack(indices, reported);
+    EXPECT_GT(dropped, 0u);
+    EXPECT_EQ(indices.size() + dropped, static_cast<size_t>(kRecords));
+    EXPECT_EQ(reported, 0u);
+    EXPECT_TRUE(increasing(indices));
+}
+
+TEST_F(LoggerOverflowTest, CountReportsEveryLostRecord) {
+    Logger::getInstance().startAsync(options(LogOverflowPolicy::COUNT, 1000));
+    burst(kRecords);
+
+    std::vector<int> indices;
+    uint64_t reported = 0;
+    readBack(indices, reported);
+    EXPECT_GT(reported, 0u);
+    EXPECT_EQ(indices.size() + reported, static_cast<size_t>(kRecords));
+    EXPECT_EQ(Logger::getInstance().droppedCount() - dropped_before, reported);
+    EXPECT_TRUE(increasing(indices));
+}
+
+TEST_F(LoggerOverflowTest, BlockLosesNothing) {
+    Logger::getInstance().startAsync(options(LogOverflowPolicy::BLOCK, 1));
+    burst(kRecords);
+
+    std::vector<int> indices;
+    uint64_t reported = 0;
+    readBack(indices, reported);
+    ASSERT_EQ(indices.size(), static_cast<size_t>(kRecords));
+    EXPECT_TRUE(increasing(indices));
+    EXPECT_EQ(Logger::getInstance().droppedCount(), dropped_before);
+}
+
+TEST_F(LoggerOverflowTest, OversizedRecordIsWrittenInOrder) {
+    Logger::getInstance().startAsync(options(LogOverflowPolicy::COUNT, 1));
+    std::string big(10000, 'x');
+    std::thread([&big] {
+        LOG_FAST(LogLevel::INFO, "overflow record {}", 0);
+        LOG_FAST(LogLevel::INFO, "oversized {}", big);
+        LOG_FAST(LogLevel::INFO, "overflow record {}", 1);
+    }).join();
+    Logger::getInstance().stopAsync();
+
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);) {
+        if (line.find("overflow record") != std::string::npos || line.find("oversized") != std::string::npos) {
+            lines.push_back(line);
+        }
+    }
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_NE(lines[0].find("overflow record 0"), std::string::npos);
+    EXPECT_NE(lines[1].find("oversized " + big), std::string::npos);
+    EXPECT_NE(lines[2].find("overflow record 1"), std::string::npos);
+}
+
+} // namespace
+} // namespace TradingSystem
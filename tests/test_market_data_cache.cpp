@@ -0,0 +1,154 @@
+#include "market_data/market_data_cache.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace TradingSystem {
+namespace {
+
+// Every field carries the same value, so a torn copy is easy to spot
+CachedBar barFor(int64_t k) {
+    CachedBar bar;
+    double v = static_cast<double>(k);
+    bar.open = v;
+    bar.high = v;
+    bar.low = v;
+    bar.close = v;
+    bar.volume = v;
+    bar.timestamp_ns = k;
+    return bar;
+}
+
+bool consistent(const CachedBar& bar) {
+    double v = static_cast<double>(bar.timestamp_ns);
+    return bar.open == v && bar.high == v && bar.low == v && bar.close == v && bar.volume == v;
+}
+
+TEST(MarketDataCacheTest, LatestReturnsNewestBar) {
+    MarketDataCache cache(0, 16);
+    CachedBar out;
+    EXPECT_FALSE(cache.latest(3, out));
+    EXPECT_EQ(cache.updateCount(3), 0u);
+
+    ASSERT_TRUE(cache.update(3, barFor(1)));
+    ASSERT_TRUE(cache.update(3, barFor(2)));
+    ASSERT_TRUE(cache.latest(3, out));
+    EXPECT_EQ(out.timestamp_ns, 2);
+    EXPECT_EQ(cache.updateCount(3), 2u);
+    EXPECT_FALSE(cache.latest(4, out));
+}
+
+TEST(MarketDataCacheTest, IdsOutsideCapacityAreRefused) {
+    MarketDataCache cache(4, 16);
+    CachedBar out;
+    EXPECT_FALSE(cache.update(16, barFor(1)));
+    EXPECT_FALSE(cache.latest(16, out));
+    EXPECT_EQ(cache.recent(16, &out, 1), 0u);
+    EXPECT_EQ(cache.updateCount(16), 0u);
+}
+
+TEST(MarketDataCacheTest, RecentIsOldestFirstAndBoundedByDepth) {
+    MarketDataCache cache(4, 16);
+    CachedBar out[8];
+    EXPECT_EQ(cache.recent(1, out, 8), 0u);
+
+    for (int64_t k = 1; k <= 2; ++k) cache.update(1, barFor(k));
+    ASSERT_EQ(cache.recent(1, out, 8), 2u);
+    EXPECT_EQ(out[0].timestamp_ns, 1);
+    EXPECT_EQ(out[1].timestamp_ns, 2);
+
+    // Wrap the ring: only the last four survive
+    for (int64_t k = 3; k <= 10; ++k) cache.update(1, barFor(k));
+    ASSERT_EQ(cache.recent(1, out, 8), 4u);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(out[i].timestamp_ns, static_cast<int64_t>(7 + i));
+    }
+    ASSERT_EQ(cache.recent(1, out, 2), 2u);
+    EXPECT_EQ(out[0].timestamp_ns, 9);
+    EXPECT_EQ(out[1].timestamp_ns, 10);
+}
+
+TEST(MarketDataCacheTest, LookupByNameUsesInternedId) {
+    MarketDataCache cache;
+    MarketData data;
+    data.symbol = "TEST_CACHE_NAME";
+    data.open = data.high = data.low = 10.0;
+    data.close = 12.5;
+    data.volume = 300.0;
+    data.timestamp = fromEpochNanos(1700000000LL * 1000000000LL);
+    ASSERT_TRUE(cache.update(data));
+
+    MarketData out;
+    ASSERT_TRUE(cache.latest("TEST_CACHE_NAME", out));
+    EXPECT_EQ(out.symbol, "TEST_CACHE_NAME");
+    EXPECT_DOUBLE_EQ(out.close, 12.5);
+    EXPECT_EQ(out.timestamp, data.timestamp);
+
+    double close = 0.0;
+    ASSERT_TRUE(cache.latestClose("TEST_CACHE_NAME", close));
+    EXPECT_DOUBLE_EQ(close, 12.5);
+    EXPECT_FALSE(cache.latestClose("TEST_CACHE_NEVER_SEEN", close));
+}
+
+TEST(MarketDataCacheTest, ReadersNeverSeeTornOrStaleBars) {
+    constexpr int64_t kUpdates = 200000;
+    MarketDataCache cache(8, 16);
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> backwards{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            int64_t last = 0;
+            CachedBar ring[8];
+            while (!done.load(std::memory_order_acquire)) {
+                CachedBar bar;
+                if (cache.latest(5, bar)) {
+                    if (!consistent(bar)) ++torn;
+                    if (bar.timestamp_ns < last) ++backwards;
+                    last = bar.timestamp_ns;
+                }
+                if (cache.latest(6, bar) && !consistent(bar)) ++torn;
+                size_t n = cache.recent(5, ring, 8);
+                for (size_t i = 0; i < n; ++i) {
+                    if (!consistent(ring[i])) ++torn;
+                    if (i > 0 && ring[i].timestamp_ns != ring[i - 1].timestamp_ns + 1) ++torn;
+                }
+            }
+        });
+    }
+
+    // One writer owns symbol 5; two more share symbol 6, where the
+    // seqlock has to serialize them
+    std::atomic<int64_t> next{1};
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 2; ++w) {
+        writers.emplace_back([&] {
+            for (;;) {
+                int64_t k = next.fetch_add(1);
+                if (k > kUpdates) break;
+                cache.update(6, barFor(k));
+            }
+        });
+    }
+    for (int64_t k = 1; k <= kUpdates; ++k) {
+        cache.update(5, barFor(k));
+    }
+    for (auto& t : writers) t.join();
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers) t.join();
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(backwards.load(), 0u);
+    EXPECT_EQ(cache.updateCount(5), static_cast<uint64_t>(kUpdates));
+    EXPECT_EQ(cache.updateCount(6), static_cast<uint64_t>(kUpdates));
+    CachedBar bar;
+    ASSERT_TRUE(cache.latest(6, bar));
+    EXPECT_TRUE(consistent(bar));
+}
+
+} // namespace
+} // namespace TradingSystem
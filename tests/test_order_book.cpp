@@ -0,0 +1,127 @@
+#include "trading/order_book.h"
+#include "trading/trading_engine.h"
+#include "market_data/market_data_cache.h"
+#include "market_data/pricing_service.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace TradingSystem {
+namespace {
+
+using Trigger = OrderBook::Trigger;
+
+TEST(OrderBookTest, TriggerDirections) {
+    EXPECT_EQ(OrderBook::triggerFor(OrderSide::BUY, OrderType::LIMIT), Trigger::AT_OR_BELOW);
+    EXPECT_EQ(OrderBook::triggerFor(OrderSide::SELL, OrderType::STOP), Trigger::AT_OR_BELOW);
+    EXPECT_EQ(OrderBook::triggerFor(OrderSide::SELL, OrderType::LIMIT), Trigger::AT_OR_ABOVE);
+    EXPECT_EQ(OrderBook::triggerFor(OrderSide::BUY, OrderType::STOP), Trigger::AT_OR_ABOVE);
+}
+
+TEST(OrderBookTest, CrossesBestPriceFirstAndArrivalOrderWithinLevel) {
+    OrderBook book;
+    book.add(1, 99.0, Trigger::AT_OR_BELOW);
+    book.add(2, 100.0, Trigger::AT_OR_BELOW);
+    book.add(3, 100.0, Trigger::AT_OR_BELOW);
+    book.add(4, 98.0, Trigger::AT_OR_BELOW);
+    book.add(5, 101.0, Trigger::AT_OR_ABOVE);
+
+    std::vector<OrderId> crossed;
+    book.collectCrossed(100.5, crossed);
+    EXPECT_TRUE(crossed.empty());
+
+    book.collectCrossed(99.0, crossed);
+    EXPECT_EQ(crossed, (std::vector<OrderId>{2, 3, 1}));
+    EXPECT_EQ(book.size(), 2u);
+    EXPECT_FALSE(book.contains(2));
+    EXPECT_TRUE(book.contains(4));
+
+    crossed.clear();
+    book.collectCrossed(101.0, crossed);
+    EXPECT_EQ(crossed, (std::vector<OrderId>{5}));
+    EXPECT_EQ(book.size(), 1u);
+}
+
+TEST(OrderBookTest, CancelledEntriesNeverFire) {
+    OrderBook book;
+    book.add(1, 100.0, Trigger::AT_OR_ABOVE);
+    book.add(2, 100.0, Trigger::AT_OR_ABOVE);
+    EXPECT_TRUE(book.cancel(1));
+    EXPECT_FALSE(book.cancel(1));
+    EXPECT_FALSE(book.cancel(42));
+
+    std::vector<OrderId> crossed;
+    book.collectCrossed(150.0, crossed);
+    EXPECT_EQ(crossed, (std::vector<OrderId>{2}));
+    EXPECT_TRUE(book.empty());
+}
+
+// Protective exits are an OCO pair in the engine's book: whichever fires
+// closes the position and cancels the other
+class ProtectiveExitTest : public ::testing::Test {
+protected:
+    static constexpr double kEntry = 100.0;
+    static constexpr double kQuantity = 10.0;
+    static constexpr double kBalance = 100000.0;
+
+    void SetUp() override {
+        cache = std::make_shared<MarketDataCache>();
+        engine = std::make_unique<TradingEngine>(TradingMode::PAPER, kBalance);
+        engine->setVerbose(false);
+        engine->setSlippageRate(0.0);
+        engine->setSpreadRate(0.0);
+        engine->setMarketDataCache(cache);
+        engine->setStopLoss(0.02);
+        engine->setTakeProfit(0.05);
+        id = SymbolTable::getInstance().intern("TEST_OCO");
+
+        ASSERT_NE(engine->placeOrder(id, OrderSide::BUY, kQuantity, OrderType::MARKET, kEntry), kInvalidOrderId);
+        ASSERT_DOUBLE_EQ(engine->getPosition(id).quantity, kQuantity);
+    }
+
+    std::shared_ptr<MarketDataCache> cache;
+    std::unique_ptr<TradingEngine> engine;
+    SymbolId id = kInvalidSymbolId;
+};
+
+TEST_F(ProtectiveExitTest, NothingFiresInsideTheBand) {
+    engine->updatePositionPrice(id, 99.0);
+    engine->updatePositionPrice(id, 104.0);
+    EXPECT_DOUBLE_EQ(engine->getPosition(id).quantity, kQuantity);
+    EXPECT_EQ(engine->getFillCount(), 1u);
+}
+
+TEST_F(ProtectiveExitTest, TakeProfitCancelsStopLoss) {
+    engine->updatePositionPrice(id, 106.0);
+    EXPECT_DOUBLE_EQ(engine->getPosition(id).quantity, 0.0);
+    EXPECT_EQ(engine->getFillCount(), 2u);
+    EXPECT_DOUBLE_EQ(engine->getAvailableCash(), kBalance + kQuantity * (106.0 - kEntry));
+
+    // The stop-loss leg is gone: a later drop sells nothing
+    engine->updatePositionPrice(id, 90.0);
+    EXPECT_EQ(engine->getFillCount(), 2u);
+    EXPECT_DOUBLE_EQ(engine->getAvailableCash(), kBalance + kQuantity * (106.0 - kEntry));
+}
+
+TEST_F(ProtectiveExitTest, StopLossCancelsTakeProfit) {
+    engine->updatePositionPrice(id, 97.0);
+    EXPECT_DOUBLE_EQ(engine->getPosition(id).quantity, 0.0);
+    EXPECT_EQ(engine->getFillCount(), 2u);
+    EXPECT_DOUBLE_EQ(engine->getAvailableCash(), kBalance + kQuantity * (97.0 - kEntry));
+
+    engine->updatePositionPrice(id, 110.0);
+    EXPECT_EQ(engine->getFillCount(), 2u);
+}
+
+TEST_F(ProtectiveExitTest, AddingToThePositionMovesTheExits) {
+    // Average entry becomes 102, so the take-profit moves to 107.1
+    ASSERT_NE(engine->placeOrder(id, OrderSide::BUY, kQuantity, OrderType::MARKET, 104.0), kInvalidOrderId);
+    engine->updatePositionPrice(id, 106.0);
+    EXPECT_DOUBLE_EQ(engine->getPosition(id).quantity, 2 * kQuantity);
+
+    engine->updatePositionPrice(id, 107.5);
+    EXPECT_DOUBLE_EQ(engine->getPosition(id).quantity, 0.0);
+}
+
+} // namespace
+} // namespace TradingSystem
@@ -0,0 +1,71 @@
+#include "trading/trading_engine.h"
+#include "market_data/market_data_cache.h"
+#include "market_data/pricing_service.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace TradingSystem {
+namespace {
+
+TEST(PaperTradingSimulatorTest, SpreadWorksAgainstEachSide) {
+    PaperTradingSimulator simulator;
+    simulator.setSpreadRate(0.001);
+    EXPECT_DOUBLE_EQ(simulator.simulateSpread(100.0, OrderSide::BUY), 100.1);
+    EXPECT_DOUBLE_EQ(simulator.simulateSpread(100.0, OrderSide::SELL), 99.9);
+}
+
+TEST(PaperTradingSimulatorTest, SlippageWorksAgainstEachSide) {
+    PaperTradingSimulator simulator;
+    simulator.setSlippageRate(0.001);
+    EXPECT_GT(simulator.simulateSlippage(100.0, 1.0, OrderSide::BUY), 100.0);
+    EXPECT_LT(simulator.simulateSlippage(100.0, 1.0, OrderSide::SELL), 100.0);
+}
+
+// Buy and sell back at an unchanged price: the spread is the only cost
+class RoundTripTest : public ::testing::Test {
+protected:
+    static constexpr double kBalance = 100000.0;
+    static constexpr double kPrice = 100.0;
+    static constexpr double kQuantity = 10.0;
+
+    void SetUp() override {
+        engine = std::make_unique<TradingEngine>(TradingMode::PAPER, kBalance);
+        engine->setVerbose(false);
+        engine->setSlippageRate(0.0);
+        engine->setRestingExits(false);
+        id = SymbolTable::getInstance().intern("TEST_ROUND_TRIP");
+    }
+
+    double roundTripLoss() {
+        EXPECT_NE(engine->placeOrder(id, OrderSide::BUY, kQuantity, OrderType::MARKET, kPrice), kInvalidOrderId);
+        EXPECT_NE(engine->placeOrder(id, OrderSide::SELL, kQuantity, OrderType::MARKET, kPrice), kInvalidOrderId);
+        EXPECT_DOUBLE_EQ(engine->getPosition(id).quantity, 0.0);
+        return kBalance - engine->getAvailableCash();
+    }
+
+    std::unique_ptr<TradingEngine> engine;
+    SymbolId id = kInvalidSymbolId;
+};
+
+TEST_F(RoundTripTest, ZeroDriftRoundTripLosesTheSpread) {
+    engine->setSpreadRate(0.001);
+    EXPECT_NEAR(roundTripLoss(), 2 * 0.001 * kPrice * kQuantity, 1e-9);
+}
+
+TEST_F(RoundTripTest, NoSpreadNoSlippageBreaksEven) {
+    engine->setSpreadRate(0.0);
+    EXPECT_NEAR(roundTripLoss(), 0.0, 1e-9);
+}
+
+TEST_F(RoundTripTest, QuoteSpreadIsNotChargedTwice) {
+    // Fills cross the pricing service's bid and ask; the simulator's own
+    // spread is not added on top
+    auto cache = std::make_shared<MarketDataCache>();
+    engine->setMarketDataCache(cache);
+    engine->setPricingService(std::make_shared<PricingService>(cache, std::chrono::nanoseconds::zero(), 0.002));
+    engine->setSpreadRate(0.001);
+    EXPECT_NEAR(roundTripLoss(), 0.002 * kPrice * kQuantity, 1e-9);
+}
+
+} // namespace
+} // namespace TradingSystem
@@ -0,0 +1,194 @@
+#include "trading/performance_stats.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace TradingSystem {
+namespace {
+
+using std::chrono::hours;
+
+class PerformanceStatsTest : public ::testing::Test {
+protected:
+    // Midnight UTC, 2023-11-15
+    static std::chrono::system_clock::time_point day(int n, int hour = 12) {
+        return std::chrono::system_clock::time_point(std::chrono::seconds(1700006400)) + hours(24 * n + hour);
+    }
+
+    static double mean(const std::vector<double>& r, size_t first = 0) {
+        double sum = 0.0;
+        for (size_t i = first; i < r.size(); ++i) sum += r[i];
+        return sum / static_cast<double>(r.size() - first);
+    }
+
+    static double stddev(const std::vector<double>& r, size_t first = 0) {
+        double m = mean(r, first);
+        double m2 = 0.0;
+        for (size_t i = first; i < r.size(); ++i) m2 += (r[i] - m) * (r[i] - m);
+        return std::sqrt(m2 / static_cast<double>(r.size() - first - 1));
+    }
+
+    // Daily returns from a sequence of closes, starting from initial
+    static std::vector<double> returns(double initial, const std::vector<double>& closes) {
+        std::vector<double> r;
+        double previous = initial;
+        for (double close : closes) {
+            r.push_back((close - previous) / previous);
+            previous = close;
+        }
+        return r;
+    }
+};
+
+TEST_F(PerformanceStatsTest, DailyReturnsMatchBatchRatios) {
+    const double initial = 10000.0;
+    std::vector<double> closes = {10100, 10050, 10300, 10200, 10500, 10400, 10450, 10300, 10600, 10650};
+    PerformanceStats stats(initial);
+    for (size_t i = 0; i < closes.size(); ++i) {
+        stats.onEquity(day(static_cast<int>(i)), closes[i]);
+    }
+    // The last day's return is closed by the first mark of the next day
+    stats.onEquity(day(static_cast<int>(closes.size())), closes.back());
+
+    std::vector<double> r = returns(initial, closes);
+    ASSERT_EQ(stats.returnCount(), r.size());
+    EXPECT_NEAR(stats.meanReturn(), mean(r), 1e-12);
+    EXPECT_NEAR(stats.returnStdDev(), stddev(r), 1e-12);
+    EXPECT_NEAR(stats.sharpeRatio(), mean(r) / stddev(r) * std::sqrt(365.0), 1e-9);
+
+    double downside = 0.0;
+    for (double x : r) {
+        if (x < 0) downside += x * x;
+    }
+    double expected_sortino = mean(r) / std::sqrt(downside / r.size()) * std::sqrt(365.0);
+    EXPECT_NEAR(stats.sortinoRatio(), expected_sortino, 1e-9);
+}
+
+TEST_F(PerformanceStatsTest, OnlyTheLastMarkOfADayCounts) {
+    PerformanceStats stats(1000.0);
+    stats.onEquity(day(0, 1), 1500.0);
+    stats.onEquity(day(0, 12), 800.0);
+    stats.onEquity(day(0, 23), 1100.0);
+    EXPECT_EQ(stats.returnCount(), 0u);
+    EXPECT_DOUBLE_EQ(stats.dailyPnL(), 100.0);
+
+    stats.onEquity(day(1, 0), 1100.0);
+    ASSERT_EQ(stats.returnCount(), 1u);
+    EXPECT_NEAR(stats.meanReturn(), 0.1, 1e-12);
+    EXPECT_DOUBLE_EQ(stats.dailyPnL(), 0.0);
+}
+
+TEST_F(PerformanceStatsTest, DaysWithoutMarksFoldIntoOneReturn) {
+    PerformanceStats stats(1000.0);
+    stats.onEquity(day(0), 1000.0);
+    stats.onEquity(day(5), 1200.0);  // Nothing for four days
+    stats.onEquity(day(6), 1200.0);
+    ASSERT_EQ(stats.returnCount(), 2u);
+    // 0% for day 0, then 20% for day 5 measured from day 0's close
+    EXPECT_NEAR(stats.meanReturn(), 0.1, 1e-12);
+}
+
+TEST_F(PerformanceStatsTest, RollingSharpeCoversTheLastWindowOnly) {
+    const size_t window = 5;
+    PerformanceStats stats(100.0, window);
+    std::vector<double> closes;
+    double equity = 100.0;
+    for (int i = 0; i < 40; ++i) {
+        equity *= 1.0 + 0.01 * std::sin(i * 1.7) + 0.002;
+        closes.push_back(equity);
+    }
+
+    std::vector<double> r;
+    double previous = 100.0;
+    for (size_t i = 0; i < closes.size(); ++i) {
+        stats.onEquity(day(static_cast<int>(i)), closes[i]);
+        if (i == 0) continue;
+        // Opening day i closed day i - 1
+        r.push_back((closes[i - 1] - previous) / previous);
+        previous = closes[i - 1];
+
+        ASSERT_EQ(stats.rollingCount(), std::min(r.size(), window));
+        if (r.size() < 2) {
+            EXPECT_DOUBLE_EQ(stats.rollingSharpeRatio(), 0.0);
+            continue;
+        }
+        size_t first = r.size() > window ? r.size() - window : 0;
+        double expected = mean(r, first) / stddev(r, first) * std::sqrt(365.0);
+        EXPECT_NEAR(stats.rollingSharpeRatio(), expected, 1e-9 * std::max(1.0, std::fabs(expected)))
+            << "after " << r.size() << " returns";
+    }
+}
+
+TEST_F(PerformanceStatsTest, FlatEquityHasNoRatios) {
+    PerformanceStats stats(500.0, 3);
+    for (int i = 0; i < 10; ++i) {
+        stats.onEquity(day(i), 500.0);
+    }
+    EXPECT_EQ(stats.returnCount(), 9u);
+    EXPECT_DOUBLE_EQ(stats.sharpeRatio(), 0.0);
+    EXPECT_DOUBLE_EQ(stats.sortinoRatio(), 0.0);
+    EXPECT_DOUBLE_EQ(stats.rollingSharpeRatio(), 0.0);
+}
+
+TEST_F(PerformanceStatsTest, DrawdownTracksThePeak) {
+    PerformanceStats stats(1000.0);
+    stats.onEquity(day(0, 1), 1200.0);
+    stats.onEquity(day(0, 2), 900.0);
+    EXPECT_DOUBLE_EQ(stats.peakEquity(), 1200.0);
+    EXPECT_DOUBLE_EQ(stats.drawdown(), 0.25);
+
+    stats.onEquity(day(0, 3), 1100.0);
+    EXPECT_NEAR(stats.drawdown(), 100.0 / 1200.0, 1e-12);
+    EXPECT_DOUBLE_EQ(stats.maxDrawdown(), 0.25);
+
+    stats.onEquity(day(0, 4), 1300.0);
+    EXPECT_DOUBLE_EQ(stats.drawdown(), 0.0);
+    EXPECT_DOUBLE_EQ(stats.maxDrawdown(), 0.25);
+}
+
+TEST_F(PerformanceStatsTest, TradeCountersAndProfitFactor) {
+    PerformanceStats stats(1000.0);
+    EXPECT_DOUBLE_EQ(stats.winRate(), 0.0);
+    EXPECT_DOUBLE_EQ(stats.profitFactor(), 0.0);
+
+    stats.onTrade(50.0);
+    stats.onTrade(30.0);
+    EXPECT_DOUBLE_EQ(stats.profitFactor(), 0.0);  // no losing trade yet
+    stats.onTrade(-20.0);
+    stats.onTrade(0.0);
+    EXPECT_EQ(stats.winningTrades(), 2u);
+    EXPECT_EQ(stats.losingTrades(), 1u);
+    EXPECT_NEAR(stats.winRate(), 2.0 / 3.0, 1e-12);
+    EXPECT_DOUBLE_EQ(stats.grossProfit(), 80.0);
+    EXPECT_DOUBLE_EQ(stats.grossLoss(), 20.0);
+    EXPECT_DOUBLE_EQ(stats.profitFactor(), 4.0);
+
+    stats.seedTrades(3, 4);
+    EXPECT_EQ(stats.winningTrades(), 5u);
+    EXPECT_EQ(stats.losingTrades(), 5u);
+    EXPECT_DOUBLE_EQ(stats.winRate(), 0.5);
+}
+
+TEST_F(PerformanceStatsTest, ResetStartsOver) {
+    PerformanceStats stats(1000.0);
+    stats.onEquity(day(0), 800.0);
+    stats.onEquity(day(1), 900.0);
+    stats.onTrade(-5.0);
+
+    stats.reset(2000.0);
+    EXPECT_EQ(stats.returnCount(), 0u);
+    EXPECT_EQ(stats.rollingCount(), 0u);
+    EXPECT_EQ(stats.losingTrades(), 0u);
+    EXPECT_DOUBLE_EQ(stats.equity(), 2000.0);
+    EXPECT_DOUBLE_EQ(stats.peakEquity(), 2000.0);
+    EXPECT_DOUBLE_EQ(stats.maxDrawdown(), 0.0);
+
+    stats.onEquity(day(5), 2200.0);
+    stats.onEquity(day(6), 2200.0);
+    ASSERT_EQ(stats.returnCount(), 1u);
+    EXPECT_NEAR(stats.meanReturn(), 0.1, 1e-12);
+}
+
+} // namespace
+} // namespace TradingSystem
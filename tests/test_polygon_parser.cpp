@@ -0,0 +1,66 @@
+#include "polygon_parser.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+
+namespace TradingSystem {
+namespace {
+
+const char* kResponse =
+    R"({"ticker":"AAPL","status":"OK","resultsCount":2,"results":[)"
+    R"({"v":70790813,"vw":131.6292,"o":131.25,"c":130.84,"h":132.22,"l":130.5,"t":1611896400000,"n":485344},)"
+    R"({"v":1000.5,"o":12.5,"c":13,"h":13.25,"l":12.25,"t":1.6119828e12,"n":10}]})";
+
+bool parse(std::string_view body, PolygonBar* bars, size_t capacity, PolygonAggParser& parser) {
+    parser.reset(bars, capacity);
+    return parser.feed(body) && parser.finish();
+}
+
+TEST(PolygonParserTest, ParsesBarsAndRootFields) {
+    PolygonBar bars[4];
+    PolygonAggParser parser;
+    ASSERT_TRUE(parse(kResponse, bars, 4, parser));
+    EXPECT_TRUE(parser.statusOk());
+    EXPECT_EQ(parser.ticker(), "AAPL");
+    ASSERT_EQ(parser.barCount(), 2u);
+    EXPECT_DOUBLE_EQ(bars[0].open, 131.25);
+    EXPECT_DOUBLE_EQ(bars[0].vwap, 131.6292);
+    EXPECT_EQ(bars[0].timestamp_ms, 1611896400000LL);
+    EXPECT_EQ(bars[0].transactions, 485344);
+    // Integral fields sent as floats
+    EXPECT_EQ(bars[1].timestamp_ms, 1611982800000LL);
+    EXPECT_DOUBLE_EQ(bars[1].close, 13.0);
+}
+
+TEST(PolygonParserTest, ScalarsSplitAcrossChunks) {
+    std::string body = kResponse;
+    for (size_t split = 1; split < body.size(); ++split) {
+        PolygonBar bars[2];
+        PolygonAggParser parser(bars, 2);
+        ASSERT_TRUE(parser.feed(std::string_view(body).substr(0, split))) << split;
+        ASSERT_TRUE(parser.feed(std::string_view(body).substr(split))) << split;
+        ASSERT_TRUE(parser.finish()) << split;
+        EXPECT_EQ(bars[0].timestamp_ms, 1611896400000LL) << split;
+        EXPECT_DOUBLE_EQ(bars[1].low, 12.25) << split;
+    }
+}
+
+TEST(PolygonParserTest, RejectsPartiallyNumericValues) {
+    PolygonBar bars[1];
+    PolygonAggParser parser;
+    EXPECT_FALSE(parse(R"({"results":[{"o":12.5x,"t":1}]})", bars, 1, parser));
+    EXPECT_FALSE(parse(R"({"results":[{"o":12.5,"t":16e11abc}]})", bars, 1, parser));
+    EXPECT_FALSE(parse(R"({"results":[{"o":12.5,"n":10.0.0}]})", bars, 1, parser));
+}
+
+TEST(PolygonParserTest, CountsBarsBeyondCapacity) {
+    PolygonBar bars[1];
+    PolygonAggParser parser;
+    ASSERT_TRUE(parse(kResponse, bars, 1, parser));
+    EXPECT_EQ(parser.barCount(), 1u);
+    EXPECT_EQ(parser.totalBars(), 2u);
+    EXPECT_TRUE(parser.truncated());
+}
+
+} // namespace
+} // namespace TradingSystem
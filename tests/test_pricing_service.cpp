@@ -0,0 +1,139 @@
+#include "market_data/pricing_service.h"
+#include "trading/trading_engine.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <memory>
+
+namespace TradingSystem {
+namespace {
+
+using std::chrono::seconds;
+
+class PricingServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        cache = std::make_shared<MarketDataCache>();
+        id = SymbolTable::getInstance().intern("TEST_PRICING");
+        now = fromEpochNanos(1700000000LL * 1000000000LL);
+    }
+
+    void publish(double close, std::chrono::system_clock::time_point at) {
+        CachedBar bar;
+        bar.open = bar.high = bar.low = bar.close = close;
+        bar.volume = 1000.0;
+        bar.timestamp_ns = toEpochNanos(at);
+        ASSERT_TRUE(cache->update(id, bar));
+    }
+
+    std::shared_ptr<MarketDataCache> cache;
+    SymbolId id = kInvalidSymbolId;
+    std::chrono::system_clock::time_point now;
+};
+
+TEST_F(PricingServiceTest, MissingUntilABarArrives) {
+    PricingService pricing(cache, seconds(60));
+    PriceSnapshot quote;
+    EXPECT_EQ(pricing.snapshot(id, now, quote), PricingService::Status::MISSING);
+    EXPECT_FALSE(pricing.fresh(id, now, quote));
+}
+
+TEST_F(PricingServiceTest, FreshWithinMaxAgeStaleAfter) {
+    PricingService pricing(cache, seconds(60));
+    publish(50.0, now);
+
+    PriceSnapshot quote;
+    EXPECT_EQ(pricing.snapshot(id, now + seconds(60), quote), PricingService::Status::OK);
+    EXPECT_DOUBLE_EQ(quote.last, 50.0);
+    EXPECT_EQ(quote.timestamp_ns, toEpochNanos(now));
+
+    // A stale snapshot still reports the price it rejected
+    quote = PriceSnapshot();
+    EXPECT_EQ(pricing.snapshot(id, now + seconds(61), quote), PricingService::Status::STALE);
+    EXPECT_DOUBLE_EQ(quote.last, 50.0);
+
+    publish(51.0, now + seconds(61));
+    EXPECT_TRUE(pricing.fresh(id, now + seconds(61), quote));
+    EXPECT_DOUBLE_EQ(quote.last, 51.0);
+}
+
+TEST_F(PricingServiceTest, ZeroMaxAgeAcceptsAnyAge) {
+    PricingService pricing(cache);
+    publish(50.0, now);
+    PriceSnapshot quote;
+    EXPECT_TRUE(pricing.fresh(id, now + seconds(86400 * 365), quote));
+}
+
+TEST_F(PricingServiceTest, SpreadSitsEitherSideOfLast) {
+    PricingService pricing(cache, seconds(0), 0.002);
+    publish(100.0, now);
+    PriceSnapshot quote;
+    ASSERT_TRUE(pricing.fresh(id, now, quote));
+    EXPECT_DOUBLE_EQ(quote.bid, 99.9);
+    EXPECT_DOUBLE_EQ(quote.ask, 100.1);
+    EXPECT_DOUBLE_EQ(quote.crossing(OrderSide::BUY), quote.ask);
+    EXPECT_DOUBLE_EQ(quote.crossing(OrderSide::SELL), quote.bid);
+}
+
+TEST_F(PricingServiceTest, EngineRejectsMarketOrdersOnStaleQuotes) {
+    auto pricing = std::make_shared<PricingService>(cache, seconds(60));
+    TradingEngine engine(TradingMode::PAPER, 100000.0);
+    engine.setVerbose(false);
+    engine.setMarketDataCache(cache);
+    engine.setPricingService(pricing);
+    publish(50.0, now);
+
+    engine.setSimulatedTime(now + seconds(120));
+    EXPECT_EQ(engine.placeOrder(id, OrderSide::BUY, 1.0, OrderType::MARKET), kInvalidOrderId);
+
+    TradingSignal signal;
+    signal.symbol = "TEST_PRICING";
+    signal.action = SignalAction::BUY;
+    signal.confidence = 1.0;
+    signal.suggested_position_size = 1000.0;
+    engine.processTradingSignal(signal);
+    EXPECT_EQ(engine.getFillCount(), 0u);
+
+    engine.setSimulatedTime(now + seconds(30));
+    EXPECT_NE(engine.placeOrder(id, OrderSide::BUY, 1.0, OrderType::MARKET), kInvalidOrderId);
+    EXPECT_DOUBLE_EQ(engine.getPosition(id).quantity, 1.0);
+}
+
+TEST_F(PricingServiceTest, RiskCheckSeesSlippageAndSpread) {
+    TradingEngine engine(TradingMode::PAPER, 100000.0);
+    engine.setVerbose(false);
+    engine.setMarketDataCache(cache);
+    engine.setSlippageRate(0.001);
+    engine.setSpreadRate(0.01);
+    engine.setMaxPositionSize(5000.0);
+    publish(100.0, now);
+
+    // 50 at 100 is exactly the limit, but the fill would cost about 5058
+    EXPECT_EQ(engine.placeOrder(id, OrderSide::BUY, 50.0, OrderType::MARKET), kInvalidOrderId);
+    EXPECT_EQ(engine.getFillCount(), 0u);
+}
+
+TEST_F(PricingServiceTest, SignalSizedAtTheFillPrice) {
+    TradingEngine engine(TradingMode::PAPER, 100000.0);
+    engine.setVerbose(false);
+    engine.setMarketDataCache(cache);
+    engine.setSlippageRate(0.001);
+    engine.setSpreadRate(0.01);
+    engine.setMaxPositionSize(5000.0);
+    publish(100.0, now);
+
+    TradingSignal signal;
+    signal.symbol = "TEST_PRICING";
+    signal.action = SignalAction::BUY;
+    signal.confidence = 1.0;
+    signal.suggested_position_size = 5000.0;
+    engine.processTradingSignal(signal);
+
+    // Sized so slippage and spread stay inside the position limit
+    ASSERT_EQ(engine.getFillCount(), 1u);
+    double spent = 100000.0 - engine.getAvailableCash();
+    EXPECT_LE(spent, 5000.0);
+    EXPECT_GT(spent, 4990.0);
+}
+
+} // namespace
+} // namespace TradingSystem
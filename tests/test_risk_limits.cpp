@@ -0,0 +1,53 @@
+#include "trading/trading_engine.h"
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace TradingSystem {
+namespace {
+
+class RiskLimitsTest : public ::testing::Test {
+protected:
+    static constexpr double kPrice = 100.0;
+
+    void SetUp() override {
+        engine = std::make_unique<TradingEngine>(TradingMode::PAPER, 100000.0);
+        engine->setVerbose(false);
+        engine->setRestingExits(false);
+        engine->setSlippageRate(0.0);
+        engine->setSpreadRate(0.0);
+        engine->setMaxPositionSize(5000.0);
+        id = SymbolTable::getInstance().intern("TEST_RISK_LIMITS");
+        other = SymbolTable::getInstance().intern("TEST_RISK_LIMITS_OTHER");
+    }
+
+    std::unique_ptr<TradingEngine> engine;
+    SymbolId id = kInvalidSymbolId;
+    SymbolId other = kInvalidSymbolId;
+};
+
+TEST_F(RiskLimitsTest, SingleOrderAboveTheLimitIsRejected) {
+    EXPECT_TRUE(engine->checkRiskLimits(id, 50.0, kPrice));
+    EXPECT_FALSE(engine->checkRiskLimits(id, 51.0, kPrice));
+}
+
+TEST_F(RiskLimitsTest, HeldPositionCountsTowardsTheLimit) {
+    ASSERT_NE(engine->placeOrder(id, OrderSide::BUY, 30.0, OrderType::MARKET, kPrice), kInvalidOrderId);
+
+    // 3000 held: another 2000 fits, 2100 does not
+    EXPECT_TRUE(engine->checkRiskLimits(id, 20.0, kPrice));
+    EXPECT_FALSE(engine->checkRiskLimits(id, 21.0, kPrice));
+    EXPECT_EQ(engine->placeOrder(id, OrderSide::BUY, 21.0, OrderType::MARKET, kPrice), kInvalidOrderId);
+    EXPECT_DOUBLE_EQ(engine->getPosition(id).quantity, 30.0);
+
+    // The cap is per symbol
+    EXPECT_TRUE(engine->checkRiskLimits(other, 50.0, kPrice));
+}
+
+TEST_F(RiskLimitsTest, SellsAreNotCapped) {
+    ASSERT_NE(engine->placeOrder(id, OrderSide::BUY, 50.0, OrderType::MARKET, kPrice), kInvalidOrderId);
+    EXPECT_NE(engine->placeOrder(id, OrderSide::SELL, 50.0, OrderType::MARKET, kPrice), kInvalidOrderId);
+    EXPECT_DOUBLE_EQ(engine->getPosition(id).quantity, 0.0);
+}
+
+} // namespace
+} // namespace TradingSystem
@@ -0,0 +1,147 @@
+#include "database/database_manager.h"
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+namespace TradingSystem {
+namespace {
+
+// Opens the file behind the manager's back to build a version 0 schema
+// (TEXT timestamps only) and to inspect what the migration left
+class SchemaMigrationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = "trading_tests_migration_" + std::to_string(getpid()) + ".db";
+        removeFiles();
+    }
+
+    void TearDown() override {
+        removeFiles();
+    }
+
+    void removeFiles() {
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::remove((path + suffix).c_str());
+        }
+    }
+
+    void exec(const std::string& sql) {
+        sqlite3* raw = nullptr;
+        ASSERT_EQ(sqlite3_open(path.c_str(), &raw), SQLITE_OK);
+        char* error = nullptr;
+        EXPECT_EQ(sqlite3_exec(raw, sql.c_str(), nullptr, nullptr, &error), SQLITE_OK) << (error ? error : "");
+        sqlite3_free(error);
+        sqlite3_close(raw);
+    }
+
+    int64_t queryInt(const std::string& sql) {
+        sqlite3* raw = nullptr;
+        sqlite3_stmt* stmt = nullptr;
+        int64_t value = -1;
+        if (sqlite3_open(path.c_str(), &raw) == SQLITE_OK &&
+            sqlite3_prepare_v2(raw, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK &&
+            sqlite3_step(stmt) == SQLITE_ROW) {
+            value = sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_close(raw);
+        return value;
+    }
+
+    void createVersionZero() {
+        exec("CREATE TABLE market_data (id INTEGER PRIMARY KEY AUTOINCREMENT, symbol TEXT NOT NULL,"
+             " open REAL NOT NULL, high REAL NOT NULL, low REAL NOT NULL, close REAL NOT NULL,"
+             " volume REAL NOT NULL, timestamp DATETIME NOT NULL,"
+             " created_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+             "CREATE TABLE trading_signals (id INTEGER PRIMARY KEY AUTOINCREMENT, symbol TEXT NOT NULL,"
+             " confidence REAL NOT NULL, action TEXT NOT NULL, suggested_position_size REAL NOT NULL,"
+             " timestamp DATETIME NOT NULL, created_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+             "CREATE TABLE positions (id INTEGER PRIMARY KEY AUTOINCREMENT, symbol TEXT NOT NULL,"
+             " quantity REAL NOT NULL, entry_price REAL NOT NULL, current_price REAL, unrealized_pnl REAL,"
+             " entry_time DATETIME NOT NULL, exit_time DATETIME, exit_price REAL, realized_pnl REAL,"
+             " status TEXT DEFAULT 'OPEN', created_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+             "CREATE TABLE orders (id INTEGER PRIMARY KEY AUTOINCREMENT, order_id TEXT UNIQUE NOT NULL,"
+             " symbol TEXT NOT NULL, side TEXT NOT NULL, quantity REAL NOT NULL, price REAL NOT NULL,"
+             " order_type TEXT NOT NULL, status TEXT NOT NULL, timestamp DATETIME NOT NULL,"
+             " created_at DATETIME DEFAULT CURRENT_TIMESTAMP);"
+             "CREATE INDEX idx_market_data_symbol_timestamp ON market_data(symbol, timestamp);"
+             "CREATE INDEX idx_trading_signals_timestamp ON trading_signals(timestamp);"
+             "INSERT INTO market_data (symbol, open, high, low, close, volume, timestamp) VALUES"
+             " ('TEST_MIGRATE', 1, 1, 1, 10, 100, '2023-11-14 22:13:20'),"
+             " ('TEST_MIGRATE', 1, 1, 1, 11, 100, '2023-11-14 22:14:20'),"
+             " ('TEST_MIGRATE', 1, 1, 1, 12, 100, '2023-11-14 22:15:20');"
+             "INSERT INTO positions (symbol, quantity, entry_price, entry_time) VALUES"
+             " ('TEST_MIGRATE', 5, 10, '2023-11-14 22:13:20');");
+    }
+
+    static std::chrono::system_clock::time_point at(int64_t seconds) {
+        return std::chrono::system_clock::time_point(std::chrono::seconds(seconds));
+    }
+
+    std::string path;
+};
+
+// 2023-11-14 22:13:20 UTC
+constexpr int64_t kFirstBar = 1700000000;
+
+TEST_F(SchemaMigrationTest, VersionZeroFileGetsIntegerTimestamps) {
+    createVersionZero();
+    {
+        DatabaseManager db(path);
+        ASSERT_TRUE(db.initialize());
+
+        auto bars = db.getMarketDataRange("TEST_MIGRATE", at(kFirstBar + 60), at(kFirstBar + 120));
+        ASSERT_EQ(bars.size(), 2u);
+        EXPECT_DOUBLE_EQ(bars[0].close, 11.0);
+        EXPECT_EQ(bars[0].timestamp, at(kFirstBar + 60));
+        EXPECT_EQ(bars[1].timestamp, at(kFirstBar + 120));
+
+        auto positions = db.getOpenPositions();
+        ASSERT_EQ(positions.size(), 1u);
+        EXPECT_EQ(positions[0].entry_time, at(kFirstBar));
+    }
+
+    EXPECT_EQ(queryInt("PRAGMA user_version;"), DatabaseManager::kSchemaVersion);
+    EXPECT_EQ(queryInt("SELECT MIN(ts_us) FROM market_data;"), kFirstBar * 1000000);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM sqlite_master WHERE name = 'idx_market_data_symbol_timestamp';"), 0);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM sqlite_master WHERE name = 'idx_market_data_symbol_ts';"), 1);
+}
+
+TEST_F(SchemaMigrationTest, MigratedFileAcceptsNewRowsAndReopensUnchanged) {
+    createVersionZero();
+    {
+        DatabaseManager db(path);
+        ASSERT_TRUE(db.initialize());
+        MarketData bar;
+        bar.symbol = "TEST_MIGRATE";
+        bar.open = bar.high = bar.low = bar.close = 13.0;
+        bar.volume = 100.0;
+        bar.timestamp = at(kFirstBar + 180) + std::chrono::microseconds(250);
+        ASSERT_TRUE(db.insertMarketData(bar));
+    }
+    {
+        DatabaseManager db(path);
+        ASSERT_TRUE(db.initialize());
+        auto bars = db.getMarketDataRange("TEST_MIGRATE", at(kFirstBar), at(kFirstBar + 3600));
+        ASSERT_EQ(bars.size(), 4u);
+        // The integer column keeps what the TEXT one rounds away
+        EXPECT_EQ(bars[3].timestamp, at(kFirstBar + 180) + std::chrono::microseconds(250));
+    }
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM market_data WHERE ts_us = 0;"), 0);
+}
+
+TEST_F(SchemaMigrationTest, NewFileStartsAtCurrentVersion) {
+    {
+        DatabaseManager db(path);
+        ASSERT_TRUE(db.initialize());
+    }
+    EXPECT_EQ(queryInt("PRAGMA user_version;"), DatabaseManager::kSchemaVersion);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM pragma_table_info('orders') WHERE name = 'ts_us';"), 1);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM pragma_table_info('positions') WHERE name = 'entry_ts_us';"), 1);
+}
+
+} // namespace
+} // namespace TradingSystem
@@ -0,0 +1,108 @@
+#include "ipc/shm_ring_buffer.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace TradingSystem {
+namespace {
+
+class ShmRingBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        name = "/trading_tests_ring_" + std::to_string(getpid());
+        ASSERT_TRUE(producer.create(name, 4096));
+        ASSERT_TRUE(consumer.attach(name));
+    }
+
+    std::string name;
+    ShmRingBuffer producer;
+    ShmRingBuffer consumer;
+};
+
+TEST_F(ShmRingBufferTest, FramesArriveInOrder) {
+    std::string_view frame;
+    EXPECT_FALSE(consumer.peek(frame));
+
+    ASSERT_TRUE(producer.tryWrite("first", 5));
+    ASSERT_TRUE(producer.tryWrite("second", 6));
+
+    ASSERT_TRUE(consumer.peek(frame));
+    EXPECT_EQ(frame, "first");
+    consumer.consume();
+    ASSERT_TRUE(consumer.peek(frame));
+    EXPECT_EQ(frame, "second");
+    consumer.consume();
+    EXPECT_FALSE(consumer.peek(frame));
+}
+
+TEST_F(ShmRingBufferTest, BinaryPayloadsKeepEmbeddedNuls) {
+    const std::string payload("a\0b\0c", 5);
+    ASSERT_TRUE(producer.tryWrite(payload.data(), payload.size()));
+    std::string_view frame;
+    ASSERT_TRUE(consumer.peek(frame));
+    EXPECT_EQ(std::string(frame), payload);
+    consumer.consume();
+}
+
+TEST_F(ShmRingBufferTest, FullRingRejectsUntilConsumed) {
+    std::string payload(1000, 'x');
+    int written = 0;
+    while (producer.tryWrite(payload.data(), payload.size())) {
+        ++written;
+    }
+    EXPECT_GT(written, 0);
+    EXPECT_LT(written, 5);
+
+    std::string_view frame;
+    ASSERT_TRUE(consumer.peek(frame));
+    consumer.consume();
+    EXPECT_TRUE(producer.tryWrite(payload.data(), payload.size()));
+}
+
+TEST_F(ShmRingBufferTest, OversizedFrameIsRejected) {
+    std::string payload(producer.maxFrameSize() + 1, 'x');
+    EXPECT_FALSE(producer.tryWrite(payload.data(), payload.size()));
+}
+
+TEST_F(ShmRingBufferTest, WrapsAcrossTheEndOfTheBuffer) {
+    // Odd sizes walk the write position through every alignment, so some
+    // frames need the wrap marker
+    std::string_view frame;
+    for (int i = 0; i < 500; ++i) {
+        std::string payload(100 + (i * 37) % 900, static_cast<char>('a' + i % 26));
+        ASSERT_TRUE(producer.tryWrite(payload.data(), payload.size())) << "frame " << i;
+        ASSERT_TRUE(consumer.peek(frame)) << "frame " << i;
+        ASSERT_EQ(std::string(frame), payload) << "frame " << i;
+        consumer.consume();
+    }
+}
+
+TEST_F(ShmRingBufferTest, BlockingWriteAndWaitAcrossThreads) {
+    constexpr int kFrames = 5000;
+    std::thread writer([this] {
+        for (int i = 0; i < kFrames; ++i) {
+            std::string payload = std::to_string(i);
+            ASSERT_TRUE(producer.write(payload.data(), payload.size(), 5000));
+        }
+    });
+
+    std::string_view frame;
+    for (int i = 0; i < kFrames; ++i) {
+        while (!consumer.peek(frame)) {
+            ASSERT_TRUE(consumer.waitForData(5000));
+        }
+        ASSERT_EQ(std::string(frame), std::to_string(i));
+        consumer.consume();
+    }
+    writer.join();
+}
+
+TEST(ShmRingBufferAttachTest, MissingSegmentFailsToAttach) {
+    ShmRingBuffer ring;
+    EXPECT_FALSE(ring.attach("/trading_tests_missing_" + std::to_string(getpid())));
+    EXPECT_FALSE(ring.isOpen());
+}
+
+} // namespace
+} // namespace TradingSystem
@@ -0,0 +1,129 @@
+#include "trading/trading_engine.h"
+#include "market_data/market_data_cache.h"
+#include "trading/portfolio_aggregator.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TradingSystem {
+namespace {
+
+class SignalBatchTest : public ::testing::Test {
+protected:
+    static constexpr double kPrice = 100.0;
+
+    void SetUp() override {
+        cache = std::make_shared<MarketDataCache>();
+    }
+
+    // shared_cash runs the engine as the only shard of an aggregator, whose
+    // cash debit is what refuses a fill the balance cannot cover
+    void makeEngine(double balance, bool shared_cash = false) {
+        engine = std::make_unique<TradingEngine>(TradingMode::PAPER, balance);
+        if (shared_cash) {
+            aggregator = std::make_shared<PortfolioAggregator>(balance, 1);
+            engine->attachAggregator(aggregator, 0);
+        }
+        engine->setVerbose(false);
+        engine->setRestingExits(false);
+        engine->setSlippageRate(0.0);
+        engine->setSpreadRate(0.0);
+        engine->setMarketDataCache(cache);
+    }
+
+    SymbolId symbol(const std::string& name) {
+        SymbolId id = SymbolTable::getInstance().intern("TEST_BATCH_" + name);
+        CachedBar bar;
+        bar.open = bar.high = bar.low = bar.close = kPrice;
+        bar.volume = 1000.0;
+        bar.timestamp_ns = 1;
+        EXPECT_TRUE(cache->update(id, bar));
+        return id;
+    }
+
+    static TradingSignal signal(SymbolId id, SignalAction action, double size = 0.0) {
+        TradingSignal s;
+        s.symbol = SymbolTable::getInstance().name(id);
+        s.symbol_id = id;
+        s.action = action;
+        s.confidence = 1.0;
+        s.suggested_position_size = size;
+        return s;
+    }
+
+    std::shared_ptr<MarketDataCache> cache;
+    std::shared_ptr<PortfolioAggregator> aggregator;
+    std::unique_ptr<TradingEngine> engine;
+};
+
+TEST_F(SignalBatchTest, BuysAreScaledToFitTheBudget) {
+    makeEngine(10000.0);
+    std::vector<TradingSignal> batch = {signal(symbol("A"), SignalAction::BUY, 4000.0),
+                                        signal(symbol("B"), SignalAction::BUY, 4000.0),
+                                        signal(symbol("C"), SignalAction::BUY, 4000.0)};
+    EXPECT_EQ(engine->processTradingSignals(batch.data(), batch.size()), 3u);
+
+    // 12000 asked for, 9500 deployable: every BUY gets the same share
+    for (const auto& s : batch) {
+        EXPECT_NEAR(engine->getPosition(s.symbol_id).quantity * kPrice, 9500.0 / 3, 1e-6);
+    }
+    EXPECT_NEAR(engine->getAvailableCash(), 500.0, 1e-6);
+}
+
+TEST_F(SignalBatchTest, RepeatedSymbolIsOrderedOnce) {
+    makeEngine(10000.0);
+    SymbolId id = symbol("DUP");
+    std::vector<TradingSignal> batch = {signal(id, SignalAction::BUY, 1000.0),
+                                        signal(id, SignalAction::BUY, 1000.0)};
+    EXPECT_EQ(engine->processTradingSignals(batch.data(), batch.size()), 1u);
+    EXPECT_EQ(engine->getFillCount(), 1u);
+}
+
+TEST_F(SignalBatchTest, SellAndBuyShareABatch) {
+    makeEngine(10000.0);
+    SymbolId held = symbol("HELD");
+    SymbolId next = symbol("NEXT");
+    ASSERT_NE(engine->placeOrder(held, OrderSide::BUY, 40.0, OrderType::MARKET), kInvalidOrderId);
+
+    std::vector<TradingSignal> batch = {signal(next, SignalAction::BUY, 5000.0),
+                                        signal(held, SignalAction::SELL)};
+    EXPECT_EQ(engine->processTradingSignals(batch.data(), batch.size()), 2u);
+    EXPECT_DOUBLE_EQ(engine->getPosition(held).quantity, 0.0);
+    EXPECT_NEAR(engine->getPosition(next).quantity * kPrice, 5000.0, 1e-6);
+}
+
+TEST_F(SignalBatchTest, UnactionableSignalsAreNotPlaced) {
+    makeEngine(10000.0);
+    SymbolId id = symbol("NONE");
+    std::vector<TradingSignal> batch = {signal(id, SignalAction::SELL),     // nothing held
+                                        signal(id, SignalAction::HOLD),
+                                        signal(symbol("ZERO"), SignalAction::BUY, 0.0)};
+    EXPECT_EQ(engine->processTradingSignals(batch.data(), batch.size()), 0u);
+    EXPECT_EQ(engine->getFillCount(), 0u);
+}
+
+TEST_F(SignalBatchTest, OrdersRejectedAtTheFillAreNotPlaced) {
+    // A ten percent spread makes every fill cost more than the quote the
+    // batch was sized on
+    makeEngine(5000.0, true);
+    engine->setSpreadRate(0.10);
+    std::vector<TradingSignal> batch = {signal(symbol("WIDE"), SignalAction::BUY, 5000.0)};
+    size_t placed = engine->processTradingSignals(batch.data(), batch.size());
+
+    EXPECT_EQ(placed, engine->getFillCount());
+    EXPECT_GE(aggregator->cash(), 0.0);
+}
+
+TEST_F(SignalBatchTest, FillThatCannotBePaidForReturnsInvalidId) {
+    makeEngine(1000.0, true);
+    SymbolId id = symbol("SHORT");
+    engine->setSpreadRate(0.01);
+    // 10 at 100 uses the whole balance; the spread makes it 1010
+    EXPECT_EQ(engine->placeOrder(id, OrderSide::BUY, 10.0, OrderType::MARKET, kPrice), kInvalidOrderId);
+    EXPECT_DOUBLE_EQ(engine->getPosition(id).quantity, 0.0);
+    EXPECT_DOUBLE_EQ(aggregator->cash(), 1000.0);
+}
+
+} // namespace
+} // namespace TradingSystem
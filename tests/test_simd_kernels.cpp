@@ -0,0 +1,181 @@
+#include "analysis/simd_kernels.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace TradingSystem {
+namespace {
+
+// Every kernel set the CPU can run is checked against the scalar kernels
+// and against a naive two-pass reference, on lengths around the 512-window
+// blocks and the four-block AVX2 chunks
+class SimdKernelsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        initial = activeKernelSet();
+
+        // A random walk around 100 with two flat runs, one of them across
+        // the first block boundary
+        std::mt19937 rng(7);
+        double value = 100.0;
+        prices.resize(5000);
+        for (size_t i = 0; i < prices.size(); ++i) {
+            bool flat = (i >= 300 && i < 340) || (i >= 500 && i < 530);
+            if (!flat) {
+                value *= 1.0 + (static_cast<int>(rng() % 2001) - 1000) / 100000.0;
+            }
+            prices[i] = value;
+        }
+
+        for (KernelSet set : {KernelSet::SCALAR, KernelSet::AVX2, KernelSet::NEON}) {
+            if (forceKernelSet(set)) {
+                sets.push_back(set);
+            }
+        }
+        forceKernelSet(initial);
+    }
+
+    void TearDown() override {
+        forceKernelSet(initial);
+    }
+
+    static std::vector<double> run(KernelSet set, void (*kernel)(const double*, size_t, size_t, double*),
+                                   const double* x, size_t n, size_t window) {
+        EXPECT_TRUE(forceKernelSet(set));
+        std::vector<double> out(n, -1.0);
+        kernel(x, n, window, out.data());
+        return out;
+    }
+
+    static void expectClose(const std::vector<double>& actual, const std::vector<double>& expected,
+                            double tolerance, const char* what, size_t n, size_t window) {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            if (std::isnan(expected[i])) {
+                EXPECT_TRUE(std::isnan(actual[i]))
+                    << what << " n=" << n << " w=" << window << " i=" << i << ": " << actual[i];
+            } else {
+                EXPECT_NEAR(actual[i], expected[i], tolerance * std::max(1.0, std::fabs(expected[i])))
+                    << what << " n=" << n << " w=" << window << " i=" << i;
+            }
+        }
+    }
+
+    static std::vector<double> referenceMoments(const double* x, size_t n, size_t w, bool stdev) {
+        std::vector<double> out(n, std::nan(""));
+        if (w == 0 || (stdev && w < 2)) return out;
+        for (size_t i = w - 1; i < n; ++i) {
+            double mean = 0.0;
+            for (size_t k = i + 1 - w; k <= i; ++k) mean += x[k];
+            mean /= static_cast<double>(w);
+            if (!stdev) {
+                out[i] = mean;
+                continue;
+            }
+            double m2 = 0.0;
+            for (size_t k = i + 1 - w; k <= i; ++k) m2 += (x[k] - mean) * (x[k] - mean);
+            out[i] = std::sqrt(m2 / static_cast<double>(w - 1));
+        }
+        return out;
+    }
+
+    // Shorter than a window, around one block, and around one AVX2 chunk
+    std::vector<size_t> lengths() const {
+        return {0, 1, 3, 4, 5, 19, 20, 21, 511, 512, 513, 531, 2067, 2068, 2075, 4115, prices.size()};
+    }
+
+    KernelSet initial = KernelSet::SCALAR;
+    std::vector<KernelSet> sets;
+    std::vector<double> prices;
+};
+
+TEST_F(SimdKernelsTest, RollingMeanMatchesScalar) {
+    for (size_t window : {1, 5, 20}) {
+        for (size_t n : lengths()) {
+            std::vector<double> reference = referenceMoments(prices.data(), n, window, false);
+            std::vector<double> scalar = run(KernelSet::SCALAR, rollingMean, prices.data(), n, window);
+            expectClose(scalar, reference, 1e-12, "scalar mean", n, window);
+            for (KernelSet set : sets) {
+                expectClose(run(set, rollingMean, prices.data(), n, window), scalar, 1e-12,
+                            kernelSetName(set), n, window);
+            }
+        }
+    }
+}
+
+TEST_F(SimdKernelsTest, RollingStdMatchesScalar) {
+    for (size_t window : {2, 5, 20}) {
+        for (size_t n : lengths()) {
+            std::vector<double> reference = referenceMoments(prices.data(), n, window, true);
+            std::vector<double> scalar = run(KernelSet::SCALAR, rollingStd, prices.data(), n, window);
+            expectClose(scalar, reference, 1e-9, "scalar std", n, window);
+            for (KernelSet set : sets) {
+                expectClose(run(set, rollingStd, prices.data(), n, window), scalar, 1e-12,
+                            kernelSetName(set), n, window);
+            }
+        }
+    }
+}
+
+TEST_F(SimdKernelsTest, FlatWindowsHaveExactMomentsInEverySet) {
+    for (KernelSet set : sets) {
+        std::vector<double> mean = run(set, rollingMean, prices.data(), prices.size(), 20);
+        std::vector<double> stdev = run(set, rollingStd, prices.data(), prices.size(), 20);
+        for (size_t i = 319; i < 340; ++i) {
+            EXPECT_EQ(mean[i], prices[i]) << kernelSetName(set) << " i=" << i;
+            EXPECT_EQ(stdev[i], 0.0) << kernelSetName(set) << " i=" << i;
+        }
+        for (size_t i = 519; i < 530; ++i) {
+            EXPECT_EQ(stdev[i], 0.0) << kernelSetName(set) << " i=" << i;
+        }
+    }
+}
+
+TEST_F(SimdKernelsTest, WindowLongerThanSeriesIsAllNaN) {
+    for (KernelSet set : sets) {
+        for (auto kernel : {rollingMean, rollingStd}) {
+            std::vector<double> out = run(set, kernel, prices.data(), 19, 20);
+            for (double v : out) {
+                EXPECT_TRUE(std::isnan(v)) << kernelSetName(set);
+            }
+        }
+    }
+}
+
+TEST_F(SimdKernelsTest, EmaMatchesScalarRecursion) {
+    for (size_t n : lengths()) {
+        std::vector<double> expected(n);
+        double value = n > 0 ? prices[0] : 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            value += (2.0 / 13.0) * (prices[i] - value);
+            expected[i] = value;
+        }
+        for (KernelSet set : sets) {
+            ASSERT_TRUE(forceKernelSet(set));
+            std::vector<double> out(n);
+            ema(prices.data(), n, 12, out.data());
+            expectClose(out, expected, 1e-12, kernelSetName(set), n, 12);
+        }
+    }
+}
+
+TEST_F(SimdKernelsTest, RsiMatchesScalarIncludingFlatRuns) {
+    for (size_t n : lengths()) {
+        std::vector<double> scalar = run(KernelSet::SCALAR, rsi, prices.data(), n, 14);
+        for (size_t i = 0; i < std::min<size_t>(n, 13); ++i) {
+            EXPECT_TRUE(std::isnan(scalar[i])) << "n=" << n << " i=" << i;
+        }
+        for (KernelSet set : sets) {
+            expectClose(run(set, rsi, prices.data(), n, 14), scalar, 1e-9, kernelSetName(set), n, 14);
+        }
+    }
+    // 14 bars without a move have neither gains nor losses
+    std::vector<double> out = run(KernelSet::SCALAR, rsi, prices.data(), prices.size(), 14);
+    for (size_t i = 314; i < 340; ++i) {
+        EXPECT_TRUE(std::isnan(out[i])) << "i=" << i;
+    }
+}
+
+} // namespace
+} // namespace TradingSystem
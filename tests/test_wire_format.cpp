@@ -0,0 +1,141 @@
+#include "common/wire_format.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace TradingSystem {
+namespace {
+
+MarketData bar(const std::string& symbol, double close, int64_t timestamp_ns) {
+    MarketData data;
+    data.symbol = symbol;
+    data.open = close - 1.0;
+    data.high = close + 2.0;
+    data.low = close - 2.0;
+    data.close = close;
+    data.volume = 1000.0 + close;
+    data.timestamp = fromEpochNanos(timestamp_ns);
+    return data;
+}
+
+// Sender and receiver intern symbols in different orders, as the C++ and
+// Python sides do, so IDs only line up through the symbol table frame
+class WireFormatTest : public ::testing::Test {
+protected:
+    WireFormatTest() : encoder(sender_symbols), decoder(receiver_symbols) {
+        receiver_symbols.intern("UNRELATED");
+    }
+
+    SymbolTable sender_symbols;
+    SymbolTable receiver_symbols;
+    WireEncoder encoder;
+    WireDecoder decoder;
+};
+
+TEST_F(WireFormatTest, MarketDataRoundTrip) {
+    std::vector<MarketData> sent = {bar("AAPL", 190.5, 1700000000000000001LL),
+                                    bar("MSFT", 410.25, 1700000000000000002LL),
+                                    bar("AAPL", 191.0, 1700000060000000000LL)};
+    std::string buffer;
+    encoder.appendMarketData(buffer, sent);
+
+    std::vector<MarketData> received;
+    ASSERT_EQ(decoder.decodeAll(buffer, &received, nullptr), buffer.size());
+    ASSERT_EQ(received.size(), sent.size());
+    for (size_t i = 0; i < sent.size(); ++i) {
+        EXPECT_EQ(received[i].symbol, sent[i].symbol);
+        EXPECT_EQ(received[i].open, sent[i].open);
+        EXPECT_EQ(received[i].high, sent[i].high);
+        EXPECT_EQ(received[i].low, sent[i].low);
+        EXPECT_EQ(received[i].close, sent[i].close);
+        EXPECT_EQ(received[i].volume, sent[i].volume);
+        EXPECT_EQ(toEpochNanos(received[i].timestamp), toEpochNanos(sent[i].timestamp));
+    }
+}
+
+TEST_F(WireFormatTest, SignalsRoundTripWithLocalIds) {
+    std::vector<TradingSignal> sent(3);
+    const char* symbols[] = {"BTC", "ETH", "BTC"};
+    const SignalAction actions[] = {SignalAction::BUY, SignalAction::SELL, SignalAction::HOLD};
+    for (size_t i = 0; i < sent.size(); ++i) {
+        sent[i].symbol = symbols[i];
+        sent[i].action = actions[i];
+        sent[i].confidence = 0.25 * static_cast<double>(i + 1);
+        sent[i].suggested_position_size = 100.0 * static_cast<double>(i + 1);
+        sent[i].timestamp = fromEpochNanos(1700000000000000000LL + static_cast<int64_t>(i));
+    }
+    std::string buffer;
+    encoder.appendTradingSignals(buffer, sent);
+
+    std::vector<TradingSignal> received;
+    ASSERT_EQ(decoder.decodeAll(buffer, nullptr, &received), buffer.size());
+    ASSERT_EQ(received.size(), sent.size());
+    for (size_t i = 0; i < sent.size(); ++i) {
+        EXPECT_EQ(received[i].symbol, sent[i].symbol);
+        EXPECT_EQ(received[i].symbol_id, receiver_symbols.find(sent[i].symbol));
+        EXPECT_EQ(received[i].action, sent[i].action);
+        EXPECT_EQ(received[i].confidence, sent[i].confidence);
+        EXPECT_EQ(received[i].suggested_position_size, sent[i].suggested_position_size);
+        EXPECT_EQ(toEpochNanos(received[i].timestamp), toEpochNanos(sent[i].timestamp));
+    }
+}
+
+TEST_F(WireFormatTest, SymbolsAreAnnouncedOnce) {
+    std::string first;
+    encoder.appendMarketData(first, {bar("AAPL", 1.0, 1)});
+    std::string second;
+    encoder.appendMarketData(second, {bar("AAPL", 2.0, 2)});
+    EXPECT_LT(second.size(), first.size());
+
+    // The second buffer alone refers to an ID this decoder has not seen
+    WireDecoder fresh(receiver_symbols);
+    std::vector<MarketData> received;
+    EXPECT_EQ(fresh.decodeAll(second, &received, nullptr), second.size());
+    EXPECT_TRUE(received.empty());
+
+    ASSERT_EQ(decoder.decodeAll(first + second, &received, nullptr), first.size() + second.size());
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[1].close, 2.0);
+}
+
+TEST_F(WireFormatTest, PartialFrameIsNotConsumed) {
+    std::string buffer;
+    encoder.appendMarketData(buffer, {bar("AAPL", 1.0, 1), bar("MSFT", 2.0, 2)});
+
+    WireHeader header;
+    EXPECT_TRUE(WireDecoder::peekHeader(buffer, header));
+    std::string truncated = buffer.substr(0, buffer.size() - 1);
+    std::vector<MarketData> received;
+    size_t consumed = decoder.decodeAll(truncated, &received, nullptr);
+    EXPECT_LT(consumed, truncated.size());
+    EXPECT_TRUE(received.empty());
+}
+
+TEST_F(WireFormatTest, RejectsForeignBuffers) {
+    WireHeader header;
+    EXPECT_FALSE(WireDecoder::peekHeader("{\"results\":[]}", header));
+    EXPECT_FALSE(WireDecoder::peekHeader("", header));
+
+    std::string buffer;
+    encoder.appendMarketData(buffer, {bar("AAPL", 1.0, 1)});
+    buffer[0] ^= 0x01;
+    std::vector<MarketData> received;
+    EXPECT_EQ(decoder.decodeAll(buffer, &received, nullptr), 0u);
+    EXPECT_TRUE(received.empty());
+}
+
+TEST_F(WireFormatTest, UnknownFrameTypesAreSkipped) {
+    WireHeader unknown{kWireMagic, kWireVersion, 99, 1, 4};
+    std::string buffer(reinterpret_cast<const char*>(&unknown), sizeof(unknown));
+    buffer.append("abcd");
+    encoder.appendMarketData(buffer, {bar("AAPL", 3.0, 3)});
+
+    std::vector<MarketData> received;
+    EXPECT_EQ(decoder.decodeAll(buffer, &received, nullptr), buffer.size());
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0].close, 3.0);
+}
+
+} // namespace
+} // namespace TradingSystem